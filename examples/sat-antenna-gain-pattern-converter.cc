@@ -0,0 +1,92 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ *
+ */
+
+#include <sstream>
+#include "ns3/core-module.h"
+#include "ns3/satellite-module.h"
+
+using namespace ns3;
+
+/**
+ * \file sat-antenna-gain-pattern-converter.cc
+ * \ingroup satellite
+ *
+ * \brief Converter of the text antenna gain pattern files to the binary
+ * pattern files, which are memory-mapped by SatAntennaGainPattern. The
+ * binary file is written next to the text file with ".bin" extension.
+ *
+ * By default, the antenna patterns of the 72 beam reference system in the
+ * data folder are converted. A single file is converted with --file option.
+ *
+ * ./waf --run "sat-antenna-gain-pattern-converter --file=<path>"
+ *
+ */
+
+NS_LOG_COMPONENT_DEFINE ("sat-antenna-gain-pattern-converter");
+
+static void
+ConvertAntennaGainPattern (std::string filePathName)
+{
+  Ptr<SatAntennaGainPattern> gainPattern = CreateObject<SatAntennaGainPattern> (filePathName);
+  std::string binaryFilePathName = SatAntennaGainPattern::GetBinaryFilePathName (filePathName);
+
+  if (!gainPattern->WriteAntennaPatternToBinaryFile (binaryFilePathName))
+    {
+      NS_FATAL_ERROR ("Converting " << filePathName << " to " << binaryFilePathName << " failed");
+    }
+
+  NS_LOG_INFO ("Converted " << filePathName << " to " << binaryFilePathName);
+}
+
+int
+main (int argc, char *argv[])
+{
+  LogComponentEnable ("sat-antenna-gain-pattern-converter", LOG_LEVEL_INFO);
+
+  std::string filePathName ("");
+  uint32_t numberOfBeams (72);
+
+  CommandLine cmd;
+  cmd.AddValue ("file", "Text antenna pattern file to convert (default: all the patterns of the data folder)", filePathName);
+  cmd.AddValue ("beams", "Number of beams in the data folder", numberOfBeams);
+  cmd.Parse (argc, argv);
+
+  // The patterns are always read from the text files
+  Config::SetDefault ("ns3::SatAntennaGainPattern::UseBinaryPatternFile", BooleanValue (false));
+
+  if (!filePathName.empty ())
+    {
+      ConvertAntennaGainPattern (filePathName);
+      return 0;
+    }
+
+  std::string dataPath = Singleton<SatEnvVariables>::Get ()->LocateDataDirectory ();
+
+  // Note, that the beam ids start from 1
+  for (uint32_t i = 1; i <= numberOfBeams; ++i)
+    {
+      std::ostringstream ss;
+      ss << dataPath << "/antennapatterns/SatAntennaGain" << numberOfBeams << "Beams_" << i << ".txt";
+      ConvertAntennaGainPattern (ss.str ());
+    }
+
+  return 0;
+}
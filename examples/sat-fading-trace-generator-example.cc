@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/satellite-module.h"
+
+using namespace ns3;
+
+/**
+ * \file sat-fading-trace-generator-example.cc
+ * \ingroup satellite
+ *
+ * \brief  Example of generating Markov fading traces offline. The fading of
+ *         the given number of terminals with the same elevation and velocity
+ *         is generated with SatFadingTraceGeneratorHelper into the folder
+ *         "markov-fadingtraces" of the simulation output folder.
+ *
+ *         The traces are replayed in a simulation by setting the attribute
+ *         "ns3::SatBeamHelper::FadingModel" to "FadingMarkovReplay" and
+ *         "ns3::SatBeamHelper::FadingReplayFolder" to the generated folder.
+ *         Each GW and UT node gets a trace not used by the other nodes,
+ *         which has the same Markov elevation set as the node and the
+ *         closest velocity.
+ *
+ *         The generation drives the simulator, so it is done here in a
+ *         program of its own instead of the simulation using the traces.
+ *
+ *         execute command -> ./waf --run "sat-fading-trace-generator-example --PrintHelp"
+ */
+
+NS_LOG_COMPONENT_DEFINE ("sat-fading-trace-generator-example");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t terminals (10);
+  double elevation (45.0);
+  double velocity (0.0);
+  double duration (60.0);
+  uint32_t seed (1);
+
+  LogComponentEnable ("sat-fading-trace-generator-example", LOG_LEVEL_INFO);
+
+  CommandLine cmd;
+  cmd.AddValue ("terminals", "Number of terminals", terminals);
+  cmd.AddValue ("elevation", "Elevation angle of the terminals in degrees", elevation);
+  cmd.AddValue ("velocity", "Velocity of the terminals in m/s", velocity);
+  cmd.AddValue ("duration", "Duration of the traces in seconds", duration);
+  cmd.AddValue ("seed", "Seed of the random number generator", seed);
+  cmd.Parse (argc, argv);
+
+  RngSeedManager::SetSeed (seed);
+
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("example-fading-trace-generator", "", true);
+
+  Ptr<SatFadingTraceGeneratorHelper> generator = CreateObject<SatFadingTraceGeneratorHelper> ();
+  generator->SetAttribute ("Duration", TimeValue (Seconds (duration)));
+
+  for (uint32_t i = 0; i < terminals; ++i)
+    {
+      generator->AddTerminal (elevation, velocity);
+    }
+
+  std::string folder = Singleton<SatEnvVariables>::Get ()->GetOutputPath () + "/markov-fadingtraces";
+  generator->Generate (folder);
+
+  NS_LOG_INFO ("Fading traces of " << terminals << " terminals written to " << folder);
+
+  generator->Dispose ();
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/satellite-module.h"
+
+using namespace ns3;
+
+/**
+ * \file sat-random-access-monte-carlo-example.cc
+ * \ingroup satellite
+ *
+ * \brief  Example of the frame level random access Monte-Carlo simulator.
+ *         The example sweeps the offered load of a CRDSA (or slotted ALOHA
+ *         with one replica) random access channel and produces the throughput
+ *         and packet loss ratio versus the offered load without running the
+ *         full simulation. The load points are simulated in parallel with
+ *         the given number of threads.
+ *
+ *         The results are written into file "random-access-monte-carlo.txt"
+ *         in the simulation output folder. Each row contains the offered load
+ *         (unique packets per slot), the throughput (received unique packets
+ *         per slot), the packet loss ratio and the number of sent and received
+ *         unique packets.
+ *
+ *         execute command -> ./waf --run "sat-random-access-monte-carlo-example --PrintHelp"
+ */
+
+NS_LOG_COMPONENT_DEFINE ("sat-random-access-monte-carlo-example");
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t slotsPerFrame (100);
+  uint32_t replicas (3);
+  uint32_t waveformId (3);
+  uint32_t frames (1000);
+  uint32_t threads (1);
+  double minLoad (0.1);
+  double maxLoad (1.0);
+  double loadStep (0.1);
+  double meanEsNoDb (10.0);
+  double esNoRangeDb (0.0);
+  bool strictCollisions (false);
+
+  LogComponentEnable ("sat-random-access-monte-carlo-example", LOG_LEVEL_INFO);
+
+  CommandLine cmd;
+  cmd.AddValue ("slotsPerFrame", "Number of random access slots in a frame", slotsPerFrame);
+  cmd.AddValue ("replicas", "Number of replicas of each unique packet (1 = slotted ALOHA)", replicas);
+  cmd.AddValue ("waveformId", "DVB-RCS2 waveform id of the packets", waveformId);
+  cmd.AddValue ("frames", "Number of frames simulated for each load point", frames);
+  cmd.AddValue ("threads", "Number of threads simulating the load points in parallel", threads);
+  cmd.AddValue ("minLoad", "Minimum offered load in unique packets per slot", minLoad);
+  cmd.AddValue ("maxLoad", "Maximum offered load in unique packets per slot", maxLoad);
+  cmd.AddValue ("loadStep", "Offered load step", loadStep);
+  cmd.AddValue ("meanEsNoDb", "Mean user link Es/No in dB", meanEsNoDb);
+  cmd.AddValue ("esNoRangeDb", "Width of the uniform user link Es/No distribution in dB", esNoRangeDb);
+  cmd.AddValue ("strictCollisions", "Drop all the colliding packets instead of checking against SINR", strictCollisions);
+  cmd.Parse (argc, argv);
+
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("example-random-access-monte-carlo", "", true);
+
+  Ptr<SatRandomAccessMonteCarloHelper> helper = CreateObject<SatRandomAccessMonteCarloHelper> ();
+  helper->SetAttribute ("SlotsPerFrame", UintegerValue (slotsPerFrame));
+  helper->SetAttribute ("Replicas", UintegerValue (replicas));
+  helper->SetAttribute ("WaveformId", UintegerValue (waveformId));
+  helper->SetAttribute ("FramesPerLoadPoint", UintegerValue (frames));
+  helper->SetAttribute ("Threads", UintegerValue (threads));
+  helper->SetAttribute ("MeanEsNoDb", DoubleValue (meanEsNoDb));
+  helper->SetAttribute ("EsNoRangeDb", DoubleValue (esNoRangeDb));
+
+  if (strictCollisions)
+    {
+      helper->SetAttribute ("CollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS));
+    }
+
+  std::vector<double> offeredLoads;
+
+  for (double load = minLoad; load <= maxLoad + loadStep / 2; load += loadStep)
+    {
+      offeredLoads.push_back (load);
+    }
+
+  std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s> results = helper->Run (offeredLoads);
+
+  NS_LOG_INFO ("--- sat-random-access-monte-carlo-example ---");
+  NS_LOG_INFO ("  Slots per frame: " << slotsPerFrame);
+  NS_LOG_INFO ("  Replicas: " << replicas);
+  NS_LOG_INFO ("  Frames per load point: " << frames);
+  NS_LOG_INFO ("  ");
+
+  for (uint32_t i = 0; i < results.size (); ++i)
+    {
+      NS_LOG_INFO ("  Offered load: " << results[i].offeredLoad
+                   << ", throughput: " << results[i].throughput
+                   << ", packet loss ratio: " << results[i].packetLossRatio);
+    }
+
+  std::string fileName = Singleton<SatEnvVariables>::Get ()->GetOutputPath () + "/random-access-monte-carlo.txt";
+  helper->WriteResults (fileName, results);
+
+  helper->Dispose ();
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ *
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/satellite-module.h"
+
+using namespace ns3;
+
+/**
+ * \file sat-trace-file-converter.cc
+ * \ingroup satellite
+ *
+ * \brief Converter between the text and the binary (SatBinaryTraceFile)
+ * formats of the rx power, fading, interference and composite SINR trace
+ * files. The direction of the conversion is detected from the input file,
+ * i.e. a binary file is converted to text and a text file to binary.
+ *
+ * The number of columns of a text file is given with --columns option,
+ * e.g. 2 for the rx power, fading and interference traces.
+ *
+ * ./waf --run "sat-trace-file-converter --input=<path> --output=<path> --columns=2 --float32=1 --deltaTime=1"
+ *
+ */
+
+NS_LOG_COMPONENT_DEFINE ("sat-trace-file-converter");
+
+int
+main (int argc, char *argv[])
+{
+  LogComponentEnable ("sat-trace-file-converter", LOG_LEVEL_INFO);
+
+  std::string inputFilePathName ("");
+  std::string outputFilePathName ("");
+  uint32_t columns (2);
+  bool float32 (false);
+  bool deltaTime (false);
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "Trace file to convert", inputFilePathName);
+  cmd.AddValue ("output", "Converted trace file", outputFilePathName);
+  cmd.AddValue ("columns", "Number of columns in the text file including the time column", columns);
+  cmd.AddValue ("float32", "Store the value columns of the binary file as float instead of double", float32);
+  cmd.AddValue ("deltaTime", "Delta encode the time column of the binary file with nanosecond resolution", deltaTime);
+  cmd.Parse (argc, argv);
+
+  if (inputFilePathName.empty () || outputFilePathName.empty ())
+    {
+      NS_FATAL_ERROR ("Both the input and the output file must be given.");
+    }
+
+  if (SatBinaryTraceFile::IsBinaryTraceFile (inputFilePathName))
+    {
+      SatBinaryTraceFile::ConvertBinaryToText (inputFilePathName, outputFilePathName);
+    }
+  else
+    {
+      SatBinaryTraceFile::ValueType_t valueType = float32 ? SatBinaryTraceFile::FLOAT32 : SatBinaryTraceFile::FLOAT64;
+      SatBinaryTraceFile::ConvertTextToBinary (inputFilePathName, outputFilePathName, columns, valueType, deltaTime);
+    }
+
+  NS_LOG_INFO ("Converted " << inputFilePathName << " to " << outputFilePathName);
+
+  return 0;
+}
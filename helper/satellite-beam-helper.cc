@@ -18,6 +18,8 @@
  * Author: Sami Rantanen <sami.rantanen@magister.fi>
  */
 
+#include <cmath>
+#include <fstream>
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/ipv4-static-routing-helper.h"
@@ -29,6 +31,7 @@
 #include "ns3/config.h"
 #include "../model/satellite-const-variables.h"
 #include "../model/satellite-channel.h"
+#include "../model/satellite-co-channel-activity.h"
 #include "../model/satellite-phy.h"
 #include "../model/satellite-phy-tx.h"
 #include "../model/satellite-phy-rx.h"
@@ -43,6 +46,9 @@
 #include "satellite-beam-helper.h"
 #include "ns3/satellite-fading-input-trace-container.h"
 #include "ns3/satellite-fading-input-trace.h"
+#include "ns3/satellite-fading-trace-replay.h"
+#include "ns3/satellite-env-variables.h"
+#include "satellite-fading-trace-generator-helper.h"
 #include "ns3/singleton.h"
 #include "ns3/satellite-id-mapper.h"
 #include <ns3/satellite-typedefs.h>
@@ -69,7 +75,14 @@ SatBeamHelper::GetTypeId (void)
                    MakeEnumAccessor (&SatBeamHelper::m_fadingModel),
                    MakeEnumChecker (SatEnums::FADING_OFF, "FadingOff",
                                     SatEnums::FADING_TRACE, "FadingTrace",
-                                    SatEnums::FADING_MARKOV, "FadingMarkov"))
+                                    SatEnums::FADING_MARKOV, "FadingMarkov",
+                                    SatEnums::FADING_MARKOV_REPLAY, "FadingMarkovReplay"))
+    .AddAttribute ("FadingReplayFolder",
+                   "Folder of the pre-generated Markov fading traces used with FadingMarkovReplay. "
+                   "By default the markov-fadingtraces folder of the data directory.",
+                   StringValue (""),
+                   MakeStringAccessor (&SatBeamHelper::m_fadingReplayFolder),
+                   MakeStringChecker ())
     .AddAttribute ("RandomAccessModel",
                    "Random Access Model",
                    EnumValue (SatEnums::RA_MODEL_OFF),
@@ -145,7 +158,8 @@ SatBeamHelper::SatBeamHelper ()
     m_randomAccessModel (SatEnums::RA_MODEL_OFF),
     m_raInterferenceModel (SatPhyRxCarrierConf::IF_CONSTANT),
     m_raCollisionModel (SatPhyRxCarrierConf::RA_COLLISION_NOT_DEFINED),
-    m_raConstantErrorRate (0.0)
+    m_raConstantErrorRate (0.0),
+    m_fadingReplayTraces ()
 {
   NS_LOG_FUNCTION (this);
 
@@ -167,7 +181,8 @@ SatBeamHelper::SatBeamHelper (Ptr<Node> geoNode,
     m_randomAccessModel (SatEnums::RA_MODEL_OFF),
     m_raInterferenceModel (SatPhyRxCarrierConf::IF_CONSTANT),
     m_raCollisionModel (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR),
-    m_raConstantErrorRate (0.0)
+    m_raConstantErrorRate (0.0),
+    m_fadingReplayTraces ()
 {
   NS_LOG_FUNCTION (this << geoNode << rtnLinkCarrierCount << fwdLinkCarrierCount << seq);
 
@@ -261,6 +276,7 @@ SatBeamHelper::SatBeamHelper (Ptr<Node> geoNode,
   switch (m_fadingModel)
     {
     case SatEnums::FADING_MARKOV:
+    case SatEnums::FADING_MARKOV_REPLAY:
       {
         /// create default Markov & Loo configurations
         m_markovConf = CreateObject<SatMarkovConf> ();
@@ -287,6 +303,7 @@ SatBeamHelper::DoDispose ()
   m_flChannels.clear ();
   m_beamFreqs.clear ();
   m_markovConf = NULL;
+  m_fadingReplayTraces.clear ();
   m_ncc = NULL;
   m_geoHelper = NULL;
   m_gwHelper = NULL;
@@ -497,6 +514,13 @@ SatBeamHelper::GetGeoHelper () const
   return m_geoHelper;
 }
 
+Ptr<SatSuperframeSeq>
+SatBeamHelper::GetSuperframeSeq () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_superframeSeq;
+}
+
 NodeContainer
 SatBeamHelper::GetGwNodes () const
 {
@@ -978,6 +1002,20 @@ SatBeamHelper::GetChannelPair (std::map<uint32_t, ChannelPair_t > & chPairMap, u
       forwardCh->SetFreeSpaceLoss (pFsl);
       returnCh->SetFreeSpaceLoss (pFsl);
 
+      /**
+       * Co-channel activity of the user link channels is used by the co-channel
+       * interference model. Activity recording is enabled only if the model is
+       * actually configured to be used for some carrier.
+       */
+      if (isUserLink)
+        {
+          NS_ASSERT (m_geoNode != NULL);
+
+          Ptr<MobilityModel> geoMobility = m_geoNode->GetObject<MobilityModel> ();
+          forwardCh->SetCoChannelActivity (CreateObject<SatCoChannelActivity> (m_antennaGainPatterns, geoMobility, pDelay));
+          returnCh->SetCoChannelActivity (CreateObject<SatCoChannelActivity> (m_antennaGainPatterns, geoMobility, pDelay));
+        }
+
       channelPair.first = forwardCh;
       channelPair.second = returnCh;
 
@@ -1121,6 +1159,27 @@ SatBeamHelper::InstallFadingContainer (Ptr<Node> node) const
 
             fadingContainer = CreateObject<SatFadingInputTrace> (Singleton<SatFadingInputTraceContainer>::Get ());
 
+            node->AggregateObject (fadingContainer);
+            break;
+          }
+        case SatEnums::FADING_MARKOV_REPLAY:
+          {
+            /// replay the pre-generated traces of the same elevation set and velocity as the node
+            Ptr<SatMobilityObserver> observer = node->GetObject<SatMobilityObserver> ();
+            NS_ASSERT (observer != NULL);
+
+            if (m_fadingReplayTraces.empty ())
+              {
+                LoadFadingReplayIndex ();
+              }
+
+            const fadingReplayTrace_s& trace = SelectFadingReplayTrace (observer->GetElevationAngle (), observer->GetVelocity ());
+
+            Ptr<SatFadingExternalInputTrace> upTrace = Create<SatFadingExternalInputTrace> (SatFadingExternalInputTrace::FT_TWO_COLUMN, trace.upFile);
+            Ptr<SatFadingExternalInputTrace> downTrace = Create<SatFadingExternalInputTrace> (SatFadingExternalInputTrace::FT_TWO_COLUMN, trace.downFile);
+
+            fadingContainer = CreateObject<SatFadingTraceReplay> (upTrace, downTrace, m_markovConf->AreDecibelsUsed ());
+
             node->AggregateObject (fadingContainer);
             break;
           }
@@ -1136,6 +1195,79 @@ SatBeamHelper::InstallFadingContainer (Ptr<Node> node) const
   return fadingContainer;
 }
 
+void
+SatBeamHelper::LoadFadingReplayIndex () const
+{
+  NS_LOG_FUNCTION (this);
+
+  std::string folder = m_fadingReplayFolder;
+
+  if (folder.empty ())
+    {
+      folder = Singleton<SatEnvVariables>::Get ()->LocateDataDirectory () + "/markov-fadingtraces";
+    }
+
+  std::string indexFile = folder + "/" + SatFadingTraceGeneratorHelper::GetIndexFileName ();
+  std::ifstream ifs (indexFile.c_str (), std::ios::in);
+
+  if (!ifs.is_open ())
+    {
+      NS_FATAL_ERROR ("SatBeamHelper::LoadFadingReplayIndex - Index file " << indexFile << " not found");
+    }
+
+  uint32_t id;
+  std::string upFile, downFile;
+  double elevation, velocity;
+
+  while (ifs >> id >> upFile >> downFile >> elevation >> velocity)
+    {
+      fadingReplayTrace_s trace;
+      trace.upFile = folder + "/" + upFile;
+      trace.downFile = folder + "/" + downFile;
+      trace.velocity = velocity;
+      trace.installed = false;
+
+      m_fadingReplayTraces[m_markovConf->GetProbabilitySetID (elevation)].push_back (trace);
+    }
+
+  if (m_fadingReplayTraces.empty ())
+    {
+      NS_FATAL_ERROR ("SatBeamHelper::LoadFadingReplayIndex - No traces in index file " << indexFile);
+    }
+}
+
+const SatBeamHelper::fadingReplayTrace_s&
+SatBeamHelper::SelectFadingReplayTrace (double elevation, double velocity) const
+{
+  NS_LOG_FUNCTION (this << elevation << velocity);
+
+  uint32_t setId = m_markovConf->GetProbabilitySetID (elevation);
+  std::map<uint32_t, std::vector<fadingReplayTrace_s> >::iterator it = m_fadingReplayTraces.find (setId);
+  fadingReplayTrace_s* selected = NULL;
+
+  if (it != m_fadingReplayTraces.end ())
+    {
+      for (std::vector<fadingReplayTrace_s>::iterator trace = it->second.begin (); trace != it->second.end (); ++trace)
+        {
+          if (!trace->installed
+              && (selected == NULL || std::abs (trace->velocity - velocity) < std::abs (selected->velocity - velocity)))
+            {
+              selected = &(*trace);
+            }
+        }
+    }
+
+  if (selected == NULL)
+    {
+      NS_FATAL_ERROR ("SatBeamHelper::SelectFadingReplayTrace - Not enough pre-generated fading traces for elevation "
+                      << elevation << " (set " << setId << ")");
+    }
+
+  selected->installed = true;
+
+  return *selected;
+}
+
 void
 SatBeamHelper::AddMulticastRouteToUt (Ptr<Node> utNode, Ipv4Address sourceAddress, Ipv4Address groupAddress, bool routeToSatellite)
 {
@@ -253,6 +253,11 @@ public:
    */
   Ptr<SatNcc> GetNcc () const;
 
+  /**
+   * \return pointer to the superframe sequence of the return link.
+   */
+  Ptr<SatSuperframeSeq> GetSuperframeSeq () const;
+
   /**
    * Get beam Id of the given UT.
    *
@@ -378,6 +383,30 @@ private:
    */
   double m_raConstantErrorRate;
 
+  /**
+   * Folder of the pre-generated fading traces replayed with
+   * FADING_MARKOV_REPLAY. Set as an attribute.
+   */
+  std::string m_fadingReplayFolder;
+
+  /**
+   * Uplink and downlink trace files and the velocity of a pre-generated
+   * fading trace, and whether the trace is already installed to a node
+   */
+  typedef struct
+  {
+    std::string upFile;
+    std::string downFile;
+    double velocity;
+    bool installed;
+  } fadingReplayTrace_s;
+
+  /**
+   * Pre-generated fading traces by the Markov probability set of their
+   * elevation, in the order of the index file
+   */
+  mutable std::map<uint32_t, std::vector<fadingReplayTrace_s> > m_fadingReplayTraces;
+
   /**
    * Packet trace
    */
@@ -429,6 +458,22 @@ private:
    */
   Ptr<SatBaseFading>  InstallFadingContainer (Ptr<Node> node) const;
 
+  /**
+   * Read the index file of the pre-generated fading traces
+   */
+  void LoadFadingReplayIndex () const;
+
+  /**
+   * Select a pre-generated fading trace not installed yet, which has the
+   * same Markov probability set as the given elevation and the closest
+   * velocity to the given one
+   *
+   * \param elevation Elevation angle of the node in degrees
+   * \param velocity Velocity of the node in m/s
+   * \return Selected trace
+   */
+  const fadingReplayTrace_s& SelectFadingReplayTrace (double elevation, double velocity) const;
+
   /**
    * Add multicast route to UT node.
    *
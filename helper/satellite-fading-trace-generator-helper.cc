@@ -0,0 +1,245 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/node-list.h"
+#include "ns3/singleton.h"
+#include "ns3/mac48-address.h"
+#include "ns3/satellite-utils.h"
+#include "ns3/satellite-env-variables.h"
+#include "satellite-fading-trace-generator-helper.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatFadingTraceGeneratorHelper");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SatFadingTraceGeneratorHelper);
+
+TypeId
+SatFadingTraceGeneratorHelper::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatFadingTraceGeneratorHelper")
+    .SetParent<Object> ()
+    .AddConstructor<SatFadingTraceGeneratorHelper> ()
+    .AddAttribute ("SampleInterval",
+                   "Interval of the generated fading samples.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&SatFadingTraceGeneratorHelper::m_sampleInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("Duration",
+                   "Duration of the generated fading traces.",
+                   TimeValue (Seconds (60)),
+                   MakeTimeAccessor (&SatFadingTraceGeneratorHelper::m_duration),
+                   MakeTimeChecker ())
+    .AddAttribute ("TerminalsPerBatch",
+                   "Number of terminals generated at the same time, limits the memory usage.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&SatFadingTraceGeneratorHelper::m_terminalsPerBatch),
+                   MakeUintegerChecker<uint32_t> (1));
+  return tid;
+}
+
+SatFadingTraceGeneratorHelper::SatFadingTraceGeneratorHelper ()
+  : m_terminals (),
+    m_markovConf (NULL),
+    m_sampleInterval (MilliSeconds (10)),
+    m_duration (Seconds (60)),
+    m_terminalsPerBatch (1000)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SatFadingTraceGeneratorHelper::~SatFadingTraceGeneratorHelper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatFadingTraceGeneratorHelper::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_terminals.clear ();
+  m_markovConf = NULL;
+  Object::DoDispose ();
+}
+
+std::string
+SatFadingTraceGeneratorHelper::GetIndexFileName ()
+{
+  return "markov_fading_trace_index.txt";
+}
+
+uint32_t
+SatFadingTraceGeneratorHelper::AddTerminal (double elevation, double velocity)
+{
+  NS_LOG_FUNCTION (this << elevation << velocity);
+
+  terminal_s terminal;
+  terminal.elevation = elevation;
+  terminal.velocity = velocity;
+  m_terminals.push_back (terminal);
+
+  return m_terminals.size ();
+}
+
+double
+SatFadingTraceGeneratorHelper::GetConstantValue (double value)
+{
+  return value;
+}
+
+std::string
+SatFadingTraceGeneratorHelper::GetTraceFileName (uint32_t id, bool up) const
+{
+  std::stringstream fileName;
+  fileName << "markov_fading_trace_" << id << (up ? "_up.dat" : "_down.dat");
+  return fileName.str ();
+}
+
+void
+SatFadingTraceGeneratorHelper::Generate (std::string folder)
+{
+  NS_LOG_FUNCTION (this << folder);
+
+  if (m_terminals.empty ())
+    {
+      NS_FATAL_ERROR ("SatFadingTraceGeneratorHelper::Generate - No terminals added");
+    }
+
+  if (m_sampleInterval.IsZero () || m_duration < m_sampleInterval)
+    {
+      NS_FATAL_ERROR ("SatFadingTraceGeneratorHelper::Generate - Invalid sample interval or duration");
+    }
+
+  // the simulator is run and destroyed below, which must not touch a scenario of the caller
+  if (!Simulator::Now ().IsZero () || !Simulator::IsFinished () || NodeList::GetNNodes () > 0)
+    {
+      NS_FATAL_ERROR ("SatFadingTraceGeneratorHelper::Generate - Simulator already in use, generate the traces in a program of its own");
+    }
+
+  if (!Singleton<SatEnvVariables>::Get ()->IsValidDirectory (folder))
+    {
+      Singleton<SatEnvVariables>::Get ()->CreateDirectory (folder);
+    }
+
+  m_markovConf = CreateObject<SatMarkovConf> ();
+
+  // one extra sample is needed for the interpolation at the end of the trace
+  uint32_t samples = m_duration.GetInteger () / m_sampleInterval.GetInteger () + 2;
+
+  std::ofstream index ((folder + "/" + GetIndexFileName ()).c_str (), std::ios::out);
+
+  if (!index.is_open ())
+    {
+      NS_FATAL_ERROR ("SatFadingTraceGeneratorHelper::Generate - Index file " << folder << "/" << GetIndexFileName () << " not opened");
+    }
+
+  for (uint32_t first = 0; first < m_terminals.size (); first += m_terminalsPerBatch)
+    {
+      uint32_t count = std::min<uint32_t> (m_terminalsPerBatch, m_terminals.size () - first);
+
+      NS_LOG_INFO ("Generating fading of terminals " << first + 1 << " - " << first + count);
+
+      // containers and their random variables are created in the order of the terminals
+      batch_s batch;
+      batch.upSamples.resize (count);
+      batch.downSamples.resize (count);
+
+      for (uint32_t i = 0; i < count; i++)
+        {
+          const terminal_s& terminal = m_terminals[first + i];
+
+          SatBaseFading::ElevationCallback elevationCb = MakeBoundCallback (&SatFadingTraceGeneratorHelper::GetConstantValue, terminal.elevation);
+          SatBaseFading::VelocityCallback velocityCb = MakeBoundCallback (&SatFadingTraceGeneratorHelper::GetConstantValue, terminal.velocity);
+
+          batch.containers.push_back (CreateObject<SatMarkovContainer> (m_markovConf, elevationCb, velocityCb));
+          batch.upSamples[i].reserve (2 * samples);
+          batch.downSamples[i].reserve (2 * samples);
+        }
+
+      for (uint32_t k = 0; k < samples; k++)
+        {
+          Simulator::Schedule (m_sampleInterval * k, &SatFadingTraceGeneratorHelper::SampleBatch, this, &batch);
+        }
+
+      Simulator::Run ();
+      Simulator::Destroy ();
+
+      for (uint32_t i = 0; i < count; i++)
+        {
+          uint32_t id = first + i + 1;
+
+          WriteTraceFile (folder + "/" + GetTraceFileName (id, true), batch.upSamples[i]);
+          WriteTraceFile (folder + "/" + GetTraceFileName (id, false), batch.downSamples[i]);
+
+          index << id << " " << GetTraceFileName (id, true) << " " << GetTraceFileName (id, false)
+                << " " << m_terminals[first + i].elevation << " " << m_terminals[first + i].velocity << std::endl;
+
+          batch.containers[i]->Dispose ();
+        }
+    }
+
+  index.close ();
+}
+
+void
+SatFadingTraceGeneratorHelper::SampleBatch (SatFadingTraceGeneratorHelper::batch_s* batch)
+{
+  NS_LOG_FUNCTION (this);
+
+  float time = Simulator::Now ().GetSeconds ();
+  bool useDecibels = m_markovConf->AreDecibelsUsed ();
+  const Address address = Mac48Address ();
+
+  for (uint32_t i = 0; i < batch->containers.size (); i++)
+    {
+      double up = batch->containers[i]->GetFading (address, SatEnums::RETURN_USER_CH);
+      double down = batch->containers[i]->GetFading (address, SatEnums::FORWARD_USER_CH);
+
+      batch->upSamples[i].push_back (time);
+      batch->upSamples[i].push_back (useDecibels ? up : SatUtils::LinearToDb (up));
+      batch->downSamples[i].push_back (time);
+      batch->downSamples[i].push_back (useDecibels ? down : SatUtils::LinearToDb (down));
+    }
+}
+
+void
+SatFadingTraceGeneratorHelper::WriteTraceFile (std::string fileName, const std::vector<float>& samples) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  std::ofstream ofs (fileName.c_str (), std::ios::out | std::ios::binary);
+
+  if (!ofs.is_open ())
+    {
+      NS_FATAL_ERROR ("SatFadingTraceGeneratorHelper::WriteTraceFile - File " << fileName << " not opened");
+    }
+
+  ofs.write ((const char*) &samples[0], samples.size () * sizeof (float));
+  ofs.close ();
+}
+
+} // namespace ns3
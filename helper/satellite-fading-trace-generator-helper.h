@@ -0,0 +1,162 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+#ifndef SATELLITE_FADING_TRACE_GENERATOR_HELPER_H
+#define SATELLITE_FADING_TRACE_GENERATOR_HELPER_H
+
+#include <string>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/satellite-markov-conf.h"
+#include "ns3/satellite-markov-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Offline generator of Markov fading traces. The helper samples the
+ * uplink and downlink fading of SatMarkovContainer for each added terminal
+ * with the given constant elevation and velocity, and writes the channel
+ * gain in dB into binary two column files in the format read by
+ * SatFadingExternalInputTrace. The files are listed in an index file, which
+ * is read by SatBeamHelper when the fading model is FADING_MARKOV_REPLAY,
+ * so that simulations varying only the traffic can reuse the same fading.
+ *
+ * SatMarkovContainer and its faders take the time from the simulator, so
+ * the generation runs and destroys the global simulator for each batch.
+ * Thus it must be done in a program of its own, such as
+ * sat-fading-trace-generator-example, before any node or event has been
+ * created. Generate fails otherwise instead of destroying the state of the
+ * calling simulation. The terminals are generated in batches to limit
+ * the memory usage. The fading is sampled in the simulator thread, as the
+ * Markov containers log and take the time from the simulator, which is not
+ * thread safe. The containers and their random variables are created in
+ * the order of the terminals, so the traces depend only on the seed and
+ * run number.
+ */
+class SatFadingTraceGeneratorHelper : public Object
+{
+public:
+  /**
+   * \brief Get the type ID
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  SatFadingTraceGeneratorHelper ();
+
+  /**
+   * \brief Destructor
+   */
+  virtual ~SatFadingTraceGeneratorHelper ();
+
+  /**
+   * \brief Add a terminal to generate the fading for
+   * \param elevation Elevation angle of the terminal in degrees
+   * \param velocity Velocity of the terminal in m/s
+   * \return Id of the terminal in the index file, starting from 1
+   */
+  uint32_t AddTerminal (double elevation, double velocity);
+
+  /**
+   * \brief Generate the fading traces and the index file of the added
+   * terminals. Must not be called after the simulator has been used or
+   * nodes have been created.
+   * \param folder Folder to write the files into
+   */
+  void Generate (std::string folder);
+
+  /**
+   * \brief Get the name of the index file
+   * \return Name of the index file
+   */
+  static std::string GetIndexFileName ();
+
+protected:
+  /**
+   * \brief Dispose implementation
+   */
+  virtual void DoDispose ();
+
+private:
+  /**
+   * \brief Elevation and velocity of a terminal
+   */
+  typedef struct
+  {
+    double elevation;
+    double velocity;
+  } terminal_s;
+
+  /**
+   * \brief Fading containers and samples of a batch of terminals
+   */
+  typedef struct
+  {
+    std::vector<Ptr<SatMarkovContainer> > containers;
+    std::vector<std::vector<float> > upSamples;
+    std::vector<std::vector<float> > downSamples;
+  } batch_s;
+
+  /**
+   * \brief Sample the fading of all the terminals of a batch at the current time
+   * \param batch Batch to sample
+   */
+  void SampleBatch (SatFadingTraceGeneratorHelper::batch_s* batch);
+
+  /**
+   * \brief Write samples into a binary trace file
+   * \param fileName Name of the file
+   * \param samples Interleaved time and fading samples
+   */
+  void WriteTraceFile (std::string fileName, const std::vector<float>& samples) const;
+
+  /**
+   * \brief Get the file name of a terminal trace
+   * \param id Id of the terminal
+   * \param up Uplink or downlink trace
+   * \return File name
+   */
+  std::string GetTraceFileName (uint32_t id, bool up) const;
+
+  /**
+   * \brief Return a constant value, used as elevation and velocity callback
+   * \param value Value to return
+   * \return The value
+   */
+  static double GetConstantValue (double value);
+
+  std::vector<SatFadingTraceGeneratorHelper::terminal_s> m_terminals;
+  Ptr<SatMarkovConf> m_markovConf;
+
+  Time m_sampleInterval;
+  Time m_duration;
+  uint32_t m_terminalsPerBatch;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_FADING_TRACE_GENERATOR_HELPER_H */
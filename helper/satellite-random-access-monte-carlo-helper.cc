@@ -0,0 +1,484 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#include <cmath>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/singleton.h"
+#include "ns3/satellite-utils.h"
+#include "ns3/satellite-const-variables.h"
+#include "ns3/satellite-wave-form-conf.h"
+#include "ns3/satellite-link-results.h"
+#include "ns3/satellite-env-variables.h"
+#include "ns3/satellite-thread-pool.h"
+#include "ns3/satellite-output-fstream-double-container.h"
+#include "satellite-random-access-monte-carlo-helper.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatRandomAccessMonteCarloHelper");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SatRandomAccessMonteCarloHelper);
+
+TypeId
+SatRandomAccessMonteCarloHelper::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatRandomAccessMonteCarloHelper")
+    .SetParent<Object> ()
+    .AddConstructor<SatRandomAccessMonteCarloHelper> ()
+    .AddAttribute ("SlotsPerFrame",
+                   "Number of random access slots in a frame.",
+                   UintegerValue (100),
+                   MakeUintegerAccessor (&SatRandomAccessMonteCarloHelper::m_slotsPerFrame),
+                   MakeUintegerChecker<uint32_t> (1, 65536))
+    .AddAttribute ("Replicas",
+                   "Number of replicas of each unique packet (1 = slotted ALOHA).",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&SatRandomAccessMonteCarloHelper::m_replicas),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("WaveformId",
+                   "DVB-RCS2 waveform id of the packets.",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&SatRandomAccessMonteCarloHelper::m_waveformId),
+                   MakeUintegerChecker<uint32_t> (2, 22))
+    .AddAttribute ("CollisionModel",
+                   "Random access collision model.",
+                   EnumValue (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR),
+                   MakeEnumAccessor (&SatRandomAccessMonteCarloHelper::m_collisionModel),
+                   MakeEnumChecker (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS, "RaCollisionAlwaysDropCollidingPackets",
+                                    SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR, "RaCollisionCheckAgainstSinr"))
+    .AddAttribute ("MeanEsNoDb",
+                   "Mean user link Es/No of the packets at the satellite in dB.",
+                   DoubleValue (10.0),
+                   MakeDoubleAccessor (&SatRandomAccessMonteCarloHelper::m_meanEsNoDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("EsNoRangeDb",
+                   "Width of the uniform distribution of the user link Es/No in dB around the mean.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&SatRandomAccessMonteCarloHelper::m_esNoRangeDb),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("FeederLinkSinrDb",
+                   "SINR of the feeder link in dB.",
+                   DoubleValue (30.0),
+                   MakeDoubleAccessor (&SatRandomAccessMonteCarloHelper::m_feederLinkSinrDb),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("FramesPerLoadPoint",
+                   "Number of frames simulated for each load point.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&SatRandomAccessMonteCarloHelper::m_framesPerLoadPoint),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("Threads",
+                   "Maximum number of threads simulating the load points in parallel.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&SatRandomAccessMonteCarloHelper::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+SatRandomAccessMonteCarloHelper::SatRandomAccessMonteCarloHelper ()
+  : m_slotsPerFrame (100),
+    m_replicas (3),
+    m_waveformId (3),
+    m_collisionModel (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR),
+    m_meanEsNoDb (10.0),
+    m_esNoRangeDb (0.0),
+    m_feederLinkSinrDb (30.0),
+    m_framesPerLoadPoint (1000),
+    m_threads (1),
+    m_rxTemperatureK (290.0),
+    m_carrierBandwidthHz (1.25e6),
+    m_noisePowerW (0.0),
+    m_waveformConf (),
+    m_linkResults (),
+    m_carrierConf (),
+    m_sourceAddresses (),
+    m_sinrCalculate ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_noisePowerW = SatConstVariables::BOLTZMANN_CONSTANT * m_rxTemperatureK * m_carrierBandwidthHz;
+}
+
+SatRandomAccessMonteCarloHelper::~SatRandomAccessMonteCarloHelper ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatRandomAccessMonteCarloHelper::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_carrierConf != NULL)
+    {
+      m_carrierConf->Dispose ();
+      m_carrierConf = NULL;
+    }
+
+  m_waveformConf = NULL;
+  m_linkResults = NULL;
+  m_sourceAddresses.clear ();
+  m_sinrCalculate.Nullify ();
+
+  Object::DoDispose ();
+}
+
+void
+SatRandomAccessMonteCarloHelper::CreateCarrierConf ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_waveformConf == NULL)
+    {
+      std::string dataPath = Singleton<SatEnvVariables>::Get ()->LocateDataDirectory () + "/";
+      m_waveformConf = CreateObject<SatWaveformConf> (dataPath + "dvbRcs2Waveforms.txt");
+
+      m_linkResults = CreateObject<SatLinkResultsDvbRcs2> ();
+      m_linkResults->Initialize ();
+
+      m_sinrCalculate = MakeCallback (&SatRandomAccessMonteCarloHelper::CalculateSinr);
+    }
+
+  // the collision model is the only attribute stored in the carrier configuration
+  if (m_carrierConf != NULL)
+    {
+      if (m_carrierConf->GetRandomAccessCollisionModel () == m_collisionModel)
+        {
+          return;
+        }
+
+      m_carrierConf->Dispose ();
+      m_carrierConf = NULL;
+    }
+
+  SatPhyRxCarrierConf::RxCarrierCreateParams_s params = SatPhyRxCarrierConf::RxCarrierCreateParams_s ();
+  params.m_rxTemperatureK = m_rxTemperatureK;
+  params.m_errorModel = SatPhyRxCarrierConf::EM_AVI;
+  params.m_daIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  params.m_raIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  params.m_rxMode = SatPhyRxCarrierConf::TRANSPARENT;
+  params.m_chType = SatEnums::RETURN_FEEDER_CH;
+  params.m_bwConverter = MakeCallback (&SatRandomAccessMonteCarloHelper::GetCarrierBandwidthHz, this);
+  params.m_carrierCount = 1;
+  params.m_raCollisionModel = m_collisionModel;
+  params.m_randomAccessModel = SatEnums::RA_MODEL_CRDSA;
+
+  m_carrierConf = CreateObject<SatPhyRxCarrierConf> (params);
+  m_carrierConf->SetLinkResults (m_linkResults);
+  m_carrierConf->SetSinrCalculatorCb (m_sinrCalculate);
+}
+
+std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s>
+SatRandomAccessMonteCarloHelper::Run (const std::vector<double>& offeredLoads)
+{
+  NS_LOG_FUNCTION (this << offeredLoads.size ());
+
+  CreateCarrierConf ();
+
+  std::vector<SatRandomAccessMonteCarloHelper::loadPoint_s> loadPoints (offeredLoads.size ());
+
+  for (uint32_t i = 0; i < offeredLoads.size (); ++i)
+    {
+      if (offeredLoads[i] < 0.0)
+        {
+          NS_FATAL_ERROR ("SatRandomAccessMonteCarloHelper::Run - Negative offered load: " << offeredLoads[i]);
+        }
+
+      loadPoints[i].offeredLoad = offeredLoads[i];
+      loadPoints[i].fixedPacketCount = 0;
+      loadPoints[i].frames = m_framesPerLoadPoint;
+
+      SetupLoadPoint (loadPoints[i], std::ceil (offeredLoads[i] * m_slotsPerFrame));
+    }
+
+  // each task touches only the state of its own load point
+  Singleton<SatThreadPool>::Get ()->ParallelFor (m_threads, loadPoints.size (),
+                                                 [this, &loadPoints] (uint32_t i)
+                                                 {
+                                                   SimulateLoadPoint (loadPoints[i]);
+                                                 });
+
+  std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s> results;
+
+  for (uint32_t i = 0; i < loadPoints.size (); ++i)
+    {
+      results.push_back (loadPoints[i].result);
+      ReleaseLoadPoint (loadPoints[i]);
+
+      NS_LOG_INFO ("SatRandomAccessMonteCarloHelper::Run - Offered load: " << results.back ().offeredLoad
+                   << ", throughput: " << results.back ().throughput
+                   << ", packet loss ratio: " << results.back ().packetLossRatio);
+    }
+
+  return results;
+}
+
+SatRandomAccessMonteCarloHelper::loadPointResult_s
+SatRandomAccessMonteCarloHelper::RunFixedPacketCount (uint32_t packetsPerFrame, uint32_t frames)
+{
+  NS_LOG_FUNCTION (this << packetsPerFrame << frames);
+
+  CreateCarrierConf ();
+
+  SatRandomAccessMonteCarloHelper::loadPoint_s loadPoint;
+
+  loadPoint.offeredLoad = (double) packetsPerFrame / m_slotsPerFrame;
+  loadPoint.fixedPacketCount = packetsPerFrame;
+  loadPoint.frames = frames;
+
+  SetupLoadPoint (loadPoint, packetsPerFrame);
+  SimulateLoadPoint (loadPoint);
+  ReleaseLoadPoint (loadPoint);
+
+  return loadPoint.result;
+}
+
+void
+SatRandomAccessMonteCarloHelper::SetupLoadPoint (SatRandomAccessMonteCarloHelper::loadPoint_s& loadPoint, uint32_t maxPacketsPerFrame)
+{
+  NS_LOG_FUNCTION (this << loadPoint.offeredLoad << maxPacketsPerFrame);
+
+  if (m_replicas > m_slotsPerFrame)
+    {
+      NS_FATAL_ERROR ("SatRandomAccessMonteCarloHelper::SetupLoadPoint - More replicas than slots in a frame");
+    }
+
+  Ptr<SatWaveform> waveform = m_waveformConf->GetWaveform (m_waveformId);
+
+  loadPoint.carrier = CreateObject<SatPhyRxCarrierPerFrame> (0, m_carrierConf, true);
+  loadPoint.uniformVariable = CreateObject<UniformRandomVariable> ();
+
+  /**
+   * Everything touching the reference counts, the callbacks or the global state
+   * is created here in the calling thread, the simulation only updates the values.
+   */
+  while (m_sourceAddresses.size () < maxPacketsPerFrame)
+    {
+      m_sourceAddresses.push_back (Mac48Address::Allocate ());
+    }
+
+  loadPoint.sourceAddresses.assign (m_sourceAddresses.begin (), m_sourceAddresses.begin () + maxPacketsPerFrame);
+
+  for (uint32_t i = 0; i < maxPacketsPerFrame; ++i)
+    {
+      for (uint32_t j = 0; j < m_replicas; ++j)
+        {
+          Ptr<SatSignalParameters> rxParams = Create<SatSignalParameters> ();
+
+          rxParams->m_txInfo.packetType = SatEnums::PACKET_TYPE_CRDSA;
+          rxParams->m_txInfo.modCod = waveform->GetModCod ();
+          rxParams->m_txInfo.fecBlockSizeInBytes = waveform->GetPayloadInBytes ();
+          rxParams->m_txInfo.frameType = SatEnums::UNDEFINED_FRAME;
+          rxParams->m_txInfo.waveformId = m_waveformId;
+          rxParams->m_txInfo.crdsaUniquePacketId = i;
+          rxParams->m_rxNoisePowerInSatellite_W = m_noisePowerW;
+          rxParams->m_rxAciIfPowerInSatellite_W = 0.0;
+          rxParams->m_rxExtNoisePowerInSatellite_W = 0.0;
+          rxParams->m_sinrCalculate = m_sinrCalculate;
+
+          loadPoint.rxParams.push_back (rxParams);
+        }
+    }
+
+  loadPoint.slotIds.resize (maxPacketsPerFrame * m_replicas);
+  loadPoint.slotPowers.resize (m_slotsPerFrame);
+  loadPoint.frame.slots.resize (m_slotsPerFrame);
+  loadPoint.frame.results.reserve (maxPacketsPerFrame);
+
+  loadPoint.result.offeredLoad = loadPoint.offeredLoad;
+  loadPoint.result.frames = loadPoint.frames;
+  loadPoint.result.sentPackets = 0;
+  loadPoint.result.receivedPackets = 0;
+  loadPoint.result.throughput = 0.0;
+  loadPoint.result.packetLossRatio = 0.0;
+}
+
+void
+SatRandomAccessMonteCarloHelper::SimulateLoadPoint (SatRandomAccessMonteCarloHelper::loadPoint_s& loadPoint) const
+{
+  NS_LOG_FUNCTION (this << loadPoint.offeredLoad);
+
+  double feederLinkRxPowerW = m_noisePowerW * SatUtils::DbToLinear (m_feederLinkSinrDb);
+  double meanPackets = loadPoint.offeredLoad * m_slotsPerFrame;
+  uint32_t maxPackets = loadPoint.sourceAddresses.size ();
+
+  SatPhyRxCarrierPerFrame::crdsaFrame_s& frame = loadPoint.frame;
+
+  for (uint32_t f = 0; f < loadPoint.frames; ++f)
+    {
+      uint32_t packets = loadPoint.fixedPacketCount;
+
+      if (loadPoint.fixedPacketCount == 0)
+        {
+          // random rounding keeps the mean number of packets
+          packets = std::floor (meanPackets);
+
+          if (loadPoint.uniformVariable->GetValue (0.0, 1.0) < meanPackets - packets)
+            {
+              ++packets;
+            }
+
+          packets = std::min (packets, maxPackets);
+        }
+
+      std::fill (loadPoint.slotPowers.begin (), loadPoint.slotPowers.end (), 0.0);
+
+      // select the slots and the powers of the replicas
+      for (uint32_t i = 0; i < packets; ++i)
+        {
+          double esNoDb = m_meanEsNoDb + m_esNoRangeDb * (loadPoint.uniformVariable->GetValue (0.0, 1.0) - 0.5);
+          double rxPowerW = m_noisePowerW * SatUtils::DbToLinear (esNoDb);
+
+          for (uint32_t j = 0; j < m_replicas; ++j)
+            {
+              uint32_t index = i * m_replicas + j;
+              bool slotFound = false;
+
+              while (!slotFound)
+                {
+                  loadPoint.slotIds[index] = loadPoint.uniformVariable->GetInteger (0, m_slotsPerFrame - 1);
+                  slotFound = (std::find (loadPoint.slotIds.begin () + i * m_replicas,
+                                          loadPoint.slotIds.begin () + index,
+                                          loadPoint.slotIds[index]) == loadPoint.slotIds.begin () + index);
+                }
+
+              loadPoint.slotPowers[loadPoint.slotIds[index]] += rxPowerW;
+
+              Ptr<SatSignalParameters>& rxParams = loadPoint.rxParams[index];
+              rxParams->m_rxPowerInSatellite_W = rxPowerW;
+              rxParams->m_rxPower_W = feederLinkRxPowerW;
+              rxParams->m_ifPower_W = 0.0;
+            }
+        }
+
+      // store the replicas with the interference of the other packets in the slot
+      for (uint32_t i = 0; i < packets; ++i)
+        {
+          for (uint32_t j = 0; j < m_replicas; ++j)
+            {
+              uint32_t index = i * m_replicas + j;
+              SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s params;
+
+              params.rxParams = loadPoint.rxParams[index];
+              params.rxParams->m_ifPowerInSatellite_W = loadPoint.slotPowers[loadPoint.slotIds[index]]
+                - params.rxParams->m_rxPowerInSatellite_W;
+              params.destAddress = Mac48Address ();
+              params.sourceAddress = loadPoint.sourceAddresses[i];
+              params.ownSlotId = loadPoint.slotIds[index];
+              params.hasCollision = (params.rxParams->m_ifPowerInSatellite_W > 0.0);
+              params.packetHasBeenProcessed = false;
+              params.cSinr = 0.0;
+              params.ifPower = 0.0;
+              params.phyError = false;
+
+              for (uint32_t k = 0; k < m_replicas; ++k)
+                {
+                  if (k != j)
+                    {
+                      params.slotIdsForOtherReplicas.push_back (loadPoint.slotIds[i * m_replicas + k]);
+                    }
+                }
+
+              SatPhyRxCarrierPerFrame::AddCrdsaPacketToFrame (frame, params);
+            }
+        }
+
+      loadPoint.carrier->ProcessFrame (frame);
+
+      for (uint32_t i = 0; i < frame.results.size (); ++i)
+        {
+          if (!frame.results[i].phyError)
+            {
+              ++loadPoint.result.receivedPackets;
+            }
+        }
+
+      loadPoint.result.sentPackets += packets;
+
+      SatPhyRxCarrierPerFrame::ClearCrdsaFrame (frame);
+    }
+
+  uint64_t slots = (uint64_t) loadPoint.frames * m_slotsPerFrame;
+  loadPoint.result.throughput = (double) loadPoint.result.receivedPackets / slots;
+
+  if (loadPoint.result.sentPackets > 0)
+    {
+      loadPoint.result.packetLossRatio = 1.0 - (double) loadPoint.result.receivedPackets / loadPoint.result.sentPackets;
+    }
+}
+
+void
+SatRandomAccessMonteCarloHelper::ReleaseLoadPoint (SatRandomAccessMonteCarloHelper::loadPoint_s& loadPoint) const
+{
+  NS_LOG_FUNCTION (this);
+
+  SatPhyRxCarrierPerFrame::ClearCrdsaFrame (loadPoint.frame);
+  loadPoint.frame.slots.clear ();
+
+  loadPoint.carrier->Dispose ();
+  loadPoint.carrier = NULL;
+  loadPoint.uniformVariable = NULL;
+  loadPoint.rxParams.clear ();
+}
+
+void
+SatRandomAccessMonteCarloHelper::WriteResults (std::string fileName,
+                                               const std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s>& results) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  Ptr<SatOutputFileStreamDoubleContainer> container = CreateObject<SatOutputFileStreamDoubleContainer> (fileName, std::ios::out, 5);
+
+  for (uint32_t i = 0; i < results.size (); ++i)
+    {
+      std::vector<double> row;
+
+      row.push_back (results[i].offeredLoad);
+      row.push_back (results[i].throughput);
+      row.push_back (results[i].packetLossRatio);
+      row.push_back (results[i].sentPackets);
+      row.push_back (results[i].receivedPackets);
+
+      container->AddToContainer (row);
+    }
+
+  container->WriteContainerToFile ();
+  container->Dispose ();
+}
+
+double
+SatRandomAccessMonteCarloHelper::GetCarrierBandwidthHz (SatEnums::ChannelType_t channelType,
+                                                        uint32_t carrierId,
+                                                        SatEnums::CarrierBandwidthType_t bandwidthType)
+{
+  return m_carrierBandwidthHz;
+}
+
+double
+SatRandomAccessMonteCarloHelper::CalculateSinr (double sinr)
+{
+  return sinr;
+}
+
+} // namespace ns3
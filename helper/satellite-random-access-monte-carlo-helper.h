@@ -0,0 +1,238 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#ifndef SATELLITE_RANDOM_ACCESS_MONTE_CARLO_HELPER_H
+#define SATELLITE_RANDOM_ACCESS_MONTE_CARLO_HELPER_H
+
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/ptr.h"
+#include "ns3/mac48-address.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/satellite-enums.h"
+#include "ns3/satellite-signal-parameters.h"
+#include "ns3/satellite-phy-rx-carrier-conf.h"
+#include "ns3/satellite-phy-rx-carrier-per-frame.h"
+
+namespace ns3 {
+
+class SatWaveformConf;
+class SatLinkResultsDvbRcs2;
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Frame level Monte-Carlo simulator of the return link random access.
+ *
+ * The helper generates synthetic CRDSA frames: each unique packet selects
+ * the given number of distinct slots of the frame for its replicas (one
+ * replica equals to slotted ALOHA) and gets a random user link Es/No at
+ * the satellite. The frames are processed with the successive interference
+ * cancellation of SatPhyRxCarrierPerFrame and the DVB-RCS2 link results
+ * exactly as in the full simulation, but without the network stack, the
+ * scheduling nor the event queue. The feeder link is modeled with a
+ * constant SINR and no interference.
+ *
+ * The load points are simulated in parallel with SatThreadPool. Each
+ * load point has its own carrier, random number generators and packet
+ * storage, which are created in the calling thread, thus the results do
+ * not depend on the number of threads used.
+ *
+ * The offered load is given as the mean number of unique packets per slot.
+ * The number of packets in a frame is the offered load multiplied by the
+ * number of slots, randomly rounded to an integer so that the mean is kept.
+ * Thus the number of packets varies by at most one between the frames, the
+ * packet arrivals are not Poisson distributed as often assumed in the random
+ * access literature. A Poisson or any other distribution of the packets per
+ * frame can be simulated with RunFixedPacketCount and weighting the results
+ * of the packet counts by their probabilities.
+ */
+class SatRandomAccessMonteCarloHelper : public Object
+{
+public:
+  /**
+   * \brief Results of one load point
+   */
+  typedef struct
+  {
+    double offeredLoad;         //< Offered load in unique packets per slot
+    uint32_t frames;            //< Number of simulated frames
+    uint64_t sentPackets;       //< Number of sent unique packets
+    uint64_t receivedPackets;   //< Number of successfully received unique packets
+    double throughput;          //< Throughput in received unique packets per slot
+    double packetLossRatio;     //< Ratio of the lost unique packets
+  } loadPointResult_s;
+
+  /**
+   * \brief Get the type ID
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Constructor
+   */
+  SatRandomAccessMonteCarloHelper ();
+
+  /**
+   * \brief Destructor
+   */
+  virtual ~SatRandomAccessMonteCarloHelper ();
+
+  /**
+   * \brief Simulate the given load points. The number of packets in a frame
+   * is the offered load multiplied by the number of slots, randomly rounded.
+   * \param offeredLoads Offered loads in unique packets per slot
+   * \return Results of the load points in the given order
+   */
+  std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s> Run (const std::vector<double>& offeredLoads);
+
+  /**
+   * \brief Simulate frames having a fixed number of unique packets
+   * \param packetsPerFrame Number of unique packets in each frame
+   * \param frames Number of frames simulated
+   * \return Results of the simulation
+   */
+  SatRandomAccessMonteCarloHelper::loadPointResult_s RunFixedPacketCount (uint32_t packetsPerFrame, uint32_t frames);
+
+  /**
+   * \brief Write the results into a file. Each row contains the offered
+   * load, the throughput, the packet loss ratio and the number of sent
+   * and received unique packets of one load point.
+   * \param fileName Name of the file
+   * \param results Results of the load points
+   */
+  void WriteResults (std::string fileName,
+                     const std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s>& results) const;
+
+protected:
+  /**
+   * \brief Dispose implementation
+   */
+  virtual void DoDispose ();
+
+private:
+  /**
+   * \brief State of one simulated load point. Accessed only by the thread
+   * simulating the load point.
+   */
+  typedef struct
+  {
+    double offeredLoad;
+    uint32_t fixedPacketCount;
+    uint32_t frames;
+    Ptr<SatPhyRxCarrierPerFrame> carrier;
+    Ptr<UniformRandomVariable> uniformVariable;
+    std::vector<Ptr<SatSignalParameters> > rxParams;
+    std::vector<Mac48Address> sourceAddresses;
+    std::vector<uint16_t> slotIds;
+    std::vector<double> slotPowers;
+    SatPhyRxCarrierPerFrame::crdsaFrame_s frame;
+    SatRandomAccessMonteCarloHelper::loadPointResult_s result;
+  } loadPoint_s;
+
+  /**
+   * \brief Create the waveform configuration and the link results, if not
+   * done already, and the carrier configuration, if not done already or if
+   * the collision model has been changed since
+   */
+  void CreateCarrierConf ();
+
+  /**
+   * \brief Create the state of a load point
+   * \param loadPoint Load point to set up
+   * \param maxPacketsPerFrame Maximum number of unique packets in a frame
+   */
+  void SetupLoadPoint (SatRandomAccessMonteCarloHelper::loadPoint_s& loadPoint, uint32_t maxPacketsPerFrame);
+
+  /**
+   * \brief Simulate the frames of a load point
+   * \param loadPoint Load point to simulate
+   */
+  void SimulateLoadPoint (SatRandomAccessMonteCarloHelper::loadPoint_s& loadPoint) const;
+
+  /**
+   * \brief Release the state of a load point
+   * \param loadPoint Load point to release
+   */
+  void ReleaseLoadPoint (SatRandomAccessMonteCarloHelper::loadPoint_s& loadPoint) const;
+
+  /**
+   * \brief Carrier bandwidth converter of the simulated carrier
+   * \param channelType Type of the channel
+   * \param carrierId Id of the carrier
+   * \param bandwidthType Type of the bandwidth
+   * \return Bandwidth of the carrier in Hz
+   */
+  double GetCarrierBandwidthHz (SatEnums::ChannelType_t channelType,
+                                uint32_t carrierId,
+                                SatEnums::CarrierBandwidthType_t bandwidthType);
+
+  /**
+   * \brief SINR calculator of the simulated receivers, no additional
+   * interference is taken into account
+   * \param sinr SINR
+   * \return SINR
+   */
+  static double CalculateSinr (double sinr);
+
+  /**
+   * Configuration of the simulated random access channel
+   */
+  uint32_t m_slotsPerFrame;
+  uint32_t m_replicas;
+  uint32_t m_waveformId;
+  SatPhyRxCarrierConf::RandomAccessCollisionModel m_collisionModel;
+
+  /**
+   * User link Es/No at the satellite is drawn uniformly in dB from
+   * range [m_meanEsNoDb - m_esNoRangeDb / 2, m_meanEsNoDb + m_esNoRangeDb / 2]
+   */
+  double m_meanEsNoDb;
+  double m_esNoRangeDb;
+  double m_feederLinkSinrDb;
+
+  uint32_t m_framesPerLoadPoint;
+  uint32_t m_threads;
+
+  /**
+   * Receiver noise temperature and carrier bandwidth. These only scale the
+   * absolute power levels, which are kept in the same range as in the full
+   * simulation.
+   */
+  double m_rxTemperatureK;
+  double m_carrierBandwidthHz;
+  double m_noisePowerW;
+
+  Ptr<SatWaveformConf> m_waveformConf;
+  Ptr<SatLinkResultsDvbRcs2> m_linkResults;
+  Ptr<SatPhyRxCarrierConf> m_carrierConf;
+
+  /**
+   * Source addresses of the unique packets, allocated once and shared by
+   * all the load points and runs of the helper
+   */
+  std::vector<Mac48Address> m_sourceAddresses;
+  SatPhyRxCarrierConf::SinrCalculatorCallback m_sinrCalculate;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_RANDOM_ACCESS_MONTE_CARLO_HELPER_H */
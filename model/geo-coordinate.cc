@@ -147,21 +147,19 @@ GeoCoordinate::Initialize ()
   m_e2Param = ( ( m_equatorRadius * m_equatorRadius ) - ( m_polarRadius * m_polarRadius ) ) / (m_equatorRadius * m_equatorRadius );
 }
 
+// The getters do not log, since they are used by the link budget worker threads
 double GeoCoordinate::GetLongitude () const
 {
-  NS_LOG_FUNCTION (this);
   return m_longitude;
 }
 
 double GeoCoordinate::GetLatitude () const
 {
-  NS_LOG_FUNCTION (this);
   return m_latitude;
 }
 
 double GeoCoordinate::GetAltitude () const
 {
-  NS_LOG_FUNCTION (this);
   return m_altitude;
 }
 
@@ -19,6 +19,8 @@
  */
 
 #include <sstream>
+#include <algorithm>
+#include <limits>
 #include "ns3/log.h"
 #include "satellite-antenna-gain-pattern-container.h"
 #include "ns3/singleton.h"
@@ -41,6 +43,11 @@ SatAntennaGainPatternContainer::GetTypeId (void)
 }
 
 SatAntennaGainPatternContainer::SatAntennaGainPatternContainer ()
+  : m_antennaPatternMap (),
+    m_bestBeamRasterBuilt (false),
+    m_rasterOffsets (),
+    m_rasterBeams (),
+    m_coChannelGainMatrix ()
 {
   /**
    * TODO: To change the reference system, these hard coded paths
@@ -89,6 +96,45 @@ SatAntennaGainPatternContainer::GetBestBeamId (GeoCoordinate coord) const
 {
   NS_LOG_FUNCTION (this << coord.GetLatitude () << coord.GetLongitude ());
 
+  if (!m_bestBeamRasterBuilt)
+    {
+      BuildBestBeamRaster ();
+    }
+
+  // Evaluate only the candidate beams of the grid square
+  if (!m_rasterOffsets.empty ())
+    {
+      uint32_t cell = m_antennaPatternMap.at (1)->GetGridCell (coord);
+      uint32_t first = m_rasterOffsets[cell];
+      uint32_t last = m_rasterOffsets[cell + 1];
+
+      // Some of the antenna patterns are not valid in this grid square.
+      if (first == last)
+        {
+          NS_FATAL_ERROR (this << " returned a NAN antenna gain value!");
+        }
+      else if (last - first == 1)
+        {
+          return m_rasterBeams[first];
+        }
+
+      double bestGain (-100.0);
+      uint32_t bestId (0);
+
+      for (uint32_t i = first; i < last; ++i)
+        {
+          double gain = m_antennaPatternMap.at (m_rasterBeams[i])->GetAntennaGain_lin (coord);
+
+          if (gain > bestGain)
+            {
+              bestGain = gain;
+              bestId = m_rasterBeams[i];
+            }
+        }
+
+      return bestId;
+    }
+
   double bestGain (-100.0);
   uint32_t bestId (0);
 
@@ -112,4 +158,149 @@ SatAntennaGainPatternContainer::GetBestBeamId (GeoCoordinate coord) const
   return bestId;
 }
 
+uint32_t
+SatAntennaGainPatternContainer::GetNumberOfBeams () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_antennaPatternMap.size ();
+}
+
+void
+SatAntennaGainPatternContainer::GetCoChannelGainRatios (uint32_t beamId, GeoCoordinate coord, std::vector<double>& ratios) const
+{
+  NS_LOG_FUNCTION (this << beamId << coord.GetLatitude () << coord.GetLongitude ());
+
+  double ownGain = GetAntennaGainPattern (beamId)->GetAntennaGain_lin (coord);
+
+  ratios.assign (NUMBER_OF_BEAMS + 1, 0.0);
+
+  for (uint32_t i = 1; i <= NUMBER_OF_BEAMS; ++i)
+    {
+      if (i != beamId)
+        {
+          ratios[i] = GetValidAntennaGain_lin (i, coord) / ownGain;
+        }
+    }
+}
+
+void
+SatAntennaGainPatternContainer::GetCoChannelGainRatios (uint32_t beamId, std::vector<double>& ratios) const
+{
+  NS_LOG_FUNCTION (this << beamId);
+
+  if (beamId < 1 || beamId > NUMBER_OF_BEAMS)
+    {
+      NS_FATAL_ERROR ("SatAntennaGainPatternContainer::GetCoChannelGainRatios - unvalid beam id: " << beamId);
+    }
+
+  if (m_coChannelGainMatrix.empty ())
+    {
+      std::vector<GeoCoordinate> centers;
+
+      for (uint32_t j = 1; j <= NUMBER_OF_BEAMS; ++j)
+        {
+          centers.push_back (m_antennaPatternMap.at (j)->GetPeakGainPosition ());
+        }
+
+      m_coChannelGainMatrix.resize (NUMBER_OF_BEAMS * NUMBER_OF_BEAMS);
+
+      for (uint32_t i = 1; i <= NUMBER_OF_BEAMS; ++i)
+        {
+          double ownGain = m_antennaPatternMap.at (i)->GetAntennaGain_lin (centers[i - 1]);
+
+          for (uint32_t j = 1; j <= NUMBER_OF_BEAMS; ++j)
+            {
+              m_coChannelGainMatrix[(i - 1) * NUMBER_OF_BEAMS + (j - 1)] = GetValidAntennaGain_lin (i, centers[j - 1]) / ownGain;
+            }
+        }
+    }
+
+  ratios.assign (NUMBER_OF_BEAMS + 1, 0.0);
+
+  for (uint32_t j = 1; j <= NUMBER_OF_BEAMS; ++j)
+    {
+      if (j != beamId)
+        {
+          ratios[j] = m_coChannelGainMatrix[(beamId - 1) * NUMBER_OF_BEAMS + (j - 1)];
+        }
+    }
+}
+
+double
+SatAntennaGainPatternContainer::GetValidAntennaGain_lin (uint32_t beamId, GeoCoordinate coord) const
+{
+  Ptr<SatAntennaGainPattern> pattern = m_antennaPatternMap.at (beamId);
+  double minGain, maxGain;
+
+  if (!pattern->GetCellGainRange_lin (pattern->GetGridCell (coord), minGain, maxGain))
+    {
+      return 0.0;
+    }
+
+  return pattern->GetAntennaGain_lin (coord);
+}
+
+void
+SatAntennaGainPatternContainer::BuildBestBeamRaster () const
+{
+  NS_LOG_FUNCTION (this);
+
+  m_bestBeamRasterBuilt = true;
+
+  Ptr<SatAntennaGainPattern> firstPattern = m_antennaPatternMap.at (1);
+
+  for (uint32_t i = 2; i <= NUMBER_OF_BEAMS; ++i)
+    {
+      if (!firstPattern->HasSameGrid (m_antennaPatternMap.at (i)))
+        {
+          NS_LOG_INFO ("Antenna patterns do not share the same grid, best beam raster not used");
+          return;
+        }
+    }
+
+  // Relative margin for the rounding errors of the interpolation
+  const double margin = 1.0 - 1e-9;
+
+  uint32_t nCells = firstPattern->GetNumberOfGridPoints ();
+  std::vector<double> minGains (NUMBER_OF_BEAMS);
+  std::vector<double> maxGains (NUMBER_OF_BEAMS);
+
+  m_rasterOffsets.reserve (nCells + 1);
+
+  for (uint32_t cell = 0; cell < nCells; ++cell)
+    {
+      m_rasterOffsets.push_back (m_rasterBeams.size ());
+
+      bool valid (true);
+      double lowerBound = -std::numeric_limits<double>::infinity ();
+
+      for (uint32_t i = 0; i < NUMBER_OF_BEAMS && valid; ++i)
+        {
+          valid = m_antennaPatternMap.at (i + 1)->GetCellGainRange_lin (cell, minGains[i], maxGains[i]);
+          lowerBound = std::max (lowerBound, minGains[i]);
+        }
+
+      // No candidates for grid squares where some of the patterns are not valid.
+      if (!valid)
+        {
+          continue;
+        }
+
+      // The interpolated gain of a beam is always between its lowest and highest corner gain
+      for (uint32_t i = 0; i < NUMBER_OF_BEAMS; ++i)
+        {
+          if (maxGains[i] >= lowerBound * margin)
+            {
+              m_rasterBeams.push_back (i + 1);
+            }
+        }
+    }
+
+  m_rasterOffsets.push_back (m_rasterBeams.size ());
+
+  NS_LOG_INFO ("Best beam raster built, grid squares: " << nCells <<
+               ", candidate beams: " << m_rasterBeams.size ());
+}
+
 } // namespace ns3
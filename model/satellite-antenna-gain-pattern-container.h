@@ -21,6 +21,7 @@
 #ifndef SATELLITE_ANTENNA_GAIN_PATTERN_CONTAINER_H_
 #define SATELLITE_ANTENNA_GAIN_PATTERN_CONTAINER_H_
 
+#include <vector>
 #include "satellite-antenna-gain-pattern.h"
 #include "geo-coordinate.h"
 
@@ -36,6 +37,19 @@ namespace ns3 {
  * Each antenna gain pattern is stored in a separate class
  * SatAntennaGainPattern. The best beam may be chosen based on
  * the antenna patterns by using GetBestBeamId for a given position.
+ *
+ * For the best beam selection, a raster of candidate beams per grid square
+ * of the antenna patterns is built on the first call. A beam is a candidate
+ * of a grid square if its highest corner gain is not below the highest lowest
+ * corner gain of all the beams. Since the gain is bilinearly interpolated
+ * within a grid square, only the candidates may be the best beam, thus only
+ * they are evaluated. The raster is used only if all the patterns share the
+ * same grid.
+ *
+ * For co-channel interference estimation, the container gives the gain
+ * ratios of the interfering beams relative to the wanted beam, either
+ * towards a ground position or, for the satellite receivers, as a beam x beam
+ * matrix built on the first call from the beam centers (peak gain positions).
  */
 class SatAntennaGainPatternContainer : public Object
 {
@@ -75,6 +89,31 @@ public:
    */
   uint32_t GetBestBeamId (GeoCoordinate coord) const;
 
+  /**
+   * \brief Get the number of beams (antenna patterns) in the container
+   * \return Number of beams
+   */
+  uint32_t GetNumberOfBeams () const;
+
+  /**
+   * \brief Get the co-channel gain ratios of a ground receiver, i.e. the
+   * gain of each interfering beam towards the position relative to the
+   * gain of the wanted beam.
+   * \param beamId Wanted beam id
+   * \param coord Position of the receiver
+   * \param ratios Gain ratios indexed by the beam id, zero for the wanted beam
+   */
+  void GetCoChannelGainRatios (uint32_t beamId, GeoCoordinate coord, std::vector<double>& ratios) const;
+
+  /**
+   * \brief Get the co-channel gain ratios of a satellite receiver, i.e. the
+   * gain of the wanted beam towards the center of each interfering beam
+   * relative to the gain towards its own center.
+   * \param beamId Wanted beam id
+   * \param ratios Gain ratios indexed by the beam id, zero for the wanted beam
+   */
+  void GetCoChannelGainRatios (uint32_t beamId, std::vector<double>& ratios) const;
+
 private:
   /**
    * \brief Definition of number of beams (72-beam reference scenario).
@@ -88,6 +127,46 @@ private:
    */
   std::map< uint32_t, Ptr<SatAntennaGainPattern> > m_antennaPatternMap;
 
+  /**
+   * \brief Get the antenna gain of a beam, or zero if the pattern is not
+   * valid (NaN) in the position
+   * \param beamId Beam identifier
+   * \param coord Geo coordinate
+   * \return Antenna gain in linear format
+   */
+  double GetValidAntennaGain_lin (uint32_t beamId, GeoCoordinate coord) const;
+
+  /**
+   * \brief Build the best beam candidate raster, if all the antenna
+   * patterns share the same grid
+   */
+  void BuildBestBeamRaster () const;
+
+  /**
+   * Defines whether the best beam raster has been built (or tried to build)
+   */
+  mutable bool m_bestBeamRasterBuilt;
+
+  /**
+   * Offsets of the candidate beams of the grid squares in m_rasterBeams,
+   * indexed by the grid index of the lower left corner of the square. The
+   * candidates of square i are in [m_rasterOffsets[i], m_rasterOffsets[i+1]).
+   * Empty, if the raster is not used.
+   */
+  mutable std::vector<uint32_t> m_rasterOffsets;
+
+  /**
+   * Candidate beam ids of all the grid squares in ascending order per square
+   */
+  mutable std::vector<uint32_t> m_rasterBeams;
+
+  /**
+   * Gain of beam i towards the center of beam j relative to the gain towards
+   * the center of beam i, at index (i - 1) * NUMBER_OF_BEAMS + (j - 1). Empty,
+   * until needed for the first time.
+   */
+  mutable std::vector<double> m_coChannelGainMatrix;
+
 };
 
 } // namespace ns3
@@ -19,8 +19,17 @@
  */
 
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "satellite-utils.h"
 #include "satellite-antenna-gain-pattern.h"
@@ -31,6 +40,8 @@ namespace ns3 {
 
 const std::string SatAntennaGainPattern::m_nanStringArray[4] = {"nan", "NaN", "Nan", "NAN"};
 
+const char SatAntennaGainPattern::BINARY_FILE_MAGIC[8] = {'S', 'A', 'T', 'A', 'G', 'P', 'B', '\0'};
+
 
 NS_OBJECT_ENSURE_REGISTERED (SatAntennaGainPattern);
 
@@ -45,6 +56,10 @@ SatAntennaGainPattern::GetTypeId (void)
                    DoubleValue (48.0),
                    MakeDoubleAccessor (&SatAntennaGainPattern::m_minAcceptableAntennaGainInDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("UseBinaryPatternFile", "Read the antenna pattern from the binary pattern file, if available",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&SatAntennaGainPattern::m_useBinaryFile),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -58,6 +73,14 @@ SatAntennaGainPattern::GetInstanceTypeId (void) const
 
 SatAntennaGainPattern::SatAntennaGainPattern ()
   : m_antennaPattern (),
+    m_validCells (),
+    m_gains (0),
+    m_validCellMask (0),
+    m_mappedFile (0),
+    m_mappedFileSize (0),
+    m_textFileSize (0),
+    m_textFileModificationTime (0),
+    m_useBinaryFile (true),
     m_validPositions (),
     m_minAcceptableAntennaGainInDb (40.0),
     m_uniformRandomVariable (),
@@ -69,23 +92,45 @@ SatAntennaGainPattern::SatAntennaGainPattern ()
     m_maxLon (0.0),
     m_latInterval (0.0),
     m_lonInterval (0.0),
+    m_latIntervalInv (0.0),
+    m_lonIntervalInv (0.0),
     m_nanStrings ()
 {
   // Do nothing here
 }
 
 SatAntennaGainPattern::SatAntennaGainPattern (std::string filePathName)
-  : m_nanStrings (m_nanStringArray, m_nanStringArray + (sizeof m_nanStringArray / sizeof m_nanStringArray[0]))
+  : m_gains (0),
+    m_validCellMask (0),
+    m_mappedFile (0),
+    m_mappedFileSize (0),
+    m_textFileSize (0),
+    m_textFileModificationTime (0),
+    m_useBinaryFile (true),
+    m_nanStrings (m_nanStringArray, m_nanStringArray + (sizeof m_nanStringArray / sizeof m_nanStringArray[0]))
 {
   // Attributes are needed already in construction phase:
   // - ConstructSelf call in constructor
   // - GetInstanceTypeId is needed to be implemented
   ObjectBase::ConstructSelf (AttributeConstructionList ());
 
-  ReadAntennaPatternFromFile (filePathName);
+  // Fall back to the text file, if the binary file is not available
+  if (!m_useBinaryFile || !ReadAntennaPatternFromBinaryFile (filePathName))
+    {
+      ReadAntennaPatternFromFile (filePathName);
+    }
+
   m_uniformRandomVariable = CreateObject<UniformRandomVariable> ();
 }
 
+SatAntennaGainPattern::~SatAntennaGainPattern ()
+{
+  if (m_mappedFile)
+    {
+      munmap (m_mappedFile, m_mappedFileSize);
+    }
+}
+
 
 void SatAntennaGainPattern::ReadAntennaPatternFromFile (std::string filePathName)
 {
@@ -107,8 +152,10 @@ void SatAntennaGainPattern::ReadAntennaPatternFromFile (std::string filePathName
         }
     }
 
-  // Row vector containing all the gain values for a certain latitude
-  std::vector<double> rowVector;
+  GetFileStamp (filePathName, m_textFileSize, m_textFileModificationTime);
+
+  // Gain values of the whole grid in row-major order
+  std::vector<double> gainsDb;
 
   // Start conditions
   double lat, lon, gainDouble;
@@ -176,28 +223,14 @@ void SatAntennaGainPattern::ReadAntennaPatternFromFile (std::string filePathName
         }
 
       // If this is the first gain entry
-      if (rowVector.empty ())
+      if (gainsDb.empty ())
         {
           m_minLat = lat;
           m_minLon = lon;
-          rowVector.push_back (gainDouble);
-        }
-      // We are still in the same row (= latitude)
-      else if (lat == m_maxLat)
-        {
-          rowVector.push_back (gainDouble);
-        }
-      // Latitude changed
-      // - Store the vector
-      // - Clean-up
-      // - Start from another row
-      else
-        {
-          m_antennaPattern.push_back (rowVector);
-          rowVector.clear ();
-          rowVector.push_back (gainDouble);
         }
 
+      gainsDb.push_back (gainDouble);
+
       // Update the maximum values
       m_maxLat = lat;
       m_maxLon = lon;
@@ -206,17 +239,370 @@ void SatAntennaGainPattern::ReadAntennaPatternFromFile (std::string filePathName
       *ifs >> lat >> lon >> gainString;
     }
 
-  // At this point, the last row should not be stored, since the storing
-  // happens every time the row changes. I.e. the last row is stored here!
-  NS_ASSERT ( rowVector.size () == m_longitudes.size ());
-
-  m_antennaPattern.push_back (rowVector);
-  rowVector.clear ();
-
   ifs->close ();
   delete ifs;
+
+  // The grid has to be complete
+  NS_ASSERT ( gainsDb.size () == m_latitudes.size () * m_longitudes.size ());
+
+  ConstructGrid (gainsDb);
+}
+
+void SatAntennaGainPattern::ConstructGrid (const std::vector<double>& gainsDb)
+{
+  NS_LOG_FUNCTION (this << gainsDb.size ());
+
+  // Interpolation needs at least one full grid square
+  if (m_latitudes.size () < 2 || m_longitudes.size () < 2)
+    {
+      NS_FATAL_ERROR ("SatAntennaGainPattern::ConstructGrid - at least 2x2 grid is needed for interpolation!");
+    }
+
+  m_latIntervalInv = 1.0 / m_latInterval;
+  m_lonIntervalInv = 1.0 / m_lonInterval;
+
+  // Change the gains to linear values, because the interpolation is done in linear domain.
+  m_antennaPattern.resize (gainsDb.size ());
+
+  for (uint32_t i = 0; i < gainsDb.size (); ++i)
+    {
+      m_antennaPattern[i] = std::isnan (gainsDb[i]) ? NAN : (float)(SatUtils::DbToLinear (gainsDb[i]));
+    }
+
+  // Mark the grid squares with all the four corners valid
+  uint32_t nLons = m_longitudes.size ();
+  m_validCells.assign ((gainsDb.size () + 63) / 64, 0);
+
+  for (uint32_t latIndex = 0; latIndex + 1 < m_latitudes.size (); ++latIndex)
+    {
+      for (uint32_t lonIndex = 0; lonIndex + 1 < nLons; ++lonIndex)
+        {
+          uint32_t cell = latIndex * nLons + lonIndex;
+
+          if (!std::isnan (gainsDb[cell])
+              && !std::isnan (gainsDb[cell + 1])
+              && !std::isnan (gainsDb[cell + nLons])
+              && !std::isnan (gainsDb[cell + nLons + 1]))
+            {
+              m_validCells[cell >> 6] |= ((uint64_t)1 << (cell & 63));
+            }
+        }
+    }
+
+  m_gains = &m_antennaPattern[0];
+  m_validCellMask = &m_validCells[0];
+}
+
+std::string SatAntennaGainPattern::GetBinaryFilePathName (std::string filePathName)
+{
+  const std::string textExtension (".txt");
+
+  if (filePathName.size () >= textExtension.size ()
+      && filePathName.compare (filePathName.size () - textExtension.size (), textExtension.size (), textExtension) == 0)
+    {
+      filePathName.erase (filePathName.size () - textExtension.size ());
+    }
+
+  return filePathName + ".bin";
+}
+
+void SatAntennaGainPattern::GetBinaryFileLayout (uint32_t nLatitudes, uint32_t nLongitudes,
+                                                 size_t& gainsOffset, size_t& maskOffset, size_t& fileSize)
+{
+  size_t nGridPoints = (size_t)(nLatitudes) * nLongitudes;
+
+  gainsOffset = sizeof (BinaryFileHeader_s) + (nLatitudes + nLongitudes) * sizeof (double);
+
+  // The bitmask is aligned to 8 bytes
+  maskOffset = gainsOffset + nGridPoints * sizeof (float);
+  maskOffset = (maskOffset + 7) & ~((size_t)7);
+
+  fileSize = maskOffset + ((nGridPoints + 63) / 64) * sizeof (uint64_t);
+}
+
+bool SatAntennaGainPattern::GetFileStamp (std::string filePathName, uint64_t& size, int64_t& modificationTime)
+{
+  struct stat fileStat;
+
+  if (stat (filePathName.c_str (), &fileStat) != 0)
+    {
+      return false;
+    }
+
+  size = fileStat.st_size;
+  modificationTime = fileStat.st_mtime;
+
+  return true;
+}
+
+bool SatAntennaGainPattern::ReadAntennaPatternFromBinaryFile (std::string textFilePathName)
+{
+  NS_LOG_FUNCTION (this << textFilePathName);
+
+  std::string filePathName = GetBinaryFilePathName (textFilePathName);
+  int fd = open (filePathName.c_str (), O_RDONLY);
+
+  if (fd < 0)
+    {
+      // script might be launched by test.py, try a different base path
+      textFilePathName = "../../" + textFilePathName;
+      filePathName = GetBinaryFilePathName (textFilePathName);
+      fd = open (filePathName.c_str (), O_RDONLY);
+
+      if (fd < 0)
+        {
+          return false;
+        }
+    }
+
+  struct stat fileStat;
+
+  if (fstat (fd, &fileStat) != 0 || (size_t)(fileStat.st_size) < sizeof (BinaryFileHeader_s))
+    {
+      close (fd);
+      return false;
+    }
+
+  size_t mappedSize = fileStat.st_size;
+  void *mappedFile = mmap (0, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+
+  // The mapping stays valid after closing the file
+  close (fd);
+
+  if (mappedFile == MAP_FAILED)
+    {
+      return false;
+    }
+
+  const char *data = (const char *)(mappedFile);
+  const BinaryFileHeader_s *header = (const BinaryFileHeader_s *)(data);
+
+  size_t gainsOffset, maskOffset, fileSize;
+  GetBinaryFileLayout (header->m_nLatitudes, header->m_nLongitudes, gainsOffset, maskOffset, fileSize);
+
+  if (memcmp (header->m_magic, BINARY_FILE_MAGIC, sizeof (BINARY_FILE_MAGIC)) != 0
+      || header->m_version != BINARY_FILE_VERSION
+      || header->m_nLatitudes < 2
+      || header->m_nLongitudes < 2
+      || fileSize != mappedSize)
+    {
+      NS_LOG_WARN ("Binary antenna pattern file " << filePathName << " is not valid, using the text file");
+      munmap (mappedFile, mappedSize);
+      return false;
+    }
+
+  // The binary file is not checked, if the text file is not available
+  uint64_t textFileSize;
+  int64_t textFileModificationTime;
+
+  if (GetFileStamp (textFilePathName, textFileSize, textFileModificationTime)
+      && (header->m_textFileSize != textFileSize || header->m_textFileModificationTime != textFileModificationTime))
+    {
+      NS_LOG_WARN ("Binary antenna pattern file " << filePathName << " is stale, regenerating it from " << textFilePathName);
+      munmap (mappedFile, mappedSize);
+
+      ReadAntennaPatternFromFile (textFilePathName);
+
+      if (!WriteAntennaPatternToBinaryFile (filePathName))
+        {
+          NS_LOG_WARN ("Binary antenna pattern file " << filePathName << " cannot be regenerated, using the text file");
+        }
+
+      return true;
+    }
+
+  m_textFileSize = header->m_textFileSize;
+  m_textFileModificationTime = header->m_textFileModificationTime;
+
+  const double *latitudes = (const double *)(data + sizeof (BinaryFileHeader_s));
+  const double *longitudes = latitudes + header->m_nLatitudes;
+
+  m_latitudes.assign (latitudes, latitudes + header->m_nLatitudes);
+  m_longitudes.assign (longitudes, longitudes + header->m_nLongitudes);
+
+  m_minLat = m_latitudes.front ();
+  m_maxLat = m_latitudes.back ();
+  m_minLon = m_longitudes.front ();
+  m_maxLon = m_longitudes.back ();
+  m_latInterval = m_latitudes.back () - m_latitudes[m_latitudes.size () - 2];
+  m_lonInterval = m_longitudes.back () - m_longitudes[m_longitudes.size () - 2];
+  m_latIntervalInv = 1.0 / m_latInterval;
+  m_lonIntervalInv = 1.0 / m_lonInterval;
+
+  m_gains = (const float *)(data + gainsOffset);
+  m_validCellMask = (const uint64_t *)(data + maskOffset);
+  m_mappedFile = mappedFile;
+  m_mappedFileSize = mappedSize;
+
+  // Add the positions with the gain above a specified threshold to valid positions vector.
+  double minAcceptableAntennaGain = SatUtils::DbToLinear (m_minAcceptableAntennaGainInDb);
+
+  for (uint32_t latIndex = 0; latIndex < m_latitudes.size (); ++latIndex)
+    {
+      for (uint32_t lonIndex = 0; lonIndex < m_longitudes.size (); ++lonIndex)
+        {
+          float gain = m_gains[latIndex * m_longitudes.size () + lonIndex];
+
+          if (!std::isnan (gain) && gain >= minAcceptableAntennaGain)
+            {
+              m_validPositions.push_back (std::make_pair (m_latitudes[latIndex], m_longitudes[lonIndex]));
+            }
+        }
+    }
+
+  NS_LOG_INFO ("Antenna pattern mapped from binary file " << filePathName);
+
+  return true;
 }
 
+bool SatAntennaGainPattern::WriteAntennaPatternToBinaryFile (std::string filePathName) const
+{
+  NS_LOG_FUNCTION (this << filePathName);
+
+  // The file is written under a temporary name and renamed, so that the
+  // processes having the old file mapped are not affected
+  std::ostringstream tmpFilePathName;
+  tmpFilePathName << filePathName << ".tmp." << getpid ();
+
+  std::ofstream ofs (tmpFilePathName.str ().c_str (), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+  if (!ofs.is_open ())
+    {
+      NS_LOG_WARN ("The file " << tmpFilePathName.str () << " cannot be opened for writing.");
+      return false;
+    }
+
+  BinaryFileHeader_s header;
+  memset (&header, 0, sizeof (header));
+  memcpy (header.m_magic, BINARY_FILE_MAGIC, sizeof (BINARY_FILE_MAGIC));
+  header.m_version = BINARY_FILE_VERSION;
+  header.m_nLatitudes = m_latitudes.size ();
+  header.m_nLongitudes = m_longitudes.size ();
+  header.m_textFileSize = m_textFileSize;
+  header.m_textFileModificationTime = m_textFileModificationTime;
+
+  size_t gainsOffset, maskOffset, fileSize;
+  GetBinaryFileLayout (header.m_nLatitudes, header.m_nLongitudes, gainsOffset, maskOffset, fileSize);
+
+  size_t nGridPoints = GetNumberOfGridPoints ();
+  const char padding[8] = { 0 };
+
+  ofs.write ((const char *)(&header), sizeof (header));
+  ofs.write ((const char *)(&m_latitudes[0]), m_latitudes.size () * sizeof (double));
+  ofs.write ((const char *)(&m_longitudes[0]), m_longitudes.size () * sizeof (double));
+  ofs.write ((const char *)(m_gains), nGridPoints * sizeof (float));
+  ofs.write (padding, maskOffset - gainsOffset - nGridPoints * sizeof (float));
+  ofs.write ((const char *)(m_validCellMask), fileSize - maskOffset);
+
+  ofs.close ();
+
+  if (!ofs.good () || rename (tmpFilePathName.str ().c_str (), filePathName.c_str ()) != 0)
+    {
+      unlink (tmpFilePathName.str ().c_str ());
+      NS_LOG_WARN ("Writing the file " << filePathName << " failed.");
+      return false;
+    }
+
+  return true;
+}
+
+
+bool SatAntennaGainPattern::HasSameGrid (Ptr<const SatAntennaGainPattern> pattern) const
+{
+  NS_LOG_FUNCTION (this << pattern);
+
+  return m_latitudes == pattern->m_latitudes && m_longitudes == pattern->m_longitudes;
+}
+
+uint32_t SatAntennaGainPattern::GetNumberOfGridPoints () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return m_latitudes.size () * m_longitudes.size ();
+}
+
+uint32_t SatAntennaGainPattern::GetGridCell (GeoCoordinate coord) const
+{
+  NS_LOG_FUNCTION (this << coord.GetLatitude () << coord.GetLongitude ());
+
+  double latitude = coord.GetLatitude ();
+  double longitude = coord.GetLongitude ();
+
+  // Given {latitude, longitude} has to be inside the min/max latitude/longitude values
+  if (m_minLat > latitude
+      || latitude > m_maxLat
+      || m_minLon > longitude
+      || longitude > m_maxLon)
+    {
+      NS_FATAL_ERROR (this << " given latitude and longitude out of range!");
+    }
+
+  // The maximum latitude/longitude belongs to the last grid square
+  double latIndex = std::min (std::floor ((latitude - m_minLat) * m_latIntervalInv), m_latitudes.size () - 2.0);
+  double lonIndex = std::min (std::floor ((longitude - m_minLon) * m_lonIntervalInv), m_longitudes.size () - 2.0);
+
+  return (uint32_t)(latIndex) * m_longitudes.size () + (uint32_t)(lonIndex);
+}
+
+bool SatAntennaGainPattern::GetCellGainRange_lin (uint32_t cell, double& minGain, double& maxGain) const
+{
+  NS_LOG_FUNCTION (this << cell);
+
+  if (!IsValidCell (cell))
+    {
+      return false;
+    }
+
+  const uint32_t nLons = m_longitudes.size ();
+  const float corners[4] = { m_gains[cell], m_gains[cell + 1],
+                             m_gains[cell + nLons], m_gains[cell + nLons + 1] };
+
+  minGain = *std::min_element (corners, corners + 4);
+  maxGain = *std::max_element (corners, corners + 4);
+
+  return true;
+}
+
+GeoCoordinate SatAntennaGainPattern::GetPeakGainPosition () const
+{
+  NS_LOG_FUNCTION (this);
+
+  const uint32_t nLats = m_latitudes.size ();
+  const uint32_t nLons = m_longitudes.size ();
+  double peakGain (-1.0);
+  uint32_t peakIndex (0);
+
+  for (uint32_t i = 0; i + 1 < nLats; ++i)
+    {
+      for (uint32_t j = 0; j + 1 < nLons; ++j)
+        {
+          uint32_t cell = i * nLons + j;
+
+          if (!IsValidCell (cell))
+            {
+              continue;
+            }
+
+          const uint32_t corners[4] = { cell, cell + 1, cell + nLons, cell + nLons + 1 };
+
+          for (uint32_t k = 0; k < 4; ++k)
+            {
+              if (m_gains[corners[k]] > peakGain)
+                {
+                  peakGain = m_gains[corners[k]];
+                  peakIndex = corners[k];
+                }
+            }
+        }
+    }
+
+  if (peakGain < 0.0)
+    {
+      NS_FATAL_ERROR ("SatAntennaGainPattern::GetPeakGainPosition - no valid grid squares in the pattern!");
+    }
+
+  return GeoCoordinate (m_latitudes[peakIndex / nLons], m_longitudes[peakIndex % nLons], 0.0);
+}
 
 GeoCoordinate SatAntennaGainPattern::GetValidRandomPosition () const
 {
@@ -274,81 +660,101 @@ GeoCoordinate SatAntennaGainPattern::GetValidRandomPosition () const
 
 double SatAntennaGainPattern::GetAntennaGain_lin (GeoCoordinate coord) const
 {
-  NS_LOG_FUNCTION (this << coord.GetLatitude () << coord.GetLongitude ());
-
-  // Get the requested position {latitude, longitude}
-  double latitude = coord.GetLatitude ();
-  double longitude = coord.GetLongitude ();
-
-  // Given {latitude, longitude} has to be inside the min/max latitude/longitude values
-  if (m_minLat > latitude
-      || latitude > m_maxLat
-      || m_minLon > longitude
-      || longitude > m_maxLon)
-    {
-      NS_FATAL_ERROR (this << " given latitude and longitude out of range!");
-    }
+  // No logging, since called also by the link budget worker threads
+  double gain;
+  GetAntennaGain_lin (&coord, 1, &gain);
 
-  // Calculate the minimum grid point {minLatIndex, minLonIndex} for the given {latitude, longitude} point
-  uint32_t minLatIndex = (uint32_t)(std::floor (std::abs (latitude - m_minLat) / m_latInterval));
-  uint32_t minLonIndex = (uint32_t)(std::floor (std::abs (longitude - m_minLon) / m_lonInterval));
-
-  // All the values within the grid box has to be valid! If UT is placed (or
-  // is moving outside) the valid simulation area, the simulation will crash
-  // to a fatal error.
-  if (std::isnan (m_antennaPattern[minLatIndex][minLonIndex])
-      || std::isnan (m_antennaPattern[minLatIndex][minLonIndex + 1])
-      || std::isnan (m_antennaPattern[minLatIndex + 1][minLonIndex])
-      || std::isnan (m_antennaPattern[minLatIndex + 1][minLonIndex + 1]))
-    {
-      NS_FATAL_ERROR (this << ", some value(s) of the interpolated grid point(s) is/are NAN!");
-    }
+  return gain;
+}
 
+void SatAntennaGainPattern::GetAntennaGain_lin (const GeoCoordinate* coords, uint32_t n, double* gains) const
+{
   /**
-   * 4-point bilinear interpolation
+   * The positions are processed in blocks in three passes, so that the
+   * index and the interpolation computations are done in tight loops over
+   * plain arrays, which the compiler is able to vectorize:
+   * 1) calculate the grid square and the position within the square
+   * 2) check the validity of the squares and fetch the corner gains
+   * 3) 4-point bilinear interpolation
+   *
    * R(x,y1) = (x2 - x)/(x2 - x1) * Q(x1,y1)) + (x - x1)/(x2 - x1) * Q(x2,y1);
    * R(x,y2) = (x2 - x)/(x2 - x1) * Q(x1,y2)) + (x - x1)/(x2 - x1) * Q(x2,y2);
    * R = (y2 - y)/(y2 - y1) * R(x,y1) + (y - y1)/(y2 - y1) * R(x,y2);
    */
+  static const uint32_t BLOCK_SIZE = 64;
+
+  double latShares[BLOCK_SIZE];
+  double lonShares[BLOCK_SIZE];
+  uint32_t cells[BLOCK_SIZE];
+  double g11[BLOCK_SIZE];
+  double g12[BLOCK_SIZE];
+  double g21[BLOCK_SIZE];
+  double g22[BLOCK_SIZE];
+
+  const uint32_t nLons = m_longitudes.size ();
+  const double maxLatIndex = m_latitudes.size () - 2;
+  const double maxLonIndex = nLons - 2;
+  const float *pattern = m_gains;
+
+  for (uint32_t start = 0; start < n; start += BLOCK_SIZE)
+    {
+      const uint32_t blockSize = std::min (BLOCK_SIZE, n - start);
+      const GeoCoordinate *blockCoords = coords + start;
+      bool outOfRange (false);
 
-  // Longitude direction with latitude minLatIndex
-  double upperLonShare = (m_longitudes[minLonIndex + 1] - longitude) / m_lonInterval;
-  double lowerLonShare = (longitude - m_longitudes[minLonIndex]) / m_lonInterval;
-
-  // Change the gains to linear values , because the interpolation is done in linear domain.
-  double G11 = SatUtils::DbToLinear ( m_antennaPattern[minLatIndex][minLonIndex] );
-  double G12 = SatUtils::DbToLinear ( m_antennaPattern[minLatIndex][minLonIndex + 1] );
-  double G21 = SatUtils::DbToLinear ( m_antennaPattern[minLatIndex + 1][minLonIndex] );
-  double G22 = SatUtils::DbToLinear ( m_antennaPattern[minLatIndex + 1][minLonIndex + 1] );
-
-  // Longitude direction with latitude minLatIndex
-  double valLatLower = upperLonShare * G11 + lowerLonShare * G12;
-
-  // Longitude direction with latitude minLatIndex+1
-  double valLatUpper = upperLonShare * G21 + lowerLonShare * G22;
-
-  // Latitude direction with longitude "longitude"
-  double gain = ((m_latitudes[minLatIndex + 1] - latitude) / m_latInterval) * valLatLower +
-    ((latitude - m_latitudes[minLatIndex]) / m_latInterval) * valLatUpper;
-
-  /*
-  std::cout << "minLonIndex = " << minLonIndex <<
-      ", minLatIndex = " << minLatIndex <<
-      ", m_lonInterval = " << m_lonInterval <<
-      ", m_LatInterval = " << m_latInterval <<
-      ", x1 = " << m_longitudes[minLonIndex] <<
-      ", y1 = " << m_latitudes[minLatIndex] <<
-      ", x2 = " << m_longitudes[minLonIndex+1] <<
-      ", y2 = " << m_latitudes[minLatIndex+1] <<
-      ", G(x1,y1) = " << m_antennaPattern[minLatIndex][minLonIndex] <<
-      ", G(x1,y2) = " << m_antennaPattern[minLatIndex+1][minLonIndex] <<
-      ", G(x2,y1) = " << m_antennaPattern[minLatIndex][minLonIndex+1] <<
-      ", G(x2,y2) = " << m_antennaPattern[minLatIndex+1][minLonIndex+1] <<
-      ", x = " << longitude <<
-      ", y = " << latitude <<
-      ", interpolated gain: " << gain << std::endl;
-   */
-  return gain;
+      for (uint32_t i = 0; i < blockSize; ++i)
+        {
+          double latitude = blockCoords[i].GetLatitude ();
+          double longitude = blockCoords[i].GetLongitude ();
+
+          // Given {latitude, longitude} has to be inside the min/max latitude/longitude values
+          outOfRange |= (m_minLat > latitude) | (latitude > m_maxLat) | (m_minLon > longitude) | (longitude > m_maxLon);
+
+          // The minimum grid point {latIndex, lonIndex} for the given {latitude, longitude} point.
+          // The maximum latitude/longitude is interpolated within the last grid square.
+          double latPos = (latitude - m_minLat) * m_latIntervalInv;
+          double lonPos = (longitude - m_minLon) * m_lonIntervalInv;
+          double latIndex = std::max (0.0, std::min (std::floor (latPos), maxLatIndex));
+          double lonIndex = std::max (0.0, std::min (std::floor (lonPos), maxLonIndex));
+
+          latShares[i] = latPos - latIndex;
+          lonShares[i] = lonPos - lonIndex;
+          cells[i] = (uint32_t)(latIndex) * nLons + (uint32_t)(lonIndex);
+        }
+
+      if (outOfRange)
+        {
+          NS_FATAL_ERROR (this << " given latitude and longitude out of range!");
+        }
+
+      for (uint32_t i = 0; i < blockSize; ++i)
+        {
+          // All the values within the grid box has to be valid! If UT is placed (or
+          // is moving outside) the valid simulation area, the simulation will crash
+          // to a fatal error.
+          if (!IsValidCell (cells[i]))
+            {
+              NS_FATAL_ERROR (this << ", some value(s) of the interpolated grid point(s) is/are NAN!");
+            }
+
+          const float *lower = pattern + cells[i];
+          const float *upper = lower + nLons;
+          g11[i] = lower[0];
+          g12[i] = lower[1];
+          g21[i] = upper[0];
+          g22[i] = upper[1];
+        }
+
+      for (uint32_t i = 0; i < blockSize; ++i)
+        {
+          // Longitude direction with latitudes latIndex and latIndex+1
+          double valLatLower = (1.0 - lonShares[i]) * g11[i] + lonShares[i] * g12[i];
+          double valLatUpper = (1.0 - lonShares[i]) * g21[i] + lonShares[i] * g22[i];
+
+          // Latitude direction with longitude "longitude"
+          gains[start + i] = (1.0 - latShares[i]) * valLatLower + latShares[i] * valLatUpper;
+        }
+    }
 }
 
 
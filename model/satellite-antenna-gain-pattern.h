@@ -21,6 +21,7 @@
 #ifndef SATELLITE_ANTENNA_GAIN_PATTERN_H
 #define SATELLITE_ANTENNA_GAIN_PATTERN_H
 
+#include <stdint.h>
 #include <vector>
 #include <fstream>
 #include "ns3/random-variable-stream.h"
@@ -35,15 +36,29 @@ namespace ns3 {
  * for a one single spot-beam. In initialization phase, the gain pattern
  * is read from a file to a container. Current implementation assumes
  * that the antenna pattern is using a constant longitude-latitude grid of
- * samples. This assumption is made to enable fast look-ups from the container
- * (= vector<vector<double>>).
+ * samples. This assumption is made to enable fast look-ups from the container,
+ * which is a contiguous row-major grid of linear gains stored as floats. The
+ * validity (= all four corners are not NaN) of each grid square is
+ * precomputed into a bitmask, so that a look-up needs only one validity check.
+ *
+ * The pattern is read preferably from a binary pattern file, which has the
+ * same name as the text file but ".bin" extension. The binary file holds the
+ * latitude-longitude grid, the linear float gains and the validity bitmask
+ * in the in-memory layout, so it is memory-mapped read-only and shared
+ * between concurrent simulation processes. If the binary file is not found
+ * or it is not valid, the text file is read. Binary files are created from
+ * the text files with sat-antenna-gain-pattern-converter. The size and the
+ * modification time of the text file are stored in the binary file, and a
+ * binary file not matching its text file anymore is regenerated.
  *
  * Antenna gain patter is used also for spot-beam selection. In initialization phase
  * a valid positions list is constructed based on a minimum accepted antenna gain set
  * as an attribute. This approach is selected to speed up the random UT positioning.
  *
  * Antenna gain value for a given longitude and latitude position is calculated by
- * using 4-point bilinear interpolation.
+ * using 4-point bilinear interpolation in linear domain. Several positions may be
+ * interpolated with one batch call, which is organized so that the compiler is
+ * able to vectorize the index and interpolation computations.
  */
 class SatAntennaGainPattern : public Object
 {
@@ -71,23 +86,145 @@ public:
    * \param filePathName 
    */
   SatAntennaGainPattern (std::string filePathName);
-  ~SatAntennaGainPattern ()
-  {
-  }
 
   /**
-   * \brief Calculate the antenna gain value for a certain {latitude, longitude} point
+   * Destructor. Unmaps the binary pattern file, if mapped.
+   */
+  ~SatAntennaGainPattern ();
+
+  /**
+   * \brief Calculate the antenna gain value for a certain {latitude, longitude} point.
+   * Does not log, thus it may be called also outside the simulator thread.
    * \return The gain value in linear format
    */
   double GetAntennaGain_lin (GeoCoordinate coord) const;
 
+  /**
+   * \brief Calculate the antenna gain values for a set of {latitude, longitude} points
+   * \param coords Array of the positions
+   * \param n Number of the positions
+   * \param gains Array to store the gain values in linear format
+   */
+  void GetAntennaGain_lin (const GeoCoordinate* coords, uint32_t n, double* gains) const;
+
+  /**
+   * \brief Check whether the pattern uses the same latitude-longitude grid
+   * as another pattern
+   * \param pattern Antenna gain pattern to compare with
+   * \return true if the grids are identical
+   */
+  bool HasSameGrid (Ptr<const SatAntennaGainPattern> pattern) const;
+
+  /**
+   * \brief Get the number of grid points of the pattern
+   * \return Number of grid points
+   */
+  uint32_t GetNumberOfGridPoints () const;
+
+  /**
+   * \brief Get the grid square of a {latitude, longitude} point
+   * \param coord Position
+   * \return Grid index of the lower left corner of the grid square
+   */
+  uint32_t GetGridCell (GeoCoordinate coord) const;
+
+  /**
+   * \brief Get the range of the gain values at the corners of a grid square
+   * \param cell Grid index of the lower left corner of the grid square
+   * \param minGain Minimum corner gain in linear format
+   * \param maxGain Maximum corner gain in linear format
+   * \return false if some of the corners are not valid (NaN)
+   */
+  bool GetCellGainRange_lin (uint32_t cell, double& minGain, double& maxGain) const;
+
+  /**
+   * \brief Get the grid point with the highest antenna gain, i.e. the
+   * center of the beam. Only the corners of valid grid squares are
+   * considered.
+   * \return Position of the highest gain (altitude zero)
+   */
+  GeoCoordinate GetPeakGainPosition () const;
+
   /**
    * \brief Get a valid random position under this spot-beam coverage.
    * \return A valid random GeoCoordinate
    */
   GeoCoordinate GetValidRandomPosition () const;
 
+  /**
+   * \brief Write the antenna gain pattern to a binary pattern file
+   * \param filePathName Path and file name of the binary pattern file
+   * \return false if the file cannot be written
+   */
+  bool WriteAntennaPatternToBinaryFile (std::string filePathName) const;
+
+  /**
+   * \brief Get the binary pattern file name related to a text pattern file,
+   * i.e. the ".txt" extension replaced with ".bin"
+   * \param filePathName Path and file name of the text pattern file
+   * \return Path and file name of the binary pattern file
+   */
+  static std::string GetBinaryFilePathName (std::string filePathName);
+
 private:
+  /**
+   * \brief Header of the binary pattern file. The header is followed by
+   * - latitudes (double)
+   * - longitudes (double)
+   * - linear gains in row-major order (float)
+   * - padding to 8 bytes
+   * - validity bitmask of the grid squares (uint64_t)
+   * The values are stored in the native byte order.
+   */
+  typedef struct
+  {
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_nLatitudes;
+    uint32_t m_nLongitudes;
+    uint32_t m_reserved;
+    uint64_t m_textFileSize;
+    int64_t m_textFileModificationTime;
+  } BinaryFileHeader_s;
+
+  /**
+   * Magic string and version of the binary pattern file
+   */
+  static const char BINARY_FILE_MAGIC[8];
+  static const uint32_t BINARY_FILE_VERSION = 2;
+
+  /**
+   * \brief Calculate the layout of a binary pattern file
+   * \param nLatitudes Number of latitudes
+   * \param nLongitudes Number of longitudes
+   * \param gainsOffset Offset of the gain values
+   * \param maskOffset Offset of the validity bitmask
+   * \param fileSize Size of the file
+   */
+  static void GetBinaryFileLayout (uint32_t nLatitudes, uint32_t nLongitudes,
+                                   size_t& gainsOffset, size_t& maskOffset, size_t& fileSize);
+
+  /**
+   * \brief Get the size and the modification time of a file
+   * \param filePathName Path and file name
+   * \param size Size of the file in bytes
+   * \param modificationTime Modification time of the file in seconds
+   * \return false if the file is not found
+   */
+  static bool GetFileStamp (std::string filePathName, uint64_t& size, int64_t& modificationTime);
+
+  /**
+   * \brief Read (memory-map) the antenna gain pattern from a binary file.
+   * If the binary file is stale, i.e. the text file has been changed after
+   * the binary file was written, the text file is read and the binary file
+   * is regenerated from it. If the regenerated file cannot be written, e.g.
+   * in a read-only data directory, the pattern read from the text file is
+   * used.
+   * \param textFilePathName Path and file name of the text pattern file
+   * \return false if the binary file is not found or it is not valid
+   */
+  bool ReadAntennaPatternFromBinaryFile (std::string textFilePathName);
+
   /**
    * \brief Read the antenna gain pattern from a file
    * \param filePathName Path and file name of the antenna pattern file
@@ -95,11 +232,59 @@ private:
   void ReadAntennaPatternFromFile (std::string filePathName);
 
   /**
-   * Container for the antenna pattern from one spot-beam
-   * - Outer vector holds gain values for all latitudes
-   * - Inner vector holds gain values for all longitudes for a certain latitude
+   * \brief Construct the linear gain grid and the grid square validity
+   * bitmask from the gain values read from the file
+   * \param gainsDb Gain values in dBs in row-major order (NaN = not valid)
+   */
+  void ConstructGrid (const std::vector<double>& gainsDb);
+
+  /**
+   * \brief Check whether all the four corners of a grid square are valid
+   * \param cell Index of the lower left corner of the grid square
+   * \return true if the grid square may be used in interpolation
+   */
+  inline bool IsValidCell (uint32_t cell) const
+  {
+    return (m_validCellMask[cell >> 6] >> (cell & 63)) & 1;
+  }
+
+  /**
+   * Container for the antenna pattern from one spot-beam. Linear gain values
+   * in row-major order, i.e. the gain values of all longitudes for the first
+   * latitude, then for the second latitude etc. NaN for not valid positions.
+   */
+  std::vector<float> m_antennaPattern;
+
+  /**
+   * Bitmask of valid grid squares, indexed by the grid index of the lower
+   * left corner of the square
    */
-  std::vector< std::vector <double> > m_antennaPattern;
+  std::vector<uint64_t> m_validCells;
+
+  /**
+   * Linear gain values and validity bitmask in use, i.e. either the above
+   * containers or the memory-mapped binary file
+   */
+  const float *m_gains;
+  const uint64_t *m_validCellMask;
+
+  /**
+   * Memory-mapped binary pattern file, NULL if the text file is used
+   */
+  void *m_mappedFile;
+  size_t m_mappedFileSize;
+
+  /**
+   * Size and modification time of the text pattern file the pattern
+   * originates from, stored into the written binary pattern file
+   */
+  uint64_t m_textFileSize;
+  int64_t m_textFileModificationTime;
+
+  /**
+   * Defines whether the binary pattern file is tried to read first
+   */
+  bool m_useBinaryFile;
 
   /**
    * Container for valid positions
@@ -159,6 +344,16 @@ private:
    */
   double m_lonInterval;
 
+  /**
+   * Inverse of the interval between latitudes
+   */
+  double m_latIntervalInv;
+
+  /**
+   * Inverse of the interval between longitudes
+   */
+  double m_lonIntervalInv;
+
   /**
    * Valid Not-a-Number (NaN) strings
    */
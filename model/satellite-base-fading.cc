@@ -17,6 +17,10 @@
  *
  * Author: Frans Laakso <frans.laakso@magister.fi>
  */
+#include <algorithm>
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "satellite-const-variables.h"
 #include "satellite-base-fading.h"
 
 NS_LOG_COMPONENT_DEFINE ("SatBaseFading");
@@ -29,11 +33,39 @@ TypeId
 SatBaseFading::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::SatBaseFading")
-    .SetParent<Object> ();
+    .SetParent<Object> ()
+    .AddAttribute ("EnableCoherenceCache",
+                   "Reuse the calculated fading values within the coherence time bucket.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SatBaseFading::m_enableCoherenceCache),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CoherenceCarrierFrequency",
+                   "Carrier frequency in Hz used in the coherence time calculation.",
+                   DoubleValue (30e9),
+                   MakeDoubleAccessor (&SatBaseFading::m_carrierFrequencyHz),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("CoherenceTimeFraction",
+                   "Fraction of the coherence time used as the cache bucket length.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&SatBaseFading::m_coherenceTimeFraction),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("MaximumCachePeriod",
+                   "Maximum cache bucket length, used also for stationary nodes.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&SatBaseFading::m_maxCachePeriod),
+                   MakeTimeChecker ());
   return tid;
 }
 
 SatBaseFading::SatBaseFading ()
+  : m_enableCoherenceCache (false),
+    m_carrierFrequencyHz (30e9),
+    m_coherenceTimeFraction (0.1),
+    m_maxCachePeriod (MilliSeconds (10)),
+    m_velocity (),
+    m_cache (),
+    m_cacheHitCount (0),
+    m_cacheMissCount (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -43,12 +75,119 @@ SatBaseFading::~SatBaseFading ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+SatBaseFading::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_velocity.Nullify ();
+  m_cache.clear ();
+  Object::DoDispose ();
+}
+
 double
 SatBaseFading::GetFading (Address macAddress, SatEnums::ChannelType_t channelType)
 {
   NS_LOG_FUNCTION (this);
 
-  return DoGetFading (macAddress,channelType);
+  if (!m_enableCoherenceCache || m_velocity.IsNull ())
+    {
+      return DoGetFading (macAddress,channelType);
+    }
+
+  Time bucketLength = GetCoherenceBucketLength ();
+
+  if (bucketLength.IsZero ())
+    {
+      return DoGetFading (macAddress,channelType);
+    }
+
+  Time now = Now ();
+  std::pair<Address, SatEnums::ChannelType_t> key = std::make_pair (macAddress, channelType);
+  std::map<std::pair<Address, SatEnums::ChannelType_t>, cachedFading_s>::iterator it = m_cache.find (key);
+
+  if (it != m_cache.end () && now < it->second.m_validUntil)
+    {
+      ++m_cacheHitCount;
+      NotifyCacheHit (macAddress, channelType, it->second.m_fadingValue);
+      return it->second.m_fadingValue;
+    }
+
+  ++m_cacheMissCount;
+
+  /// the buckets are aligned to the multiples of the bucket length
+  int64_t bucket = now.GetInteger () / bucketLength.GetInteger ();
+
+  cachedFading_s entry;
+  entry.m_validUntil = TimeStep ((bucket + 1) * bucketLength.GetInteger ());
+  entry.m_fadingValue = DoGetFading (macAddress,channelType);
+  m_cache[key] = entry;
+
+  return entry.m_fadingValue;
+}
+
+void
+SatBaseFading::NotifyCacheHit (Address macAddress, SatEnums::ChannelType_t channelType, double fadingValue)
+{
+  NS_LOG_FUNCTION (this << channelType << fadingValue);
+}
+
+void
+SatBaseFading::SetVelocityCallback (VelocityCallback velocity)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_velocity = velocity;
+}
+
+Time
+SatBaseFading::GetCoherenceBucketLength ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_velocity.IsNull ())
+    {
+      return Seconds (0);
+    }
+
+  /**
+   * Maximum Doppler frequency f_d = v * f_c / c and the coherence time
+   * T_c = 0.423 / f_d. Stationary nodes use the maximum cache period.
+   */
+  double dopplerHz = m_velocity () * m_carrierFrequencyHz / SatConstVariables::SPEED_OF_LIGHT;
+  Time bucketLength = m_maxCachePeriod;
+
+  if (dopplerHz > 0.0)
+    {
+      bucketLength = std::min (bucketLength, Seconds (m_coherenceTimeFraction * 0.423 / dopplerHz));
+    }
+
+  return bucketLength;
+}
+
+uint64_t
+SatBaseFading::GetCacheHitCount () const
+{
+  return m_cacheHitCount;
+}
+
+uint64_t
+SatBaseFading::GetCacheMissCount () const
+{
+  return m_cacheMissCount;
+}
+
+double
+SatBaseFading::GetCacheHitRate () const
+{
+  uint64_t requests = m_cacheHitCount + m_cacheMissCount;
+
+  if (requests == 0)
+    {
+      return 0.0;
+    }
+
+  return (double) m_cacheHitCount / requests;
 }
 
 } // namespace ns3
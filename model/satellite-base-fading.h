@@ -24,8 +24,10 @@
 #include "ns3/uinteger.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/nstime.h"
 #include "satellite-enums.h"
 #include "ns3/mac48-address.h"
+#include <map>
 
 namespace ns3 {
 
@@ -37,6 +39,14 @@ namespace ns3 {
  * different fading models must implement for the fading
  * interface. This base class itself is abstract and will not
  * implement any real functionality.
+ *
+ * The base class implements an optional coherence time cache for the
+ * fading values. When enabled, the value calculated for an address and
+ * channel type is reused until the end of the current time bucket. The
+ * bucket length is a fraction of the channel coherence time derived from
+ * the node velocity and the carrier frequency, but at most the maximum
+ * cache period, which applies also to stationary nodes. The cache is used
+ * only when a velocity callback has been set with SetVelocityCallback.
  */
 class SatBaseFading : public Object
 {
@@ -84,7 +94,98 @@ public:
    */
   virtual double DoGetFading (Address macAddress, SatEnums::ChannelType_t channelType) = 0;
 
+  /**
+   * \brief Set the velocity callback used in the coherence time calculation
+   * \param velocity velocity callback
+   */
+  void SetVelocityCallback (VelocityCallback velocity);
+
+  /**
+   * \brief Get the length of the current coherence time bucket
+   * \return bucket length, zero if the cache is not applicable
+   */
+  Time GetCoherenceBucketLength ();
+
+  /**
+   * \brief Get the number of fading requests served from the cache
+   * \return number of cache hits
+   */
+  uint64_t GetCacheHitCount () const;
+
+  /**
+   * \brief Get the number of fading requests calculated while the cache
+   * was in use
+   * \return number of cache misses
+   */
+  uint64_t GetCacheMissCount () const;
+
+  /**
+   * \brief Get the ratio of the cache hits to all the cached requests
+   * \return cache hit rate
+   */
+  double GetCacheHitRate () const;
+
+protected:
+  /**
+   * \brief Do needed dispose actions
+   */
+  virtual void DoDispose ();
+
+  /**
+   * \brief Notify the inherited class that a fading value was served
+   * from the cache instead of calling DoGetFading, e.g. to keep its
+   * traces identical to the uncached ones. The default does nothing.
+   * \param macAddress MAC address
+   * \param channelType channel type
+   * \param fadingValue cached fading value
+   */
+  virtual void NotifyCacheHit (Address macAddress, SatEnums::ChannelType_t channelType, double fadingValue);
+
 private:
+  /**
+   * \brief Cached fading value of an address and channel type
+   */
+  typedef struct
+  {
+    Time m_validUntil;
+    double m_fadingValue;
+  } cachedFading_s;
+
+  /**
+   * \brief Is the coherence time cache enabled
+   */
+  bool m_enableCoherenceCache;
+
+  /**
+   * \brief Carrier frequency used in the Doppler frequency calculation
+   */
+  double m_carrierFrequencyHz;
+
+  /**
+   * \brief Fraction of the coherence time used as the bucket length
+   */
+  double m_coherenceTimeFraction;
+
+  /**
+   * \brief Maximum bucket length
+   */
+  Time m_maxCachePeriod;
+
+  /**
+   * \brief Node velocity
+   */
+  VelocityCallback m_velocity;
+
+  /**
+   * \brief Cached fading values
+   */
+  std::map<std::pair<Address, SatEnums::ChannelType_t>, cachedFading_s> m_cache;
+
+  /**
+   * \brief Cache statistics
+   */
+  uint64_t m_cacheHitCount;
+  uint64_t m_cacheMissCount;
 };
 
 } // namespace ns3
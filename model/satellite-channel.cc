@@ -19,6 +19,7 @@
  */
 
 #include <algorithm>
+#include <limits>
 #include "ns3/object.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
@@ -28,10 +29,11 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/mobility-model.h"
 #include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "satellite-phy-rx.h"
 #include "satellite-phy-tx.h"
 #include "satellite-channel.h"
-#include "satellite-mac-tag.h"
 #include "ns3/singleton.h"
 #include "ns3/boolean.h"
 #include "satellite-rx-power-output-trace-container.h"
@@ -40,6 +42,7 @@
 #include "satellite-fading-external-input-trace-container.h"
 #include "satellite-id-mapper.h"
 #include "satellite-utils.h"
+#include "satellite-thread-pool.h"
 
 NS_LOG_COMPONENT_DEFINE ("SatChannel");
 
@@ -54,6 +57,7 @@ SatChannel::SatChannel ()
     m_carrierFreqConverter (),
     m_freqId (),
     m_propagationDelay (),
+    m_coChannelActivity (),
     m_freeSpaceLoss (),
     m_rxPowerCalculationMode (SatEnums::RX_PWR_CALCULATION),
     /*
@@ -65,7 +69,20 @@ SatChannel::SatChannel ()
      */
     m_enableRxPowerOutputTrace (false),
     m_enableFadingOutputTrace (false),
-    m_enableExternalFadingInputTrace (false)
+    m_enableExternalFadingInputTrace (false),
+    m_enableReceiverCulling (false),
+    m_receiverCullingThresholdDb (-30.0),
+    m_culledReceivers (),
+    m_observedMobilities (),
+    m_enableBatchedDelivery (false),
+    m_pendingRxBatches (),
+    m_enableLinkBudgetCache (false),
+    m_linkBudgetCache (),
+    m_parallelLinkBudgetThreads (1),
+    m_parallelLinkBudgetMinBatchSize (16),
+    m_rxIndexesOutdated (true),
+    m_addressRxIndexes (),
+    m_beamRxIndexes ()
 {
   NS_LOG_FUNCTION (this);
 }
@@ -80,7 +97,27 @@ SatChannel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_phyRxContainer.clear ();
+  m_culledReceivers.clear ();
+
+  // Disconnect the course change sinks, since the mobility models may outlive the channel
+  for (std::set<Ptr<SatMobilityModel> >::iterator it = m_observedMobilities.begin (); it != m_observedMobilities.end (); ++it)
+    {
+      (*it)->TraceDisconnectWithoutContext ("SatCourseChange", MakeCallback (&SatChannel::MobilityChanged, this));
+    }
+
+  m_observedMobilities.clear ();
+  m_pendingRxBatches.clear ();
+  m_linkBudgetCache.clear ();
+  m_addressRxIndexes.clear ();
+  m_beamRxIndexes.clear ();
   m_propagationDelay = 0;
+
+  if (m_coChannelActivity)
+    {
+      m_coChannelActivity->Dispose ();
+      m_coChannelActivity = 0;
+    }
+
   Channel::DoDispose ();
 }
 
@@ -118,6 +155,44 @@ SatChannel::GetTypeId (void)
                    MakeEnumChecker (SatChannel::ONLY_DEST_NODE, "OnlyDestNode",
                                     SatChannel::ONLY_DEST_BEAM, "OnlyDestBeam",
                                     SatChannel::ALL_BEAMS, "AllBeams"))
+    .AddAttribute ( "EnableReceiverCulling",
+                    "Enable antenna gain based receiver culling in AllBeams forwarding mode.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&SatChannel::m_enableReceiverCulling),
+                    MakeBooleanChecker ())
+    .AddAttribute ( "ReceiverCullingThresholdDb",
+                    "Receivers with link antenna gain below this threshold (relative to the strongest link of the transmitter) are culled.",
+                    DoubleValue (-30.0),
+                    MakeDoubleAccessor (&SatChannel::m_receiverCullingThresholdDb),
+                    MakeDoubleChecker<double> (-std::numeric_limits<double>::max (), 0.0))
+    .AddAttribute ( "EnableBatchedDelivery",
+                    "Enable batched delivery, i.e. one reception event per propagation delay group instead of one per receiver.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&SatChannel::m_enableBatchedDelivery),
+                    MakeBooleanChecker ())
+    .AddAttribute ( "EnableLinkBudgetCache",
+                    "Enable caching of the static link budget (antenna gains, free space loss and losses) per link and carrier.",
+                    BooleanValue (false),
+                    MakeBooleanAccessor (&SatChannel::m_enableLinkBudgetCache),
+                    MakeBooleanChecker ())
+    .AddAttribute ( "ParallelLinkBudgetThreads",
+                    "Number of threads evaluating the static link budgets of a batched delivery group in parallel (1 = sequential). Used only with batched delivery.",
+                    UintegerValue (1),
+                    MakeUintegerAccessor (&SatChannel::m_parallelLinkBudgetThreads),
+                    MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ( "ParallelLinkBudgetMinBatchSize",
+                    "Minimum number of receivers in a batched delivery group for the parallel link budget evaluation.",
+                    UintegerValue (16),
+                    MakeUintegerAccessor (&SatChannel::m_parallelLinkBudgetMinBatchSize),
+                    MakeUintegerChecker<uint32_t> (2))
+    .AddTraceSource ("ReceiverCulling",
+                     "A culled receiver set of a transmitter has been (re)built",
+                     MakeTraceSourceAccessor (&SatChannel::m_receiverCullingTrace),
+                     "ns3::SatChannel::ReceiverCullingCallback")
+    .AddTraceSource ("RxBatch",
+                     "A batched reception event starts the receptions of a delay group",
+                     MakeTraceSourceAccessor (&SatChannel::m_rxBatchTrace),
+                     "ns3::SatChannel::RxBatchCallback")
   ;
   return tid;
 }
@@ -127,6 +202,9 @@ SatChannel::AddRx (Ptr<SatPhyRx> phyRx)
 {
   NS_LOG_FUNCTION (this << phyRx);
   m_phyRxContainer.push_back (phyRx);
+  m_culledReceivers.clear ();
+  m_linkBudgetCache.clear ();
+  m_rxIndexesOutdated = true;
 }
 
 void
@@ -139,6 +217,9 @@ SatChannel::RemoveRx (Ptr<SatPhyRx> phyRx)
   if (phyIter != m_phyRxContainer.end ()) // == vector.end() means the element was not found
     {
       m_phyRxContainer.erase (phyIter);
+      m_culledReceivers.clear ();
+      m_linkBudgetCache.clear ();
+      m_rxIndexesOutdated = true;
     }
 }
 
@@ -158,67 +239,83 @@ SatChannel::StartTx (Ptr<SatSignalParameters> txParams)
     */
     case SatChannel::ONLY_DEST_NODE:
       {
-        // For all receivers
-        for (PhyRxContainer::const_iterator rxPhyIterator = m_phyRxContainer.begin ();
-             rxPhyIterator != m_phyRxContainer.end ();
-             ++rxPhyIterator)
+        UpdateRxIndexes ();
+
+        switch (m_channelType)
           {
-            // If the same beam
-            if ( (*rxPhyIterator)->GetBeamId () == txParams->m_beamId )
-              {
-                switch (m_channelType)
-                  {
-                  // If the destination is satellite
-                  case SatEnums::FORWARD_FEEDER_CH:
-                  case SatEnums::RETURN_USER_CH:
+          // If the destination is satellite
+          case SatEnums::FORWARD_FEEDER_CH:
+          case SatEnums::RETURN_USER_CH:
+            {
+              // The packet burst is passed on to the satellite receivers of the beam
+              ScheduleRxForIndexes (txParams, m_beamRxIndexes[txParams->m_beamId]);
+              break;
+            }
+          // If the destination is terrestrial node
+          case SatEnums::FORWARD_USER_CH:
+          case SatEnums::RETURN_FEEDER_CH:
+            {
+              if (txParams->GetDestAddresses ().empty ())
+                {
+                  NS_FATAL_ERROR ("MAC tag was not found from the packet!");
+                }
+
+              RxIndexes_t destIndexes;
+              bool groupDest (false);
+
+              // Look up the receivers of the burst destinations
+              SatSignalParameters::DestinationAddresses_t::const_iterator it = txParams->GetDestAddresses ().begin ();
+              for (; it != txParams->GetDestAddresses ().end (); ++it )
+                {
+                  if (it->IsBroadcast () || it->IsGroup ())
                     {
-                      // The packet burst is passed on to the satellite receiver
-                      ScheduleRx (txParams, *rxPhyIterator);
+                      groupDest = true;
                       break;
                     }
-                  // If the destination is terrestrial node
-                  case SatEnums::FORWARD_USER_CH:
-                  case SatEnums::RETURN_FEEDER_CH:
-                    {
-                      // Go through the packets and check their destination address by peeking the MAC tag
-                      SatSignalParameters::PacketsInBurst_t::const_iterator it = txParams->m_packetsInBurst.begin ();
-                      for (; it != txParams->m_packetsInBurst.end (); ++it )
-                        {
-                          SatMacTag macTag;
-                          bool mSuccess = (*it)->PeekPacketTag (macTag);
-                          if (!mSuccess)
-                            {
-                              NS_FATAL_ERROR ("MAC tag was not found from the packet!");
-                            }
 
-                          Mac48Address dest = macTag.GetDestAddress ();
+                  std::map<Mac48Address, RxIndexes_t>::const_iterator addrIt = m_addressRxIndexes.find (*it);
 
-                          // If the packet destination is the same as the receiver MAC
-                          if (dest == (*rxPhyIterator)->GetAddress () || dest.IsBroadcast () || dest.IsGroup ())
+                  if (addrIt != m_addressRxIndexes.end ())
+                    {
+                      for (RxIndexes_t::const_iterator idxIt = addrIt->second.begin (); idxIt != addrIt->second.end (); ++idxIt)
+                        {
+                          // If the same beam
+                          if (m_phyRxContainer[*idxIt]->GetBeamId () == txParams->m_beamId)
                             {
-                              ScheduleRx (txParams, *rxPhyIterator);
-
-                              // Remember to break the packet loop, so that the transmission
-                              // is not received several times!
-                              break;
+                              destIndexes.push_back (*idxIt);
                             }
                         }
-                      break;
-                    }
-                  default:
-                    {
-                      NS_FATAL_ERROR ("Unsupported channel type!");
-                      break;
                     }
-                  }
-              }
+                }
+
+              // Broadcast and group frames are received by all the receivers of the beam
+              if (groupDest)
+                {
+                  ScheduleRxForIndexes (txParams, m_beamRxIndexes[txParams->m_beamId]);
+                }
+              else
+                {
+                  // Keep the receiver container order and make sure that the
+                  // transmission is not received several times!
+                  std::sort (destIndexes.begin (), destIndexes.end ());
+                  destIndexes.erase (std::unique (destIndexes.begin (), destIndexes.end ()), destIndexes.end ());
+                  ScheduleRxForIndexes (txParams, destIndexes);
+                }
+              break;
+            }
+          default:
+            {
+              NS_FATAL_ERROR ("Unsupported channel type!");
+              break;
+            }
           }
         break;
       }
     /**
      * The packet shall be received by only by the receivers within the same spot-beam.
      * Note, that with ONLY_DEST_BEAM mode, the PerPacket interference may not be used,
-     * since there will be no interference.
+     * since there will be no interference. CoChannel interference model may be used
+     * instead, since it is based on the co-channel activity of the channel.
     */
     case SatChannel::ONLY_DEST_BEAM:
       {
@@ -242,8 +339,10 @@ SatChannel::StartTx (Ptr<SatSignalParameters> txParams)
     */
     case SatChannel::ALL_BEAMS:
       {
-        for (PhyRxContainer::const_iterator rxPhyIterator = m_phyRxContainer.begin ();
-             rxPhyIterator != m_phyRxContainer.end ();
+        const PhyRxContainer& receivers = m_enableReceiverCulling ? GetCulledReceivers (txParams) : m_phyRxContainer;
+
+        for (PhyRxContainer::const_iterator rxPhyIterator = receivers.begin ();
+             rxPhyIterator != receivers.end ();
              ++rxPhyIterator)
           {
             ScheduleRx (txParams, *rxPhyIterator);
@@ -256,6 +355,183 @@ SatChannel::StartTx (Ptr<SatSignalParameters> txParams)
         break;
       }
     }
+
+  if (m_enableBatchedDelivery)
+    {
+      FlushBatchedRx ();
+    }
+}
+
+void
+SatChannel::UpdateRxIndexes ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_rxIndexesOutdated)
+    {
+      return;
+    }
+
+  m_addressRxIndexes.clear ();
+  m_beamRxIndexes.clear ();
+
+  for (uint32_t i = 0; i < m_phyRxContainer.size (); ++i)
+    {
+      m_addressRxIndexes[m_phyRxContainer[i]->GetAddress ()].push_back (i);
+      m_beamRxIndexes[m_phyRxContainer[i]->GetBeamId ()].push_back (i);
+    }
+
+  m_rxIndexesOutdated = false;
+}
+
+void
+SatChannel::ScheduleRxForIndexes (Ptr<SatSignalParameters> txParams, const RxIndexes_t& indexes)
+{
+  NS_LOG_FUNCTION (this << txParams << indexes.size ());
+
+  for (RxIndexes_t::const_iterator it = indexes.begin (); it != indexes.end (); ++it)
+    {
+      ScheduleRx (txParams, m_phyRxContainer[*it]);
+    }
+}
+
+const SatChannel::PhyRxContainer&
+SatChannel::GetCulledReceivers (Ptr<SatSignalParameters> txParams)
+{
+  NS_LOG_FUNCTION (this << txParams);
+
+  Ptr<SatPhyTx> phyTx = txParams->m_phyTx;
+  std::map<Ptr<SatPhyTx>, CulledReceivers_s>::iterator it = m_culledReceivers.find (phyTx);
+
+  if (it != m_culledReceivers.end ())
+    {
+      return it->second.m_receivers;
+    }
+
+  ObserveMobility (phyTx->GetMobility ());
+
+  // Link antenna gains towards all the receivers of the channel
+  std::vector<double> gains (m_phyRxContainer.size ());
+  double peakGain_W (0.0);
+
+  for (PhyRxContainer::const_iterator rxIt = m_phyRxContainer.begin (); rxIt != m_phyRxContainer.end (); ++rxIt)
+    {
+      ObserveMobility ((*rxIt)->GetMobility ());
+    }
+
+  switch (m_channelType)
+    {
+    case SatEnums::RETURN_FEEDER_CH:
+    case SatEnums::FORWARD_USER_CH:
+      {
+        /**
+         * The receiver positions are used, thus the transmitter gains towards
+         * all the receivers are looked up from its pattern with one batch call.
+         */
+        std::vector<GeoCoordinate> positions;
+        positions.reserve (m_phyRxContainer.size ());
+
+        for (PhyRxContainer::const_iterator rxIt = m_phyRxContainer.begin (); rxIt != m_phyRxContainer.end (); ++rxIt)
+          {
+            positions.push_back (DynamicCast<SatMobilityModel> ((*rxIt)->GetMobility ())->GetGeoPosition ());
+          }
+
+        if (!positions.empty ())
+          {
+            phyTx->GetAntennaGains (&positions[0], positions.size (), &gains[0]);
+          }
+
+        for (uint32_t i = 0; i < m_phyRxContainer.size (); ++i)
+          {
+            gains[i] *= m_phyRxContainer[i]->GetAntennaGain (positions[i]);
+          }
+        break;
+      }
+    default:
+      {
+        for (uint32_t i = 0; i < m_phyRxContainer.size (); ++i)
+          {
+            gains[i] = GetLinkAntennaGain (phyTx, m_phyRxContainer[i]);
+          }
+        break;
+      }
+    }
+
+  for (uint32_t i = 0; i < gains.size (); ++i)
+    {
+      peakGain_W = std::max (peakGain_W, gains[i]);
+    }
+
+  double thresholdGain_W = peakGain_W * SatUtils::DbToLinear (m_receiverCullingThresholdDb);
+
+  CulledReceivers_s entry;
+  entry.m_culledCount = 0;
+  double culledGain_W (0.0);
+
+  for (uint32_t i = 0; i < m_phyRxContainer.size (); ++i)
+    {
+      // Receivers of the transmitting beam are never culled
+      if (m_phyRxContainer[i]->GetBeamId () == txParams->m_beamId || gains[i] >= thresholdGain_W)
+        {
+          entry.m_receivers.push_back (m_phyRxContainer[i]);
+        }
+      else
+        {
+          entry.m_culledCount++;
+          culledGain_W += gains[i];
+        }
+    }
+
+  entry.m_culledGainDb = (culledGain_W > 0.0 && peakGain_W > 0.0) ?
+    SatUtils::LinearToDb (culledGain_W / peakGain_W) : -std::numeric_limits<double>::infinity ();
+
+  NS_LOG_INFO ("SatChannel::GetCulledReceivers - beam: " << txParams->m_beamId <<
+               ", delivered: " << entry.m_receivers.size () <<
+               ", culled: " << entry.m_culledCount <<
+               ", aggregate culled gain: " << entry.m_culledGainDb << " dB" <<
+               ", channelType: " << SatEnums::GetChannelTypeName (m_channelType));
+
+  m_receiverCullingTrace (txParams->m_beamId, entry.m_receivers.size (), entry.m_culledCount, entry.m_culledGainDb);
+
+  it = m_culledReceivers.insert (std::make_pair (phyTx, entry)).first;
+  return it->second.m_receivers;
+}
+
+void
+SatChannel::ObserveMobility (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+
+  Ptr<SatMobilityModel> satMobility = DynamicCast<SatMobilityModel> (mobility);
+
+  if (satMobility && m_observedMobilities.insert (satMobility).second)
+    {
+      satMobility->TraceConnectWithoutContext ("SatCourseChange", MakeCallback (&SatChannel::MobilityChanged, this));
+    }
+}
+
+void
+SatChannel::MobilityChanged (Ptr<const SatMobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+
+  m_culledReceivers.clear ();
+
+  // Remove the cached link budgets of the links the mobility model belongs to
+  std::map<LinkBudgetKey_t, LinkBudget_s>::iterator it = m_linkBudgetCache.begin ();
+
+  while (it != m_linkBudgetCache.end ())
+    {
+      if (PeekPointer (it->second.m_txMobility) == PeekPointer (mobility)
+          || PeekPointer (it->second.m_rxMobility) == PeekPointer (mobility))
+        {
+          m_linkBudgetCache.erase (it++);
+        }
+      else
+        {
+          ++it;
+        }
+    }
 }
 
 void
@@ -263,14 +539,86 @@ SatChannel::ScheduleRx (Ptr<SatSignalParameters> txParams, Ptr<SatPhyRx> receive
 {
   NS_LOG_FUNCTION (this << txParams << receiver);
 
+  Time delay = GetRxDelay (txParams, receiver);
+
+  NS_LOG_INFO ("copying signal parameters " << txParams);
+  Ptr<SatSignalParameters> rxParams = txParams->Copy ();
+
+  NS_LOG_INFO ("Time: " << Simulator::Now ().GetSeconds () << ": setting propagation delay: " << delay);
+
+  /**
+   * In batched delivery mode the receivers are only collected here into
+   * delay groups and the groups are scheduled by FlushBatchedRx at the end
+   * of StartTx.
+   */
+  if (m_enableBatchedDelivery)
+    {
+      m_pendingRxBatches[delay].push_back (std::make_pair (rxParams, receiver));
+      return;
+    }
+
+  Ptr<NetDevice> netDev = receiver->GetDevice ();
+  uint32_t dstNodeId =  netDev->GetNode ()->GetId ();
+  Simulator::ScheduleWithContext (dstNodeId, delay, &SatChannel::StartRx, this, rxParams, receiver);
+}
+
+void
+SatChannel::FlushBatchedRx ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (std::map<Time, RxBatch_t>::const_iterator it = m_pendingRxBatches.begin ();
+       it != m_pendingRxBatches.end ();
+       ++it)
+    {
+      uint32_t dstNodeId = it->second.front ().second->GetDevice ()->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNodeId, it->first, &SatChannel::StartRxBatch, this, it->second);
+    }
+
+  m_pendingRxBatches.clear ();
+}
+
+void
+SatChannel::StartRxBatch (RxBatch_t batch)
+{
+  NS_LOG_FUNCTION (this << batch.size ());
+
+  m_rxBatchTrace (m_channelType, batch.size ());
+
+  /**
+   * The static link budgets of a large enough group are evaluated in parallel
+   * beforehand. The receptions are still started one by one in the receiver
+   * order, so the fading and the traces are evaluated as sequentially.
+   */
+  if (m_parallelLinkBudgetThreads > 1
+      && m_rxPowerCalculationMode == SatEnums::RX_PWR_CALCULATION
+      && batch.size () >= m_parallelLinkBudgetMinBatchSize)
+    {
+      std::vector<LinkBudget_s> linkBudgets = CalculateLinkBudgets (batch);
+
+      for (uint32_t i = 0; i < batch.size (); ++i)
+        {
+          DoStartRx (batch[i].first, batch[i].second, &linkBudgets[i]);
+        }
+      return;
+    }
+
+  for (RxBatch_t::const_iterator it = batch.begin (); it != batch.end (); ++it)
+    {
+      StartRx (it->first, it->second);
+    }
+}
+
+Time
+SatChannel::GetRxDelay (Ptr<SatSignalParameters> txParams, Ptr<SatPhyRx> receiver)
+{
+  NS_LOG_FUNCTION (this << txParams << receiver);
+
   Time delay = Seconds (0);
 
   Ptr<MobilityModel> senderMobility = txParams->m_phyTx->GetMobility ();
   Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
 
-  NS_LOG_INFO ("copying signal parameters " << txParams);
-  Ptr<SatSignalParameters> rxParams = txParams->Copy ();
-
   if (m_propagationDelay)
     {
       delay = m_propagationDelay->GetDelay (senderMobility, receiverMobility);
@@ -298,7 +646,7 @@ SatChannel::ScheduleRx (Ptr<SatSignalParameters> txParams, Ptr<SatPhyRx> receive
               }
             else
               {
-                NS_FATAL_ERROR ("SatChannel::ScheduleRx - PHY packet burst duration " << (txParams->m_duration).GetSeconds () <<  "s is longer than one-link propagation delay " << delay.GetSeconds () << "s!");
+                NS_FATAL_ERROR ("SatChannel::GetRxDelay - PHY packet burst duration " << (txParams->m_duration).GetSeconds () <<  "s is longer than one-link propagation delay " << delay.GetSeconds () << "s!");
               }
             break;
           }
@@ -315,14 +663,10 @@ SatChannel::ScheduleRx (Ptr<SatSignalParameters> txParams, Ptr<SatPhyRx> receive
    */
   else
     {
-      NS_FATAL_ERROR ("SatChannel::ScheduleRx - propagation delay model not set!");
+      NS_FATAL_ERROR ("SatChannel::GetRxDelay - propagation delay model not set!");
     }
 
-  NS_LOG_INFO ("Time: " << Simulator::Now ().GetSeconds () << ": setting propagation delay: " << delay);
-
-  Ptr<NetDevice> netDev = receiver->GetDevice ();
-  uint32_t dstNodeId =  netDev->GetNode ()->GetId ();
-  Simulator::ScheduleWithContext (dstNodeId, delay, &SatChannel::StartRx, this, rxParams, receiver);
+  return delay;
 }
 
 void
@@ -330,6 +674,14 @@ SatChannel::StartRx (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
 {
   NS_LOG_FUNCTION (this << rxParams << phyRx);
 
+  DoStartRx (rxParams, phyRx, 0);
+}
+
+void
+SatChannel::DoStartRx (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx, const LinkBudget_s *linkBudget)
+{
+  NS_LOG_FUNCTION (this << rxParams << phyRx << linkBudget);
+
   rxParams->m_channelType = m_channelType;
 
   double frequency_hz = m_carrierFreqConverter (m_channelType, m_freqId, rxParams->m_carrierId);
@@ -339,7 +691,7 @@ SatChannel::StartRx (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
     {
     case SatEnums::RX_PWR_CALCULATION:
       {
-        DoRxPowerCalculation (rxParams, phyRx);
+        DoRxPowerCalculation (rxParams, phyRx, linkBudget);
 
         if (m_enableRxPowerOutputTrace)
           {
@@ -354,7 +706,7 @@ SatChannel::StartRx (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
       }
     default:
       {
-        NS_FATAL_ERROR ("SatChannel::StartRx - Invalid Rx power calculation mode");
+        NS_FATAL_ERROR ("SatChannel::DoStartRx - Invalid Rx power calculation mode");
         break;
       }
     }
@@ -392,7 +744,7 @@ SatChannel::DoRxPowerOutputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyR
     case SatEnums::FORWARD_FEEDER_CH:
     case SatEnums::RETURN_USER_CH:
       {
-        Singleton<SatRxPowerOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (GetSourceAddress (rxParams), m_channelType), tempVector);
+        Singleton<SatRxPowerOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (rxParams->m_sourceAddress, m_channelType), tempVector);
         break;
       }
     default:
@@ -425,7 +777,7 @@ SatChannel::DoRxPowerInputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx
     case SatEnums::RETURN_USER_CH:
       {
         // Calculate the Rx power from Rx power density
-        rxParams->m_rxPower_W = carrierBandwidthHz * Singleton<SatRxPowerInputTraceContainer>::Get ()->GetRxPowerDensity (std::make_pair (GetSourceAddress (rxParams), m_channelType));
+        rxParams->m_rxPower_W = carrierBandwidthHz * Singleton<SatRxPowerInputTraceContainer>::Get ()->GetRxPowerDensity (std::make_pair (rxParams->m_sourceAddress, m_channelType));
         break;
       }
     default:
@@ -467,7 +819,7 @@ SatChannel::DoFadingOutputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx
     case SatEnums::FORWARD_FEEDER_CH:
     case SatEnums::RETURN_USER_CH:
       {
-        Singleton<SatFadingOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (GetSourceAddress (rxParams), m_channelType), tempVector);
+        Singleton<SatFadingOutputTraceContainer>::Get ()->AddToContainer (std::make_pair (rxParams->m_sourceAddress, m_channelType), tempVector);
         break;
       }
     default:
@@ -479,35 +831,34 @@ SatChannel::DoFadingOutputTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx
 }
 
 void
-SatChannel::DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
+SatChannel::DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx, const LinkBudget_s *precalculatedLinkBudget)
 {
-  NS_LOG_FUNCTION (this << rxParams << phyRx);
-
-  Ptr<MobilityModel> txMobility = rxParams->m_phyTx->GetMobility ();
-  Ptr<MobilityModel> rxMobility = phyRx->GetMobility ();
+  NS_LOG_FUNCTION (this << rxParams << phyRx << precalculatedLinkBudget);
 
-  double txAntennaGain_W = 0.0;
-  double rxAntennaGain_W = 0.0;
   double markovFading = 0.0;
   double extFading = 1.0;
 
-  // use always UT's or GW's position when getting antenna gain
+  /**
+   * The static part of the link budget (antenna gains, free space loss and
+   * losses) is either precalculated, or fetched from the cache if enabled,
+   * so that only fading is evaluated per packet.
+   */
+  const LinkBudget_s linkBudget = precalculatedLinkBudget ? *precalculatedLinkBudget :
+    m_enableLinkBudgetCache ? GetCachedLinkBudget (rxParams, phyRx) :
+    CalculateLinkBudget (rxParams->m_phyTx, phyRx, rxParams->m_carrierFreq_hz);
+
   switch (m_channelType)
     {
     case SatEnums::RETURN_FEEDER_CH:
     case SatEnums::FORWARD_USER_CH:
       {
-        txAntennaGain_W = rxParams->m_phyTx->GetAntennaGain (rxMobility);
-        rxAntennaGain_W = phyRx->GetAntennaGain (rxMobility);
         markovFading = phyRx->GetFadingValue (phyRx->GetDevice ()->GetAddress (), m_channelType);
         break;
       }
     case SatEnums::RETURN_USER_CH:
     case SatEnums::FORWARD_FEEDER_CH:
       {
-        txAntennaGain_W = rxParams->m_phyTx->GetAntennaGain (txMobility);
-        rxAntennaGain_W = phyRx->GetAntennaGain (txMobility);
-        markovFading = rxParams->m_phyTx->GetFadingValue (GetSourceAddress (rxParams), m_channelType);
+        markovFading = rxParams->m_phyTx->GetFadingValue (rxParams->m_sourceAddress, m_channelType);
         break;
       }
     default:
@@ -538,9 +889,205 @@ SatChannel::DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyR
       DoFadingOutputTrace (rxParams, phyRx, markovFading);
     }
 
-  // get (calculate) free space loss and RX power and set it to RX params
-  double rxPower_W = (rxParams->m_txPower_W * txAntennaGain_W) / m_freeSpaceLoss->GetFsl (txMobility, rxMobility, rxParams->m_carrierFreq_hz);
-  rxParams->m_rxPower_W = rxPower_W * rxAntennaGain_W / phyRx->GetLosses () * markovFading / extFading;
+  // calculate RX power and set it to RX params
+  double rxPower_W = (rxParams->m_txPower_W * linkBudget.m_txAntennaGain_W) / linkBudget.m_fsl;
+  rxParams->m_rxPower_W = rxPower_W * linkBudget.m_rxAntennaGain_W / linkBudget.m_losses * markovFading / extFading;
+}
+
+SatChannel::LinkBudget_s
+SatChannel::CalculateLinkBudget (Ptr<SatPhyTx> phyTx, Ptr<SatPhyRx> phyRx, double carrierFreq_hz)
+{
+  NS_LOG_FUNCTION (this << phyTx << phyRx << carrierFreq_hz);
+
+  LinkBudget_s linkBudget;
+  linkBudget.m_txMobility = phyTx->GetMobility ();
+  linkBudget.m_rxMobility = phyRx->GetMobility ();
+
+  // use always UT's or GW's position when getting antenna gain
+  switch (m_channelType)
+    {
+    case SatEnums::RETURN_FEEDER_CH:
+    case SatEnums::FORWARD_USER_CH:
+      {
+        linkBudget.m_txAntennaGain_W = phyTx->GetAntennaGain (linkBudget.m_rxMobility);
+        linkBudget.m_rxAntennaGain_W = phyRx->GetAntennaGain (linkBudget.m_rxMobility);
+        break;
+      }
+    case SatEnums::RETURN_USER_CH:
+    case SatEnums::FORWARD_FEEDER_CH:
+      {
+        linkBudget.m_txAntennaGain_W = phyTx->GetAntennaGain (linkBudget.m_txMobility);
+        linkBudget.m_rxAntennaGain_W = phyRx->GetAntennaGain (linkBudget.m_txMobility);
+        break;
+      }
+    default:
+      {
+        NS_FATAL_ERROR ("SatChannel::CalculateLinkBudget - Invalid channel type");
+        break;
+      }
+    }
+
+  linkBudget.m_fsl = m_freeSpaceLoss->GetFsl (linkBudget.m_txMobility, linkBudget.m_rxMobility, carrierFreq_hz);
+  linkBudget.m_losses = phyRx->GetLosses ();
+
+  return linkBudget;
+}
+
+const SatChannel::LinkBudget_s&
+SatChannel::GetCachedLinkBudget (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx)
+{
+  NS_LOG_FUNCTION (this << rxParams << phyRx);
+
+  LinkBudgetKey_t key = std::make_pair (std::make_pair (rxParams->m_phyTx, phyRx), rxParams->m_carrierId);
+  std::map<LinkBudgetKey_t, LinkBudget_s>::iterator it = m_linkBudgetCache.find (key);
+
+  if (it == m_linkBudgetCache.end ())
+    {
+      LinkBudget_s linkBudget = CalculateLinkBudget (rxParams->m_phyTx, phyRx, rxParams->m_carrierFreq_hz);
+
+      ObserveMobility (linkBudget.m_txMobility);
+      ObserveMobility (linkBudget.m_rxMobility);
+
+      it = m_linkBudgetCache.insert (std::make_pair (key, linkBudget)).first;
+    }
+
+  return it->second;
+}
+
+std::vector<SatChannel::LinkBudget_s>
+SatChannel::CalculateLinkBudgets (const RxBatch_t& batch)
+{
+  NS_LOG_FUNCTION (this << batch.size ());
+
+  std::vector<LinkBudget_s> linkBudgets (batch.size ());
+  std::vector<LinkBudgetInput_s> inputs;
+  std::vector<uint32_t> inputIndexes;
+
+  /**
+   * Gather the inputs in the event loop thread. The positions are read here,
+   * since the mobility models update their positions lazily and the workers
+   * must not copy any Ptr.
+   */
+  for (uint32_t i = 0; i < batch.size (); ++i)
+    {
+      Ptr<SatSignalParameters> rxParams = batch[i].first;
+      Ptr<SatPhyRx> phyRx = batch[i].second;
+      double carrierFreq_hz = m_carrierFreqConverter (m_channelType, m_freqId, rxParams->m_carrierId);
+
+      if (m_enableLinkBudgetCache)
+        {
+          LinkBudgetKey_t key = std::make_pair (std::make_pair (rxParams->m_phyTx, phyRx), rxParams->m_carrierId);
+          std::map<LinkBudgetKey_t, LinkBudget_s>::const_iterator it = m_linkBudgetCache.find (key);
+
+          if (it != m_linkBudgetCache.end ())
+            {
+              linkBudgets[i] = it->second;
+              continue;
+            }
+        }
+
+      LinkBudget_s& linkBudget = linkBudgets[i];
+      linkBudget.m_txMobility = rxParams->m_phyTx->GetMobility ();
+      linkBudget.m_rxMobility = phyRx->GetMobility ();
+      linkBudget.m_losses = phyRx->GetLosses ();
+
+      LinkBudgetInput_s input;
+      input.m_phyTx = PeekPointer (rxParams->m_phyTx);
+      input.m_phyRx = PeekPointer (phyRx);
+      input.m_txPosition = linkBudget.m_txMobility->GetPosition ();
+      input.m_rxPosition = linkBudget.m_rxMobility->GetPosition ();
+      input.m_carrierFreq_hz = carrierFreq_hz;
+
+      // use always UT's or GW's position when getting antenna gain
+      switch (m_channelType)
+        {
+        case SatEnums::RETURN_FEEDER_CH:
+        case SatEnums::FORWARD_USER_CH:
+          {
+            input.m_terminalPosition = DynamicCast<SatMobilityModel> (linkBudget.m_rxMobility)->GetGeoPosition ();
+            break;
+          }
+        case SatEnums::RETURN_USER_CH:
+        case SatEnums::FORWARD_FEEDER_CH:
+          {
+            input.m_terminalPosition = DynamicCast<SatMobilityModel> (linkBudget.m_txMobility)->GetGeoPosition ();
+            break;
+          }
+        default:
+          {
+            NS_FATAL_ERROR ("SatChannel::CalculateLinkBudgets - Invalid channel type");
+            break;
+          }
+        }
+
+      inputs.push_back (input);
+      inputIndexes.push_back (i);
+    }
+
+  // each task writes only its own link budget
+  Singleton<SatThreadPool>::Get ()->ParallelFor (m_parallelLinkBudgetThreads, inputs.size (),
+                                                 [this, &inputs, &inputIndexes, &linkBudgets] (uint32_t j)
+                                                 {
+                                                   EvaluateLinkBudget (inputs[j], linkBudgets[inputIndexes[j]]);
+                                                 });
+
+  if (m_enableLinkBudgetCache)
+    {
+      for (std::vector<uint32_t>::const_iterator it = inputIndexes.begin (); it != inputIndexes.end (); ++it)
+        {
+          const LinkBudget_s& linkBudget = linkBudgets[*it];
+          LinkBudgetKey_t key = std::make_pair (std::make_pair (batch[*it].first->m_phyTx, batch[*it].second), batch[*it].first->m_carrierId);
+
+          ObserveMobility (linkBudget.m_txMobility);
+          ObserveMobility (linkBudget.m_rxMobility);
+
+          m_linkBudgetCache.insert (std::make_pair (key, linkBudget));
+        }
+    }
+
+  return linkBudgets;
+}
+
+void
+SatChannel::EvaluateLinkBudget (const LinkBudgetInput_s& input, LinkBudget_s& linkBudget) const
+{
+  linkBudget.m_txAntennaGain_W = input.m_phyTx->GetAntennaGain (input.m_terminalPosition);
+  linkBudget.m_rxAntennaGain_W = input.m_phyRx->GetAntennaGain (input.m_terminalPosition);
+  linkBudget.m_fsl = m_freeSpaceLoss->GetFsl (CalculateDistance (input.m_txPosition, input.m_rxPosition), input.m_carrierFreq_hz);
+}
+
+double
+SatChannel::GetLinkAntennaGain (Ptr<SatPhyTx> phyTx, Ptr<SatPhyRx> phyRx)
+{
+  NS_LOG_FUNCTION (this << phyTx << phyRx);
+
+  double gain_W = 0.0;
+
+  // use always UT's or GW's position when getting antenna gain
+  switch (m_channelType)
+    {
+    case SatEnums::RETURN_FEEDER_CH:
+    case SatEnums::FORWARD_USER_CH:
+      {
+        Ptr<MobilityModel> rxMobility = phyRx->GetMobility ();
+        gain_W = phyTx->GetAntennaGain (rxMobility) * phyRx->GetAntennaGain (rxMobility);
+        break;
+      }
+    case SatEnums::RETURN_USER_CH:
+    case SatEnums::FORWARD_FEEDER_CH:
+      {
+        Ptr<MobilityModel> txMobility = phyTx->GetMobility ();
+        gain_W = phyTx->GetAntennaGain (txMobility) * phyRx->GetAntennaGain (txMobility);
+        break;
+      }
+    default:
+      {
+        NS_FATAL_ERROR ("SatChannel::GetLinkAntennaGain - Invalid channel type");
+        break;
+      }
+    }
+
+  return gain_W;
 }
 
 double
@@ -567,13 +1114,13 @@ SatChannel::GetExternalFadingTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPh
       }
     case SatEnums::RETURN_USER_CH:
       {
-        nodeId = Singleton<SatIdMapper>::Get ()->GetUtIdWithMac (GetSourceAddress (rxParams));
+        nodeId = rxParams->m_sourceUtId;
         mobility = rxParams->m_phyTx->GetMobility ();
         break;
       }
     case SatEnums::FORWARD_FEEDER_CH:
       {
-        nodeId = Singleton<SatIdMapper>::Get ()->GetGwIdWithMac (GetSourceAddress (rxParams));
+        nodeId = rxParams->m_sourceGwId;
         mobility = rxParams->m_phyTx->GetMobility ();
         break;
       }
@@ -592,26 +1139,6 @@ SatChannel::GetExternalFadingTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPh
   return (Singleton<SatFadingExternalInputTraceContainer>::Get ()->GetFadingTrace ((uint32_t)nodeId, m_channelType, mobility))->GetFading ();
 }
 
-/// TODO get rid of source MAC address peeking
-Mac48Address
-SatChannel::GetSourceAddress (Ptr<SatSignalParameters> rxParams)
-{
-  NS_LOG_FUNCTION (this << rxParams);
-
-  SatMacTag tag;
-
-  SatSignalParameters::PacketsInBurst_t::const_iterator i = rxParams->m_packetsInBurst.begin ();
-
-  if (*i == NULL)
-    {
-      NS_FATAL_ERROR ("SatChannel::GetSourceAddress - Empty packet list");
-    }
-
-  (*i)->PeekPacketTag (tag);
-
-  return tag.GetSourceAddress ();
-}
-
 void
 SatChannel::SetChannelType (SatEnums::ChannelType_t chType)
 {
@@ -671,6 +1198,20 @@ SatChannel::GetPropagationDelayModel ()
   return m_propagationDelay;
 }
 
+void
+SatChannel::SetCoChannelActivity (Ptr<SatCoChannelActivity> activity)
+{
+  NS_LOG_FUNCTION (this << activity);
+  m_coChannelActivity = activity;
+}
+
+Ptr<SatCoChannelActivity>
+SatChannel::GetCoChannelActivity () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_coChannelActivity;
+}
+
 void
 SatChannel::SetFreeSpaceLoss (Ptr<SatFreeSpaceLoss> loss)
 {
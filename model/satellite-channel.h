@@ -22,6 +22,8 @@
 #ifndef SATELLITE_CHANNEL_H
 #define SATELLITE_CHANNEL_H
 
+#include <map>
+#include <set>
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "ns3/channel.h"
@@ -30,7 +32,10 @@
 #include "satellite-signal-parameters.h"
 #include "satellite-free-space-loss.h"
 #include "satellite-phy-rx.h"
+#include "satellite-phy-tx.h"
+#include "satellite-mobility-model.h"
 #include "satellite-phy-rx-carrier-conf.h"
+#include "satellite-co-channel-activity.h"
 #include "satellite-enums.h"
 #include "satellite-typedefs.h"
 
@@ -56,6 +61,36 @@ namespace ns3 {
  *   and fading (Markov/Loo)
  * - Handle the fading input/output trace functionality
  *
+ * In ALL_BEAMS forwarding mode the receivers may optionally be culled per
+ * transmitter: only the receivers whose antenna gain towards the transmitter
+ * is within a configured threshold from the strongest link of the transmitter
+ * (i.e. the beam peak sampled by the receivers) receive the packet. Receivers
+ * in the transmitting beam are never culled. The culled receiver sets are
+ * rebuilt lazily when any of the related mobility models fires SatCourseChange.
+ *
+ * With batched delivery enabled, the receivers of one transmission are grouped
+ * by propagation delay and only one reception event is scheduled per group.
+ * The receivers of a group are served in the same order as with per-receiver
+ * events, thus the simulation results are identical. A group contains the
+ * receivers of all the nodes, e.g. all the UTs of the forward user link, and
+ * its event runs in the context of the node of the first receiver. The
+ * receiver carriers schedule the end of the reception in the context of their
+ * own node, thus the events following the reception run in the receiver node
+ * context as with per-receiver events.
+ *
+ * The static part of the link budget (antenna gains, free space loss and
+ * receiver losses) may be cached per transmitter, receiver and carrier. Then
+ * only the fading is evaluated per packet. The cached entries of a link are
+ * removed when the mobility model of either end fires SatCourseChange, thus
+ * the cache is mainly useful with fixed terminals.
+ *
+ * In batched delivery mode the static link budgets of a delay group may be
+ * evaluated in parallel by a pool of worker threads. The inputs (positions,
+ * carrier frequencies) are gathered and the results are consumed in the
+ * event loop thread in the receiver order, thus the fading, the random number
+ * generators and the traces are never touched by the workers and the results
+ * are identical to the sequential evaluation.
+ *
  */
 
 class SatChannel : public Channel
@@ -74,7 +109,8 @@ public:
 
   /**
    * ONLY_DEST_NODE = only the receivers to which this transmission is intended to shall receive the packet
-   * ONLY_DEST_BEAM = only the receivers within the proper spot-beam shall receive the packet
+   * ONLY_DEST_BEAM = only the receivers within the proper spot-beam shall receive the packet,
+   *                  co-channel interference may still be modeled with CoChannel interference model
    * ALL_BEAMS = all receivers in the channel shall receive the packet
    */
   enum SatChannelFwdMode_e
@@ -104,6 +140,29 @@ public:
    */
   typedef Callback<double, SatEnums::ChannelType_t, uint32_t, uint32_t  > CarrierFreqConverter;
 
+  /**
+   * Callback signature for `ReceiverCulling` trace source.
+   *
+   * \param beamId Beam id of the transmitter
+   * \param nDelivered Number of receivers kept in the delivery set
+   * \param nCulled Number of receivers culled from the delivery set
+   * \param culledGainDb Aggregate antenna gain of the culled receivers relative
+   *        to the strongest link of the transmitter in dB. This is an upper bound
+   *        for the co-channel interference (relative to the wanted signal at beam
+   *        peak) omitted due to culling.
+   */
+  typedef void (*ReceiverCullingCallback)
+    (uint32_t beamId, uint32_t nDelivered, uint32_t nCulled, double culledGainDb);
+
+  /**
+   * Callback signature for `RxBatch` trace source.
+   *
+   * \param channelType Type of the channel
+   * \param nReceivers Number of receptions started by the batched reception event
+   */
+  typedef void (*RxBatchCallback)
+    (SatEnums::ChannelType_t channelType, uint32_t nReceivers);
+
   /**
    * \brief Set the  propagation delay model to be used in the SatChannel
    * \param delay Ptr to the propagation delay model to be used.
@@ -116,6 +175,20 @@ public:
    */
   virtual Ptr<PropagationDelayModel> GetPropagationDelayModel ();
 
+  /**
+   * \brief Set the co-channel activity of the channel. The activity is
+   * used by co-channel interference model to calculate interference without
+   * delivering the packets to the receivers of the other beams.
+   * \param activity Co-channel activity of the channel
+   */
+  virtual void SetCoChannelActivity (Ptr<SatCoChannelActivity> activity);
+
+  /**
+   * \brief Get the co-channel activity of the channel
+   * \return Co-channel activity of the channel, NULL if not set
+   */
+  virtual Ptr<SatCoChannelActivity> GetCoChannelActivity () const;
+
   /**
    * \brief Set the type of the channel.
    * \param chType Type of the channel.
@@ -224,6 +297,11 @@ private:
    */
   Ptr<PropagationDelayModel> m_propagationDelay;
 
+  /**
+   * \brief Co-channel activity of the channel
+   */
+  Ptr<SatCoChannelActivity> m_coChannelActivity;
+
   /**
    * \brief Free space loss model to be used with this channel.
    */
@@ -249,6 +327,145 @@ private:
    */
   bool m_enableExternalFadingInputTrace;
 
+  /**
+   * \brief Defines whether receivers are culled based on the antenna gain
+   * in ALL_BEAMS forwarding mode
+   */
+  bool m_enableReceiverCulling;
+
+  /**
+   * \brief Culling threshold in dB relative to the strongest link of the
+   * transmitter. Receivers with lower link antenna gain are not delivered
+   * the transmission.
+   */
+  double m_receiverCullingThresholdDb;
+
+  /**
+   * \brief Culled receiver set for a transmitter
+   */
+  typedef struct
+  {
+    PhyRxContainer m_receivers;
+    uint32_t m_culledCount;
+    double m_culledGainDb;
+  } CulledReceivers_s;
+
+  /**
+   * \brief Culled receiver sets for each transmitter of the channel
+   */
+  std::map<Ptr<SatPhyTx>, CulledReceivers_s> m_culledReceivers;
+
+  /**
+   * \brief Mobility models observed for SatCourseChange in order to
+   * invalidate the culled receiver sets
+   */
+  std::set<Ptr<SatMobilityModel> > m_observedMobilities;
+
+  /**
+   * \brief Trace fired when a culled receiver set is (re)built
+   */
+  TracedCallback<uint32_t, uint32_t, uint32_t, double> m_receiverCullingTrace;
+
+  /**
+   * \brief Defines whether receptions of one transmission are delivered with
+   * one event per propagation delay group instead of one event per receiver
+   */
+  bool m_enableBatchedDelivery;
+
+  /**
+   * \brief Receptions delivered by one batched reception event
+   */
+  typedef std::vector<std::pair<Ptr<SatSignalParameters>, Ptr<SatPhyRx> > > RxBatch_t;
+
+  /**
+   * \brief Receptions of the ongoing StartTx call grouped by propagation delay
+   */
+  std::map<Time, RxBatch_t> m_pendingRxBatches;
+
+  /**
+   * \brief Trace fired when a batched reception event starts the receptions
+   * of a delay group
+   */
+  TracedCallback<SatEnums::ChannelType_t, uint32_t> m_rxBatchTrace;
+
+  /**
+   * \brief Defines whether the static part of the link budget is cached
+   */
+  bool m_enableLinkBudgetCache;
+
+  /**
+   * \brief Static part of the link budget of a link, i.e. everything else
+   * than the fading.
+   */
+  typedef struct
+  {
+    double m_txAntennaGain_W;
+    double m_rxAntennaGain_W;
+    double m_fsl;
+    double m_losses;
+    Ptr<MobilityModel> m_txMobility;
+    Ptr<MobilityModel> m_rxMobility;
+  } LinkBudget_s;
+
+  /**
+   * \brief Link budget cache key: transmitter, receiver and carrier id
+   */
+  typedef std::pair<std::pair<Ptr<SatPhyTx>, Ptr<SatPhyRx> >, uint32_t> LinkBudgetKey_t;
+
+  /**
+   * \brief Cached static link budgets. The entries of a link are removed when
+   * either of the link end mobility models fires SatCourseChange.
+   */
+  std::map<LinkBudgetKey_t, LinkBudget_s> m_linkBudgetCache;
+
+  /**
+   * \brief Number of threads used to evaluate the link budgets of a batched
+   * delivery group. One means sequential evaluation.
+   */
+  uint32_t m_parallelLinkBudgetThreads;
+
+  /**
+   * \brief Minimum size of a batched delivery group evaluated in parallel
+   */
+  uint32_t m_parallelLinkBudgetMinBatchSize;
+
+  /**
+   * \brief Inputs of the static link budget of a link gathered in the event
+   * loop thread for the parallel evaluation. Only raw pointers are used, since
+   * the reference counts of the objects must not be touched by the workers.
+   */
+  typedef struct
+  {
+    const SatPhyTx *m_phyTx;
+    const SatPhyRx *m_phyRx;
+    GeoCoordinate m_terminalPosition;
+    Vector m_txPosition;
+    Vector m_rxPosition;
+    double m_carrierFreq_hz;
+  } LinkBudgetInput_s;
+
+  /**
+   * \brief Indexes to the receiver container
+   */
+  typedef std::vector<uint32_t> RxIndexes_t;
+
+  /**
+   * \brief Defines whether the receiver indexes need to be rebuilt. The
+   * indexes are rebuilt lazily since the MAC address and beam id of a
+   * receiver are configured only after it has been added to the channel.
+   */
+  bool m_rxIndexesOutdated;
+
+  /**
+   * \brief Receiver indexes by receiver MAC address
+   */
+  std::map<Mac48Address, RxIndexes_t> m_addressRxIndexes;
+
+  /**
+   * \brief Receiver indexes by receiver beam id
+   */
+  std::map<uint32_t, RxIndexes_t> m_beamRxIndexes;
+
   /**
    * Dispose SatChannel.
    */
@@ -261,6 +478,29 @@ private:
    */
   void ScheduleRx (Ptr<SatSignalParameters> txParams, Ptr<SatPhyRx> phyRx);
 
+  /**
+   * \brief Calculate the propagation delay from the transmitter to the receiver.
+   * In transparent satellite links the delay is reduced by the burst duration.
+   * \param txParams Parameters of the signal being transmitted
+   * \param receiver The receiver SatPhyRx entity
+   * \return propagation delay
+   */
+  Time GetRxDelay (Ptr<SatSignalParameters> txParams, Ptr<SatPhyRx> receiver);
+
+  /**
+   * \brief Schedule one reception event for each collected delay group in
+   * the context of the node of the first receiver of the group. Used in
+   * batched delivery mode at the end of StartTx.
+   */
+  void FlushBatchedRx ();
+
+  /**
+   * \brief Start the packet reception for all the receivers of a delay group
+   * in the order they were collected.
+   * \param batch Receptions of the delay group
+   */
+  void StartRxBatch (RxBatch_t batch);
+
   /**
    * \brief Used internally to start the packet reception of at the phyRx.
    *
@@ -269,6 +509,14 @@ private:
    */
   void StartRx (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx);
 
+  /**
+   * \brief Start the packet reception at the phyRx.
+   * \param rxParams Parameters of the signal being received
+   * \param phyRx The receiver SatPhyRx entity
+   * \param linkBudget Precalculated static link budget or NULL
+   */
+  void DoStartRx (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx, const LinkBudget_s *linkBudget);
+
   /**
    * \brief Function for Rx power output trace
    * \param rxParams Rx parameters
@@ -295,8 +543,9 @@ private:
    * \brief Function for calculating the Rx power
    * \param rxParams Rx parameters
    * \param phyRx The receiver SatPhyRx entity
+   * \param linkBudget Precalculated static link budget or NULL
    */
-  void DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx);
+  void DoRxPowerCalculation (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx, const LinkBudget_s *linkBudget);
 
   /**
    * \brief Function for getting the external source fading value
@@ -307,11 +556,83 @@ private:
   double GetExternalFadingTrace (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx);
 
   /**
-   * \brief Function for getting the source MAC address from Rx parameters
+   * \brief Get the combined transmit and receive antenna gain of a link.
+   * The position of the terrestrial end (UT or GW) is always used.
+   * \param phyTx The transmitter SatPhyTx entity
+   * \param phyRx The receiver SatPhyRx entity
+   * \return link antenna gain in linear format
+   */
+  double GetLinkAntennaGain (Ptr<SatPhyTx> phyTx, Ptr<SatPhyRx> phyRx);
+
+  /**
+   * \brief Rebuild the receiver address and beam indexes, if outdated.
+   */
+  void UpdateRxIndexes ();
+
+  /**
+   * \brief Schedule the reception for the receivers with given indexes.
+   * \param txParams Parameters of the signal being transmitted
+   * \param indexes Indexes of the receivers in the receiver container
+   */
+  void ScheduleRxForIndexes (Ptr<SatSignalParameters> txParams, const RxIndexes_t& indexes);
+
+  /**
+   * \brief Get the culled receiver set of a transmitter. The set is built
+   * on the first call and after every invalidation.
+   * \param txParams Tx parameters
+   * \return receivers to which the transmission shall be delivered
+   */
+  const PhyRxContainer& GetCulledReceivers (Ptr<SatSignalParameters> txParams);
+
+  /**
+   * \brief Connect to the SatCourseChange trace of a mobility model, if not
+   * connected already.
+   * \param mobility Mobility model to observe
+   */
+  void ObserveMobility (Ptr<MobilityModel> mobility);
+
+  /**
+   * \brief Invalidate all culled receiver sets and the cached link budgets
+   * of the links of the mobility model. Called by SatCourseChange trace.
+   * \param mobility The mobility model which changed course
+   */
+  void MobilityChanged (Ptr<const SatMobilityModel> mobility);
+
+  /**
+   * \brief Calculate the static part of the link budget.
+   * \param phyTx The transmitter SatPhyTx entity
+   * \param phyRx The receiver SatPhyRx entity
+   * \param carrierFreq_hz Carrier center frequency
+   * \return the static link budget
+   */
+  LinkBudget_s CalculateLinkBudget (Ptr<SatPhyTx> phyTx, Ptr<SatPhyRx> phyRx, double carrierFreq_hz);
+
+  /**
+   * \brief Get the static part of the link budget from the cache. The link
+   * budget is calculated and stored to the cache, if not found.
    * \param rxParams Rx parameters
-   * \return source MAC address
+   * \param phyRx The receiver SatPhyRx entity
+   * \return the static link budget
+   */
+  const LinkBudget_s& GetCachedLinkBudget (Ptr<SatSignalParameters> rxParams, Ptr<SatPhyRx> phyRx);
+
+  /**
+   * \brief Calculate the static link budgets of a batched delivery group in
+   * parallel. Cached link budgets are used and the calculated ones are stored
+   * to the cache, if the cache is enabled.
+   * \param batch Receptions of the delay group
+   * \return the static link budgets in the order of the batch
+   */
+  std::vector<LinkBudget_s> CalculateLinkBudgets (const RxBatch_t& batch);
+
+  /**
+   * \brief Evaluate the static part of the link budget from the gathered
+   * inputs. Called by the worker threads, thus only the given inputs and
+   * const methods without side effects may be used.
+   * \param input Inputs of the link budget
+   * \param linkBudget Link budget to fill (gains and free space loss)
    */
-  Mac48Address GetSourceAddress (Ptr<SatSignalParameters> rxParams);
+  void EvaluateLinkBudget (const LinkBudgetInput_s& input, LinkBudget_s& linkBudget) const;
 
 };
 
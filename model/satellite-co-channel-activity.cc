@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 Magister Solutions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "satellite-co-channel-activity.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatCoChannelActivity");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SatCoChannelActivity);
+
+TypeId
+SatCoChannelActivity::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatCoChannelActivity")
+    .SetParent<Object> ()
+    .AddAttribute ("RetentionTime",
+                   "Time after the end of a transmission for which it is kept for the interference calculation. "
+                   "Has to cover the propagation delays and the reception durations of the receivers.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&SatCoChannelActivity::m_retentionTime),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+SatCoChannelActivity::SatCoChannelActivity ()
+  : m_antennaPatterns (),
+    m_satelliteMobility (),
+    m_propagationDelay (),
+    m_transmissions (),
+    m_retentionTime (Seconds (1.0)),
+    m_maxDuration (Seconds (0)),
+    m_enabled (false)
+{
+  NS_LOG_FUNCTION (this);
+  NS_FATAL_ERROR ("SatCoChannelActivity::SatCoChannelActivity - Constructor not in use");
+}
+
+SatCoChannelActivity::SatCoChannelActivity (Ptr<SatAntennaGainPatternContainer> antennaPatterns,
+                                            Ptr<MobilityModel> satelliteMobility,
+                                            Ptr<PropagationDelayModel> propagationDelay)
+  : m_antennaPatterns (antennaPatterns),
+    m_satelliteMobility (satelliteMobility),
+    m_propagationDelay (propagationDelay),
+    m_transmissions (),
+    m_retentionTime (Seconds (1.0)),
+    m_maxDuration (Seconds (0)),
+    m_enabled (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SatCoChannelActivity::~SatCoChannelActivity ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatCoChannelActivity::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_antennaPatterns = 0;
+  m_satelliteMobility = 0;
+  m_propagationDelay = 0;
+  m_transmissions.clear ();
+
+  Object::DoDispose ();
+}
+
+void
+SatCoChannelActivity::Enable ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_enabled = true;
+}
+
+bool
+SatCoChannelActivity::IsEnabled () const
+{
+  return m_enabled;
+}
+
+void
+SatCoChannelActivity::AddTransmission (Ptr<MobilityModel> txMobility, uint32_t beamId, uint32_t carrierId, Time duration, double txPower_W)
+{
+  NS_LOG_FUNCTION (this << beamId << carrierId << duration << txPower_W);
+
+  Transmission_s transmission;
+  transmission.m_startTime = Simulator::Now () + GetSatelliteDelay (txMobility);
+  transmission.m_endTime = transmission.m_startTime + duration;
+  transmission.m_txPower_W = txPower_W;
+
+  m_maxDuration = std::max (m_maxDuration, duration);
+
+  std::deque<Transmission_s>& transmissions = m_transmissions[carrierId][beamId];
+
+  // remove the transmissions no longer needed by any receiver
+  while (!transmissions.empty () && transmissions.front ().m_endTime + m_retentionTime < transmission.m_startTime)
+    {
+      transmissions.pop_front ();
+    }
+
+  // the transmissions are mostly added in start time order, thus search the position from the end
+  std::deque<Transmission_s>::iterator position = transmissions.end ();
+
+  while (position != transmissions.begin () && (position - 1)->m_startTime > transmission.m_startTime)
+    {
+      --position;
+    }
+
+  transmissions.insert (position, transmission);
+}
+
+void
+SatCoChannelActivity::GetMeanTxPowers (uint32_t carrierId, Time startTime, Time endTime, std::map<uint32_t, double>& txPowers) const
+{
+  NS_LOG_FUNCTION (this << carrierId << startTime << endTime);
+
+  std::map<uint32_t, BeamTransmissions_t>::const_iterator carrierIt = m_transmissions.find (carrierId);
+
+  if (carrierIt == m_transmissions.end () || endTime <= startTime)
+    {
+      return;
+    }
+
+  double windowDuration = (endTime - startTime).GetDouble ();
+
+  for (BeamTransmissions_t::const_iterator beamIt = carrierIt->second.begin (); beamIt != carrierIt->second.end (); ++beamIt)
+    {
+      const std::deque<Transmission_s>& transmissions = beamIt->second;
+      double energy (0.0);
+
+      // the transmissions are in start time order, thus the search can be stopped
+      // when the transmissions cannot reach the window any more
+      for (std::deque<Transmission_s>::const_reverse_iterator it = transmissions.rbegin ();
+           it != transmissions.rend () && it->m_startTime + m_maxDuration > startTime;
+           ++it)
+        {
+          if (it->m_startTime < endTime && it->m_endTime > startTime)
+            {
+              Time overlap = std::min (it->m_endTime, endTime) - std::max (it->m_startTime, startTime);
+              energy += it->m_txPower_W * overlap.GetDouble ();
+            }
+        }
+
+      if (energy > 0.0)
+        {
+          txPowers[beamIt->first] = energy / windowDuration;
+        }
+    }
+}
+
+Time
+SatCoChannelActivity::GetSatelliteDelay (Ptr<MobilityModel> mobility) const
+{
+  NS_LOG_FUNCTION (this << mobility);
+
+  if (mobility == m_satelliteMobility)
+    {
+      return Seconds (0);
+    }
+
+  return m_propagationDelay->GetDelay (mobility, m_satelliteMobility);
+}
+
+Ptr<SatAntennaGainPatternContainer>
+SatCoChannelActivity::GetAntennaGainPatterns () const
+{
+  return m_antennaPatterns;
+}
+
+} // namespace ns3
@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 Magister Solutions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#ifndef SATELLITE_CO_CHANNEL_ACTIVITY_H
+#define SATELLITE_CO_CHANNEL_ACTIVITY_H
+
+#include <map>
+#include <deque>
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/mobility-model.h"
+#include "ns3/propagation-delay-model.h"
+#include "satellite-antenna-gain-pattern-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ * \brief Transmission activity of the beams sharing a user link SatChannel.
+ * The transmissions are added by the transmitting SatPhyTx objects and used
+ * by SatCoChannelInterference to estimate the co-channel interference
+ * without delivering the transmissions to the receivers of the other beams.
+ *
+ * The times of the transmissions are stored as the times when the signal
+ * is at the satellite, i.e. the transmissions of the ground transmitters
+ * are delayed by the propagation delay to the satellite. A receiver maps its
+ * reception window to the same time domain with GetSatelliteDelay.
+ */
+class SatCoChannelActivity : public Object
+{
+public:
+  /**
+   * \brief Get the type ID
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Default constructor, not used
+   */
+  SatCoChannelActivity ();
+
+  /**
+   * Constructor
+   * \param antennaPatterns Antenna gain patterns of the beams
+   * \param satelliteMobility Mobility of the satellite
+   * \param propagationDelay Propagation delay model of the channel
+   */
+  SatCoChannelActivity (Ptr<SatAntennaGainPatternContainer> antennaPatterns,
+                        Ptr<MobilityModel> satelliteMobility,
+                        Ptr<PropagationDelayModel> propagationDelay);
+
+  /**
+   * Destructor
+   */
+  ~SatCoChannelActivity ();
+
+  /**
+   * \brief Enable the tracking of the transmissions. Called by the
+   * interference models using the activity, so that the transmissions are
+   * not tracked if no one needs them.
+   */
+  void Enable ();
+
+  /**
+   * \brief Check whether the tracking of the transmissions is enabled.
+   * \return true if enabled
+   */
+  bool IsEnabled () const;
+
+  /**
+   * \brief Add a transmission started now.
+   * \param txMobility Mobility of the transmitter
+   * \param beamId Beam id of the transmission
+   * \param carrierId Carrier id of the transmission
+   * \param duration Duration of the transmission
+   * \param txPower_W Transmit power in Watts
+   */
+  void AddTransmission (Ptr<MobilityModel> txMobility, uint32_t beamId, uint32_t carrierId, Time duration, double txPower_W);
+
+  /**
+   * \brief Get the mean transmit powers of the beams within a window.
+   * \param carrierId Carrier id
+   * \param startTime Start time of the window at the satellite
+   * \param endTime End time of the window at the satellite
+   * \param txPowers Mean transmit powers in Watts by beam id, only the beams
+   * with transmissions within the window are added
+   */
+  void GetMeanTxPowers (uint32_t carrierId, Time startTime, Time endTime, std::map<uint32_t, double>& txPowers) const;
+
+  /**
+   * \brief Get the propagation delay between a node and the satellite.
+   * \param mobility Mobility of the node
+   * \return Propagation delay, zero for the satellite itself
+   */
+  Time GetSatelliteDelay (Ptr<MobilityModel> mobility) const;
+
+  /**
+   * \brief Get the antenna gain patterns of the beams.
+   * \return Antenna gain pattern container
+   */
+  Ptr<SatAntennaGainPatternContainer> GetAntennaGainPatterns () const;
+
+private:
+  /**
+   * \brief Dispose of SatCoChannelActivity
+   */
+  void DoDispose ();
+
+  /**
+   * \brief Transmission of a beam, times at the satellite
+   */
+  typedef struct
+  {
+    Time m_startTime;
+    Time m_endTime;
+    double m_txPower_W;
+  } Transmission_s;
+
+  /**
+   * \brief Transmissions of a carrier in start time order by beam id
+   */
+  typedef std::map<uint32_t, std::deque<Transmission_s> > BeamTransmissions_t;
+
+  Ptr<SatAntennaGainPatternContainer> m_antennaPatterns;
+  Ptr<MobilityModel> m_satelliteMobility;
+  Ptr<PropagationDelayModel> m_propagationDelay;
+
+  /**
+   * \brief Transmissions by carrier id
+   */
+  std::map<uint32_t, BeamTransmissions_t> m_transmissions;
+
+  /**
+   * \brief Time after the end of a transmission for which it is kept
+   */
+  Time m_retentionTime;
+
+  /**
+   * \brief Longest duration of the added transmissions
+   */
+  Time m_maxDuration;
+
+  bool m_enabled;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_CO_CHANNEL_ACTIVITY_H */
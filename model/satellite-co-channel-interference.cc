@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 Magister Solutions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#include <map>
+#include "ns3/log.h"
+#include "satellite-co-channel-interference.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatCoChannelInterference");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SatCoChannelInterference);
+
+TypeId
+SatCoChannelInterference::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatCoChannelInterference")
+    .SetParent<SatInterference> ()
+  ;
+  return tid;
+}
+
+TypeId
+SatCoChannelInterference::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+SatCoChannelInterference::SatCoChannelInterference ()
+  : m_activity (),
+    m_mobility (),
+    m_channelType (),
+    m_carrierId (0),
+    m_beamId (0),
+    m_isSatelliteReceiver (false),
+    m_gainRatios (),
+    m_gainRatioPosition (),
+    m_nextEventId (0)
+{
+  NS_LOG_FUNCTION (this);
+  NS_FATAL_ERROR ("SatCoChannelInterference::SatCoChannelInterference - Constructor not in use");
+}
+
+SatCoChannelInterference::SatCoChannelInterference (Ptr<SatCoChannelActivity> activity, SatEnums::ChannelType_t channelType, uint32_t carrierId)
+  : m_activity (activity),
+    m_mobility (),
+    m_channelType (channelType),
+    m_carrierId (carrierId),
+    m_beamId (0),
+    m_isSatelliteReceiver (channelType == SatEnums::RETURN_USER_CH),
+    m_gainRatios (),
+    m_gainRatioPosition (),
+    m_nextEventId (0)
+{
+  NS_LOG_FUNCTION (this << channelType << carrierId);
+
+  if (m_activity == NULL)
+    {
+      NS_FATAL_ERROR ("SatCoChannelInterference::SatCoChannelInterference - No co-channel activity, the model is available only for the user link");
+    }
+
+  if (channelType != SatEnums::RETURN_USER_CH && channelType != SatEnums::FORWARD_USER_CH)
+    {
+      NS_FATAL_ERROR ("SatCoChannelInterference::SatCoChannelInterference - Invalid channel type: " << SatEnums::GetChannelTypeName (channelType));
+    }
+
+  m_activity->Enable ();
+}
+
+SatCoChannelInterference::~SatCoChannelInterference ()
+{
+  NS_LOG_FUNCTION (this);
+
+  Reset ();
+}
+
+void
+SatCoChannelInterference::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_activity = 0;
+  m_mobility = 0;
+
+  SatInterference::DoDispose ();
+}
+
+void
+SatCoChannelInterference::SetBeamId (uint32_t beamId)
+{
+  NS_LOG_FUNCTION (this << beamId);
+
+  m_beamId = beamId;
+  m_gainRatios.clear ();
+}
+
+void
+SatCoChannelInterference::SetMobility (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+
+  m_mobility = mobility;
+  m_gainRatios.clear ();
+}
+
+Ptr<SatInterference::InterferenceChangeEvent>
+SatCoChannelInterference::DoAdd (Time duration, double power, Address rxAddress)
+{
+  NS_LOG_FUNCTION (this << duration.GetSeconds () << power << rxAddress);
+
+  Ptr<SatInterference::InterferenceChangeEvent> event;
+  event = Create<SatInterference::InterferenceChangeEvent> (m_nextEventId++, duration, power, rxAddress);
+
+  return event;
+}
+
+double
+SatCoChannelInterference::DoCalculate (Ptr<SatInterference::InterferenceChangeEvent> event)
+{
+  NS_LOG_FUNCTION (this);
+
+  UpdateGainRatios ();
+
+  // map the reception window to the time at the satellite
+  Time delay = m_isSatelliteReceiver ? Seconds (0) : m_activity->GetSatelliteDelay (m_mobility);
+
+  /**
+   * The channel starts the reception the burst duration earlier on the
+   * forward user link following the transparent satellite, see
+   * SatChannel::GetRxDelay. Thus the same is done here to map the window
+   * to the satellite time. The model is available only for the user links.
+   */
+  if (m_channelType == SatEnums::FORWARD_USER_CH)
+    {
+      Time duration = event->GetEndTime () - event->GetStartTime ();
+
+      if (delay > duration)
+        {
+          delay -= duration;
+        }
+    }
+
+  Time startTime = event->GetStartTime () - delay;
+  Time endTime = event->GetEndTime () - delay;
+
+  std::map<uint32_t, double> txPowers;
+  m_activity->GetMeanTxPowers (m_carrierId, startTime, endTime, txPowers);
+
+  // transmit power of the own beam is the one of the received signal
+  std::map<uint32_t, double>::const_iterator own = txPowers.find (m_beamId);
+
+  if (own == txPowers.end ())
+    {
+      NS_LOG_WARN ("No own beam transmission found for the reception, beam: " << m_beamId << ", carrier: " << m_carrierId);
+      return 0.0;
+    }
+
+  double ifPowerW (0.0);
+
+  for (std::map<uint32_t, double>::const_iterator it = txPowers.begin (); it != txPowers.end (); ++it)
+    {
+      if (it->first != m_beamId && it->first < m_gainRatios.size ())
+        {
+          ifPowerW += m_gainRatios[it->first] * it->second;
+        }
+    }
+
+  ifPowerW *= event->GetRxPower () / own->second;
+
+  NS_LOG_INFO ("Calculate: Beam= " << m_beamId << ", Carrier= " << m_carrierId <<
+               ", Active beams= " << txPowers.size () << ", IfPower (W)= " << ifPowerW);
+
+  return ifPowerW;
+}
+
+void
+SatCoChannelInterference::UpdateGainRatios ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_isSatelliteReceiver)
+    {
+      if (m_gainRatios.empty ())
+        {
+          m_activity->GetAntennaGainPatterns ()->GetCoChannelGainRatios (m_beamId, m_gainRatios);
+        }
+      return;
+    }
+
+  NS_ASSERT (m_mobility != NULL);
+
+  Vector position = m_mobility->GetPosition ();
+
+  if (m_gainRatios.empty ()
+      || position.x != m_gainRatioPosition.x
+      || position.y != m_gainRatioPosition.y
+      || position.z != m_gainRatioPosition.z)
+    {
+      m_activity->GetAntennaGainPatterns ()->GetCoChannelGainRatios (m_beamId, GeoCoordinate (position), m_gainRatios);
+      m_gainRatioPosition = position;
+    }
+}
+
+void
+SatCoChannelInterference::DoReset (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatCoChannelInterference::DoNotifyRxStart (Ptr<SatInterference::InterferenceChangeEvent> event)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatCoChannelInterference::DoNotifyRxEnd (Ptr<SatInterference::InterferenceChangeEvent> event)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+} // namespace ns3
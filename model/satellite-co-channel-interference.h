@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 Magister Solutions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#ifndef SATELLITE_CO_CHANNEL_INTERFERENCE_H
+#define SATELLITE_CO_CHANNEL_INTERFERENCE_H
+
+#include <vector>
+#include "ns3/vector.h"
+#include "ns3/mobility-model.h"
+#include "satellite-interference.h"
+#include "satellite-co-channel-activity.h"
+#include "satellite-enums.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ * \brief Co-channel interference estimated from the transmission activity
+ * of the other beams of the same channel and carrier, weighted by the
+ * antenna gain ratios of the beams. The transmissions of the other beams
+ * need not to be delivered to the receiver, thus the model may be used
+ * with the ONLY_DEST_BEAM forwarding mode of SatChannel.
+ *
+ * The interference of a reception is the received power scaled by the
+ * ratio of the mean transmit power of each interfering beam within the
+ * reception window to the transmit power of the own beam, and by the gain
+ * ratio of the interfering beam. The gain ratios of a satellite receiver
+ * are taken from the beam x beam matrix of SatAntennaGainPatternContainer,
+ * and the ones of a ground receiver are calculated for its position.
+ * The model is available only for the user link channels.
+ */
+class SatCoChannelInterference : public SatInterference
+{
+public:
+  /**
+   * \brief Get the type ID
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  TypeId GetInstanceTypeId (void) const;
+
+  /**
+   * Default constructor, not used
+   */
+  SatCoChannelInterference ();
+
+  /**
+   * Constructor
+   * \param activity Co-channel activity of the channel
+   * \param channelType Channel type of the receiver
+   * \param carrierId Carrier id of the receiver
+   */
+  SatCoChannelInterference (Ptr<SatCoChannelActivity> activity, SatEnums::ChannelType_t channelType, uint32_t carrierId);
+
+  /**
+   * Destructor for SatCoChannelInterference
+   */
+  ~SatCoChannelInterference ();
+
+  /**
+   * \brief Set the beam id of the receiver
+   * \param beamId Beam id
+   */
+  void SetBeamId (uint32_t beamId);
+
+  /**
+   * \brief Set the mobility of the receiver
+   * \param mobility Mobility model
+   */
+  void SetMobility (Ptr<MobilityModel> mobility);
+
+private:
+  /**
+   * \brief Dispose of SatCoChannelInterference
+   */
+  void DoDispose ();
+
+  /**
+   * Adds interference power to interference object.
+   *
+   * \param rxDuration Duration of the receiving.
+   * \param rxPower Receiving power.
+   * \param rxAddress MAC address.
+   *
+   * \return the pointer to interference event as a reference of the addition
+   */
+  virtual Ptr<SatInterference::InterferenceChangeEvent> DoAdd (Time rxDuration, double rxPower, Address rxAddress);
+
+  /**
+   * Calculates interference power for the given reference from the
+   * co-channel activity within the reception window.
+   *
+   * \param event Reference event which for interference is calculated.
+   *
+   * \return Final power value at end of receiving
+   */
+  virtual double DoCalculate (Ptr<SatInterference::InterferenceChangeEvent> event);
+
+  /**
+   * Resets current interference.
+   */
+  virtual void DoReset (void);
+
+  /**
+   * Notifies that RX is started by a receiver.
+   *
+   * \param event Interference reference event of receiver (ignored in this implementation)
+   */
+  virtual void DoNotifyRxStart (Ptr<SatInterference::InterferenceChangeEvent> event);
+
+  /**
+   * Notifies that RX is ended by a receiver.
+   *
+   * \param event Interference reference event of receiver (ignored in this implementation)
+   */
+  virtual void DoNotifyRxEnd (Ptr<SatInterference::InterferenceChangeEvent> event);
+
+  /**
+   * \brief Update the gain ratios of the interfering beams, if not yet
+   * calculated or if a ground receiver has moved.
+   */
+  void UpdateGainRatios ();
+
+  SatCoChannelInterference (const SatCoChannelInterference &o);
+  SatCoChannelInterference &operator = (const SatCoChannelInterference &o);
+
+  Ptr<SatCoChannelActivity> m_activity;
+  Ptr<MobilityModel> m_mobility;
+  SatEnums::ChannelType_t m_channelType;
+  uint32_t m_carrierId;
+  uint32_t m_beamId;
+
+  /**
+   * \brief Receiver is on board the satellite (return user link)
+   */
+  bool m_isSatelliteReceiver;
+
+  /**
+   * \brief Gain ratios of the interfering beams indexed by beam id
+   */
+  std::vector<double> m_gainRatios;
+
+  /**
+   * \brief Position of a ground receiver for which the gain ratios are calculated
+   */
+  Vector m_gainRatioPosition;
+
+  /**
+   * \brief event id for Events
+   */
+  uint32_t m_nextEventId;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_CO_CHANNEL_INTERFERENCE_H */
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 Magister Solutions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#include <cstring>
+#include "satellite-embedded-link-results.h"
+
+#ifdef SAT_EMBEDDED_LINK_RESULTS
+// Generated at build time from the link results files of the data package
+#include "satellite-embedded-link-results-data.h"
+#endif
+
+namespace ns3 {
+
+bool
+SatEmbeddedLinkResults::Find (std::string fileName, const double *&esNoDb, const double *&bler, uint32_t &size)
+{
+#ifdef SAT_EMBEDDED_LINK_RESULTS
+  // Tables are sorted by the file name by the generator
+  uint32_t first = 0;
+  uint32_t last = SAT_EMBEDDED_LINK_RESULTS_COUNT;
+
+  while (first < last)
+    {
+      uint32_t middle = first + (last - first) / 2;
+      int result = std::strcmp (g_satEmbeddedLinkResults[middle].m_fileName, fileName.c_str ());
+
+      if (result == 0)
+        {
+          esNoDb = g_satEmbeddedLinkResults[middle].m_esNoDb;
+          bler = g_satEmbeddedLinkResults[middle].m_bler;
+          size = g_satEmbeddedLinkResults[middle].m_size;
+          return true;
+        }
+      else if (result < 0)
+        {
+          first = middle + 1;
+        }
+      else
+        {
+          last = middle;
+        }
+    }
+#endif
+
+  return false;
+}
+
+bool
+SatEmbeddedLinkResults::IsEnabled ()
+{
+#ifdef SAT_EMBEDDED_LINK_RESULTS
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace ns3
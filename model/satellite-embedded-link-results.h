@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 Magister Solutions
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#ifndef SATELLITE_EMBEDDED_LINK_RESULTS_H
+#define SATELLITE_EMBEDDED_LINK_RESULTS_H
+
+#include <stdint.h>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * \brief SatEmbeddedLinkResults gives access to the link results compiled
+ * into the satellite module. The link results are embedded when the module
+ * is configured with --enable-sat-embedded-link-results, in which case the
+ * link results files of the data package are converted at build time into
+ * constant arrays. This class is not planned to be instantiated or inherited.
+ */
+class SatEmbeddedLinkResults
+{
+public:
+  /**
+   * \brief Embedded link results of one link results file
+   */
+  typedef struct
+  {
+    const char *m_fileName;
+    const double *m_esNoDb;
+    const double *m_bler;
+    uint32_t m_size;
+  } Table_s;
+
+  /**
+   * \brief Find the embedded link results of a link results file.
+   * \param fileName Name of the link results file, e.g. "s2_qpsk_1_to_2.txt"
+   * \param esNoDb Es/No values in dB in ascending order, set if found
+   * \param bler BLER values related to the Es/No values, set if found
+   * \param size Number of the values, set if found
+   * \return true if the link results are embedded, otherwise false
+   */
+  static bool Find (std::string fileName, const double *&esNoDb, const double *&bler, uint32_t &size);
+
+  /**
+   * \brief Check whether link results are embedded into the module.
+   * \return true if link results are embedded, otherwise false
+   */
+  static bool IsEnabled ();
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_EMBEDDED_LINK_RESULTS_H */
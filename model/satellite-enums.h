@@ -77,7 +77,8 @@ public:
   {
     FADING_OFF,
     FADING_TRACE,
-    FADING_MARKOV
+    FADING_MARKOV,
+    FADING_MARKOV_REPLAY
   } FadingModel_t;
 
   /**
@@ -22,6 +22,7 @@
 #include "ns3/log.h"
 #include "ns3/enum.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/string.h"
 #include "ns3/singleton.h"
 #include "ns3/satellite-env-variables.h"
@@ -70,7 +71,12 @@ SatFadingExternalInputTraceContainer::GetTypeId (void)
                    "Maximum distance allowed to fading source in position based mode [m].",
                    DoubleValue (5000),
                    MakeDoubleAccessor (&SatFadingExternalInputTraceContainer::m_maxDistanceToFading),
-                   MakeDoubleChecker<double> ());
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("LinearSamples",
+                   "Convert the fading samples to linear domain when the trace files are loaded.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SatFadingExternalInputTraceContainer::m_linearSamples),
+                   MakeBooleanChecker ());
   return tid;
 }
 
@@ -82,7 +88,8 @@ TypeId SatFadingExternalInputTraceContainer::GetInstanceTypeId (void) const
 SatFadingExternalInputTraceContainer::SatFadingExternalInputTraceContainer ()
   : m_utInputMode (LIST_MODE),
     m_indexFilesLoaded (false),
-    m_maxDistanceToFading (0)
+    m_maxDistanceToFading (0),
+    m_linearSamples (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -96,6 +103,7 @@ SatFadingExternalInputTraceContainer::~SatFadingExternalInputTraceContainer ()
 
   m_utFadingMap.clear ();
   m_gwFadingMap.clear ();
+  m_loadedTraces.clear ();
 }
 
 void
@@ -217,6 +225,34 @@ SatFadingExternalInputTraceContainer::GetFadingTrace (uint32_t nodeId, SatEnums:
   return ft;
 }
 
+void
+SatFadingExternalInputTraceContainer::GetFadingValues (SatEnums::ChannelType_t channelType,
+                                                       const std::vector<uint32_t>& nodeIds,
+                                                       const std::vector<Ptr<MobilityModel> >& mobilities,
+                                                       std::vector<double>& fadingValues)
+{
+  NS_LOG_FUNCTION (this << channelType << nodeIds.size ());
+  NS_ASSERT (mobilities.empty () || mobilities.size () == nodeIds.size ());
+
+  std::map<Ptr<SatFadingExternalInputTrace>, double> calculatedValues;
+
+  fadingValues.resize (nodeIds.size ());
+
+  for (uint32_t i = 0; i < nodeIds.size (); ++i)
+    {
+      Ptr<MobilityModel> mobility = mobilities.empty () ? NULL : mobilities[i];
+      Ptr<SatFadingExternalInputTrace> trace = GetFadingTrace (nodeIds[i], channelType, mobility);
+      std::map<Ptr<SatFadingExternalInputTrace>, double>::const_iterator it = calculatedValues.find (trace);
+
+      if (it == calculatedValues.end ())
+        {
+          it = calculatedValues.insert (std::make_pair (trace, trace->GetFading ())).first;
+        }
+
+      fadingValues[i] = it->second;
+    }
+}
+
 bool
 SatFadingExternalInputTraceContainer::TestFadingTraces (uint32_t numOfUts, uint32_t numOfGws)
 {
@@ -341,7 +377,6 @@ SatFadingExternalInputTraceContainer::CreateFadingTrace (SatFadingExternalInputT
 {
   NS_LOG_FUNCTION (this << mobility);
 
-  Ptr<SatFadingExternalInputTrace> trace;
   std::string fileName;
 
   switch (inputMode)
@@ -379,20 +414,26 @@ SatFadingExternalInputTraceContainer::CreateFadingTrace (SatFadingExternalInputT
 
   NS_LOG_INFO ("SatFadingExternalInputTraceContainer -> Creation info: Mode=" << m_utInputMode << ", ID (GW/UT)=" << id << ", FileName=" << fileName);
 
-  // find from loaded list
+  return GetLoadedTrace (fileType, m_dataPath + fileName);
+}
+
+Ptr<SatFadingExternalInputTrace>
+SatFadingExternalInputTraceContainer::GetLoadedTrace (SatFadingExternalInputTrace::TraceFileType_e fileType, std::string filePathName)
+{
+  NS_LOG_FUNCTION (this << filePathName);
 
-  TraceInputContainer_t::iterator it = m_loadedTraces.find (fileName);
+  // find from loaded list, the same file is shared by all the terminals using it
+  TraceInputContainer_t::iterator it = m_loadedTraces.find (std::make_pair (filePathName, fileType));
 
-  if ( it == m_loadedTraces.end ())
+  if ( it != m_loadedTraces.end ())
     {
-      // create if not found
-      trace = Create<SatFadingExternalInputTrace> (fileType, m_dataPath + fileName);
-    }
-  else
-    {
-      trace = it->second;
+      return it->second;
     }
 
+  // create if not found
+  Ptr<SatFadingExternalInputTrace> trace = Create<SatFadingExternalInputTrace> (fileType, filePathName, m_linearSamples);
+  m_loadedTraces.insert (std::make_pair (std::make_pair (filePathName, fileType), trace));
+
   return trace;
 }
 
@@ -24,6 +24,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 #include "ns3/object.h"
 #include "ns3/mobility-model.h"
 #include "satellite-enums.h"
@@ -87,6 +88,31 @@ public:
    */
   Ptr<SatFadingExternalInputTrace> GetFadingTrace (uint32_t nodeId, SatEnums::ChannelType_t channelType, Ptr<MobilityModel> mobility);
 
+  /**
+   * Get the trace of a file, loading it if not done already. All the users
+   * of the same file and type share the returned trace and its mapping.
+   *
+   * \param fileType Type of the trace file
+   * \param filePathName Path and file name of the trace file
+   * \return Shared trace of the file
+   */
+  Ptr<SatFadingExternalInputTrace> GetLoadedTrace (SatFadingExternalInputTrace::TraceFileType_e fileType, std::string filePathName);
+
+  /**
+   * Get the current fading values of many nodes of the same channel type,
+   * e.g. of all the receivers of a channel fan-out. The nodes sharing the
+   * same trace file get the value calculated once.
+   *
+   * \param channelType Channel type
+   * \param nodeIds GW or UT Node ids (from SatIdMapper)
+   * \param mobilities Mobilities of the nodes, or empty if not needed
+   * \param fadingValues Fading values of the nodes in linear format
+   */
+  void GetFadingValues (SatEnums::ChannelType_t channelType,
+                        const std::vector<uint32_t>& nodeIds,
+                        const std::vector<Ptr<MobilityModel> >& mobilities,
+                        std::vector<double>& fadingValues);
+
   /**
    * \brief A method to test that the fading traces are according to
    * assumptions.
@@ -100,7 +126,7 @@ private:
   typedef std::pair <std::string, GeoCoordinate > TraceFileContainerItem_t;
   typedef std::vector<TraceFileContainerItem_t> TraceFileContainer_t;
 
-  typedef std::map<std::string, Ptr<SatFadingExternalInputTrace> > TraceInputContainer_t;
+  typedef std::map<std::pair<std::string, SatFadingExternalInputTrace::TraceFileType_e>, Ptr<SatFadingExternalInputTrace> > TraceInputContainer_t;
 
   /**
    * Container of the UT fading traces
@@ -162,7 +188,8 @@ private:
   TraceFileContainer_t  m_gwRtnDownFileNames;
 
   /**
-   * Loaded trace files
+   * Loaded trace files by path and file name and type, shared by all the
+   * terminals using the same file
    */
   TraceInputContainer_t m_loadedTraces;
 
@@ -175,6 +202,9 @@ private:
   /// Maximum distance allowed to the external fading trace source
   double m_maxDistanceToFading;
 
+  /// Convert the fading samples to linear domain when the traces are loaded
+  bool m_linearSamples;
+
   /**
    * Initialize index files
    */
@@ -20,6 +20,13 @@
 
 #include <fstream>
 #include <algorithm>
+#include <cmath>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "satellite-fading-external-input-trace.h"
@@ -33,25 +40,57 @@ namespace ns3 {
 SatFadingExternalInputTrace::SatFadingExternalInputTrace ()
   : m_traceFileType (),
     m_startTime (),
-    m_timeInterval ()
+    m_timeInterval (),
+    m_samples (NULL),
+    m_columns (0),
+    m_rowCount (0),
+    m_mapping (NULL),
+    m_mappingLength (0),
+    m_cursor (0),
+    m_latestTime (-1.0),
+    m_latestFading (1.0)
 {
   NS_FATAL_ERROR ("SatFadingExternalInputTrace::SatFadingExternalInputTrace - Constructor not in use");
 }
 
-SatFadingExternalInputTrace::SatFadingExternalInputTrace (TraceFileType_e type, std::string fileName)
+SatFadingExternalInputTrace::SatFadingExternalInputTrace (TraceFileType_e type, std::string fileName, bool linearSamples)
   : m_startTime (-1.0),
-    m_timeInterval (-1.0)
+    m_timeInterval (-1.0),
+    m_samples (NULL),
+    m_columns (0),
+    m_rowCount (0),
+    m_mapping (NULL),
+    m_mappingLength (0),
+    m_cursor (0),
+    m_latestTime (-1.0),
+    m_latestFading (1.0)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << linearSamples);
 
   m_traceFileType = type;
   ReadTrace (fileName);
+
+  if (linearSamples)
+    {
+      m_linearFading.resize (m_rowCount);
+
+      for (uint32_t row = 0; row < m_rowCount; ++row)
+        {
+          m_linearFading[row] = SatUtils::DbToLinear (GetSample (row, FADING_INDEX));
+        }
+    }
 }
 
 
 SatFadingExternalInputTrace::~SatFadingExternalInputTrace ()
 {
   NS_LOG_FUNCTION (this);
+
+  if (m_mapping != NULL)
+    {
+      munmap (m_mapping, m_mappingLength);
+      m_mapping = NULL;
+    }
 }
 
 
@@ -59,67 +98,106 @@ void SatFadingExternalInputTrace::ReadTrace (std::string filePathName)
 {
   NS_LOG_FUNCTION (this << filePathName);
 
-  // READ FROM THE SPECIFIED INPUT FILE
-  std::ifstream *ifs = new std::ifstream (filePathName.c_str (), std::ios::in | std::ios::binary);
+  // OPEN THE SPECIFIED INPUT FILE
+  int fd = open (filePathName.c_str (), O_RDONLY);
 
-  if (!ifs->is_open ())
+  if (fd < 0)
     {
       // script might be launched by test.py, try a different base path
-      delete ifs;
       filePathName = "../../" + filePathName;
-      ifs = new std::ifstream (filePathName.c_str (), std::ifstream::in);
+      fd = open (filePathName.c_str (), O_RDONLY);
 
-      if (!ifs->is_open ())
+      if (fd < 0)
         {
           NS_FATAL_ERROR ("The file " << filePathName << " is not found.");
         }
     }
 
   // Currently supports two or three column formats
-  uint32_t columns = (m_traceFileType == FT_TWO_COLUMN) ? 2 : 3;
+  m_columns = (m_traceFileType == FT_TWO_COLUMN) ? 2 : 3;
 
-  float temp;
-  int32_t count (0);
-  std::vector<float> values;
-  ifs->read ((char*)&temp, sizeof(float));
-  m_startTime = temp;
+  struct stat fileStat;
 
-  // While state is good
-  while (ifs->good ())
+  if (fstat (fd, &fileStat) != 0)
     {
-      // Store previous value
-      values.push_back (temp);
+      NS_FATAL_ERROR ("The size of the file " << filePathName << " is not available: " << strerror (errno));
+    }
 
-      // Read the new value
-      ++count;
-      ifs->read ((char*)&temp, sizeof(float));
+  size_t fileSize = fileStat.st_size;
+
+  // An incomplete last row is ignored
+  m_rowCount = fileSize / (m_columns * sizeof (float));
+
+  if (m_rowCount > 0)
+    {
+      void* mapping = mmap (NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
 
-      // Handle previous value
-      if (count % columns == 0)
+      if (mapping != MAP_FAILED)
         {
-          NS_ASSERT (values.size () == columns);
+          m_mapping = mapping;
+          m_mappingLength = fileSize;
+          m_samples = static_cast<const float*> (mapping);
+        }
+      else
+        {
+          NS_LOG_WARN (this << " mapping of " << filePathName << " failed (" << strerror (errno) << "), reading it into memory");
 
-          m_traceVector.push_back (values);
-          values.clear ();
+          m_buffer.resize (m_rowCount * m_columns);
+          size_t bytes = m_buffer.size () * sizeof (float);
 
-          // Calculate the sampling interval
-          if (m_timeInterval < 0.0)
+          if (pread (fd, &m_buffer[0], bytes, 0) != (ssize_t) bytes)
             {
-              m_timeInterval = temp - m_startTime;
+              NS_FATAL_ERROR ("Reading of the file " << filePathName << " failed.");
             }
+
+          m_samples = &m_buffer[0];
+        }
+
+      m_startTime = GetSample (0, TIME_INDEX);
+
+      // Calculate the sampling interval
+      if (m_rowCount > 1)
+        {
+          m_timeInterval = GetSample (1, TIME_INDEX) - m_startTime;
         }
     }
-  ifs->close ();
-  delete ifs;
+
+  close (fd);
 }
 
-double
-SatFadingExternalInputTrace::GetFading () const
+bool
+SatFadingExternalInputTrace::IsMapped () const
 {
-  NS_LOG_FUNCTION (this);
-  NS_ASSERT (!m_traceVector.empty ());
+  return m_mapping != NULL;
+}
 
-  float simTime = Simulator::Now ().GetSeconds ();
+float
+SatFadingExternalInputTrace::GetLinearFading (uint32_t row) const
+{
+  if (m_linearFading.empty ())
+    {
+      return SatUtils::DbToLinear (GetSample (row, FADING_INDEX));
+    }
+
+  return m_linearFading[row];
+}
+
+uint32_t
+SatFadingExternalInputTrace::FindLowerIndex (float simTime) const
+{
+  // Common case: the time is within the current or the next sample interval
+  if (m_cursor + 1 < m_rowCount && GetSample (m_cursor, TIME_INDEX) <= simTime)
+    {
+      if (simTime < GetSample (m_cursor + 1, TIME_INDEX))
+        {
+          return m_cursor;
+        }
+
+      if (m_cursor + 2 < m_rowCount && simTime < GetSample (m_cursor + 2, TIME_INDEX))
+        {
+          return ++m_cursor;
+        }
+    }
 
   if (simTime < m_startTime)
     {
@@ -129,31 +207,44 @@ SatFadingExternalInputTrace::GetFading () const
   // Calculate the index to the time sample just before current time
   uint32_t lowerIndex = (uint32_t)(std::floor (std::abs (simTime - m_startTime) / m_timeInterval));
 
-  if (lowerIndex >= m_traceVector.size ())
+  if (lowerIndex + 1 >= m_rowCount)
     {
-      NS_LOG_ERROR (this << " calculated index exceeds trace file size!");
+      NS_FATAL_ERROR (this << " calculated index exceeds trace file size!");
     }
 
-  float lowerKey = m_traceVector.at (lowerIndex).at (TIME_INDEX);
-  float upperKey = m_traceVector.at (lowerIndex + 1).at (TIME_INDEX);
+  m_cursor = lowerIndex;
+  return lowerIndex;
+}
+
+double
+SatFadingExternalInputTrace::GetFading () const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_rowCount > 0);
+
+  float simTime = Simulator::Now ().GetSeconds ();
+
+  if (simTime == m_latestTime)
+    {
+      return m_latestFading;
+    }
+
+  uint32_t lowerIndex = FindLowerIndex (simTime);
+
+  float lowerKey = GetSample (lowerIndex, TIME_INDEX);
+  float upperKey = GetSample (lowerIndex + 1, TIME_INDEX);
 
   // Interpolation in linear domain
-  float lowerVal = SatUtils::DbToLinear (m_traceVector.at (lowerIndex).at (FADING_INDEX));
-  float upperVal = SatUtils::DbToLinear (m_traceVector.at (lowerIndex + 1).at (FADING_INDEX));
+  float lowerVal = GetLinearFading (lowerIndex);
+  float upperVal = GetLinearFading (lowerIndex + 1);
 
   // y = y0 + (y1 - y0) * (x - x0) / (x1 - x0)
   double fading = lowerVal + (upperVal - lowerVal)
     * (simTime - lowerKey) / (upperKey - lowerKey);
 
-  /*
-  std::cout << "Now: " << simTime <<
-      ", interpolated fading: " << fading_dB <<
-      ", interpolated fading: " << SatUtils::DbToLinear (fading_dB) <<
-      ", Lower time: " << lowerKey <<
-      ", Upper time: " << upperKey <<
-      ", Lower fading: " << lowerVal <<
-      ", Upper fading: " << upperVal << std::endl;
-  */
+  m_latestTime = simTime;
+  m_latestFading = fading;
+
   return fading;
 }
 
@@ -161,17 +252,16 @@ bool
 SatFadingExternalInputTrace::TestFadingTrace () const
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (!m_traceVector.empty ());
+  NS_ASSERT (m_rowCount > 0);
 
-  std::vector<std::vector<float> >::const_iterator cit;
   float prevTime (-1.0);
   float currTime (-1.0);
 
-  for (cit = m_traceVector.begin (); cit != m_traceVector.end (); ++cit)
+  for (uint32_t row = 0; row < m_rowCount; ++row)
     {
       if (prevTime > 0)
         {
-          currTime = cit->at (TIME_INDEX);
+          currTime = GetSample (row, TIME_INDEX);
           double diff = std::abs ( std::abs (currTime - prevTime) - m_timeInterval);
 
           // Test that the the time samples are from constant interval and
@@ -181,7 +271,7 @@ SatFadingExternalInputTrace::TestFadingTrace () const
               return false;
             }
         }
-      prevTime = cit->at (TIME_INDEX);
+      prevTime = GetSample (row, TIME_INDEX);
     }
 
   // Succeeded
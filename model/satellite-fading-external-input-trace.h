@@ -22,6 +22,8 @@
 #define SATELLITE_FADING_EXTERNAL_INPUT_TRACE_H
 
 #include <vector>
+#include <string>
+#include <stdint.h>
 #include "ns3/simple-ref-count.h"
 
 namespace ns3 {
@@ -31,6 +33,18 @@ namespace ns3 {
  * \brief The class for satellite fading external input trace. The class reads
  * fading trace input samples from a file and provides the current fading value
  * for this specific fading file.
+ *
+ * The binary file is memory mapped read-only and accessed as a flat array of
+ * floats, so the samples are shared through the page cache by all the trace
+ * objects and processes using the same file. If the file cannot be mapped,
+ * it is read into the heap instead.
+ *
+ * Optionally, the fading samples are converted to linear domain at load
+ * time. The trace keeps a time cursor to the latest used sample, so that
+ * the successive requests at increasing simulation time are served without
+ * the index calculation, and the latest value, so that the requests of all
+ * the terminals sharing the trace at the same time are calculated once.
+ * The trace is thus not safe to be evaluated concurrently.
  */
 class SatFadingExternalInputTrace : public SimpleRefCount <SatFadingExternalInputTrace>
 {
@@ -50,8 +64,9 @@ public:
    * Constructor with initialization parameters.
    * \param type 
    * \param filePathName 
+   * \param linearSamples Convert the fading samples to linear domain at load time
    */
-  SatFadingExternalInputTrace (TraceFileType_e type, std::string filePathName);
+  SatFadingExternalInputTrace (TraceFileType_e type, std::string filePathName, bool linearSamples = false);
 
   /**
    * Destructor for SatFadingExternalInputTrace
@@ -71,13 +86,51 @@ public:
    */
   bool TestFadingTrace () const;
 
+  /**
+   * Is the trace file memory mapped or read into the heap
+   * \return true if the trace file is memory mapped
+   */
+  bool IsMapped () const;
+
 private:
   /**
-   * Read the fading trace from a binary file
+   * Copying is not allowed, the object owns the mapping of the file.
+   */
+  SatFadingExternalInputTrace (const SatFadingExternalInputTrace&);
+  SatFadingExternalInputTrace& operator= (const SatFadingExternalInputTrace&);
+
+  /**
+   * Map or read the fading trace from a binary file
    * \param filePathName Path and file name of the fading file
    */
   void ReadTrace (std::string filePathName);
 
+  /**
+   * Get a sample of the trace
+   * \param row Row of the sample
+   * \param column Column of the sample
+   * \return sample
+   */
+  inline float GetSample (uint32_t row, uint32_t column) const
+  {
+    return m_samples[row * m_columns + column];
+  }
+
+  /**
+   * Get the linear fading value of a row
+   * \param row Row of the sample
+   * \return fading value in linear format
+   */
+  float GetLinearFading (uint32_t row) const;
+
+  /**
+   * Find the index of the time sample just before the given time, starting
+   * from the time cursor
+   * \param simTime Time in seconds
+   * \return index of the sample
+   */
+  uint32_t FindLowerIndex (float simTime) const;
+
   /**
    * There may be different fading file types.
    * - FT_TWO_COLUMN
@@ -107,9 +160,32 @@ private:
   float m_timeInterval;
 
   /**
-   * Container for the fading trace.
+   * Samples of the fading trace as a flat row major array, the number
+   * of columns and the number of complete rows.
+   */
+  const float* m_samples;
+  uint32_t m_columns;
+  uint32_t m_rowCount;
+
+  /**
+   * Memory mapping of the trace file, or NULL if the file is read
+   * into the heap buffer.
+   */
+  void* m_mapping;
+  size_t m_mappingLength;
+  std::vector<float> m_buffer;
+
+  /**
+   * Fading samples converted to linear domain, empty if not converted
+   */
+  std::vector<float> m_linearFading;
+
+  /**
+   * Time cursor and the latest calculated fading value
    */
-  std::vector<std::vector<float> > m_traceVector;
+  mutable uint32_t m_cursor;
+  mutable float m_latestTime;
+  mutable double m_latestFading;
 };
 
 } // namespace ns3
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+#include <cmath>
+#include "ns3/log.h"
+#include "satellite-fading-oscillator-bank.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatFadingOscillatorBank");
+
+namespace ns3 {
+
+SatFadingOscillatorBank::SatFadingOscillatorBank ()
+  : m_amplitudeReal (),
+    m_amplitudeImag (),
+    m_amplitude (),
+    m_phase (),
+    m_omega (),
+    m_theta (),
+    m_cos (),
+    m_sin ()
+{
+}
+
+void
+SatFadingOscillatorBank::AddOscillator (std::complex<double> amplitude, double initialPhase, double omega)
+{
+  NS_LOG_FUNCTION (this << amplitude << " " << initialPhase << " " << omega);
+
+  m_amplitudeReal.push_back (amplitude.real ());
+  m_amplitudeImag.push_back (amplitude.imag ());
+  m_amplitude.push_back (0.0);
+  m_phase.push_back (initialPhase);
+  m_omega.push_back (omega);
+
+  m_theta.resize (m_phase.size ());
+  m_cos.resize (m_phase.size ());
+  m_sin.resize (m_phase.size ());
+}
+
+void
+SatFadingOscillatorBank::AddOscillator (double amplitude, double initialPhase, double omega)
+{
+  NS_LOG_FUNCTION (this << amplitude << " " << initialPhase << " " << omega);
+
+  m_amplitudeReal.push_back (0.0);
+  m_amplitudeImag.push_back (0.0);
+  m_amplitude.push_back (amplitude);
+  m_phase.push_back (initialPhase);
+  m_omega.push_back (omega);
+
+  m_theta.resize (m_phase.size ());
+  m_cos.resize (m_phase.size ());
+  m_sin.resize (m_phase.size ());
+}
+
+void
+SatFadingOscillatorBank::Clear ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_amplitudeReal.clear ();
+  m_amplitudeImag.clear ();
+  m_amplitude.clear ();
+  m_phase.clear ();
+  m_omega.clear ();
+  m_theta.clear ();
+  m_cos.clear ();
+  m_sin.clear ();
+}
+
+uint32_t
+SatFadingOscillatorBank::GetN () const
+{
+  return m_phase.size ();
+}
+
+void
+SatFadingOscillatorBank::CalculatePhases (double timeInSeconds)
+{
+  const uint32_t n = m_phase.size ();
+  const double* omega = m_omega.data ();
+  const double* phase = m_phase.data ();
+  double* theta = m_theta.data ();
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      theta[i] = timeInSeconds * omega[i] + phase[i];
+    }
+}
+
+void
+SatFadingOscillatorBank::CalculateCosines ()
+{
+  const uint32_t n = m_theta.size ();
+  const double* theta = m_theta.data ();
+  double* cosine = m_cos.data ();
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      cosine[i] = std::cos (theta[i]);
+    }
+}
+
+void
+SatFadingOscillatorBank::CalculateCosinesAndSines ()
+{
+  const uint32_t n = m_theta.size ();
+  const double* theta = m_theta.data ();
+  double* cosine = m_cos.data ();
+  double* sine = m_sin.data ();
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      cosine[i] = std::cos (theta[i]);
+      sine[i] = std::sin (theta[i]);
+    }
+}
+
+std::complex<double>
+SatFadingOscillatorBank::GetComplexSum (double timeInSeconds)
+{
+  NS_LOG_FUNCTION (this << timeInSeconds);
+
+  CalculatePhases (timeInSeconds);
+  CalculateCosines ();
+
+  /**
+   * The sum is accumulated in the oscillator order, so the result is equal
+   * to the sum of the SatFadingOscillator::GetComplexValueAt values.
+   */
+  const uint32_t n = m_cos.size ();
+  const double* amplitudeReal = m_amplitudeReal.data ();
+  const double* amplitudeImag = m_amplitudeImag.data ();
+  const double* cosine = m_cos.data ();
+  double sumReal = 0.0;
+  double sumImag = 0.0;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      sumReal += amplitudeReal[i] * cosine[i];
+      sumImag += amplitudeImag[i] * cosine[i];
+    }
+
+  return std::complex<double> (sumReal, sumImag);
+}
+
+std::complex<double>
+SatFadingOscillatorBank::GetCosineWaveSum (double timeInSeconds)
+{
+  NS_LOG_FUNCTION (this << timeInSeconds);
+
+  CalculatePhases (timeInSeconds);
+  CalculateCosinesAndSines ();
+
+  const uint32_t n = m_cos.size ();
+  const double* amplitude = m_amplitude.data ();
+  const double* cosine = m_cos.data ();
+  const double* sine = m_sin.data ();
+  double sumReal = 0.0;
+  double sumImag = 0.0;
+
+  // exp (cos + i sin) = exp (cos) * (cos (sin) + i sin (sin)), the values are finite
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double magnitude = amplitude[i] * std::exp (cosine[i]);
+      sumReal += magnitude * std::cos (sine[i]);
+      sumImag += magnitude * std::sin (sine[i]);
+    }
+
+  return std::complex<double> (sumReal, sumImag);
+}
+
+} // namespace ns3
@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+#ifndef SATELLITE_FADING_OSCILLATOR_BANK_H
+#define SATELLITE_FADING_OSCILLATOR_BANK_H
+
+#include <complex>
+#include <vector>
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Bank of fading oscillators stored as a structure of arrays.
+ * The amplitudes, initial phases and rotation speeds of the oscillators
+ * are kept in contiguous arrays, so that the phases and the sums of all
+ * the oscillators are calculated in tight loops. The cosine and the sine
+ * of a phase are calculated in the same pass, which the compiler combines
+ * into one sincos call. The values of the bank are the same as the sums
+ * of the corresponding SatFadingOscillator values.
+ *
+ * The bank keeps scratch buffers for the evaluated phases, thus the sums
+ * are calculated without memory allocations, but the same bank must not
+ * be evaluated concurrently.
+ */
+class SatFadingOscillatorBank
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  SatFadingOscillatorBank ();
+
+  /**
+   * \brief Add an oscillator with complex amplitude
+   * \param amplitude complex amplitude
+   * \param initialPhase initial phase
+   * \param omega rotation speed
+   */
+  void AddOscillator (std::complex<double> amplitude, double initialPhase, double omega);
+
+  /**
+   * \brief Add an oscillator with real amplitude
+   * \param amplitude amplitude
+   * \param initialPhase initial phase
+   * \param omega rotation speed
+   */
+  void AddOscillator (double amplitude, double initialPhase, double omega);
+
+  /**
+   * \brief Remove all the oscillators
+   */
+  void Clear ();
+
+  /**
+   * \brief Get the number of oscillators
+   * \return number of oscillators
+   */
+  uint32_t GetN () const;
+
+  /**
+   * \brief Sum of the complex values of the oscillators at time t,
+   * see SatFadingOscillator::GetComplexValueAt
+   * \param timeInSeconds current time in seconds
+   * \return sum
+   */
+  std::complex<double> GetComplexSum (double timeInSeconds);
+
+  /**
+   * \brief Sum of the cosine wave complex values of the oscillators at
+   * time t, see SatFadingOscillator::GetCosineWaveValueAt
+   * \param timeInSeconds current time in seconds
+   * \return sum
+   */
+  std::complex<double> GetCosineWaveSum (double timeInSeconds);
+
+private:
+  /**
+   * \brief Calculate the phases of the oscillators at time t into the
+   * phase buffer
+   * \param timeInSeconds current time in seconds
+   */
+  void CalculatePhases (double timeInSeconds);
+
+  /**
+   * \brief Calculate the cosines of the phase buffer into the cosine buffer
+   */
+  void CalculateCosines ();
+
+  /**
+   * \brief Calculate the cosines and the sines of the phase buffer into
+   * the cosine and sine buffers in one pass
+   */
+  void CalculateCosinesAndSines ();
+
+  /**
+   * \brief Real and imaginary parts of the complex amplitudes
+   */
+  std::vector<double> m_amplitudeReal;
+  std::vector<double> m_amplitudeImag;
+
+  /**
+   * \brief Real amplitudes
+   */
+  std::vector<double> m_amplitude;
+
+  /**
+   * \brief Initial phases
+   */
+  std::vector<double> m_phase;
+
+  /**
+   * \brief Rotation speeds
+   */
+  std::vector<double> m_omega;
+
+  /**
+   * \brief Scratch buffers for the phases, cosines and sines at the
+   * evaluated time
+   */
+  std::vector<double> m_theta;
+  std::vector<double> m_cos;
+  std::vector<double> m_sin;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_FADING_OSCILLATOR_BANK_H */
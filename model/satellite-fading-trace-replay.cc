@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+#include "satellite-fading-trace-replay.h"
+#include "satellite-utils.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatFadingTraceReplay");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (SatFadingTraceReplay);
+
+TypeId
+SatFadingTraceReplay::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::SatFadingTraceReplay")
+    .SetParent<SatBaseFading> ()
+    .AddConstructor<SatFadingTraceReplay> ();
+  return tid;
+}
+
+SatFadingTraceReplay::SatFadingTraceReplay ()
+  : m_upTrace (),
+    m_downTrace (),
+    m_useDecibels (false)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_FATAL_ERROR ("SatFadingTraceReplay::SatFadingTraceReplay - Constructor not in use.");
+}
+
+SatFadingTraceReplay::SatFadingTraceReplay (Ptr<SatFadingExternalInputTrace> upTrace,
+                                            Ptr<SatFadingExternalInputTrace> downTrace,
+                                            bool useDecibels)
+  : m_upTrace (upTrace),
+    m_downTrace (downTrace),
+    m_useDecibels (useDecibels)
+{
+  NS_LOG_FUNCTION (this << useDecibels);
+}
+
+SatFadingTraceReplay::~SatFadingTraceReplay ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SatFadingTraceReplay::DoDispose ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_upTrace = NULL;
+  m_downTrace = NULL;
+  SatBaseFading::DoDispose ();
+}
+
+double
+SatFadingTraceReplay::DoGetFading (Address macAddress, SatEnums::ChannelType_t channelType)
+{
+  NS_LOG_FUNCTION (this << channelType);
+
+  double fadingValue = 1.0;
+
+  switch (channelType)
+    {
+    case SatEnums::RETURN_USER_CH:
+    case SatEnums::FORWARD_FEEDER_CH:
+      {
+        fadingValue = m_upTrace->GetFading ();
+        break;
+      }
+    case SatEnums::FORWARD_USER_CH:
+    case SatEnums::RETURN_FEEDER_CH:
+      {
+        fadingValue = m_downTrace->GetFading ();
+        break;
+      }
+    default:
+      {
+        NS_FATAL_ERROR ("SatFadingTraceReplay::DoGetFading - Invalid channel type");
+        break;
+      }
+    }
+
+  if (m_useDecibels)
+    {
+      return SatUtils::LinearToDb (fadingValue);
+    }
+
+  return fadingValue;
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+#ifndef SATELLITE_FADING_TRACE_REPLAY_H
+#define SATELLITE_FADING_TRACE_REPLAY_H
+
+#include "satellite-base-fading.h"
+#include "satellite-fading-external-input-trace.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Class for replaying pre-generated Markov fading. The class
+ * implements the fading interface with the uplink and downlink fading
+ * time series of one node, generated offline with
+ * SatFadingTraceGeneratorHelper into the binary format of the external
+ * fading input traces. The time series contain the channel gain in dB,
+ * which is returned either in linear units or in dB, as the Markov
+ * container would return it.
+ */
+class SatFadingTraceReplay : public SatBaseFading
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  SatFadingTraceReplay ();
+
+  /**
+   * \brief Constructor
+   * \param upTrace Fading trace of the return user and forward feeder channels
+   * \param downTrace Fading trace of the forward user and return feeder channels
+   * \param useDecibels Return the fading values in dB
+   */
+  SatFadingTraceReplay (Ptr<SatFadingExternalInputTrace> upTrace,
+                        Ptr<SatFadingExternalInputTrace> downTrace,
+                        bool useDecibels);
+
+  /**
+   * \brief Destructor
+   */
+  ~SatFadingTraceReplay ();
+
+  /**
+   * \brief NS-3 type id function
+   * \return type id
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Function for getting the fading value
+   * \param macAddress MAC address
+   * \param channelType channel type
+   * \return fading value
+   */
+  double DoGetFading (Address macAddress, SatEnums::ChannelType_t channelType);
+
+protected:
+  /**
+   * \brief Do needed dispose actions
+   */
+  virtual void DoDispose ();
+
+private:
+  /**
+   * \brief Uplink fading trace
+   */
+  Ptr<SatFadingExternalInputTrace> m_upTrace;
+
+  /**
+   * \brief Downlink fading trace
+   */
+  Ptr<SatFadingExternalInputTrace> m_downTrace;
+
+  /**
+   * \brief Defines whether the fading values are returned in decibels
+   */
+  bool m_useDecibels;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_FADING_TRACE_REPLAY_H */
@@ -63,8 +63,14 @@ SatFreeSpaceLoss::GetFsl (Ptr<MobilityModel> a, Ptr<MobilityModel> b, double fre
 {
   NS_LOG_FUNCTION (this << frequencyHz);
 
+  return GetFsl (a->GetDistanceFrom (b), frequencyHz);
+}
+
+double
+SatFreeSpaceLoss::GetFsl (double distance, double frequencyHz) const
+{
+  // No logging, since called also by the link budget worker threads
   double fsl;
-  double distance = a->GetDistanceFrom (b);
 
   fsl = std::pow ( ( (4.0 * M_PI * distance * frequencyHz ) / SatConstVariables::SPEED_OF_LIGHT ), 2.0 );
 
@@ -58,6 +58,18 @@ public:
    */
   virtual double GetFsl (Ptr<MobilityModel> a, Ptr<MobilityModel> b, double frequencyHz) const;
 
+  /**
+   * \brief Calculate the free-space loss in linear format for a given distance.
+   * Has no side effects and does not log, thus it may be called also outside
+   * the simulator thread. The mobility model variant delegates to this one,
+   * thus a subclass should override this variant to be used both in the
+   * sequential and in the parallel link budget evaluation of SatChannel.
+   * \param distance Distance between the nodes in meters
+   * \param frequencyHz Frequency in Hertz
+   * \return the free space loss as ratio.
+   */
+  virtual double GetFsl (double distance, double frequencyHz) const;
+
   /**
    * \brief Calculate the free-space loss in dB
    * \param a Mobility model of node a
@@ -195,7 +195,7 @@ SatGeoFeederPhy::SendPduWithParams (Ptr<SatSignalParameters> txParams )
                  m_nodeInfo->GetMacAddress (),
                  SatEnums::LL_PHY,
                  SatEnums::LD_RETURN,
-                 SatUtils::GetPacketInfo (txParams->m_packetsInBurst));
+                 SatUtils::GetPacketInfo (txParams->GetPackets ()));
 
   // copy as sender own PhyTx object (at satellite) to ensure right distance calculation
   // and antenna gain getting at receiver (UT or GW)
@@ -235,16 +235,14 @@ SatGeoFeederPhy::Receive (Ptr<SatSignalParameters> rxParams, bool /*phyError*/)
                  m_nodeInfo->GetMacAddress (),
                  SatEnums::LL_PHY,
                  SatEnums::LD_FORWARD,
-                 SatUtils::GetPacketInfo (rxParams->m_packetsInBurst));
+                 SatUtils::GetPacketInfo (rxParams->GetPackets ()));
 
-  m_rxCallback ( rxParams->m_packetsInBurst, rxParams);
+  m_rxCallback ( rxParams->GetPackets (), rxParams);
 }
 
 double
 SatGeoFeederPhy::CalculateSinr (double sinr)
 {
-  NS_LOG_FUNCTION (this << sinr);
-
   if ( sinr <= 0  )
     {
       NS_FATAL_ERROR ( "Calculated own SINR is expected to be greater than zero!!!");
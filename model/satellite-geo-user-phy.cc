@@ -188,7 +188,7 @@ SatGeoUserPhy::SendPduWithParams (Ptr<SatSignalParameters> txParams )
                  m_nodeInfo->GetMacAddress (),
                  SatEnums::LL_PHY,
                  SatEnums::LD_FORWARD,
-                 SatUtils::GetPacketInfo (txParams->m_packetsInBurst));
+                 SatUtils::GetPacketInfo (txParams->GetPackets ()));
 
   // copy as sender own PhyTx object (at satellite) to ensure right distance calculation
   // and antenna gain getting at receiver (UT or GW)
@@ -212,9 +212,9 @@ SatGeoUserPhy::Receive (Ptr<SatSignalParameters> rxParams, bool /*phyError*/)
                  m_nodeInfo->GetMacAddress (),
                  SatEnums::LL_PHY,
                  SatEnums::LD_RETURN,
-                 SatUtils::GetPacketInfo (rxParams->m_packetsInBurst));
+                 SatUtils::GetPacketInfo (rxParams->GetPackets ()));
 
-  m_rxCallback ( rxParams->m_packetsInBurst, rxParams);
+  m_rxCallback ( rxParams->GetPackets (), rxParams);
 }
 
 double
@@ -181,8 +181,6 @@ SatGwPhy::DoInitialize ()
 double
 SatGwPhy::CalculateSinr (double sinr)
 {
-  NS_LOG_FUNCTION (this << sinr);
-
   if ( sinr <= 0  )
     {
       NS_FATAL_ERROR ( "Calculated own SINR is expected to be greater than zero!!!");
@@ -26,6 +26,7 @@
 #include "ns3/object.h"
 #include "satellite-enums.h"
 #include "satellite-link-results.h"
+#include "satellite-embedded-link-results.h"
 #include "ns3/singleton.h"
 #include "ns3/satellite-env-variables.h"
 
@@ -42,10 +43,10 @@ NS_OBJECT_ENSURE_REGISTERED (SatLinkResults);
 
 
 SatLinkResults::SatLinkResults ()
-  : m_isInitialized (false)
+  : m_inputPath (""),
+    m_dataInputPath (""),
+    m_isInitialized (false)
 {
-  std::string dataPath = Singleton<SatEnvVariables>::Get ()->GetDataPath ();
-  m_inputPath = Singleton<SatEnvVariables>::Get ()->LocateDirectory (dataPath + "/linkresults/");
 }
 
 
@@ -53,7 +54,14 @@ TypeId
 SatLinkResults::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::SatLinkResults")
-    .SetParent<Object> ();
+    .SetParent<Object> ()
+    .AddAttribute ("InputPath",
+                   "Path to the link results files. If empty, the link results embedded into the module are used, "
+                   "or the linkresults folder of the data path if the link results are not embedded.",
+                   StringValue (""),
+                   MakeStringAccessor (&SatLinkResults::m_inputPath),
+                   MakeStringChecker ())
+  ;
   return tid;
 }
 
@@ -65,6 +73,35 @@ SatLinkResults::Initialize ()
   m_isInitialized = true;
 }
 
+Ptr<SatLookUpTable>
+SatLinkResults::CreateLookUpTable (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  if (!m_inputPath.empty ())
+    {
+      return CreateObject<SatLookUpTable> (m_inputPath + fileName);
+    }
+
+  const double *esNoDb;
+  const double *bler;
+  uint32_t size;
+
+  if (SatEmbeddedLinkResults::Find (fileName, esNoDb, bler, size))
+    {
+      NS_LOG_INFO ("Using embedded link results " << fileName);
+      return CreateObject<SatLookUpTable> (esNoDb, bler, size, fileName);
+    }
+
+  if (m_dataInputPath.empty ())
+    {
+      std::string dataPath = Singleton<SatEnvVariables>::Get ()->GetDataPath ();
+      m_dataInputPath = Singleton<SatEnvVariables>::Get ()->LocateDirectory (dataPath + "/linkresults/");
+    }
+
+  return CreateObject<SatLookUpTable> (m_dataInputPath + fileName);
+}
+
 /*
  * SATLINKRESULTSDVBRCS2 CHILD CLASS
  */
@@ -94,16 +131,14 @@ SatLinkResultsDvbRcs2::DoInitialize ()
     {
       std::ostringstream ss;
       ss << i;
-      std::string filePathName = m_inputPath + "rcs2_waveformat" + ss.str () + ".txt";
-      m_table.insert (std::make_pair (i, CreateObject<SatLookUpTable> (filePathName)));
+      std::string fileName = "rcs2_waveformat" + ss.str () + ".txt";
+      m_table.insert (std::make_pair (i, CreateLookUpTable (fileName)));
     }
 } // end of void SatLinkResultsDvbRcs2::DoInitialize
 
 double
 SatLinkResultsDvbRcs2::GetBler (uint32_t waveformId, double ebNoDb) const
 {
-  NS_LOG_FUNCTION (this << waveformId << ebNoDb);
-
   if (!m_isInitialized)
     {
       NS_FATAL_ERROR ("Error retrieving link results, call Initialize first");
@@ -158,44 +193,42 @@ SatLinkResultsDvbS2::DoInitialize ()
   NS_LOG_FUNCTION (this);
 
   // QPSK
-  m_table[SatEnums::SAT_MODCOD_QPSK_1_TO_2] = CreateObject<SatLookUpTable> (m_inputPath + "s2_qpsk_1_to_2.txt");
-  m_table[SatEnums::SAT_MODCOD_QPSK_2_TO_3] = CreateObject<SatLookUpTable> (m_inputPath + "s2_qpsk_2_to_3.txt");
-  m_table[SatEnums::SAT_MODCOD_QPSK_3_TO_4] = CreateObject<SatLookUpTable> (m_inputPath + "s2_qpsk_3_to_4.txt");
-  m_table[SatEnums::SAT_MODCOD_QPSK_3_TO_5] = CreateObject<SatLookUpTable> (m_inputPath + "s2_qpsk_3_to_5.txt");
-  m_table[SatEnums::SAT_MODCOD_QPSK_4_TO_5] = CreateObject<SatLookUpTable> (m_inputPath + "s2_qpsk_4_to_5.txt");
-  m_table[SatEnums::SAT_MODCOD_QPSK_5_TO_6] = CreateObject<SatLookUpTable> (m_inputPath + "s2_qpsk_5_to_6.txt");
-  m_table[SatEnums::SAT_MODCOD_QPSK_8_TO_9] = CreateObject<SatLookUpTable> (m_inputPath + "s2_qpsk_8_to_9.txt");
-  m_table[SatEnums::SAT_MODCOD_QPSK_9_TO_10] = CreateObject<SatLookUpTable> (m_inputPath + "s2_qpsk_9_to_10.txt");
+  m_table[SatEnums::SAT_MODCOD_QPSK_1_TO_2] = CreateLookUpTable ("s2_qpsk_1_to_2.txt");
+  m_table[SatEnums::SAT_MODCOD_QPSK_2_TO_3] = CreateLookUpTable ("s2_qpsk_2_to_3.txt");
+  m_table[SatEnums::SAT_MODCOD_QPSK_3_TO_4] = CreateLookUpTable ("s2_qpsk_3_to_4.txt");
+  m_table[SatEnums::SAT_MODCOD_QPSK_3_TO_5] = CreateLookUpTable ("s2_qpsk_3_to_5.txt");
+  m_table[SatEnums::SAT_MODCOD_QPSK_4_TO_5] = CreateLookUpTable ("s2_qpsk_4_to_5.txt");
+  m_table[SatEnums::SAT_MODCOD_QPSK_5_TO_6] = CreateLookUpTable ("s2_qpsk_5_to_6.txt");
+  m_table[SatEnums::SAT_MODCOD_QPSK_8_TO_9] = CreateLookUpTable ("s2_qpsk_8_to_9.txt");
+  m_table[SatEnums::SAT_MODCOD_QPSK_9_TO_10] = CreateLookUpTable ("s2_qpsk_9_to_10.txt");
 
   // 8PSK
-  m_table[SatEnums::SAT_MODCOD_8PSK_2_TO_3] = CreateObject<SatLookUpTable> (m_inputPath + "s2_8psk_2_to_3.txt");
-  m_table[SatEnums::SAT_MODCOD_8PSK_3_TO_4] = CreateObject<SatLookUpTable> (m_inputPath + "s2_8psk_3_to_4.txt");
-  m_table[SatEnums::SAT_MODCOD_8PSK_3_TO_5] = CreateObject<SatLookUpTable> (m_inputPath + "s2_8psk_3_to_5.txt");
-  m_table[SatEnums::SAT_MODCOD_8PSK_5_TO_6] = CreateObject<SatLookUpTable> (m_inputPath + "s2_8psk_5_to_6.txt");
-  m_table[SatEnums::SAT_MODCOD_8PSK_8_TO_9] = CreateObject<SatLookUpTable> (m_inputPath + "s2_8psk_8_to_9.txt");
-  m_table[SatEnums::SAT_MODCOD_8PSK_9_TO_10] = CreateObject<SatLookUpTable> (m_inputPath + "s2_8psk_9_to_10.txt");
+  m_table[SatEnums::SAT_MODCOD_8PSK_2_TO_3] = CreateLookUpTable ("s2_8psk_2_to_3.txt");
+  m_table[SatEnums::SAT_MODCOD_8PSK_3_TO_4] = CreateLookUpTable ("s2_8psk_3_to_4.txt");
+  m_table[SatEnums::SAT_MODCOD_8PSK_3_TO_5] = CreateLookUpTable ("s2_8psk_3_to_5.txt");
+  m_table[SatEnums::SAT_MODCOD_8PSK_5_TO_6] = CreateLookUpTable ("s2_8psk_5_to_6.txt");
+  m_table[SatEnums::SAT_MODCOD_8PSK_8_TO_9] = CreateLookUpTable ("s2_8psk_8_to_9.txt");
+  m_table[SatEnums::SAT_MODCOD_8PSK_9_TO_10] = CreateLookUpTable ("s2_8psk_9_to_10.txt");
 
   // 16APSK
-  m_table[SatEnums::SAT_MODCOD_16APSK_2_TO_3] = CreateObject<SatLookUpTable> (m_inputPath + "s2_16apsk_2_to_3.txt");
-  m_table[SatEnums::SAT_MODCOD_16APSK_3_TO_4] = CreateObject<SatLookUpTable> (m_inputPath + "s2_16apsk_3_to_4.txt");
-  m_table[SatEnums::SAT_MODCOD_16APSK_4_TO_5] = CreateObject<SatLookUpTable> (m_inputPath + "s2_16apsk_4_to_5.txt");
-  m_table[SatEnums::SAT_MODCOD_16APSK_5_TO_6] = CreateObject<SatLookUpTable> (m_inputPath + "s2_16apsk_5_to_6.txt");
-  m_table[SatEnums::SAT_MODCOD_16APSK_8_TO_9] = CreateObject<SatLookUpTable> (m_inputPath + "s2_16apsk_8_to_9.txt");
-  m_table[SatEnums::SAT_MODCOD_16APSK_9_TO_10] = CreateObject<SatLookUpTable> (m_inputPath + "s2_16apsk_9_to_10.txt");
+  m_table[SatEnums::SAT_MODCOD_16APSK_2_TO_3] = CreateLookUpTable ("s2_16apsk_2_to_3.txt");
+  m_table[SatEnums::SAT_MODCOD_16APSK_3_TO_4] = CreateLookUpTable ("s2_16apsk_3_to_4.txt");
+  m_table[SatEnums::SAT_MODCOD_16APSK_4_TO_5] = CreateLookUpTable ("s2_16apsk_4_to_5.txt");
+  m_table[SatEnums::SAT_MODCOD_16APSK_5_TO_6] = CreateLookUpTable ("s2_16apsk_5_to_6.txt");
+  m_table[SatEnums::SAT_MODCOD_16APSK_8_TO_9] = CreateLookUpTable ("s2_16apsk_8_to_9.txt");
+  m_table[SatEnums::SAT_MODCOD_16APSK_9_TO_10] = CreateLookUpTable ("s2_16apsk_9_to_10.txt");
 
   // 32APSK
-  m_table[SatEnums::SAT_MODCOD_32APSK_3_TO_4] = CreateObject<SatLookUpTable> (m_inputPath + "s2_32apsk_3_to_4.txt");
-  m_table[SatEnums::SAT_MODCOD_32APSK_4_TO_5] = CreateObject<SatLookUpTable> (m_inputPath + "s2_32apsk_4_to_5.txt");
-  m_table[SatEnums::SAT_MODCOD_32APSK_5_TO_6] = CreateObject<SatLookUpTable> (m_inputPath + "s2_32apsk_5_to_6.txt");
-  m_table[SatEnums::SAT_MODCOD_32APSK_8_TO_9] = CreateObject<SatLookUpTable> (m_inputPath + "s2_32apsk_8_to_9.txt");
+  m_table[SatEnums::SAT_MODCOD_32APSK_3_TO_4] = CreateLookUpTable ("s2_32apsk_3_to_4.txt");
+  m_table[SatEnums::SAT_MODCOD_32APSK_4_TO_5] = CreateLookUpTable ("s2_32apsk_4_to_5.txt");
+  m_table[SatEnums::SAT_MODCOD_32APSK_5_TO_6] = CreateLookUpTable ("s2_32apsk_5_to_6.txt");
+  m_table[SatEnums::SAT_MODCOD_32APSK_8_TO_9] = CreateLookUpTable ("s2_32apsk_8_to_9.txt");
 
 } // end of void SatLinkResultsDvbS2::DoInitialize
 
 double
 SatLinkResultsDvbS2::GetBler (SatEnums::SatModcod_t modcod, SatEnums::SatBbFrameType_t frameType, double esNoDb) const
 {
-  NS_LOG_FUNCTION (this << modcod << esNoDb);
-
   if (!m_isInitialized)
     {
       NS_FATAL_ERROR ("Error retrieving link results, call Initialize first");
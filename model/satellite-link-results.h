@@ -74,6 +74,19 @@ public:
   void Initialize ();
 
 protected:
+  /**
+   * \brief Create a look up table for a link results file.
+   *
+   * If no input path is configured and the link results are embedded into
+   * the module, the embedded link results are used. Otherwise the file is
+   * read from the input path, or from the linkresults folder of the data
+   * path if no input path is configured.
+   *
+   * \param fileName Name of the link results file
+   * \return Look up table
+   */
+  Ptr<SatLookUpTable> CreateLookUpTable (std::string fileName);
+
   /**
    * \brief Initialize look up tables.
    *
@@ -87,9 +100,16 @@ protected:
   /**
    * \brief The base path where the text
    *        files containing link results data can be found.
+   *        Overrides the embedded link results, if set.
    */
   std::string m_inputPath;
 
+  /**
+   * \brief The linkresults folder of the data path, located when
+   *        the first link results file is read from it.
+   */
+  std::string m_dataInputPath;
+
   /**
    * \brief Indicates if SatLinkResults::Initialize has been called.
    */
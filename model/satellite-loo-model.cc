@@ -18,6 +18,7 @@
  * Author: Frans Laakso <frans.laakso@magister.fi>
  */
 
+#include "ns3/double.h"
 #include "satellite-loo-model.h"
 #include "satellite-utils.h"
 
@@ -93,29 +94,8 @@ SatLooModel::Reset ()
   m_normalRandomVariable = NULL;
   m_uniformVariable = NULL;
 
-  if (!m_directSignalOscillators.empty ())
-    {
-      for (uint32_t i = 0; i < m_numOfStates; i++)
-        {
-          if (!m_directSignalOscillators[i].empty ())
-            {
-              m_directSignalOscillators[i].clear ();
-            }
-        }
-      m_directSignalOscillators.clear ();
-    }
-
-  if (!m_multipathOscillators.empty ())
-    {
-      for (uint32_t i = 0; i < m_numOfStates; i++)
-        {
-          if (!m_multipathOscillators[i].empty ())
-            {
-              m_multipathOscillators[i].clear ();
-            }
-        }
-      m_multipathOscillators.clear ();
-    }
+  m_directSignalOscillators.clear ();
+  m_multipathOscillators.clear ();
 
   m_looParameters.clear ();
   m_sigma.clear ();
@@ -128,7 +108,7 @@ SatLooModel::ConstructDirectSignalOscillators ()
 
   for (uint32_t i = 0; i < m_numOfStates; i++)
     {
-      std::vector< Ptr<SatFadingOscillator> > oscillators;
+      SatFadingOscillatorBank oscillators;
 
       /// Initial phase is common for all oscillators:
       double phi = m_uniformVariable->GetValue ();
@@ -153,7 +133,7 @@ SatLooModel::ConstructDirectSignalOscillators ()
           amplitude = pow (10,amplitude / 10) / m_looParameters[i][3];
 
           /// 3. Construct oscillator:
-          oscillators.push_back (CreateObject<SatFadingOscillator> (amplitude, phi, omega));
+          oscillators.AddOscillator (amplitude, phi, omega);
         }
       m_directSignalOscillators.push_back (oscillators);
     }
@@ -166,7 +146,7 @@ SatLooModel::ConstructMultipathOscillators ()
 
   for (uint32_t i = 0; i < m_numOfStates; i++)
     {
-      std::vector< Ptr<SatFadingOscillator> > oscillators;
+      SatFadingOscillatorBank oscillators;
 
       /// Initial phase is common for all oscillators:
       double phi = m_uniformVariable->GetValue ();
@@ -184,7 +164,7 @@ SatLooModel::ConstructMultipathOscillators ()
           double psi = m_normalRandomVariable->GetValue ();
           std::complex<double> amplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (m_looParameters[i][4]);
           /// 3. Construct oscillator:
-          oscillators.push_back (CreateObject<SatFadingOscillator> (amplitude, phi, omega));
+          oscillators.AddOscillator (amplitude, phi, omega);
         }
       m_multipathOscillators.push_back (oscillators);
     }
@@ -208,10 +188,10 @@ SatLooModel::GetChannelGain ()
   double timeInSeconds = Now ().GetSeconds ();
 
   /// Direct signal
-  std::complex<double> directComplexGain = GetOscillatorCosineWaveSum (m_directSignalOscillators[m_currentState], timeInSeconds);
+  std::complex<double> directComplexGain = m_directSignalOscillators[m_currentState].GetCosineWaveSum (timeInSeconds);
 
   /// Multipath
-  std::complex<double> multipathComplexGain = GetOscillatorComplexSum (m_multipathOscillators[m_currentState], timeInSeconds);
+  std::complex<double> multipathComplexGain = m_multipathOscillators[m_currentState].GetComplexSum (timeInSeconds);
   multipathComplexGain = multipathComplexGain * m_sigma[m_currentState];
 
   /// Combining
@@ -219,36 +199,6 @@ SatLooModel::GetChannelGain ()
   return sqrt ((pow (fadingGain.real (), 2) + pow (fadingGain.imag (), 2)));
 }
 
-std::complex<double>
-SatLooModel::GetOscillatorCosineWaveSum (std::vector< Ptr<SatFadingOscillator> > oscillator, double timeInSeconds)
-{
-  NS_LOG_FUNCTION (this);
-
-  std::complex<double> complexSum = std::complex<double> (0, 0);
-
-  for (uint32_t i = 0; i < oscillator.size (); i++)
-    {
-      complexSum += oscillator[i]->GetCosineWaveValueAt (timeInSeconds);
-    }
-
-  return complexSum;
-}
-
-std::complex<double>
-SatLooModel::GetOscillatorComplexSum (std::vector< Ptr<SatFadingOscillator> > oscillator, double timeInSeconds)
-{
-  NS_LOG_FUNCTION (this);
-
-  std::complex<double> complexSum = std::complex<double> (0, 0);
-
-  for (uint32_t i = 0; i < oscillator.size (); i++)
-    {
-      complexSum += oscillator[i]->GetComplexValueAt (timeInSeconds);
-    }
-
-  return complexSum;
-}
-
 void
 SatLooModel::UpdateParameters (uint32_t newSet, uint32_t newState)
 {
@@ -276,29 +226,8 @@ SatLooModel::ChangeSet (uint32_t newSet, uint32_t newState)
 
   ChangeState (newState);
 
-  if (!m_directSignalOscillators.empty ())
-    {
-      for (uint32_t i = 0; i < m_numOfStates; i++)
-        {
-          if (!m_directSignalOscillators[i].empty ())
-            {
-              m_directSignalOscillators[i].clear ();
-            }
-        }
-      m_directSignalOscillators.clear ();
-    }
-
-  if (!m_multipathOscillators.empty ())
-    {
-      for (uint32_t i = 0; i < m_numOfStates; i++)
-        {
-          if (!m_multipathOscillators[i].empty ())
-            {
-              m_multipathOscillators[i].clear ();
-            }
-        }
-      m_multipathOscillators.clear ();
-    }
+  m_directSignalOscillators.clear ();
+  m_multipathOscillators.clear ();
 
   m_sigma.clear ();
 
@@ -20,9 +20,12 @@
  */
 
 #include <cmath>
+#include <algorithm>
+#include <functional>
 
 #include "ns3/log.h"
 #include "ns3/fatal-error.h"
+#include "ns3/double.h"
 #include "satellite-look-up-table.h"
 #include "satellite-utils.h"
 
@@ -34,9 +37,46 @@ NS_OBJECT_ENSURE_REGISTERED (SatLookUpTable);
 
 
 SatLookUpTable::SatLookUpTable (std::string linkResultPath)
+  : m_ifs (0),
+    m_uniformBler (),
+    m_uniformEsNoDbMin (0.0),
+    m_uniformStepDb (0.0),
+    m_uniformStepDbInv (0.0),
+    m_resamplingStepDb (0.05),
+    m_maxResamplingError (0.01)
 {
   NS_LOG_FUNCTION (this << linkResultPath);
+
+  // Attributes are needed already in construction phase
+  ObjectBase::ConstructSelf (AttributeConstructionList ());
+
   Load (linkResultPath);
+  Resample (linkResultPath);
+}
+
+
+SatLookUpTable::SatLookUpTable (const double *esNoDb, const double *bler, uint32_t size, std::string name)
+  : m_esNoDb (esNoDb, esNoDb + size),
+    m_bler (bler, bler + size),
+    m_ifs (0),
+    m_uniformBler (),
+    m_uniformEsNoDbMin (0.0),
+    m_uniformStepDb (0.0),
+    m_uniformStepDbInv (0.0),
+    m_resamplingStepDb (0.05),
+    m_maxResamplingError (0.01)
+{
+  NS_LOG_FUNCTION (this << size << name);
+
+  // Attributes are needed already in construction phase
+  ObjectBase::ConstructSelf (AttributeConstructionList ());
+
+  if (m_esNoDb.empty ())
+    {
+      NS_FATAL_ERROR ("No link results given for " << name << ".");
+    }
+
+  Resample (name);
 }
 
 
@@ -53,6 +93,7 @@ SatLookUpTable::DoDispose ()
 
   m_esNoDb.clear ();
   m_bler.clear ();
+  m_uniformBler.clear ();
 
   if (m_ifs != 0)
     {
@@ -74,43 +115,80 @@ SatLookUpTable::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::SatLookUpTable")
     .SetParent<Object> ()
+    .AddAttribute ("ResamplingStepDb",
+                   "Initial Es/No step of the uniformly resampled link results in dB (0 = no resampling)",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&SatLookUpTable::m_resamplingStepDb),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("MaxResamplingError",
+                   "Maximum accepted relative BLER error of the resampled link results. The error is relative "
+                   "to the BLER of the link results, but at least to their smallest non-zero BLER.",
+                   DoubleValue (0.01),
+                   MakeDoubleAccessor (&SatLookUpTable::m_maxResamplingError),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
+TypeId
+SatLookUpTable::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
 
 
 double
 SatLookUpTable::GetBler (double esNoDb) const
 {
-  NS_LOG_FUNCTION (this << esNoDb);
+  if (m_uniformBler.empty ())
+    {
+      return GetBlerFromLinkResults (esNoDb);
+    }
 
-  uint16_t n = m_esNoDb.size ();
+  double pos = (esNoDb - m_uniformEsNoDbMin) * m_uniformStepDbInv;
 
-  NS_ASSERT (n > 0);
-  NS_ASSERT (m_bler.size () == n);
-
-  if (esNoDb < m_esNoDb[0])
+  if (pos < 0.0)
     {
       // edge case: very low SINR, return maximum BLER (100% error rate)
-      NS_LOG_INFO (this << " Very low SINR -> BLER = 1.0");
       return 1.0;
     }
 
-  uint16_t i = 1;
+  if (esNoDb > m_esNoDb.back ())
+    {
+      // edge case: very high SINR, return minimum BLER (100% success rate)
+      return 0.0;
+    }
 
-  while ((i < n) && (esNoDb > m_esNoDb[i]))
+  // normal case, the last point belongs to the last interval
+  uint32_t i = std::min ((uint32_t)(pos), (uint32_t)(m_uniformBler.size () - 2));
+  double relPos = pos - i;
+  double bler = m_uniformBler[i] + relPos * (m_uniformBler[i + 1] - m_uniformBler[i]);
+
+  return bler;
+} // end of double SatLookUpTable::GetBler (double sinrDb) const
+
+
+double
+SatLookUpTable::GetBlerFromLinkResults (double esNoDb) const
+{
+  uint32_t n = m_esNoDb.size ();
+
+  NS_ASSERT (n > 0);
+  NS_ASSERT (m_bler.size () == n);
+
+  if (esNoDb < m_esNoDb[0])
     {
-      i++;
+      // edge case: very low SINR, return maximum BLER (100% error rate)
+      return 1.0;
     }
 
-  NS_LOG_DEBUG (this << " i=" << i << " esno[i]=" << m_esNoDb[i]
-                     << " bler[i]=" << m_bler[i]);
+  // the first point from the second one onwards with Es/No not below the given one
+  uint32_t i = std::lower_bound (m_esNoDb.begin () + 1, m_esNoDb.end (), esNoDb) - m_esNoDb.begin ();
 
   if (i >= n)
     {
       // edge case: very high SINR, return minimum BLER (100% success rate)
-      NS_LOG_INFO (this << " Very high SINR -> BLER = 0.0");
       return 0.0;
     }
   else // sinrDb <= m_esNoDb[i]
@@ -123,12 +201,10 @@ SatLookUpTable::GetBler (double esNoDb) const
       double esno0 = m_esNoDb[i - 1];
       double esno1 = m_esNoDb[i];
       double bler = SatUtils::Interpolate (esno, esno0, esno1, m_bler[i - 1], m_bler[i]);
-      NS_LOG_INFO (this << " Interpolate: " << esno << " to BLER = " << bler << "(sinr0: " << esno0 << ", sinr1: " << esno1 << ", bler0: " << m_bler[i - 1] << ", bler1: " << m_bler[i] << ")");
 
       return bler;
     }
-
-} // end of double SatLookUpTable::GetBler (double sinrDb) const
+}
 
 
 double
@@ -136,9 +212,9 @@ SatLookUpTable::GetEsNoDb (double blerTarget) const
 {
   NS_LOG_FUNCTION (this << blerTarget);
 
-  uint16_t n = m_bler.size ();
+  uint32_t n = m_bler.size ();
 
-  NS_ASSERT (n > 0);
+  NS_ASSERT (n > 1);
   NS_ASSERT (m_esNoDb.size () == n);
 
   // If the requested BLER is smaller than the smallest BLER entry
@@ -155,22 +231,127 @@ SatLookUpTable::GetEsNoDb (double blerTarget) const
       NS_FATAL_ERROR ("The BLER target is set to be too high!");
     }
 
-  double sinr = 0.0;
-  // Go through the list from end to beginning
-  for (uint32_t i = 0; i < n; ++i)
+  // The BLER is non-increasing, thus the first point with BLER not above
+  // the target is searched with binary search
+  const std::vector<double>& blers = m_uniformBler.empty () ? m_bler : m_uniformBler;
+  uint32_t i = std::lower_bound (blers.begin (), blers.end (), blerTarget, std::greater<double> ()) - blers.begin ();
+  i = std::max (i, (uint32_t)(1));
+
+  double esNo0, esNo1;
+
+  if (m_uniformBler.empty ())
     {
-      if (blerTarget >= m_bler[i])
-        {
-          sinr = SatUtils::Interpolate (blerTarget, m_bler[i - 1], m_bler[i], m_esNoDb[i - 1], m_esNoDb[i]);
-          NS_LOG_INFO (this << " Interpolate: " << blerTarget << " to SINR = " << sinr << "(bler0: " << m_bler[i - 1] << ", bler1: " << m_bler[i] << ", sinr0: " << m_esNoDb[i - 1] << ", sinr1: " << m_esNoDb[i] << ")");
-          return sinr;
-        }
+      esNo0 = m_esNoDb[i - 1];
+      esNo1 = m_esNoDb[i];
+    }
+  else
+    {
+      esNo0 = m_uniformEsNoDbMin + (i - 1) * m_uniformStepDb;
+      esNo1 = (i == blers.size () - 1) ? m_esNoDb.back () : m_uniformEsNoDbMin + i * m_uniformStepDb;
     }
 
+  double sinr = SatUtils::Interpolate (blerTarget, blers[i - 1], blers[i], esNo0, esNo1);
+  NS_LOG_INFO (this << " Interpolate: " << blerTarget << " to SINR = " << sinr << "(bler0: " << blers[i - 1] << ", bler1: " << blers[i] << ", sinr0: " << esNo0 << ", sinr1: " << esNo1 << ")");
+
   return sinr;
 } // end of double SatLookUpTable::GetSinr (double bler) const
 
 
+bool
+SatLookUpTable::IsResampled () const
+{
+  NS_LOG_FUNCTION (this);
+
+  return !m_uniformBler.empty ();
+}
+
+
+void
+SatLookUpTable::Resample (std::string linkResultPath)
+{
+  NS_LOG_FUNCTION (this << linkResultPath);
+
+  if (m_esNoDb.size () < 2 || m_resamplingStepDb <= 0.0)
+    {
+      return;
+    }
+
+  double range = m_esNoDb.back () - m_esNoDb.front ();
+  double stepDb = m_resamplingStepDb;
+
+  while (true)
+    {
+      uint32_t nIntervals = (uint32_t)(std::max (1.0, std::ceil (range / stepDb)));
+
+      if (nIntervals >= MAX_RESAMPLED_POINTS)
+        {
+          NS_LOG_WARN ("Resampling of " << linkResultPath << " does not meet the relative BLER error " << m_maxResamplingError
+                       << ", using the original link results");
+          m_uniformBler.clear ();
+          return;
+        }
+
+      m_uniformEsNoDbMin = m_esNoDb.front ();
+      m_uniformStepDb = range / nIntervals;
+      m_uniformStepDbInv = nIntervals / range;
+      m_uniformBler.resize (nIntervals + 1);
+
+      for (uint32_t i = 0; i < nIntervals; ++i)
+        {
+          m_uniformBler[i] = GetBlerFromLinkResults (m_uniformEsNoDbMin + i * m_uniformStepDb);
+        }
+
+      // The last point is taken as such to avoid rounding past the link results
+      m_uniformBler[nIntervals] = m_bler.back ();
+
+      double maxError = GetMaxResamplingError ();
+
+      if (maxError <= m_maxResamplingError)
+        {
+          NS_LOG_INFO ("Resampled " << linkResultPath << ": " << m_esNoDb.size () << " -> " << m_uniformBler.size () <<
+                       " points, step: " << m_uniformStepDb << " dB, max relative BLER error: " << maxError);
+          return;
+        }
+
+      stepDb /= 2.0;
+    }
+}
+
+
+double
+SatLookUpTable::GetMaxResamplingError () const
+{
+  NS_LOG_FUNCTION (this);
+
+  // The errors of the zero BLER values are relative to the smallest non-zero BLER
+  double minBler (1.0);
+
+  for (uint32_t i = 0; i < m_bler.size (); ++i)
+    {
+      if (m_bler[i] > 0.0)
+        {
+          minBler = std::min (minBler, m_bler[i]);
+        }
+    }
+
+  double maxError (0.0);
+
+  for (uint32_t i = 0; i < m_esNoDb.size (); ++i)
+    {
+      maxError = std::max (maxError, std::abs (GetBler (m_esNoDb[i]) - m_bler[i]) / std::max (m_bler[i], minBler));
+
+      if (i + 1 < m_esNoDb.size ())
+        {
+          double esNoDb = (m_esNoDb[i] + m_esNoDb[i + 1]) / 2.0;
+          double bler = GetBlerFromLinkResults (esNoDb);
+          maxError = std::max (maxError, std::abs (GetBler (esNoDb) - bler) / std::max (bler, minBler));
+        }
+    }
+
+  return maxError;
+}
+
+
 void
 SatLookUpTable::Load (std::string linkResultPath)
 {
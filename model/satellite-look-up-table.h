@@ -34,6 +34,17 @@ namespace ns3 {
  * \ingroup satellite
  *
  * \brief Loads a link result file and provide query service for BLER.
+ *
+ * At load time, the link results are resampled to a uniform Es/No grid,
+ * so that a BLER look-up is a direct index calculation and one linear
+ * interpolation. The resampling step is halved until the maximum relative
+ * BLER error of the resampled curve (checked at the original points and at
+ * the mid-points between them) is within the configured tolerance. The error
+ * is relative to the BLER of the link results, but at least to the smallest
+ * non-zero BLER of the link results, so that the low BLER targets inverted
+ * by GetEsNoDb are as accurate as the high ones. If the tolerance cannot be
+ * met with a reasonable table size, a warning is logged and the original
+ * link results are used.
  */
 class SatLookUpTable : public Object
 {
@@ -45,6 +56,16 @@ public:
    */
   SatLookUpTable (std::string linkResultPath);
 
+  /**
+   * Constructor with link results given as arrays, e.g. the link results
+   * embedded into the module.
+   * \param esNoDb Es/No values in dB in ascending order
+   * \param bler BLER values related to the Es/No values
+   * \param size Number of the values
+   * \param name Name of the link results, for logging
+   */
+  SatLookUpTable (const double *esNoDb, const double *bler, uint32_t size, std::string name);
+
   /**
    * Destructor for SatLookUpTable
    */
@@ -57,7 +78,14 @@ public:
   static TypeId GetTypeId ();
 
   /**
-   * \brief Get the BLER corresponding to a given SINR
+   * \brief Get the type ID of instance
+   * \return the object TypeId
+   */
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /**
+   * \brief Get the BLER corresponding to a given SINR. The function does
+   * not log, thus it may be called from several threads in parallel.
    * \param sinrDb SINR in logarithmic scale
    * \return BLER
    */
@@ -70,6 +98,14 @@ public:
    */
   double GetEsNoDb (double blerTarget) const;
 
+  /**
+   * \brief Check whether the link results were resampled to a uniform Es/No
+   * grid, or the original link results are used as the resampling did not
+   * meet the MaxResamplingError tolerance
+   * \return true if the link results are resampled
+   */
+  bool IsResampled () const;
+
 private:
   virtual void DoDispose ();
 
@@ -79,9 +115,58 @@ private:
    */
   void Load (std::string linkResultPath);
 
+  /**
+   * \brief Resample the link results to a uniform Es/No grid
+   * \param linkResultPath Path to the link results file, for logging
+   */
+  void Resample (std::string linkResultPath);
+
+  /**
+   * \brief Get the BLER from the original link results
+   * \param esNoDb Es/No in logarithmic scale
+   * \return BLER
+   */
+  double GetBlerFromLinkResults (double esNoDb) const;
+
+  /**
+   * \brief Get the maximum relative BLER error of the resampled link results
+   * at the original points and the mid-points between them
+   * \return maximum relative BLER error
+   */
+  double GetMaxResamplingError () const;
+
+  /**
+   * \brief Maximum number of points in the resampled link results
+   */
+  static const uint32_t MAX_RESAMPLED_POINTS = 65536;
+
   std::vector<double> m_esNoDb;
   std::vector<double> m_bler;
   std::ifstream *m_ifs;
+
+  /**
+   * \brief BLER values of the resampled link results. Empty if the original
+   * link results are used.
+   */
+  std::vector<double> m_uniformBler;
+
+  /**
+   * \brief Es/No of the first point, step and inverse step of the resampled
+   * link results
+   */
+  double m_uniformEsNoDbMin;
+  double m_uniformStepDb;
+  double m_uniformStepDbInv;
+
+  /**
+   * \brief Initial Es/No step of the resampling in dB
+   */
+  double m_resamplingStepDb;
+
+  /**
+   * \brief Maximum accepted relative BLER error of the resampling
+   */
+  double m_maxResamplingError;
 };
 
 } // end of namespace ns3
@@ -88,6 +88,8 @@ SatMarkovContainer::SatMarkovContainer (Ptr<SatMarkovConf> markovConf, SatBaseFa
 {
   NS_LOG_FUNCTION (this);
 
+  SetVelocityCallback (velocity);
+
   /// create Markov model
   m_markovModel = CreateObject<SatMarkovModel> (m_numOfStates,m_currentState);
 
@@ -198,6 +200,14 @@ SatMarkovContainer::DoGetFading (Address macAddress, SatEnums::ChannelType_t cha
   return fadingValue;
 }
 
+void
+SatMarkovContainer::NotifyCacheHit (Address macAddress, SatEnums::ChannelType_t channelType, double fadingValue)
+{
+  NS_LOG_FUNCTION (this << channelType << fadingValue);
+
+  m_fadingTrace (Now ().GetSeconds (), channelType, fadingValue);
+}
+
 double
 SatMarkovContainer::GetCachedFadingValue (SatEnums::ChannelType_t channelType)
 {
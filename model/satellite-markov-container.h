@@ -125,6 +125,16 @@ public:
   typedef void (*FadingTraceCallback)
     (double time, SatEnums::ChannelType_t channelType, double value);
 
+protected:
+  /**
+   * \brief Fire the fading trace also for the values served from the
+   * coherence time cache of SatBaseFading
+   * \param macAddress MAC address
+   * \param channelType channel type
+   * \param fadingValue cached fading value
+   */
+  virtual void NotifyCacheHit (Address macAddress, SatEnums::ChannelType_t channelType, double fadingValue);
+
 private:
   /**
    * \brief Markov model object
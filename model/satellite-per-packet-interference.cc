@@ -94,21 +94,8 @@ SatPerPacketInterference::DoAdd (Time duration, double power, Address rxAddress)
 
   NS_LOG_INFO ( "Add change: Duration= " << duration << ", Power= " << power << ", Time: " << now );
 
-  // do update and clean-ups, if we are not receiving
-  if (!m_rxing)
-    {
-      InterferenceChanges::iterator nowIterator = m_interferenceChanges.upper_bound (now);
-
-      for (InterferenceChanges::iterator i = m_interferenceChanges.begin (); i != nowIterator; i++)
-        {
-          NS_LOG_INFO ( "Change to erase: Time= " << i->first << ", Id= " << i->second.first << ", PowerValue= " << i->second.second);
-
-          m_residualPowerW += i->second.second;
-
-          NS_LOG_INFO ( "First power after erase: " << m_residualPowerW);
-        }
-      m_interferenceChanges.erase (m_interferenceChanges.begin (), nowIterator);
-    }
+  // do clean-ups up to the start of the oldest ongoing reception, or up to now if we are not receiving
+  PruneChanges (m_rxing ? m_rxEventStartTimes.begin ()->second : now);
 
   NS_LOG_INFO ( "Change count before addition: " << m_interferenceChanges.size () );
 
@@ -123,8 +110,8 @@ SatPerPacketInterference::DoAdd (Time duration, double power, Address rxAddress)
         }
     }
 
-  m_interferenceChanges.insert (std::make_pair (now, InterferenceChange (event->GetId (), power)));
-  m_interferenceChanges.insert (std::make_pair (event->GetEndTime (), InterferenceChange (event->GetId (), -power)));
+  InsertChange (now, event->GetId (), power);
+  InsertChange (event->GetEndTime (), event->GetId (), -power);
 
   NS_LOG_INFO ( "Change count after addition: " << m_interferenceChanges.size () );
 
@@ -137,6 +124,56 @@ SatPerPacketInterference::DoAdd (Time duration, double power, Address rxAddress)
   return event;
 }
 
+bool
+SatPerPacketInterference::IsBefore (const Time &time, const InterferenceChange_s &change)
+{
+  return time < change.m_time;
+}
+
+void
+SatPerPacketInterference::InsertChange (Time time, uint32_t id, long double powerW)
+{
+  NS_LOG_FUNCTION (this << time << id << powerW);
+
+  // changes are added close to the end of the timeline, since only the
+  // end times of the ongoing transmissions are in the future
+  InterferenceChanges::iterator position = std::upper_bound (m_interferenceChanges.begin (),
+                                                             m_interferenceChanges.end (),
+                                                             time, IsBefore);
+
+  InterferenceChange_s change;
+  change.m_time = time;
+  change.m_id = id;
+  change.m_powerW = powerW;
+  change.m_cumulativePowerW = powerW;
+  change.m_cumulativePowerW += (position == m_interferenceChanges.begin ()) ? m_residualPowerW : (position - 1)->m_cumulativePowerW;
+
+  position = m_interferenceChanges.insert (position, change);
+
+  for (++position; position != m_interferenceChanges.end (); ++position)
+    {
+      position->m_cumulativePowerW += powerW;
+    }
+}
+
+void
+SatPerPacketInterference::PruneChanges (Time watermark)
+{
+  NS_LOG_FUNCTION (this << watermark);
+
+  while (!m_interferenceChanges.empty () && m_interferenceChanges.front ().m_time <= watermark)
+    {
+      const InterferenceChange_s &change = m_interferenceChanges.front ();
+
+      NS_LOG_INFO ( "Change to erase: Time= " << change.m_time << ", Id= " << change.m_id << ", PowerValue= " << change.m_powerW);
+
+      m_residualPowerW = change.m_cumulativePowerW;
+      m_interferenceChanges.pop_front ();
+
+      NS_LOG_INFO ( "First power after erase: " << m_residualPowerW);
+    }
+}
+
 double
 SatPerPacketInterference::DoCalculate (Ptr<SatInterference::InterferenceChangeEvent> event)
 {
@@ -147,46 +184,33 @@ SatPerPacketInterference::DoCalculate (Ptr<SatInterference::InterferenceChangeEv
       NS_FATAL_ERROR ("Receiving is not set on!!!");
     }
 
-  double ifPowerW = m_residualPowerW;
   double rxDuration = event->GetDuration ().GetDouble ();
   double rxEndTime = event->GetEndTime ().GetDouble ();
-  bool ownStartReached = false;
 
-  NS_LOG_INFO ( "Calculate: IfPower (W)= " << ifPowerW << ", Duration= " << event->GetDuration () <<
+  NS_LOG_INFO ( "Calculate: Duration= " << event->GetDuration () <<
                  ", StartTime= " << event->GetStartTime () << ", EndTime= " << event->GetEndTime () );
 
-  InterferenceChanges::iterator currentItem = m_interferenceChanges.begin ();
+  InterferenceChanges::const_iterator currentItem = std::upper_bound (m_interferenceChanges.begin (),
+                                                                      m_interferenceChanges.end (),
+                                                                      event->GetStartTime (), IsBefore);
 
-  // calculate power values until own "stop" event found (own negative power event)
-  while ( (currentItem != m_interferenceChanges.end ())
-          && !( (event->GetId () == currentItem->second.first) && (event->GetRxPower () == -currentItem->second.second)) )
-    {
-      if (event->GetId () == currentItem->second.first)
-        {
-          // stop increasing power value fully, when own 'start' event is reached
-          // needed to support multiple simultaneous receiving (currently not supported)
-          // own event is not updated to ifPower
-          ownStartReached = true;
-        }
-      else if (ownStartReached)
-        {
-          // increase/decrease interference power with relative part of duration of power change in list
-          double itemTime = currentItem->first.GetDouble ();
-          ifPowerW += ((rxEndTime - itemTime) / rxDuration) * currentItem->second.second;
+  // changes until own start are fully included in the interference power,
+  // own power is not part of the interference
+  long double ifPowerW = (currentItem == m_interferenceChanges.begin ()) ? m_residualPowerW : (currentItem - 1)->m_cumulativePowerW;
+  ifPowerW -= event->GetRxPower ();
 
-          NS_LOG_INFO ( "Update (partial): ID: " << currentItem->second.first << ", Power (W)= " << currentItem->second.second <<
-                         ", Time= " << currentItem->first << ", DeltaTime= " << (rxEndTime - itemTime) );
+  NS_LOG_INFO ( "IfPower (W) at own start= " << ifPowerW );
 
-          NS_LOG_INFO ( "IfPower after update: " << ifPowerW );
-        }
-      else
-        {
-          // increase/decrease interference power with full power change in list
-          ifPowerW += currentItem->second.second;
+  // increase/decrease interference power with relative part of duration of power changes until own end
+  while ( (currentItem != m_interferenceChanges.end ()) && (currentItem->m_time < event->GetEndTime ()) )
+    {
+      double itemTime = currentItem->m_time.GetDouble ();
+      ifPowerW += ((rxEndTime - itemTime) / rxDuration) * currentItem->m_powerW;
 
-          NS_LOG_INFO ( "Update (full): ID: " << currentItem->second.first << ", Power (W)= " << currentItem->second.second );
-          NS_LOG_INFO ( "IfPower after update: " << ifPowerW );
-        }
+      NS_LOG_INFO ( "Update (partial): ID: " << currentItem->m_id << ", Power (W)= " << currentItem->m_powerW <<
+                     ", Time= " << currentItem->m_time << ", DeltaTime= " << (rxEndTime - itemTime) );
+
+      NS_LOG_INFO ( "IfPower after update: " << ifPowerW );
 
       currentItem++;
     }
@@ -208,6 +232,7 @@ SatPerPacketInterference::DoReset (void)
   NS_LOG_FUNCTION (this);
 
   m_interferenceChanges.clear ();
+  m_rxEventStartTimes.clear ();
   m_rxing = false;
   m_residualPowerW = 0.0;
 }
@@ -217,7 +242,7 @@ SatPerPacketInterference::DoNotifyRxStart (Ptr<SatInterference::InterferenceChan
 {
   NS_LOG_FUNCTION (this);
 
-  std::pair<std::set<uint32_t>::iterator, bool> result = m_rxEventIds.insert (event->GetId ());
+  std::pair<std::map<uint32_t, Time>::iterator, bool> result = m_rxEventStartTimes.insert (std::make_pair (event->GetId (), event->GetStartTime ()));
 
   NS_ASSERT (result.second);
   m_rxing = true;
@@ -228,9 +253,9 @@ SatPerPacketInterference::DoNotifyRxEnd (Ptr<SatInterference::InterferenceChange
 {
   NS_LOG_FUNCTION (this);
 
-  m_rxEventIds.erase (event->GetId ());
+  m_rxEventStartTimes.erase (event->GetId ());
 
-  if (m_rxEventIds.empty ())
+  if (m_rxEventStartTimes.empty ())
     {
       m_rxing = false;
     }
@@ -22,7 +22,7 @@
 #define SATELLITE_PER_PACKET_INTERFERENCE_H
 
 #include <map>
-#include <set>
+#include <deque>
 #include "satellite-interference.h"
 #include "satellite-interference-output-trace-container.h"
 #include "satellite-enums.h"
@@ -119,14 +119,50 @@ private:
   virtual void DoNotifyRxEnd (Ptr<SatInterference::InterferenceChangeEvent> event);
 
   /**
-   *
+   * \brief Change of the interference power in the interference timeline
    */
-  typedef std::pair <uint32_t, long double > InterferenceChange;
+  typedef struct
+  {
+    Time m_time;
+    uint32_t m_id;
+    long double m_powerW;
+    long double m_cumulativePowerW;
+  } InterferenceChange_s;
 
   /**
-   *
+   * \brief Interference timeline. The changes are kept in time order, and
+   * a change with equal time is placed after the existing ones. The
+   * cumulative power of a change is the residual power plus the sum of the
+   * powers of the changes up to and including the change itself.
+   */
+  typedef std::deque <InterferenceChange_s> InterferenceChanges;
+
+  /**
+   * \brief Compare a time to the time of an interference change
+   * \param time Time to compare
+   * \param change Interference change to compare
+   * \return true if the time is before the change
+   */
+  static bool IsBefore (const Time &time, const InterferenceChange_s &change);
+
+  /**
+   * \brief Insert an interference change to the timeline and update the
+   * cumulative power of the later changes.
+   * \param time Time of the change
+   * \param id Id of the interference event
+   * \param powerW Power change in Watts
+   */
+  void InsertChange (Time time, uint32_t id, long double powerW);
+
+  /**
+   * \brief Remove the changes at or before the watermark from the timeline
+   * and add their power to the residual power. The changes can be removed,
+   * since they are fully included to the interference of all the ongoing
+   * and future receptions.
+   * \param watermark Start time of the oldest ongoing reception, or the
+   * current time if there are no ongoing receptions
    */
-  typedef std::multimap <Time, InterferenceChange > InterferenceChanges;
+  void PruneChanges (Time watermark);
 
   /**
    *
@@ -142,18 +178,20 @@ private:
   SatPerPacketInterference &operator = (const SatPerPacketInterference &o);
 
   /**
-   * \brief interference change list
+   * \brief interference change timeline
    */
   InterferenceChanges m_interferenceChanges;
 
   /**
-   * \brief notified interference event IDs
+   * \brief start times of the notified interference events by event ID.
+   * Event IDs grow with the start time, so the first item is the oldest
+   * ongoing reception.
    */
-  std::set <uint32_t> m_rxEventIds;
+  std::map <uint32_t, Time> m_rxEventStartTimes;
 
   /**
    * \brief Residual power value for interference.
-   * Sum of negative values in list m_changes, which positive value is not in list.
+   * Sum of the power values removed from the timeline.
    */
   long double m_residualPowerW;
 
@@ -53,7 +53,8 @@ SatPhyRxCarrierConf::SatPhyRxCarrierConf ()
     m_raCollisionModel (RA_COLLISION_NOT_DEFINED),
     m_raConstantErrorRate (0.0),
     m_enableRandomAccessDynamicLoadControl (true),
-		m_randomAccessModel ()
+		m_randomAccessModel (),
+    m_coChannelActivity ()
 {
   NS_FATAL_ERROR ("SatPhyRxCarrierConf::SatPhyRxCarrierConf - Constructor not in use");
 }
@@ -78,7 +79,8 @@ SatPhyRxCarrierConf::SatPhyRxCarrierConf (RxCarrierCreateParams_s createParams)
     m_raCollisionModel (createParams.m_raCollisionModel),
     m_raConstantErrorRate (createParams.m_raConstantErrorRate),
     m_enableRandomAccessDynamicLoadControl (true),
-		m_randomAccessModel (createParams.m_randomAccessModel)
+		m_randomAccessModel (createParams.m_randomAccessModel),
+    m_coChannelActivity (createParams.m_coChannelActivity)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -114,6 +116,7 @@ SatPhyRxCarrierConf::DoDispose ()
   NS_LOG_FUNCTION (this);
 
   m_linkResults = NULL;
+  m_coChannelActivity = NULL;
   m_carrierBandwidthConverter.Nullify ();
   m_sinrCalculate.Nullify ();
 
@@ -225,6 +228,12 @@ SatPhyRxCarrierConf::GetRandomAccessCollisionModel () const
     }
 }
 
+Ptr<SatCoChannelActivity>
+SatPhyRxCarrierConf::GetCoChannelActivity () const
+{
+  return m_coChannelActivity;
+}
+
 double
 SatPhyRxCarrierConf::GetRandomAccessConstantErrorRate () const
 {
@@ -71,7 +71,7 @@ public:
    */
   enum InterferenceModel
   {
-    IF_PER_PACKET, IF_TRACE, IF_CONSTANT
+    IF_PER_PACKET, IF_TRACE, IF_CONSTANT, IF_CO_CHANNEL
   };
 
   /**
@@ -94,6 +94,7 @@ public:
    * \param converter Bandwidth converter
    * \param carrierCount carrier count
    * \param cec Channel estimation error container
+   * \param coChannelActivity Co-channel activity of the channel, used by co-channel interference model
    */
   typedef struct RxCarrierCreateParams_s
   {
@@ -112,6 +113,7 @@ public:
     RandomAccessCollisionModel               m_raCollisionModel;
     double                                   m_raConstantErrorRate;
     SatEnums::RandomAccessModel_t            m_randomAccessModel;
+    Ptr<SatCoChannelActivity>                m_coChannelActivity;
 
     RxCarrierCreateParams_s ()
       : m_rxTemperatureK (0.0),
@@ -128,7 +130,8 @@ public:
         m_cec (NULL),
         m_raCollisionModel (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR),
         m_raConstantErrorRate (0.0),
-				m_randomAccessModel (SatEnums::RA_MODEL_OFF)
+				m_randomAccessModel (SatEnums::RA_MODEL_OFF),
+        m_coChannelActivity (NULL)
     {
       // do nothing
     }
@@ -294,6 +297,12 @@ public:
 
   inline SatEnums::RandomAccessModel_t GetRandomAccessModel () const { return m_randomAccessModel; };
 
+  /**
+   * \brief Get co-channel activity of the channel
+   * \return co-channel activity, NULL if not available for the channel
+   */
+  Ptr<SatCoChannelActivity> GetCoChannelActivity () const;
+
 private:
   /*
    * Note, that different carriers may be different bandwidth (symbol rate).
@@ -321,6 +330,7 @@ private:
   double m_raConstantErrorRate;
   bool m_enableRandomAccessDynamicLoadControl;
   SatEnums::RandomAccessModel_t m_randomAccessModel;
+  Ptr<SatCoChannelActivity> m_coChannelActivity;
 };
 
 } // namespace ns3
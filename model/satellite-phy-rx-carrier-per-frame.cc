@@ -21,7 +21,9 @@
 #include <ns3/log.h>
 #include <ns3/simulator.h>
 #include <ns3/boolean.h>
+#include <ns3/uinteger.h>
 
+#include "../utils/satellite-thread-pool.h"
 #include "satellite-phy-rx-carrier-per-frame.h"
 
 #include <algorithm>
@@ -35,10 +37,19 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (SatPhyRxCarrierPerFrame);
 
+std::vector<SatPhyRxCarrierPerFrame*> SatPhyRxCarrierPerFrame::s_parallelFrameCarriers;
+int64_t SatPhyRxCarrierPerFrame::s_parallelProcessingTimeStep = -1;
+
 SatPhyRxCarrierPerFrame::SatPhyRxCarrierPerFrame (uint32_t carrierId,
 																									Ptr<SatPhyRxCarrierConf> carrierConf,
 																									bool randomAccessEnabled)
 : SatPhyRxCarrierPerSlot (carrierId, carrierConf, randomAccessEnabled),
+	m_crdsaFrame (),
+	m_parallelProcessedFrame (),
+	m_parallelFrameProcessed (false),
+	m_nextFrameEndTime (),
+	m_parallelFrameProcessingThreads (1),
+	m_fullRescanInterferenceCancellation (false),
 	m_frameEndSchedulingInitialized (false)
 {
 	NS_LOG_FUNCTION (this);
@@ -67,6 +78,12 @@ SatPhyRxCarrierPerFrame::BeginFrameEndScheduling ()
 				}
 
 			m_frameEndSchedulingInitialized = true;
+			m_nextFrameEndTime = nextSuperFrameRxTime;
+
+			if (m_parallelFrameProcessingThreads > 1)
+				{
+					s_parallelFrameCarriers.push_back (this);
+				}
 
 			Simulator::ScheduleWithContext (GetNodeInfo ()->GetNodeId (),schedulingDelay, &SatPhyRxCarrierPerFrame::DoFrameEnd, this);
 		}
@@ -93,6 +110,21 @@ SatPhyRxCarrierPerFrame::GetTypeId (void)
                    "through Random Access CRDSA",
                    MakeTraceSourceAccessor (&SatPhyRxCarrierPerFrame::m_crdsaUniquePayloadRxTrace),
                    "ns3::SatPhyRxCarrierPacketProbe::RxStatusCallback")
+  .AddAttribute ("ParallelFrameProcessingThreads",
+                 "Number of threads processing the CRDSA frames of the carriers ending at the same time in parallel "
+                 "(1 = sequential). The frames are processed in the first frame end event of the carriers and "
+                 "each carrier delivers its packets in its own frame end event, thus in the same order as with "
+                 "the sequential processing.",
+                 UintegerValue (1),
+                 MakeUintegerAccessor (&SatPhyRxCarrierPerFrame::m_parallelFrameProcessingThreads),
+                 MakeUintegerChecker<uint32_t> (1))
+  .AddAttribute ("FullRescanInterferenceCancellation",
+                 "Scan the whole CRDSA frame from the first slot after each successfully received packet "
+                 "instead of re-processing only the slots in which the interference has changed. "
+                 "The results are identical, the full rescan is kept as a reference for the verification.",
+                 BooleanValue (false),
+                 MakeBooleanAccessor (&SatPhyRxCarrierPerFrame::m_fullRescanInterferenceCancellation),
+                 MakeBooleanChecker ())
 	;
   return tid;
 }
@@ -102,18 +134,39 @@ void
 SatPhyRxCarrierPerFrame::DoDispose ()
 {
 	SatPhyRxCarrierPerSlot::DoDispose ();
-  std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter;
 
-  for (iter = m_crdsaPacketContainer.begin (); iter != m_crdsaPacketContainer.end (); iter++)
+  std::vector<SatPhyRxCarrierPerFrame*>::iterator it = std::find (s_parallelFrameCarriers.begin (), s_parallelFrameCarriers.end (), this);
+
+  if (it != s_parallelFrameCarriers.end ())
     {
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
-      for (iterList = iter->second.begin (); iterList != iter->second.end (); iterList++)
-        {
-          iterList->rxParams = NULL;
-        }
-      iter->second.clear ();
+      s_parallelFrameCarriers.erase (it);
+    }
+
+  if (s_parallelFrameCarriers.empty ())
+    {
+      s_parallelProcessingTimeStep = -1;
+    }
+
+  m_parallelFrameProcessed = false;
+
+  ClearCrdsaFrame (m_crdsaFrame);
+  ClearCrdsaFrame (m_parallelProcessedFrame);
+  m_crdsaFrame.slots.clear ();
+  m_parallelProcessedFrame.slots.clear ();
+}
+
+void
+SatPhyRxCarrierPerFrame::ClearCrdsaFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame)
+{
+  for (uint32_t slotId = 0; slotId < frame.slots.size (); ++slotId)
+    {
+      frame.slots[slotId].clear ();
     }
-  m_crdsaPacketContainer.clear ();
+
+  frame.packetCount = 0;
+  frame.slotsToProcess.clear ();
+  frame.results.clear ();
+  frame.linkSinrs.clear ();
 }
 
 void
@@ -159,73 +212,42 @@ SatPhyRxCarrierPerFrame::DoFrameEnd ()
 
   NS_LOG_INFO ("SatPhyRxCarrier::DoFrameEnd - Time: " << Now ().GetSeconds ());
 
-  if (!m_crdsaPacketContainer.empty ())
+  if (m_parallelFrameProcessingThreads > 1)
     {
-      // Update the CRDSA random access load for unique payloads!
-      UpdateRandomAccessLoad ();
-
-      NS_LOG_INFO ("SatPhyRxCarrier::DoFrameEnd - Packets in container, will process the frame");
-
-      std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> results = ProcessFrame ();
-
-      if (!m_crdsaPacketContainer.empty ())
+      /**
+       * The frames of all the carriers ending at this time are processed together
+       * in the first frame end event of the time. The packets received after that
+       * belong to the next frame, as the packets ending at the frame end time are
+       * received after the frame end events scheduled a superframe earlier.
+       */
+      if (s_parallelProcessingTimeStep != Now ().GetTimeStep ())
         {
-          NS_FATAL_ERROR ("SatPhyRxCarrier::DoFrameEnd - All CRDSA packets in the frame were not processed");
+          ProcessFramesEndingNow ();
         }
 
-      /// sort the results based on CRDSA packet IDs to make sure the packets are processed in correct order
-      std::sort (results.begin (), results.end (), CompareCrdsaPacketId);
-
-      for (uint32_t i = 0; i < results.size (); i++)
+      if (m_parallelFrameProcessed)
         {
-          NS_LOG_INFO ("SatPhyRxCarrier::DoFrameEnd - Sending a packet to the next layer, slot: " << results[i].ownSlotId
-                       << ", UT: " << results[i].sourceAddress
-                       << ", unique CRDSA packet ID: " << results[i].rxParams->m_txInfo.crdsaUniquePacketId
-                       << ", destination address: " << results[i].destAddress
-                       << ", error: " << results[i].phyError
-                       << ", SINR: " << results[i].cSinr);
-
-          for (uint32_t j = 0; j < results[i].rxParams->m_packetsInBurst.size (); j++)
-            {
-              NS_LOG_INFO ("SatPhyRxCarrier::DoFrameEnd - Fragment (HL packet) UID: " << results[i].rxParams->m_packetsInBurst.at (j)->GetUid ());
-            }
+          NS_LOG_INFO ("SatPhyRxCarrier::DoFrameEnd - Delivering the frame processed in parallel, processed packets: "
+                       << m_parallelProcessedFrame.results.size ()
+                       << ", processed replicas: " << m_parallelProcessedFrame.linkSinrs.size ());
 
-          /// uses composite sinr
-          m_linkBudgetTrace (results[i].rxParams,
-                             GetOwnAddress (),
-                             results[i].destAddress,
-                             results[i].ifPower,
-                             results[i].cSinr);
-          /// CRDSA trace
-          m_crdsaUniquePayloadRxTrace (results[i].rxParams->m_packetsInBurst.size (),  // number of packets
-                                       results[i].sourceAddress,  // sender address
-                                       results[i].phyError        // error flag
-          );
-
-          // Update composite SINR trace for CRDSA packet after combination
-          m_sinrTrace (SatUtils::LinearToDb (results[i].cSinr), results[i].sourceAddress);
-
-          /// send packet upwards
-          m_rxCallback (results[i].rxParams,
-                        results[i].phyError);
-
-          results[i].rxParams = NULL;
+          m_parallelFrameProcessed = false;
+          DeliverFrame (m_parallelProcessedFrame);
         }
+    }
+  else if (m_crdsaFrame.packetCount > 0)
+    {
+      NS_LOG_INFO ("SatPhyRxCarrier::DoFrameEnd - Packets in container, will process the frame");
 
-      results.clear ();
+      BeginFrameProcessing ();
+      ProcessFrame (m_crdsaFrame);
+      DeliverFrame (m_crdsaFrame);
     }
 
   if (IsRandomAccessDynamicLoadControlEnabled ())
     {
       MeasureRandomAccessLoad ();
     }
-  else
-    {
-      if (!m_crdsaPacketContainer.empty ())
-        {
-          NS_FATAL_ERROR ("SatPhyRxCarrier::DoFrameEnd - CRDSA packets received by carrier which has random access disabled");
-        }
-    }
 
   Time nextSuperFrameRxTime = Singleton<SatRtnLinkTime>::Get ()->GetNextSuperFrameStartTime (SatConstVariables::SUPERFRAME_SEQUENCE);
 
@@ -235,42 +257,157 @@ SatPhyRxCarrierPerFrame::DoFrameEnd ()
     }
 
   Time schedulingDelay = nextSuperFrameRxTime - Now ();
+  m_nextFrameEndTime = nextSuperFrameRxTime;
 
   Simulator::Schedule (schedulingDelay, &SatPhyRxCarrierPerFrame::DoFrameEnd, this);
 }
 
+void
+SatPhyRxCarrierPerFrame::BeginFrameProcessing ()
+{
+  NS_LOG_FUNCTION (this);
+
+  /**
+   * The carrier configuration is checked before the frame is handed over to the
+   * processing, so that it is caught in the same way in the parallel processing.
+   */
+  if (!m_randomAccessEnabled
+      || GetRandomAccessCollisionModel () == SatPhyRxCarrierConf::RA_COLLISION_NOT_DEFINED)
+    {
+      NS_FATAL_ERROR ("SatPhyRxCarrier::BeginFrameProcessing - CRDSA packets received by carrier which has random access disabled");
+    }
+
+  // Update the CRDSA random access load for unique payloads!
+  UpdateRandomAccessLoad ();
+}
+
+void
+SatPhyRxCarrierPerFrame::ProcessFramesEndingNow ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  s_parallelProcessingTimeStep = Now ().GetTimeStep ();
+
+  std::vector<SatPhyRxCarrierPerFrame*> carriers;
+  uint32_t nThreads (1);
+
+  for (std::vector<SatPhyRxCarrierPerFrame*>::const_iterator it = s_parallelFrameCarriers.begin (); it != s_parallelFrameCarriers.end (); ++it)
+    {
+      SatPhyRxCarrierPerFrame* carrier = *it;
+
+      if (carrier->m_nextFrameEndTime == Now () && carrier->m_crdsaFrame.packetCount > 0)
+        {
+          carrier->BeginFrameProcessing ();
+
+          // the packets received after this point belong to the next frame
+          std::swap (carrier->m_crdsaFrame, carrier->m_parallelProcessedFrame);
+          carrier->m_parallelFrameProcessed = true;
+
+          carriers.push_back (carrier);
+          nThreads = std::max (nThreads, carrier->m_parallelFrameProcessingThreads);
+        }
+    }
+
+  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFramesEndingNow - Time: " << Now ().GetSeconds ()
+               << ", carriers: " << carriers.size () << ", threads: " << nThreads);
+
+  // each task processes only the frame of its own carrier, the processing is logged at the delivery
+  Singleton<SatThreadPool>::Get ()->ParallelFor (nThreads, carriers.size (),
+                                                 [&carriers] (uint32_t i)
+                                                 {
+                                                   carriers[i]->ProcessFrame (carriers[i]->m_parallelProcessedFrame);
+                                                 });
+}
+
+void
+SatPhyRxCarrierPerFrame::DeliverFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (frame.packetCount > 0)
+    {
+      NS_FATAL_ERROR ("SatPhyRxCarrier::DeliverFrame - All CRDSA packets in the frame were not processed");
+    }
+
+  /*
+   * Update link specific SINR trace for the RETURN_FEEDER link. The RETURN_USER
+   * link SINR is already updated at the SatPhyRxCarrier::EndRxDataTransparent ()
+   * method!
+   */
+  for (uint32_t i = 0; i < frame.linkSinrs.size (); i++)
+    {
+      m_linkSinrTrace (SatUtils::LinearToDb (frame.linkSinrs[i]));
+    }
+
+  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>& results = frame.results;
+
+  /// sort the results based on CRDSA packet IDs to make sure the packets are processed in correct order
+  std::sort (results.begin (), results.end (), CompareCrdsaPacketId);
+
+  for (uint32_t i = 0; i < results.size (); i++)
+    {
+      NS_LOG_INFO ("SatPhyRxCarrier::DeliverFrame - Sending a packet to the next layer, slot: " << results[i].ownSlotId
+                   << ", UT: " << results[i].sourceAddress
+                   << ", unique CRDSA packet ID: " << results[i].rxParams->m_txInfo.crdsaUniquePacketId
+                   << ", destination address: " << results[i].destAddress
+                   << ", error: " << results[i].phyError
+                   << ", SINR: " << results[i].cSinr);
+
+      for (uint32_t j = 0; j < results[i].rxParams->GetPackets ().size (); j++)
+        {
+          NS_LOG_INFO ("SatPhyRxCarrier::DeliverFrame - Fragment (HL packet) UID: " << results[i].rxParams->GetPackets ().at (j)->GetUid ());
+        }
+
+      /// uses composite sinr
+      m_linkBudgetTrace (results[i].rxParams,
+                         GetOwnAddress (),
+                         results[i].destAddress,
+                         results[i].ifPower,
+                         results[i].cSinr);
+      /// CRDSA trace
+      m_crdsaUniquePayloadRxTrace (results[i].rxParams->GetPackets ().size (),  // number of packets
+                                   results[i].sourceAddress,  // sender address
+                                   results[i].phyError        // error flag
+      );
+
+      // Update composite SINR trace for CRDSA packet after combination
+      m_sinrTrace (SatUtils::LinearToDb (results[i].cSinr), results[i].sourceAddress);
+
+      /// send packet upwards
+      m_rxCallback (results[i].rxParams,
+                    results[i].phyError);
+
+      results[i].rxParams = NULL;
+    }
+
+  ClearCrdsaFrame (frame);
+}
 
 void
 SatPhyRxCarrierPerFrame::UpdateRandomAccessLoad ()
 {
 	NS_LOG_FUNCTION (this);
 
-  std::vector<uint64_t> uniquePacketIds;
+  std::set<uint64_t> uniquePacketIds;
   uint32_t uniqueCrdsaBytes (0);
 
 	// Go through all the received CRDSA packets
-  std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter;
-	for (iter = m_crdsaPacketContainer.begin (); iter != m_crdsaPacketContainer.end (); iter++)
+	for (uint32_t slotId = 0; slotId < m_crdsaFrame.slots.size (); ++slotId)
 	  {
 	    // Go through all the packets received in the same slot id
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
-      for (iterList = iter->second.begin (); iterList != iter->second.end (); iterList++)
+      const crdsaSlotPackets_t& slot = m_crdsaFrame.slots[slotId];
+
+      for (crdsaSlotPackets_t::const_iterator it = slot.begin (); it != slot.end (); ++it)
         {
           // It is sufficient to check the first packet Uid
-          uint64_t uid = iterList->rxParams->m_packetsInBurst.front ()->GetUid();
-
-          // Check if we have already counted the bytes of this transmission
-          std::vector<uint64_t>::iterator it = std::find (uniquePacketIds.begin (),
-                                                          uniquePacketIds.end (),
-                                                          uid);
-          // Not found -> is unique
-          if (it == uniquePacketIds.end ())
-            {
-              // Push this to accounted unique transmissions vector
-              uniquePacketIds.push_back (uid);
+          uint64_t uid = it->rxParams->GetPackets ().front ()->GetUid();
 
+          // Check if we have already counted the bytes of this transmission,
+          // if not, the transmission is unique
+          if (uniquePacketIds.insert (uid).second)
+            {
               // Update the load with FEC block size!
-              uniqueCrdsaBytes += iterList->rxParams->m_txInfo.fecBlockSizeInBytes;
+              uniqueCrdsaBytes += it->rxParams->m_txInfo.fecBlockSizeInBytes;
             }
           // else, do nothing, i.e. this is a replica
         }
@@ -332,12 +469,12 @@ SatPhyRxCarrierPerFrame::AddCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxP
 
   NS_LOG_INFO ("SatPhyRxCarrierPerFrame::AddCrdsaPacket - Time: " << Now ().GetSeconds ());
 
-  if (crdsaPacketParams.rxParams->m_packetsInBurst.size () > 0)
+  if (crdsaPacketParams.rxParams->GetPackets ().size () > 0)
     {
       SatCrdsaReplicaTag replicaTag;
 
       /// check the first packet for tag
-      bool result = crdsaPacketParams.rxParams->m_packetsInBurst[0]->PeekPacketTag (replicaTag);
+      bool result = crdsaPacketParams.rxParams->GetPackets ()[0]->PeekPacketTag (replicaTag);
 
       if (!result)
         {
@@ -366,9 +503,10 @@ SatPhyRxCarrierPerFrame::AddCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxP
         }
 
       /// tags are not needed after this
-      for (uint32_t i = 0; i < crdsaPacketParams.rxParams->m_packetsInBurst.size (); i++)
+      SatSignalParameters::PacketsInBurst_t& packets = crdsaPacketParams.rxParams->GetModifiablePackets ();
+      for (uint32_t i = 0; i < packets.size (); i++)
         {
-      	crdsaPacketParams.rxParams->m_packetsInBurst[i]->RemovePacketTag (replicaTag);
+      	packets[i]->RemovePacketTag (replicaTag);
         }
     }
   else
@@ -376,20 +514,7 @@ SatPhyRxCarrierPerFrame::AddCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxP
       NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::AddCrdsaPacket - CRDSA reception with 0 packets");
     }
 
-  std::map<uint32_t, std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator result;
-
-  result = m_crdsaPacketContainer.find (crdsaPacketParams.ownSlotId);
-
-  if (result == m_crdsaPacketContainer.end ())
-    {
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> tempList;
-      tempList.push_back (crdsaPacketParams);
-      m_crdsaPacketContainer.insert (std::make_pair (crdsaPacketParams.ownSlotId, tempList));
-    }
-  else
-    {
-      result->second.push_back (crdsaPacketParams);
-    }
+  AddCrdsaPacketToFrame (m_crdsaFrame, crdsaPacketParams);
 
   NS_LOG_INFO ("SatPhyRxCarrierPerFrame::AddCrdsaPacket - Packet in slot " << crdsaPacketParams.ownSlotId << " was added to the CRDSA packet container");
 
@@ -399,222 +524,197 @@ SatPhyRxCarrierPerFrame::AddCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxP
     }
 }
 
-std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>
-SatPhyRxCarrierPerFrame::ProcessFrame ()
+void
+SatPhyRxCarrierPerFrame::AddCrdsaPacketToFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                                                const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& crdsaPacketParams)
 {
-  NS_LOG_FUNCTION (this);
-
-  NS_LOG_INFO ("SatPhyRxCarrier::ProcessFrame - Time: " << Now ().GetSeconds ());
-
-  std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter;
-  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> combinedPacketsForFrame;
-  SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s processedPacket;
+  if (crdsaPacketParams.ownSlotId >= frame.slots.size ())
+    {
+      frame.slots.resize (crdsaPacketParams.ownSlotId + 1);
+    }
 
-  bool nothingToProcess = true;
+  frame.slots[crdsaPacketParams.ownSlotId].push_back (crdsaPacketParams);
+  frame.slotsToProcess.insert (crdsaPacketParams.ownSlotId);
+  ++frame.packetCount;
+}
 
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packets to process: " << m_crdsaPacketContainer.size ());
+void
+SatPhyRxCarrierPerFrame::ProcessFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame)
+{
+  /**
+   * The frames of the carriers are processed in parallel, thus the processing
+   * must not log, touch the simulator nor copy Ptrs to objects shared with the
+   * other frames. The processing is logged when the frame is delivered.
+   */
+  if (m_fullRescanInterferenceCancellation)
+    {
+      ProcessFrameFullRescan (frame);
+    }
 
-  do
+  /**
+   * Successive interference cancellation. Only the slots, in which the interference
+   * has changed since the packets of the slot were processed, are in the work list.
+   * The slot with the lowest id is always processed first, which results in the same
+   * processing order as scanning the whole frame from the first slot after each
+   * successfully received packet.
+   */
+  while (!frame.slotsToProcess.empty ())
     {
-      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Searching for the next successfully received packet");
+      uint32_t slotId = *frame.slotsToProcess.begin ();
+      frame.slotsToProcess.erase (frame.slotsToProcess.begin ());
 
-      /// reset the flag
-      nothingToProcess = true;
+      crdsaSlotPackets_t& slot = frame.slots[slotId];
 
-      /// go through the packets
-      for (iter = m_crdsaPacketContainer.begin (); iter != m_crdsaPacketContainer.end (); iter++)
+      for (uint32_t i = 0; i < slot.size (); ++i)
         {
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Iterating slot: " << iter->first);
-
-          if (iter->second.size () < 1)
+          if (slot[i].packetHasBeenProcessed)
             {
-              NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::ProcessFrame - This should not happen");
+              continue;
             }
 
-          std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
+          /// process the received packet
+          ProcessReceivedCrdsaPacket (frame, slot[i], slot.size ());
 
-          for (iterList = iter->second.begin (); iterList != iter->second.end (); iterList++)
+          /// packet successfully received
+          if (!slot[i].phyError)
             {
-              NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Iterating packet in slot: " << iterList->ownSlotId);
-
-              if (!iterList->packetHasBeenProcessed)
-                {
-                  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Found a packet ready for processing");
-
-                  /// process the received packet
-                  *iterList = ProcessReceivedCrdsaPacket (*iterList, iter->second.size ());
-
-                  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet error: " << iterList->phyError);
-
-                  /// packet successfully received
-                  if (!iterList->phyError)
-                    {
-                      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet successfully received, breaking the slot iteration");
+              RemoveReceivedPacket (frame, slotId, i);
 
-                      nothingToProcess = false;
-
-                      /// save packet for processing outside the loop
-                      processedPacket = *iterList;
-
-                      /// remove the successfully received packet from the container
-                      iter->second.erase (iterList);
-
-                      /// eliminate the interference caused by this packet to other packets in this slot
-                      EliminateInterference (iter,processedPacket);
-
-                      /// break the cycle
-                      break;
-                    }
-                }
-              else
-                {
-                  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - This packet has already been processed");
-                }
-            }
-
-          /// successfully received packet found
-          if (!nothingToProcess)
-            {
-              NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet successfully received, breaking the container iteration");
+              /// continue from the lowest slot affected by the interference elimination
               break;
             }
         }
+    }
+
+  for (uint32_t slotId = 0; slotId < frame.slots.size () && frame.packetCount > 0; ++slotId)
+    {
+      crdsaSlotPackets_t& slot = frame.slots[slotId];
 
-      if (!nothingToProcess)
+      while (!slot.empty ())
         {
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Packet successfully received, processing the replicas");
+          if (!slot.front ().packetHasBeenProcessed || !slot.front ().phyError)
+            {
+              NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::ProcessFrame - All successfully received packets should have been processed by now");
+            }
 
-          /// find and remove replicas of the received packet
-          FindAndRemoveReplicas (processedPacket);
+          /// save the unsuccessfully received packet and remove it from the container
+          frame.results.push_back (slot.front ());
+          slot.erase (slot.begin ());
+          --frame.packetCount;
 
-          /// save the the received packet
-          combinedPacketsForFrame.push_back (processedPacket);
+          /// find and remove replicas of the received packet
+          FindAndRemoveReplicas (frame, frame.results.back ());
         }
     }
-  while (!nothingToProcess);
+}
 
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - All successfully received packets processed, packets left in container: " << m_crdsaPacketContainer.size ());
+void
+SatPhyRxCarrierPerFrame::ProcessFrameFullRescan (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame)
+{
+  bool packetReceived = true;
 
-  do
+  /// scan the whole frame from the first slot until no more packets are received successfully
+  while (packetReceived)
     {
-      /// go through the packets
-      iter = m_crdsaPacketContainer.begin ();
+      packetReceived = false;
 
-      if (iter != m_crdsaPacketContainer.end ())
+      for (uint32_t slotId = 0; slotId < frame.slots.size () && !packetReceived; ++slotId)
         {
-          std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList = iter->second.begin ();
+          crdsaSlotPackets_t& slot = frame.slots[slotId];
 
-          if (iterList != iter->second.end ())
+          for (uint32_t i = 0; i < slot.size (); ++i)
             {
-              NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Processing unsuccessfully received packet in slot: " << iterList->ownSlotId
-                           << " packet phy error: " << iterList->phyError
-                           << " packet has been processed: " << iterList->packetHasBeenProcessed);
-
-              if (!iterList->packetHasBeenProcessed || !iterList->phyError)
+              if (slot[i].packetHasBeenProcessed)
                 {
-                  NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::ProcessFrame - All successfully received packets should have been processed by now");
+                  continue;
                 }
 
-              /// find and remove replicas of the received packet
-              FindAndRemoveReplicas (*iterList);
+              /// process the received packet
+              ProcessReceivedCrdsaPacket (frame, slot[i], slot.size ());
 
-              /// save the the received packet
-              combinedPacketsForFrame.push_back (*iterList);
-
-              /// remove the packet from the container
-              iter->second.erase (iterList);
-
-              /// remove the empty slot container
-              if (iter->second.empty ())
+              /// packet successfully received
+              if (!slot[i].phyError)
                 {
-                  m_crdsaPacketContainer.erase (iter);
+                  RemoveReceivedPacket (frame, slotId, i);
+                  packetReceived = true;
+                  break;
                 }
             }
-          else
-            {
-              /// remove the empty slot container
-              m_crdsaPacketContainer.erase (iter);
-            }
         }
     }
-  while (!m_crdsaPacketContainer.empty ());
-
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessFrame - Container processed, packets left: " << m_crdsaPacketContainer.size ());
 
-  return combinedPacketsForFrame;
+  /// every slot has been scanned after the last interference elimination
+  frame.slotsToProcess.clear ();
 }
 
-SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s
-SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-																							 uint32_t numOfPacketsForThisSlot)
+void
+SatPhyRxCarrierPerFrame::RemoveReceivedPacket (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                                               uint32_t slotId,
+                                               uint32_t index)
 {
-  NS_LOG_FUNCTION (this);
+  crdsaSlotPackets_t& slot = frame.slots[slotId];
 
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessSuccessfullyReceivedCrdsaPacket - Time: " << Now ().GetSeconds ());
+  /// save the successfully received packet and remove it from the container
+  frame.results.push_back (slot[index]);
+  slot.erase (slot.begin () + index);
+  --frame.packetCount;
 
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket - Processing a packet in slot: " << packet.ownSlotId <<
-               " number of packets in this slot: " << numOfPacketsForThisSlot);
+  const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& processedPacket = frame.results.back ();
 
-  for (uint32_t i = 0; i < packet.slotIdsForOtherReplicas.size (); i++)
-    {
-      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket - Replica in slot: " << packet.slotIdsForOtherReplicas[i]);
-    }
+  /// eliminate the interference caused by this packet to other packets in this slot
+  EliminateInterference (frame, slotId, processedPacket.rxParams->m_rxPowerInSatellite_W);
 
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket - SINR CALCULATION, RX sat: " << packet.rxParams->m_rxPowerInSatellite_W <<
-               " IF sat: " << packet.rxParams->m_ifPowerInSatellite_W <<
-               " RX gnd: " << packet.rxParams->m_rxPower_W <<
-               " IF gnd: " << packet.rxParams->m_ifPower_W);
+  /// find and remove replicas of the received packet
+  FindAndRemoveReplicas (frame, processedPacket);
+}
+
+void
+SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                                                     SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet,
+                                                     uint32_t numOfPacketsForThisSlot)
+{
+  const SatSignalParameters& rxParams = *packet.rxParams;
 
-  double sinrSatellite = CalculateSinr ( packet.rxParams->m_rxPowerInSatellite_W,
-                                         packet.rxParams->m_ifPowerInSatellite_W,
-                                         packet.rxParams->m_rxNoisePowerInSatellite_W,
-                                         packet.rxParams->m_rxAciIfPowerInSatellite_W,
-                                         packet.rxParams->m_rxExtNoisePowerInSatellite_W,
-                                         packet.rxParams->m_sinrCalculate);
+  double sinrSatellite = CalculateSinr ( rxParams.m_rxPowerInSatellite_W,
+                                         rxParams.m_ifPowerInSatellite_W,
+                                         rxParams.m_rxNoisePowerInSatellite_W,
+                                         rxParams.m_rxAciIfPowerInSatellite_W,
+                                         rxParams.m_rxExtNoisePowerInSatellite_W,
+                                         rxParams.m_sinrCalculate);
 
-  double sinr = CalculateSinr ( packet.rxParams->m_rxPower_W,
-                                packet.rxParams->m_ifPower_W,
+  double sinr = CalculateSinr ( rxParams.m_rxPower_W,
+                                rxParams.m_ifPower_W,
                                 m_rxNoisePowerW,
                                 m_rxAciIfPowerW,
                                 m_rxExtNoisePowerW,
                                 m_sinrCalculate);
 
-  /*
-   * Update link specific SINR trace for the RETURN_FEEDER link. The RETURN_USER
-   * link SINR is already updated at the SatPhyRxCarrier::EndRxDataTransparent ()
-   * method!
-   */
-  m_linkSinrTrace (SatUtils::LinearToDb (sinr));
+  // Link specific SINR trace is updated when the frame is delivered
+  frame.linkSinrs.push_back (sinr);
 
   double cSinr = CalculateCompositeSinr (sinr, sinrSatellite);
 
   packet.cSinr = cSinr;
-  packet.ifPower = packet.rxParams->m_ifPower_W;
+  packet.ifPower = rxParams.m_ifPower_W;
 
   if (GetRandomAccessCollisionModel () == SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS)
     {
-      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket - Strict collision detection is ENABLED");
-
       /// there is a collision
       if (numOfPacketsForThisSlot > 1)
         {
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket - Multiple packets in this slot, successful reception is not possible");
           /// not possible to have a successful reception
           packet.phyError = true;
         }
       else
         {
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket - Only packet in this slot, checking against link results");
           /// check against link results
-          packet.phyError = CheckAgainstLinkResults (packet.cSinr,packet.rxParams);
+          packet.phyError = CheckAgainstLinkResults (packet.cSinr, packet.rxParams);
         }
-      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket - Strict collision detection, phy error: " << packet.phyError);
     }
   else if (GetRandomAccessCollisionModel () == SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR)
     {
       /// check against link results
-      packet.phyError = CheckAgainstLinkResults (packet.cSinr,packet.rxParams);
-      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket - Check against link results, phy error: " << packet.phyError);
+      packet.phyError = CheckAgainstLinkResults (packet.cSinr, packet.rxParams);
     }
   else
     {
@@ -623,47 +723,41 @@ SatPhyRxCarrierPerFrame::ProcessReceivedCrdsaPacket (SatPhyRxCarrierPerFrame::cr
 
   /// mark the packet as processed
   packet.packetHasBeenProcessed = true;
-
-  return packet;
 }
 
 void
-SatPhyRxCarrierPerFrame::FindAndRemoveReplicas (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet)
+SatPhyRxCarrierPerFrame::FindAndRemoveReplicas (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                                                const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet)
 {
-  NS_LOG_FUNCTION (this);
-  NS_LOG_INFO ("SatPhyRxCarrier::FindAndRemoveReplicas - Time: " << Now ().GetSeconds ());
-
   for (uint32_t i = 0; i < packet.slotIdsForOtherReplicas.size (); i++)
     {
-      NS_LOG_INFO ("SatPhyRxCarrier::FindAndRemoveReplicas - Processing replica in slot: " << packet.slotIdsForOtherReplicas[i]);
-
-      /// get the vector of packets for processing
-      std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter;
-      iter = m_crdsaPacketContainer.find (packet.slotIdsForOtherReplicas[i]);
+      uint32_t slotId = packet.slotIdsForOtherReplicas[i];
 
-      if (iter == m_crdsaPacketContainer.end ())
+      if (slotId >= frame.slots.size ())
         {
           NS_FATAL_ERROR ("SatPhyRxCarrier::FindAndRemoveReplicas - This should not happen");
         }
 
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
-      SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s removedPacket;
+      /// get the vector of packets for processing
+      crdsaSlotPackets_t& slot = frame.slots[slotId];
+      double removedRxPowerInSatelliteW = 0.0;
 
       bool replicaFound = false;
 
-      for (iterList = iter->second.begin (); iterList != iter->second.end (); )
+      for (crdsaSlotPackets_t::iterator it = slot.begin (); it != slot.end (); )
         {
           /// check for the same UT & same slots
-          if (IsReplica (packet, iterList))
+          if (IsReplica (packet, *it))
             {
               /// replica found for removal
               replicaFound = true;
-              removedPacket = *iterList;
-              iter->second.erase (iterList++);
+              removedRxPowerInSatelliteW = it->rxParams->m_rxPowerInSatellite_W;
+              it = slot.erase (it);
+              --frame.packetCount;
             }
           else
             {
-              ++iterList;
+              ++it;
             }
         }
 
@@ -674,98 +768,67 @@ SatPhyRxCarrierPerFrame::FindAndRemoveReplicas (SatPhyRxCarrierPerFrame::crdsaPa
 
       if (!packet.phyError)
         {
-          EliminateInterference (iter, removedPacket);
+          EliminateInterference (frame, slotId, removedRxPowerInSatelliteW);
         }
     }
 }
 
 void
-SatPhyRxCarrierPerFrame::EliminateInterference (
-		std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter,
-		SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s processedPacket)
+SatPhyRxCarrierPerFrame::EliminateInterference (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                                                uint32_t slotId,
+                                                double rxPowerInSatelliteW)
 {
-  NS_LOG_FUNCTION (this);
-  NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference");
+  crdsaSlotPackets_t& slot = frame.slots[slotId];
 
-  if (iter->second.empty ())
+  if (slot.empty ())
     {
-      NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference - No other packets in this slot, erasing the slot container");
-      m_crdsaPacketContainer.erase (iter);
+      return;
     }
-  else
-    {
-      std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iterList;
 
-      for (iterList = iter->second.begin (); iterList != iter->second.end (); iterList++)
-        {
-          /// release packets in this slot for re-processing
-          iterList->packetHasBeenProcessed = false;
-
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference- BEFORE INTERFERENCE ELIMINATION, RX sat: " << iterList->rxParams->m_rxPowerInSatellite_W <<
-                       " IF sat: " << iterList->rxParams->m_ifPowerInSatellite_W <<
-                       " RX gnd: " << iterList->rxParams->m_rxPower_W <<
-                       " IF gnd: " << iterList->rxParams->m_ifPower_W);
+  for (crdsaSlotPackets_t::iterator it = slot.begin (); it != slot.end (); ++it)
+    {
+      /// release packets in this slot for re-processing
+      it->packetHasBeenProcessed = false;
 
-          /// Reduce interference power for the colliding packets. Note, that the interference is
-          /// eliminated only from the user link interference power at the satellite! The intra-beam
-          /// interference is not handled in the return feeder link so that the intra-beam interference
-          /// is not taken into account twice!
-          /// TODO A more novel way to eliminate partially overlapping interference should be considered!
-          /// In addition, as the interference values are extremely small, the use of long double (instead
-          /// of double) should be considered to improve the accuracy.
+      SatSignalParameters& rxParams = *it->rxParams;
 
-          iterList->rxParams->m_ifPowerInSatellite_W -= processedPacket.rxParams->m_rxPowerInSatellite_W;
+      /// Reduce interference power for the colliding packets. Note, that the interference is
+      /// eliminated only from the user link interference power at the satellite! The intra-beam
+      /// interference is not handled in the return feeder link so that the intra-beam interference
+      /// is not taken into account twice!
+      /// TODO A more novel way to eliminate partially overlapping interference should be considered!
+      /// In addition, as the interference values are extremely small, the use of long double (instead
+      /// of double) should be considered to improve the accuracy.
 
-          if (std::abs (iterList->rxParams->m_ifPowerInSatellite_W) < std::numeric_limits<double>::epsilon ())
-            {
-              iterList->rxParams->m_ifPowerInSatellite_W = 0;
-            }
+      rxParams.m_ifPowerInSatellite_W -= rxPowerInSatelliteW;
 
-          if (iterList->rxParams->m_ifPower_W < 0 || iterList->rxParams->m_ifPowerInSatellite_W < 0)
-            {
-              NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::EliminateInterference - Negative interference");
-            }
+      if (std::abs (rxParams.m_ifPowerInSatellite_W) < std::numeric_limits<double>::epsilon ())
+        {
+          rxParams.m_ifPowerInSatellite_W = 0;
+        }
 
-          NS_LOG_INFO ("SatPhyRxCarrierPerFrame::EliminateInterference- AFTER INTERFERENCE ELIMINATION, RX sat: " <<
-          							iterList->rxParams->m_rxPowerInSatellite_W <<
-                       " IF sat: " << iterList->rxParams->m_ifPowerInSatellite_W <<
-                       " RX gnd: " << iterList->rxParams->m_rxPower_W <<
-                       " IF gnd: " << iterList->rxParams->m_ifPower_W);
+      if (rxParams.m_ifPower_W < 0 || rxParams.m_ifPowerInSatellite_W < 0)
+        {
+          NS_FATAL_ERROR ("SatPhyRxCarrierPerFrame::EliminateInterference - Negative interference");
         }
     }
+
+  /// interference of the slot has changed, thus the slot needs to be processed again
+  frame.slotsToProcess.insert (slotId);
 }
 
 bool
-SatPhyRxCarrierPerFrame::IsReplica (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-																std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter)
+SatPhyRxCarrierPerFrame::IsReplica (const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet,
+                                    const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& other) const
 {
-  NS_LOG_FUNCTION (this);
-  NS_LOG_INFO ("SatPhyRxCarrier::IsReplica - Time: " << Now ().GetSeconds ());
-
-  NS_LOG_INFO ("SatPhyRxCarrier::IsReplica - Checking the source addresses");
-
-  bool isReplica = false;
-
-  if (iter->sourceAddress == packet.sourceAddress)
-    {
-      NS_LOG_INFO ("SatPhyRxCarrier::IsReplica - Same source addresses, checking slot IDs");
-
-      if (HaveSameSlotIds (packet, iter))
-        {
-          NS_LOG_INFO ("SatPhyRxCarrier::IsReplica - Same slot IDs, replica found");
-          isReplica = true;
-        }
-    }
-  return isReplica;
+  /// check for the same UT & same slots
+  return other.sourceAddress == packet.sourceAddress && HaveSameSlotIds (packet, other);
 }
 
 bool
-SatPhyRxCarrierPerFrame::HaveSameSlotIds (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-                                          std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter)
+SatPhyRxCarrierPerFrame::HaveSameSlotIds (const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet,
+                                          const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& other) const
 {
-  NS_LOG_FUNCTION (this);
-  NS_LOG_INFO ("SatPhyRxCarrierUt::HaveSameSlotIds - Time: " << Now ().GetSeconds ());
-
   std::set<uint16_t> firstSet;
   std::set<uint16_t> secondSet;
   std::set<uint16_t>::iterator firstSetIterator;
@@ -773,21 +836,19 @@ SatPhyRxCarrierPerFrame::HaveSameSlotIds (SatPhyRxCarrierPerFrame::crdsaPacketRx
   bool haveSameSlotIds = true;
 
   firstSet.insert (packet.ownSlotId);
-  secondSet.insert (iter->ownSlotId);
+  secondSet.insert (other.ownSlotId);
 
   /// sanity check
-  if (iter->slotIdsForOtherReplicas.size () != packet.slotIdsForOtherReplicas.size ())
+  if (other.slotIdsForOtherReplicas.size () != packet.slotIdsForOtherReplicas.size ())
     {
       NS_FATAL_ERROR ("SatPhyRxCarrierUt::HaveSameSlotIds - The amount of replicas does not match");
     }
 
-  NS_LOG_INFO ("SatPhyRxCarrierUt::HaveSameSlotIds - Comparing slot IDs");
-
   /// form sets
-  for (uint32_t i = 0; i < iter->slotIdsForOtherReplicas.size (); i++)
+  for (uint32_t i = 0; i < other.slotIdsForOtherReplicas.size (); i++)
     {
       firstSet.insert (packet.slotIdsForOtherReplicas[i]);
-      secondSet.insert (iter->slotIdsForOtherReplicas[i]);
+      secondSet.insert (other.slotIdsForOtherReplicas[i]);
     }
 
   uint32_t numOfMatchingSlots = 0;
@@ -807,9 +868,6 @@ SatPhyRxCarrierPerFrame::HaveSameSlotIds (SatPhyRxCarrierPerFrame::crdsaPacketRx
         }
     }
 
-  NS_LOG_INFO ("SatPhyRxCarrier::HaveSameSlotIds - Are slot IDs identical: " << haveSameSlotIds
-               << ", number of matching slots: " << numOfMatchingSlots);
-
   /// sanity check
   if (!haveSameSlotIds && numOfMatchingSlots > 0)
     {
@@ -26,6 +26,8 @@
 #include <ns3/satellite-crdsa-replica-tag.h>
 #include <ns3/satellite-phy-rx-carrier.h>
 #include <ns3/satellite-phy-rx-carrier-per-slot.h>
+#include <vector>
+#include <set>
 
 namespace ns3 {
 
@@ -64,6 +66,34 @@ public:
     bool phyError;
   } crdsaPacketRxParams_s;
 
+  /**
+   * \brief Received CRDSA packets of one slot
+   */
+  typedef std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> crdsaSlotPackets_t;
+
+  /**
+   * \brief Struct for storing the received CRDSA packets of a frame and
+   * the results of the frame processing
+   */
+  typedef struct crdsaFrame_s
+  {
+    std::vector<SatPhyRxCarrierPerFrame::crdsaSlotPackets_t> slots;  //< Packets indexed by the slot id
+    uint32_t packetCount;                                              //< Number of packets in the slots
+    std::set<uint32_t> slotsToProcess;                                 //< Slots to be (re-)processed
+    std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> results; //< Processed packets
+    std::vector<double> linkSinrs;                                     //< Link SINRs of the processing
+
+    crdsaFrame_s ()
+      : slots (),
+        packetCount (0),
+        slotsToProcess (),
+        results (),
+        linkSinrs ()
+    {
+      // do nothing
+    }
+  } crdsaFrame_s;
+
 	/**
 	 * Constructor.
 	 * \param carrierId ID of the carrier
@@ -96,6 +126,33 @@ public:
    */
   void BeginFrameEndScheduling ();
 
+  /**
+   * \brief Function for processing the CRDSA frame. The processed packets
+   * and the link SINRs are stored into the frame. The function does not
+   * log, touch the simulator, the trace sources nor any state shared with
+   * the other carriers, thus the frames of different carriers may be processed
+   * in parallel. The function is also used by SatRandomAccessMonteCarloHelper
+   * to process synthetic frames without running the full simulation.
+   * \param frame Frame to process
+   */
+  void ProcessFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame);
+
+  /**
+   * \brief Function for storing a CRDSA packet into a frame. The own slot id
+   * and the slot ids of the other replicas of the packet must have been set.
+   * \param frame Frame to store the packet into
+   * \param crdsaPacketParams Rx parameters of the packet
+   */
+  static void AddCrdsaPacketToFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                                     const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& crdsaPacketParams);
+
+  /**
+   * \brief Function for clearing a CRDSA frame. The slot storage is
+   * kept allocated for the next frames.
+   * \param frame Frame to clear
+   */
+  static void ClearCrdsaFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame);
+
   /**
    * \brief Method for querying the type of the carrier
    */
@@ -119,12 +176,15 @@ protected:
 private:
 
   /**
-   * \brief Function for eliminating the interference to other packets in the slot from the correctly received packet
-   * \param iter Packets in the slot
-   * \param processedPacket Correctly received processed packet
+   * \brief Function for eliminating the interference to other packets in the slot from the correctly received packet.
+   * The other packets in the slot are released for re-processing.
+   * \param frame Frame of the packets
+   * \param slotId Slot of the packets
+   * \param rxPowerInSatelliteW Rx power of the correctly received packet at the satellite
    */
-  void EliminateInterference (std::map<uint32_t,std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> >::iterator iter,
-  		SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s processedPacket);
+  void EliminateInterference (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                              uint32_t slotId,
+                              double rxPowerInSatelliteW);
 
   /**
    * \brief Function for storing the received CRDSA packets
@@ -158,34 +218,73 @@ private:
   TracedCallback<uint32_t, const Address &, bool> m_crdsaUniquePayloadRxTrace;
 
   /**
-   * \brief Function for processing the CRDSA frame
-   * \return Processed packets
+   * \brief Function for delivering the results of a processed CRDSA frame
+   * to the trace sources and to the upper layer
+   * \param frame Processed frame
+   */
+  void DeliverFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame);
+
+  /**
+   * \brief Function for checking the carrier configuration and updating the
+   * random access load before the frame is processed
+   */
+  void BeginFrameProcessing ();
+
+  /**
+   * \brief Function for processing in parallel the frames of all the carriers
+   * with the parallel processing, which have a frame ending at the current time.
+   * Called by the first frame end event of the current time, each carrier
+   * delivers its processed frame in its own frame end event.
+   */
+  static void ProcessFramesEndingNow ();
+
+  /**
+   * \brief Function for processing the successfully received packets of a
+   * CRDSA frame by scanning the whole frame from the first slot after each
+   * successfully received packet. This is the reference implementation of
+   * the successive interference cancellation done with the slot work list
+   * in ProcessFrame.
+   * \param frame Frame to process
    */
-  std::vector<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> ProcessFrame ();
+  void ProcessFrameFullRescan (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame);
+
+  /**
+   * \brief Function for removing a successfully received packet from its slot,
+   * eliminating its interference and removing its replicas. The packet is
+   * stored into the results of the frame.
+   * \param frame Frame of the packet
+   * \param slotId Slot of the packet
+   * \param index Index of the packet in the slot
+   */
+  void RemoveReceivedPacket (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                             uint32_t slotId,
+                             uint32_t index);
 
   /**
    * \brief Function for finding and removing the replicas of the CRDSA packet
+   * \param frame Frame of the packet
    * \param packet CRDSA packet
    */
-  void FindAndRemoveReplicas (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet);
+  void FindAndRemoveReplicas (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                              const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet);
 
   /**
    * \brief Function for identifying whether the packet is a replica of another packet
    * \param packet Packet
-   * \param iter A packet in certain slot
+   * \param other A packet in certain slot
    * \return Is the packet a replica
    */
-  bool IsReplica (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-  		std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter);
+  bool IsReplica (const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet,
+                  const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& other) const;
 
   /**
    * \brief Function for checking do the packets have identical slots
    * \param packet Packet
-   * \param iter A packet in certain slot
+   * \param other A packet in certain slot
    * \return Have the packets identical slots
    */
-  bool HaveSameSlotIds (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-  		std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s>::iterator iter);
+  bool HaveSameSlotIds (const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet,
+                        const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& other) const;
 
   /**
    * \brief Function for calculating the normalized offered random access load
@@ -210,17 +309,54 @@ private:
   void UpdateRandomAccessLoad ();
 
   /**
-   * Process received CRDSA packet.
+   * Process received CRDSA packet. The results are stored into the packet.
+   */
+  void ProcessReceivedCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame,
+                                   SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet,
+                                   uint32_t numOfPacketsForThisSlot);
+
+
+  /**
+   * \brief CRDSA packets of the frame being received
+   */
+  SatPhyRxCarrierPerFrame::crdsaFrame_s m_crdsaFrame;
+
+  /**
+   * \brief CRDSA frame processed in parallel and waiting for the delivery
+   */
+  SatPhyRxCarrierPerFrame::crdsaFrame_s m_parallelProcessedFrame;
+
+  /**
+   * \brief Is a frame processed in parallel waiting for the delivery
+   */
+  bool m_parallelFrameProcessed;
+
+  /**
+   * \brief Time of the next frame end event
+   */
+  Time m_nextFrameEndTime;
+
+  /**
+   * \brief Maximum number of threads processing the frames of the carriers
+   * in parallel at the frame end (1 = sequential processing)
+   */
+  uint32_t m_parallelFrameProcessingThreads;
+
+  /**
+   * \brief Is the successive interference cancellation done by scanning the
+   * whole frame after each successfully received packet
    */
-  SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s
-	ProcessReceivedCrdsaPacket (SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s packet,
-                              uint32_t numOfPacketsForThisSlot);
+  bool m_fullRescanInterferenceCancellation;
 
+  /**
+   * \brief Carriers processing their frames in parallel
+   */
+  static std::vector<SatPhyRxCarrierPerFrame*> s_parallelFrameCarriers;
 
   /**
-   * \brief CRDSA packet container
+   * \brief Time step of the last parallel processing of the frames
    */
-  std::map<uint32_t, std::list<SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s> > m_crdsaPacketContainer;
+  static int64_t s_parallelProcessingTimeStep;
 
   /**
    * \brief Has the frame end scheduling been initialized
@@ -141,7 +141,7 @@ SatPhyRxCarrierPerSlot::EndRxData (uint32_t key)
 
   rxParams_s packetRxParams = GetStoredRxParams (key);
 
-  const uint32_t nPackets = packetRxParams.rxParams->m_packetsInBurst.size ();
+  const uint32_t nPackets = packetRxParams.rxParams->GetPackets ().size ();
 
   DecreaseNumOfRxState (packetRxParams.rxParams->m_txInfo.packetType);
 
@@ -25,6 +25,7 @@
 #include <ns3/satellite-constant-interference.h>
 #include <ns3/satellite-per-packet-interference.h>
 #include <ns3/satellite-traced-interference.h>
+#include <ns3/satellite-co-channel-interference.h>
 #include <ns3/satellite-mac-tag.h>
 #include <ns3/singleton.h>
 #include <ns3/satellite-composite-sinr-output-trace-container.h>
@@ -77,6 +78,10 @@ SatPhyRxCarrier::SatPhyRxCarrier (uint32_t carrierId, Ptr<SatPhyRxCarrierConf> c
     {
       NS_LOG_INFO (this << " link results in use in carrier: " << carrierId);
       m_linkResults = carrierConf->GetLinkResults ();
+
+      // Resolve the link results type only once, the aggregate lookup is not thread safe
+      m_linkResultsDvbS2 = m_linkResults->GetObject<SatLinkResultsDvbS2> ();
+      m_linkResultsDvbRcs2 = m_linkResults->GetObject<SatLinkResultsDvbRcs2> ();
     }
 
   m_rxTemperatureK = carrierConf->GetRxTemperatureK ();
@@ -138,6 +143,14 @@ SatPhyRxCarrier::DoCreateInterferenceModel (Ptr<SatPhyRxCarrierConf> carrierConf
         m_satInterference = CreateObject<SatTracedInterference> (GetChannelType (), rxBandwidthHz);
         break;
       }
+    case SatPhyRxCarrierConf::IF_CO_CHANNEL:
+      {
+        NS_LOG_INFO (this << " Co-channel interference model created for carrier: " << carrierId);
+        m_satInterference = CreateObject<SatCoChannelInterference> (carrierConf->GetCoChannelActivity (),
+                                                                    GetChannelType (),
+                                                                    carrierId);
+        break;
+      }
     default:
       {
         NS_LOG_ERROR (this << " Not a valid interference model!");
@@ -147,6 +160,34 @@ SatPhyRxCarrier::DoCreateInterferenceModel (Ptr<SatPhyRxCarrierConf> carrierConf
 }
 
 
+void
+SatPhyRxCarrier::SetBeamId (uint32_t beamId)
+{
+  NS_LOG_FUNCTION (this << beamId);
+
+  m_beamId = beamId;
+
+  Ptr<SatCoChannelInterference> coChannelInterference = DynamicCast<SatCoChannelInterference> (m_satInterference);
+
+  if (coChannelInterference)
+    {
+      coChannelInterference->SetBeamId (beamId);
+    }
+}
+
+void
+SatPhyRxCarrier::SetMobility (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+
+  Ptr<SatCoChannelInterference> coChannelInterference = DynamicCast<SatCoChannelInterference> (m_satInterference);
+
+  if (coChannelInterference)
+    {
+      coChannelInterference->SetMobility (mobility);
+    }
+}
+
 SatPhyRxCarrier::~SatPhyRxCarrier ()
 {
   NS_LOG_FUNCTION (this);
@@ -199,6 +240,9 @@ SatPhyRxCarrier::DoDispose ()
   m_avgNormalizedOfferedLoadCallback.Nullify ();
   m_satInterference = NULL;
   m_uniformVariable = NULL;
+  m_linkResults = NULL;
+  m_linkResultsDvbS2 = NULL;
+  m_linkResultsDvbRcs2 = NULL;
 
   Object::DoDispose ();
 }
@@ -253,14 +297,13 @@ SatPhyRxCarrier::GetReceiveParams (Ptr<SatSignalParameters> rxParams)
   bool receivePacket = GetDefaultReceiveMode ();
   bool ownAddressFound = false;
 
-  for (SatSignalParameters::PacketsInBurst_t::const_iterator i = rxParams->m_packetsInBurst.begin ();
-       ((i != rxParams->m_packetsInBurst.end ()) && (ownAddressFound == false) ); i++)
-    {
-      SatMacTag tag;
-      (*i)->PeekPacketTag (tag);
+  params.sourceAddress = rxParams->m_sourceAddress;
 
-      params.destAddress = tag.GetDestAddress ();
-      params.sourceAddress = tag.GetSourceAddress ();
+  // The destinations of the burst are resolved already by the sender
+  for (SatSignalParameters::DestinationAddresses_t::const_iterator i = rxParams->GetDestAddresses ().begin ();
+       ((i != rxParams->GetDestAddresses ().end ()) && (ownAddressFound == false) ); i++)
+    {
+      params.destAddress = *i;
 
       if (( params.destAddress == GetOwnAddress () ))
         {
@@ -334,7 +377,8 @@ SatPhyRxCarrier::StartRx (Ptr<SatSignalParameters> rxParams)
             // Update link specific received signal power
             m_rxPowerTrace (SatUtils::LinearToDb (rxParams->m_rxPower_W));
 
-            Simulator::Schedule (rxParams->m_duration, &SatPhyRxCarrier::EndRxData, this, key);
+            // A batched reception of the channel may run in the context of another node
+            Simulator::ScheduleWithContext (m_nodeInfo->GetNodeId (), rxParams->m_duration, &SatPhyRxCarrier::EndRxData, this, key);
 
             IncreaseNumOfRxState (rxParams->m_txInfo.packetType);
           }
@@ -364,11 +408,8 @@ SatPhyRxCarrier::DoCompositeSinrOutputTrace (double cSinr)
 
 
 bool
-SatPhyRxCarrier::CheckAgainstLinkResults (double cSinr, Ptr<SatSignalParameters> rxParams)
+SatPhyRxCarrier::CheckAgainstLinkResults (double cSinr, const Ptr<SatSignalParameters>& rxParams)
 {
-  NS_LOG_FUNCTION (this);
-  NS_LOG_INFO ("SatPhyRxCarrier::CheckAgainstLinkResults");
-
   /// Initialize with no errors
   bool error = false;
 
@@ -404,7 +445,7 @@ SatPhyRxCarrier::CheckAgainstLinkResults (double cSinr, Ptr<SatSignalParameters>
 
 
 bool
-SatPhyRxCarrier::CheckAgainstLinkResultsErrorModelAvi (double cSinr, Ptr<SatSignalParameters> rxParams)
+SatPhyRxCarrier::CheckAgainstLinkResultsErrorModelAvi (double cSinr, const Ptr<SatSignalParameters>& rxParams)
 {
 	bool error = false;
 	switch (GetChannelType ())
@@ -427,7 +468,9 @@ SatPhyRxCarrier::CheckAgainstLinkResultsErrorModelAvi (double cSinr, Ptr<SatSign
 			 * fs = symbol rate in baud
 			*/
 
-			double ber = (GetLinkResults ()->GetObject <SatLinkResultsDvbS2> ())->GetBler (rxParams->m_txInfo.modCod,
+			NS_ASSERT (m_linkResultsDvbS2 != NULL);
+
+			double ber = m_linkResultsDvbS2->GetBler (rxParams->m_txInfo.modCod,
 																																								 rxParams->m_txInfo.frameType,
 																																								 SatUtils::LinearToDb (cSinr));
 			double r = GetUniformRandomValue (0, 1);
@@ -436,12 +479,6 @@ SatPhyRxCarrier::CheckAgainstLinkResultsErrorModelAvi (double cSinr, Ptr<SatSign
 				{
 					error = true;
 				}
-
-			NS_LOG_INFO ("FORWARD cSinr (dB): " << SatUtils::LinearToDb (cSinr)
-									 << " esNo (dB): " << SatUtils::LinearToDb (cSinr)
-									 << " rand: " << r
-									 << " ber: " << ber
-									 << " error: " << error);
 			break;
 		}
 
@@ -466,7 +503,9 @@ SatPhyRxCarrier::CheckAgainstLinkResultsErrorModelAvi (double cSinr, Ptr<SatSign
 			double ebNo = cSinr / (SatUtils::GetCodingRate (rxParams->m_txInfo.modCod) *
 														 SatUtils::GetModulatedBits (rxParams->m_txInfo.modCod));
 
-			double ber = (GetLinkResults ()->GetObject <SatLinkResultsDvbRcs2> ())->GetBler (rxParams->m_txInfo.waveformId,
+			NS_ASSERT (m_linkResultsDvbRcs2 != NULL);
+
+			double ber = m_linkResultsDvbRcs2->GetBler (rxParams->m_txInfo.waveformId,
 																																									 SatUtils::LinearToDb (ebNo));
 			double r = GetUniformRandomValue (0, 1);
 
@@ -474,13 +513,6 @@ SatPhyRxCarrier::CheckAgainstLinkResultsErrorModelAvi (double cSinr, Ptr<SatSign
 				{
 					error = true;
 				}
-
-			NS_LOG_INFO ("RETURN cSinr (dB): " << SatUtils::LinearToDb (cSinr)
-									 << " ebNo (dB): " << SatUtils::LinearToDb (ebNo)
-									 << " modulated bits: " << SatUtils::GetModulatedBits (rxParams->m_txInfo.modCod)
-									 << " rand: " << r
-									 << " ber: " << ber
-									 << " error: " << error);
 			break;
 		}
 		case SatEnums::RETURN_USER_CH:
@@ -497,6 +529,16 @@ SatPhyRxCarrier::CheckAgainstLinkResultsErrorModelAvi (double cSinr, Ptr<SatSign
 }
 
 
+int64_t
+SatPhyRxCarrier::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+
+  m_uniformVariable->SetStream (stream);
+
+  return 1;
+}
+
 void
 SatPhyRxCarrier::SetNodeInfo (const Ptr<SatNodeInfo> nodeInfo)
 {
@@ -512,10 +554,8 @@ SatPhyRxCarrier::CalculateSinr (double rxPowerW,
                                 double rxNoisePowerW,
                                 double rxAciIfPowerW,
                                 double rxExtNoisePowerW,
-                                SatPhyRxCarrierConf::SinrCalculatorCallback sinrCalculate)
+                                const SatPhyRxCarrierConf::SinrCalculatorCallback& sinrCalculate)
 {
-  NS_LOG_FUNCTION (this << rxPowerW <<  ifPowerW);
-
   if (rxNoisePowerW <= 0.0)
     {
       NS_FATAL_ERROR ("Noise power must be greater than zero!!!");
@@ -534,8 +574,6 @@ SatPhyRxCarrier::CalculateSinr (double rxPowerW,
 double
 SatPhyRxCarrier::CalculateCompositeSinr (double sinr1, double sinr2)
 {
-  NS_LOG_FUNCTION (this << sinr1 << sinr2 );
-
   if (sinr1 <= 0.0)
     {
       NS_FATAL_ERROR ("SINR 1 must be greater than zero!!!");
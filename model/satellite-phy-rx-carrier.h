@@ -157,7 +157,7 @@ public:
    * \brief Function for setting the beam id for all the transmissions from this SatPhyTx
    * \param beamId the Beam Identifier
    */
-  inline void SetBeamId (uint32_t beamId) { m_beamId = beamId; };
+  void SetBeamId (uint32_t beamId);
 
   /**
    * \brief Get ID the ID of the beam this carrier is attached to
@@ -165,6 +165,13 @@ public:
    */
   inline uint32_t GetBeamId () { return m_beamId; };
 
+  /**
+   * \brief Function for setting the mobility model of the receiver. Mobility
+   * is needed by the co-channel interference model.
+   * \param mobility Mobility model of the receiver
+   */
+  void SetMobility (Ptr<MobilityModel> mobility);
+
 
   /**
    * \brief Function for setting the node info class
@@ -172,6 +179,14 @@ public:
    */
   void SetNodeInfo (const Ptr<SatNodeInfo> nodeInfo);
 
+  /**
+   * \brief Assign a fixed random variable stream number to the random
+   * variables used by the carrier.
+   * \param stream First stream index to use
+   * \return Number of stream indices assigned
+   */
+  int64_t AssignStreams (int64_t stream);
+
   /**
    * \brief Function for starting packet reception from the SatChannel
    * \param rxParams The needed parameters for the received signal
@@ -307,12 +322,13 @@ protected:
   inline State GetState () { return m_state; }
 
   /**
-   * \brief Function for checking the SINR against the link results
+   * \brief Function for checking the SINR against the link results. The check
+   * does not log, since it is also done by the parallel CRDSA frame processing.
    * \param cSinr composite SINR
    * \param rxParams Rx parameters
    * \return result of the check
    */
-  bool CheckAgainstLinkResults (double cSinr, Ptr<SatSignalParameters> rxParams);
+  bool CheckAgainstLinkResults (double cSinr, const Ptr<SatSignalParameters>& rxParams);
 
   /**
    * \brief Function for ending the packet reception from the SatChannel
@@ -345,7 +361,7 @@ protected:
                         double rxNoisePowerW,
                         double rxAciIfPowerW,
                         double rxExtNoisePowerW,
-                        SatPhyRxCarrierConf::SinrCalculatorCallback sinrCalculate);
+                        const SatPhyRxCarrierConf::SinrCalculatorCallback& sinrCalculate);
 
   /**
    * \brief Function for calculating the composite SINR
@@ -510,7 +526,7 @@ private:
    * \param rxParams Rx parameters
    * \return result of the check
    */
-  bool CheckAgainstLinkResultsErrorModelAvi (double cSinr, Ptr<SatSignalParameters> rxParams);
+  bool CheckAgainstLinkResultsErrorModelAvi (double cSinr, const Ptr<SatSignalParameters>& rxParams);
 
   State m_state; 																//< Current state of the carrier
   uint32_t m_beamId; 														//< Beam ID
@@ -534,6 +550,8 @@ private:
   Ptr<SatNodeInfo> m_nodeInfo; 									//< NodeInfo of the node where carrier is attached
   SatEnums::ChannelType_t m_channelType;				//< Channel type
   Ptr<SatLinkResults> m_linkResults; 						//< Link results from the carrier configuration
+  Ptr<SatLinkResultsDvbS2> m_linkResultsDvbS2;		//< DVB-S2 link results, if in use
+  Ptr<SatLinkResultsDvbRcs2> m_linkResultsDvbRcs2;	//< DVB-RCS2 link results, if in use
   Ptr<UniformRandomVariable> m_uniformVariable;	//< Uniform helper random variable
   SatPhyRxCarrierConf::ErrorModel m_errorModel;	//< Error model
   double m_constantErrorRate;										//< Error rate for constant error model
@@ -109,14 +109,26 @@ SatPhyRx::GetAntennaGain (Ptr<MobilityModel> mobility)
 {
   NS_LOG_FUNCTION (this);
 
-  double gain_W (m_maxAntennaGain);
-
   // Get the receive antenna gain at the transmitter position.
   // E.g. UT transmits to the satellite receiver.
   if (m_antennaGainPattern)
     {
       Ptr<SatMobilityModel> m = DynamicCast<SatMobilityModel> (mobility);
-      gain_W = m_antennaGainPattern->GetAntennaGain_lin (m->GetGeoPosition ());
+      return GetAntennaGain (m->GetGeoPosition ());
+    }
+
+  return m_maxAntennaGain;
+}
+
+double
+SatPhyRx::GetAntennaGain (const GeoCoordinate& coord) const
+{
+  // No logging, since called also by the link budget worker threads
+  double gain_W (m_maxAntennaGain);
+
+  if (m_antennaGainPattern)
+    {
+      gain_W = m_antennaGainPattern->GetAntennaGain_lin (coord);
     }
 
   /**
@@ -267,6 +279,11 @@ SatPhyRx::SetMobility (Ptr<MobilityModel> m)
 {
   NS_LOG_FUNCTION (this << m);
   m_mobility = m;
+
+  for (std::vector< Ptr<SatPhyRxCarrier> >::iterator it = m_rxCarriers.begin (); it != m_rxCarriers.end (); ++it)
+    {
+      (*it)->SetMobility (m);
+    }
 }
 
 void
@@ -349,6 +366,12 @@ SatPhyRx::ConfigurePhyRxCarriers (Ptr<SatPhyRxCarrierConf> carrierConf, Ptr<SatS
 						NS_FATAL_ERROR ("SatPhyRx::ConfigurePhyRxCarriers - Invalid channel type!");
 					}
 				}
+
+      if (m_mobility)
+        {
+          rxc->SetMobility (m_mobility);
+        }
+
       m_rxCarriers.push_back (rxc);
     }
 }
@@ -98,6 +98,17 @@ public:
    */
   double GetAntennaGain (Ptr<MobilityModel> mobility);
 
+  /**
+   * Get antenna gain at the given position
+   * or in case that antenna pattern is not configured, maximum configured gain is return.
+   * Has no side effects and does not log, thus it may be called also outside
+   * the simulator thread.
+   *
+   * \param coord  Position used to get gain from antenna pattern
+   * \return antenna gain
+   */
+  double GetAntennaGain (const GeoCoordinate& coord) const;
+
   /**
    * \brief Function for setting the default fading value
    * \param fadingValue default fading value
@@ -18,6 +18,7 @@
  * Author: Jani Puttonen <jani.puttonen@magister.fi>
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "ns3/simulator.h"
@@ -111,14 +112,26 @@ SatPhyTx::GetAntennaGain (Ptr<MobilityModel> mobility)
 {
   NS_LOG_FUNCTION (this);
 
-  double gain_W (m_maxAntennaGain);
-
   // Get the transmit antenna gain at the receiver position.
   // E.g. GEO satellite transmits to the UT receiver.
   if (m_antennaGainPattern)
     {
       Ptr<SatMobilityModel> m = DynamicCast<SatMobilityModel> (mobility);
-      gain_W = m_antennaGainPattern->GetAntennaGain_lin (m->GetGeoPosition ());
+      return GetAntennaGain (m->GetGeoPosition ());
+    }
+
+  return m_maxAntennaGain;
+}
+
+double
+SatPhyTx::GetAntennaGain (const GeoCoordinate& coord) const
+{
+  // No logging, since called also by the link budget worker threads
+  double gain_W (m_maxAntennaGain);
+
+  if (m_antennaGainPattern)
+    {
+      gain_W = m_antennaGainPattern->GetAntennaGain_lin (coord);
     }
 
   /**
@@ -129,6 +142,21 @@ SatPhyTx::GetAntennaGain (Ptr<MobilityModel> mobility)
   return gain_W;
 }
 
+void
+SatPhyTx::GetAntennaGains (const GeoCoordinate* coords, uint32_t n, double* gains) const
+{
+  NS_LOG_FUNCTION (this << n);
+
+  if (m_antennaGainPattern)
+    {
+      m_antennaGainPattern->GetAntennaGain_lin (coords, n, gains);
+    }
+  else
+    {
+      std::fill (gains, gains + n, m_maxAntennaGain);
+    }
+}
+
 void
 SatPhyTx::SetDefaultFadingValue (double fadingValue)
 {
@@ -232,6 +260,15 @@ SatPhyTx::StartTx (Ptr<SatSignalParameters> txParams)
         ChangeState (TX);
         m_channel->StartTx (txParams);
 
+        // Co-channel interference model is based on the activity of the beams
+        Ptr<SatCoChannelActivity> coChannelActivity = m_channel->GetCoChannelActivity ();
+
+        if (coChannelActivity && coChannelActivity->IsEnabled ())
+          {
+            coChannelActivity->AddTransmission (m_mobility, txParams->m_beamId, txParams->m_carrierId,
+                                                txParams->m_duration, txParams->m_txPower_W);
+          }
+
         /**
          * The SatPhyTx is mapped to a spot-beam, which means that there may be several
          * carriers handled by the same SatPhyTx. This is why the SatPhyTx state machine
@@ -109,6 +109,27 @@ public:
    */
   double GetAntennaGain (Ptr<MobilityModel> mobility);
 
+  /**
+   * Get antenna gain at the given position
+   * or in case that antenna pattern is not configured, maximum configured gain is return.
+   * Has no side effects and does not log, thus it may be called also outside
+   * the simulator thread.
+   *
+   * \param coord  Position used to get gain from antenna pattern
+   * \return antenna gain
+   */
+  double GetAntennaGain (const GeoCoordinate& coord) const;
+
+  /**
+   * Get antenna gains at a set of positions with one batch look-up
+   * or in case that antenna pattern is not configured, maximum configured gain is return
+   *
+   * \param coords  Array of positions used to get gains from antenna pattern
+   * \param n  Number of positions
+   * \param gains  Array to store the antenna gains
+   */
+  void GetAntennaGains (const GeoCoordinate* coords, uint32_t n, double* gains) const;
+
   /**
    * \brief Function for setting the default fading value
    * \param fadingValue default fading value
@@ -18,6 +18,7 @@
  * Author: Jani Puttonen <jani.puttonen@magister.fi>
  */
 
+#include <algorithm>
 #include <ns3/log.h>
 #include <ns3/simulator.h>
 #include <ns3/boolean.h>
@@ -25,6 +26,7 @@
 #include <ns3/uinteger.h>
 #include <ns3/pointer.h>
 #include <ns3/node.h>
+#include <ns3/singleton.h>
 
 #include "satellite-phy.h"
 #include <ns3/satellite-utils.h>
@@ -36,6 +38,8 @@
 #include <ns3/satellite-node-info.h>
 #include <ns3/satellite-enums.h>
 #include <ns3/satellite-address-tag.h>
+#include <ns3/satellite-mac-tag.h>
+#include <ns3/satellite-id-mapper.h>
 #include <ns3/satellite-time-tag.h>
 #include <ns3/satellite-typedefs.h>
 
@@ -321,7 +325,6 @@ SatPhy::SendPdu (PacketContainer_t p, uint32_t carrierId, Time duration, SatSign
   Ptr<SatSignalParameters> txParams = Create<SatSignalParameters> ();
   txParams->m_duration = duration;
   txParams->m_phyTx = m_phyTx;
-  txParams->m_packetsInBurst = p;
   txParams->m_beamId = m_beamId;
   txParams->m_carrierId = carrierId;
   txParams->m_sinr = 0;
@@ -333,6 +336,52 @@ SatPhy::SendPdu (PacketContainer_t p, uint32_t carrierId, Time duration, SatSign
   txParams->m_txInfo.packetType = txInfo.packetType;
   txParams->m_txInfo.crdsaUniquePacketId = txInfo.crdsaUniquePacketId;
 
+  // Resolve the source and destinations of the burst once from the MAC tags
+  SatSignalParameters::DestinationAddresses_t destAddresses;
+
+  for (PacketContainer_t::const_iterator it = p.begin (); it != p.end (); ++it)
+    {
+      SatMacTag macTag;
+      if ((*it)->PeekPacketTag (macTag))
+        {
+          if (it == p.begin ())
+            {
+              txParams->m_sourceAddress = macTag.GetSourceAddress ();
+            }
+
+          // Keep the addresses unique and ordered by their last occurrence
+          Mac48Address dest = macTag.GetDestAddress ();
+          SatSignalParameters::DestinationAddresses_t::iterator destIt =
+            std::find (destAddresses.begin (), destAddresses.end (), dest);
+
+          if (destIt != destAddresses.end ())
+            {
+              destAddresses.erase (destIt);
+            }
+          destAddresses.push_back (dest);
+        }
+    }
+
+  txParams->SetPackets (p, destAddresses);
+
+  switch (m_nodeInfo->GetNodeType ())
+    {
+    case SatEnums::NT_UT:
+      {
+        txParams->m_sourceUtId = Singleton<SatIdMapper>::Get ()->GetUtIdWithMac (txParams->m_sourceAddress);
+        break;
+      }
+    case SatEnums::NT_GW:
+      {
+        txParams->m_sourceGwId = Singleton<SatIdMapper>::Get ()->GetGwIdWithMac (txParams->m_sourceAddress);
+        break;
+      }
+    default:
+      {
+        break;
+      }
+    }
+
   m_phyTx->StartTx (txParams);
 }
 
@@ -375,22 +424,25 @@ SatPhy::Receive (Ptr<SatSignalParameters> rxParams, bool phyError)
                  m_nodeInfo->GetMacAddress (),
                  SatEnums::LL_PHY,
                  ld,
-                 SatUtils::GetPacketInfo (rxParams->m_packetsInBurst));
+                 SatUtils::GetPacketInfo (rxParams->GetPackets ()));
 
   if (phyError)
     {
       // If there was a PHY error, the packet is dropped here.
-      NS_LOG_INFO (this << " dropped " << rxParams->m_packetsInBurst.size ()
+      NS_LOG_INFO (this << " dropped " << rxParams->GetPackets ().size ()
                          << " packets because of PHY error.");
     }
   else
     {
+      // The packets are modified by the upper layers, thus private copies are needed
+      SatSignalParameters::PacketsInBurst_t& packets = rxParams->GetModifiablePackets ();
+
       // Invoke the `Rx` and `RxDelay` trace sources.
       if (m_isStatisticsTagsEnabled)
         {
           SatSignalParameters::PacketsInBurst_t::iterator it1;
-          for (it1 = rxParams->m_packetsInBurst.begin ();
-               it1 != rxParams->m_packetsInBurst.end (); ++it1)
+          for (it1 = packets.begin ();
+               it1 != packets.end (); ++it1)
             {
               Address addr; // invalid address.
               bool isTaggedWithAddress = false;
@@ -422,12 +474,12 @@ SatPhy::Receive (Ptr<SatSignalParameters> rxParams, bool phyError)
                                   addr);
                 }
 
-            } // end of `for (it1 = rxParams->m_packetsInBurst)`
+            } // end of `for (it1 = packets)`
 
         } // end of `if (m_isStatisticsTagsEnabled)`
 
       // Pass the packet to the upper layer.
-      m_rxCallback (rxParams->m_packetsInBurst, rxParams);
+      m_rxCallback (packets, rxParams);
 
     } // end of else of `if (phyError)`
 
@@ -18,6 +18,7 @@
  * Author: Frans Laakso <frans.laakso@magister.fi>
  */
 
+#include "ns3/double.h"
 #include "satellite-rayleigh-model.h"
 
 namespace ns3 {
@@ -81,7 +82,7 @@ SatRayleighModel::Reset ()
   NS_LOG_FUNCTION (this);
 
   m_rayleighConf = NULL;
-  m_oscillators.clear ();
+  m_oscillators.Clear ();
   m_uniformVariable = NULL;
 }
 
@@ -106,7 +107,7 @@ SatRayleighModel::ConstructOscillators ()
       double psi = m_uniformVariable->GetValue ();
       std::complex<double> amplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (m_rayleighParameters[0][1]);
       /// 3. Construct oscillator:
-      m_oscillators.push_back (CreateObject<SatFadingOscillator> (amplitude, phi, omega));
+      m_oscillators.AddOscillator (amplitude, phi, omega);
     }
 }
 
@@ -115,14 +116,7 @@ SatRayleighModel::GetComplexGain ()
 {
   NS_LOG_FUNCTION (this);
 
-  double timeInSeconds = Now ().GetSeconds ();
-
-  std::complex<double> sumAmplitude = std::complex<double> (0,0);
-  for (uint32_t i = 0; i < m_oscillators.size (); i++)
-    {
-      sumAmplitude += m_oscillators[i]->GetComplexValueAt (timeInSeconds);
-    }
-  return sumAmplitude;
+  return m_oscillators.GetComplexSum (Now ().GetSeconds ());
 }
 
 double
@@ -29,7 +29,10 @@ NS_LOG_COMPONENT_DEFINE ("SatSignalParameters");
 namespace ns3 {
 
 SatSignalParameters::SatSignalParameters ()
-  : m_beamId (),
+  : m_sourceAddress (),
+    m_sourceUtId (-1),
+    m_sourceGwId (-1),
+    m_beamId (),
     m_carrierId (),
     m_carrierFreq_hz (),
     m_duration (),
@@ -44,17 +47,18 @@ SatSignalParameters::SatSignalParameters ()
     m_rxNoisePowerInSatellite_W (),
     m_rxAciIfPowerInSatellite_W (),
     m_rxExtNoisePowerInSatellite_W (),
-    m_sinrCalculate ()
+    m_sinrCalculate (),
+    m_burst (Create<Burst> ())
 {
   NS_LOG_FUNCTION (this);
 }
 
 SatSignalParameters::SatSignalParameters ( const SatSignalParameters& p )
 {
-  for ( PacketsInBurst_t::const_iterator i = p.m_packetsInBurst.begin (); i != p.m_packetsInBurst.end (); i++  )
-    {
-      m_packetsInBurst.push_back ((*i)->Copy ());
-    }
+  m_burst = p.m_burst;
+  m_sourceAddress = p.m_sourceAddress;
+  m_sourceUtId = p.m_sourceUtId;
+  m_sourceGwId = p.m_sourceGwId;
 
   m_beamId = p.m_beamId;
   m_carrierId = p.m_carrierId;
@@ -89,6 +93,55 @@ SatSignalParameters::Copy ()
   return p;
 }
 
+void
+SatSignalParameters::SetPackets (const PacketsInBurst_t& packets, const DestinationAddresses_t& destAddresses)
+{
+  NS_LOG_FUNCTION (this << packets.size ());
+
+  m_burst = Create<Burst> ();
+
+  for ( PacketsInBurst_t::const_iterator i = packets.begin (); i != packets.end (); i++  )
+    {
+      m_burst->m_packets.push_back ((*i)->Copy ());
+    }
+
+  m_burst->m_destAddresses = destAddresses;
+}
+
+const SatSignalParameters::PacketsInBurst_t&
+SatSignalParameters::GetPackets () const
+{
+  return m_burst->m_packets;
+}
+
+SatSignalParameters::PacketsInBurst_t&
+SatSignalParameters::GetModifiablePackets ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // Copy on write, if the burst container is shared
+  if (m_burst->GetReferenceCount () > 1)
+    {
+      Ptr<Burst> burst = Create<Burst> ();
+
+      for ( PacketsInBurst_t::const_iterator i = m_burst->m_packets.begin (); i != m_burst->m_packets.end (); i++  )
+        {
+          burst->m_packets.push_back ((*i)->Copy ());
+        }
+
+      burst->m_destAddresses = m_burst->m_destAddresses;
+      m_burst = burst;
+    }
+
+  return m_burst->m_packets;
+}
+
+const SatSignalParameters::DestinationAddresses_t&
+SatSignalParameters::GetDestAddresses () const
+{
+  return m_burst->m_destAddresses;
+}
+
 TypeId
 SatSignalParameters::GetTypeId (void)
 {
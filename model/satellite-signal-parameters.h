@@ -25,6 +25,8 @@
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/mac48-address.h"
 #include "satellite-enums.h"
 
 namespace ns3 {
@@ -37,6 +39,13 @@ class SatPhyTx;
 * through the SatChannel from the transmitter to the receiver. It includes e.g. the packet
 * container (BBFrame in FWD link, FPDU in RTN link) as well as all the transmission related
 * information (MODCODs, frequency, tx power, etc.).
+*
+* The packets of the burst (and the destination addresses resolved from them) are
+* held in an immutable burst container, which is shared by all the copies of the signal
+* parameters made by the SatChannel for the receivers. A receiver which needs to modify
+* the packets (e.g. to pass them to the upper layers) gets private copies of them with
+* GetModifiablePackets, thus only the small per-receiver part is allocated for each
+* receiver in the channel fan-out.
 */
 class SatSignalParameters : public Object
 {
@@ -60,18 +69,59 @@ public:
    */
   typedef std::vector< Ptr<Packet> > PacketsInBurst_t;
 
+  /**
+   * Container for the destination MAC addresses of the packets in a burst.
+   */
+  typedef std::vector<Mac48Address> DestinationAddresses_t;
+
   /**
    * default constructor
    */
   SatSignalParameters ();
 
   /**
-   * copy constructor
+   * copy constructor. The burst container is shared with the copy.
    */
   SatSignalParameters (const SatSignalParameters& p);
 
+  /**
+   * \brief Copy the signal parameters, e.g. for a receiver. The burst
+   * container is shared with the copy.
+   * \return copy of the signal parameters
+   */
   Ptr<SatSignalParameters> Copy ();
 
+  /**
+   * \brief Set the packets of the burst. The packets are copied, so that
+   * the sender may continue using the given packets.
+   * \param packets Packets of the burst
+   * \param destAddresses Unique destination MAC addresses of the packets
+   */
+  void SetPackets (const PacketsInBurst_t& packets, const DestinationAddresses_t& destAddresses);
+
+  /**
+   * \brief Get the packets of the burst. The packets are shared with the
+   * other receivers of the transmission and must not be modified.
+   * \return packets of the burst
+   */
+  const PacketsInBurst_t& GetPackets () const;
+
+  /**
+   * \brief Get the packets of the burst for modification. If the burst
+   * container is shared, private copies of the packets are made first.
+   * \return private packets of the burst
+   */
+  PacketsInBurst_t& GetModifiablePackets ();
+
+  /**
+   * \brief Get the unique destination MAC addresses of the packets in the
+   * burst ordered by their last occurrence in the burst. Resolved once from
+   * the MAC tags when the burst is sent, so that the channel and the receivers
+   * do not need to peek the packets.
+   * \return destination addresses of the burst
+   */
+  const DestinationAddresses_t& GetDestAddresses () const;
+
   /**
    * \brief Get the type ID
    * \return the object TypeId
@@ -79,11 +129,20 @@ public:
   static TypeId GetTypeId (void);
 
   /**
-   * The packets being transmitted with this signal i.e.
-   * this is transmit buffer including packet pointers.
+   * Source MAC address of the burst. Resolved once from the MAC tag of the
+   * first packet when the burst is sent.
    */
+  Mac48Address m_sourceAddress;
 
-  PacketsInBurst_t m_packetsInBurst;
+  /**
+   * UT id of the source of the burst, if sent by a UT. Otherwise -1.
+   */
+  int32_t m_sourceUtId;
+
+  /**
+   * GW id of the source of the burst, if sent by a GW. Otherwise -1.
+   */
+  int32_t m_sourceGwId;
 
   /**
    * The beam for the packet transmission
@@ -173,6 +232,31 @@ public:
    * Callback for SINR calculation
    */
   Callback<double, double> m_sinrCalculate;
+
+private:
+  /**
+   * \brief Immutable burst container shared by the copies of the signal
+   * parameters.
+   */
+  class Burst : public SimpleRefCount<Burst>
+  {
+  public:
+    /**
+     * The packets being transmitted with this signal i.e.
+     * this is transmit buffer including packet pointers.
+     */
+    PacketsInBurst_t m_packets;
+
+    /**
+     * Unique destination MAC addresses of the packets in the burst
+     */
+    DestinationAddresses_t m_destAddresses;
+  };
+
+  /**
+   * Burst container, possibly shared with other signal parameters
+   */
+  Ptr<Burst> m_burst;
 };
 
 
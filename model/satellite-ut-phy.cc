@@ -170,8 +170,6 @@ SatUtPhy::DoInitialize ()
 double
 SatUtPhy::CalculateSinr (double sinr)
 {
-  NS_LOG_FUNCTION (this << sinr);
-
   if ( sinr <= 0  )
     {
       NS_FATAL_ERROR ( "Calculated own SINR is expected to be greater than zero!!!");
@@ -18,6 +18,10 @@
  * Author: Jani Puttonen <jani.puttonen@magister.fi>
  */
 
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+#include <sys/stat.h>
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/simulator.h"
@@ -35,7 +39,13 @@ using namespace ns3;
  *
  * This case creates the antenna gain patterns classes and compares the
  * antenna gain values and best beam ids for the test positions (= GW positions
- * of the 72 beam reference system).
+ * of the 72 beam reference system). In addition, the best beam ids of random
+ * positions within each spot-beam are compared against the ones found by
+ * evaluating all the antenna patterns. Finally, a pattern is written to a
+ * binary pattern file and the gains of the mapped pattern are compared, and
+ * a stale binary pattern file is checked to be regenerated from the text file.
+ * If the stale binary pattern file cannot be regenerated, the pattern read
+ * from the text file is checked to be used.
  */
 class SatAntennaPatternTestCase : public TestCase
 {
@@ -117,6 +127,99 @@ SatAntennaPatternTestCase::DoRun (void)
       NS_TEST_ASSERT_MSG_EQ ( bestBeamId, expectedBeamIds[i], "Not expected best spot-beam id");
     }
 
+  // Compare the best beam ids of random positions to the exhaustive search
+  const uint32_t numberOfBeams (72);
+  const uint32_t positionsPerBeam (20);
+
+  for (uint32_t beamId = 1; beamId <= numberOfBeams; ++beamId)
+    {
+      for (uint32_t j = 0; j < positionsPerBeam; ++j)
+        {
+          GeoCoordinate pos = gpContainer.GetAntennaGainPattern (beamId)->GetValidRandomPosition ();
+
+          double bestGain (-100.0);
+          uint32_t expectedBeamId (0);
+
+          for (uint32_t k = 1; k <= numberOfBeams; ++k)
+            {
+              gain = gpContainer.GetAntennaGainPattern (k)->GetAntennaGain_lin (pos);
+
+              if (gain > bestGain)
+                {
+                  bestGain = gain;
+                  expectedBeamId = k;
+                }
+            }
+
+          NS_TEST_ASSERT_MSG_EQ ( gpContainer.GetBestBeamId (pos), expectedBeamId, "Best spot-beam id differs from exhaustive search");
+        }
+    }
+
+  // Write a pattern to a binary pattern file and compare the gains of the mapped pattern
+  std::string textFilePathName = Singleton<SatEnvVariables>::Get ()->GetOutputPath () + "/test-antenna-gain-pattern.txt";
+  Ptr<SatAntennaGainPattern> textPattern = gpContainer.GetAntennaGainPattern (expectedBeamIds[0]);
+  bool written = textPattern->WriteAntennaPatternToBinaryFile (SatAntennaGainPattern::GetBinaryFilePathName (textFilePathName));
+  NS_TEST_ASSERT_MSG_EQ (written, true, "Binary pattern file not written");
+  Ptr<SatAntennaGainPattern> binaryPattern = CreateObject<SatAntennaGainPattern> (textFilePathName);
+
+  for ( uint32_t i = 0; i < coordinates.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ ( binaryPattern->GetAntennaGain_lin (coordinates[i]), textPattern->GetAntennaGain_lin (coordinates[i]),
+                              "Gain of binary pattern differs from text pattern");
+    }
+
+  // Write a binary pattern file of another pattern for a copy of a text
+  // pattern file. The binary file is stale, thus it is regenerated.
+  std::string staleTextFilePathName = Singleton<SatEnvVariables>::Get ()->GetOutputPath () + "/test-antenna-gain-pattern-stale.txt";
+  std::string dataTextFilePathName = Singleton<SatEnvVariables>::Get ()->LocateDataDirectory () + "/antennapatterns/SatAntennaGain72Beams_2.txt";
+  {
+    std::ifstream ifs (dataTextFilePathName.c_str ());
+    std::ofstream ofs (staleTextFilePathName.c_str ());
+    ofs << ifs.rdbuf ();
+  }
+
+  written = textPattern->WriteAntennaPatternToBinaryFile (SatAntennaGainPattern::GetBinaryFilePathName (staleTextFilePathName));
+  NS_TEST_ASSERT_MSG_EQ (written, true, "Stale binary pattern file not written");
+  Ptr<SatAntennaGainPattern> regeneratedPattern = CreateObject<SatAntennaGainPattern> (staleTextFilePathName);
+  Ptr<SatAntennaGainPattern> mappedPattern = CreateObject<SatAntennaGainPattern> (staleTextFilePathName);
+
+  for ( uint32_t i = 0; i < coordinates.size (); ++i)
+    {
+      double expectedGain = gpContainer.GetAntennaGainPattern (2)->GetAntennaGain_lin (coordinates[i]);
+      NS_TEST_ASSERT_MSG_EQ ( regeneratedPattern->GetAntennaGain_lin (coordinates[i]), expectedGain,
+                              "Gain of stale binary pattern not regenerated from text pattern");
+      NS_TEST_ASSERT_MSG_EQ ( mappedPattern->GetAntennaGain_lin (coordinates[i]), expectedGain,
+                              "Gain of regenerated binary pattern differs from text pattern");
+    }
+
+  // Write a stale binary pattern file, which cannot be regenerated as a directory
+  // blocks the temporary file of the regeneration. The text file is used instead.
+  std::string blockedTextFilePathName = Singleton<SatEnvVariables>::Get ()->GetOutputPath () + "/test-antenna-gain-pattern-blocked.txt";
+  std::string blockedBinaryFilePathName = SatAntennaGainPattern::GetBinaryFilePathName (blockedTextFilePathName);
+  {
+    std::ifstream ifs (dataTextFilePathName.c_str ());
+    std::ofstream ofs (blockedTextFilePathName.c_str ());
+    ofs << ifs.rdbuf ();
+  }
+
+  written = textPattern->WriteAntennaPatternToBinaryFile (blockedBinaryFilePathName);
+  NS_TEST_ASSERT_MSG_EQ (written, true, "Stale binary pattern file not written");
+
+  std::ostringstream blockingDirectory;
+  blockingDirectory << blockedBinaryFilePathName << ".tmp." << getpid ();
+  mkdir (blockingDirectory.str ().c_str (), 0755);
+
+  Ptr<SatAntennaGainPattern> fallbackPattern = CreateObject<SatAntennaGainPattern> (blockedTextFilePathName);
+
+  for ( uint32_t i = 0; i < coordinates.size (); ++i)
+    {
+      double expectedGain = gpContainer.GetAntennaGainPattern (2)->GetAntennaGain_lin (coordinates[i]);
+      NS_TEST_ASSERT_MSG_EQ ( fallbackPattern->GetAntennaGain_lin (coordinates[i]), expectedGain,
+                              "Gain of not regenerated binary pattern differs from text pattern");
+    }
+
+  rmdir (blockingDirectory.str ().c_str ());
+
   Singleton<SatEnvVariables>::Get ()->DoDispose ();
 }
 
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+/**
+ * \file satellite-channel-batched-delivery-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the batched delivery of the satellite channel.
+ */
+
+#include <map>
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/cbr-application.h"
+#include "ns3/cbr-helper.h"
+#include "../model/satellite-channel.h"
+#include "../helper/satellite-helper.h"
+#include "ns3/singleton.h"
+#include "../utils/satellite-env-variables.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that the batched delivery of the channel
+ * delivers a transmission to the receivers of all the nodes at the same
+ * propagation delay with one event.
+ *
+ *   1.  Create a user defined scenario with one beam and 30 UTs, using the
+ *       constant propagation delay model.
+ *   2.  Send traffic from the GW user to the UT users with and without the
+ *       batched delivery.
+ *
+ *   Expected result:
+ *     With the batched delivery each reception event of the forward user
+ *     link starts the receptions of all the 30 UTs. The UT users receive
+ *     the same amount of data with and without the batched delivery.
+ */
+class SatChannelBatchedDeliveryTestCase : public TestCase
+{
+public:
+  SatChannelBatchedDeliveryTestCase ();
+  virtual ~SatChannelBatchedDeliveryTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void RxBatch (SatEnums::ChannelType_t channelType, uint32_t nReceivers);
+  uint64_t Simulate (bool batchedDelivery);
+
+  uint32_t m_utCount;
+  std::map<SatEnums::ChannelType_t, uint32_t> m_batches;
+  std::map<SatEnums::ChannelType_t, uint32_t> m_receptions;
+};
+
+SatChannelBatchedDeliveryTestCase::SatChannelBatchedDeliveryTestCase ()
+  : TestCase ("Test batched delivery of satellite channel with many receiver nodes."),
+    m_utCount (30)
+{
+}
+
+SatChannelBatchedDeliveryTestCase::~SatChannelBatchedDeliveryTestCase ()
+{
+}
+
+void
+SatChannelBatchedDeliveryTestCase::RxBatch (SatEnums::ChannelType_t channelType, uint32_t nReceivers)
+{
+  m_batches[channelType]++;
+  m_receptions[channelType] += nReceivers;
+}
+
+uint64_t
+SatChannelBatchedDeliveryTestCase::Simulate (bool batchedDelivery)
+{
+  // Both simulations draw the same random values
+  RngSeedManager::ResetNextStreamIndex ();
+
+  Config::SetDefault ("ns3::SatChannel::EnableBatchedDelivery", BooleanValue (batchedDelivery));
+
+  Ptr<SatHelper> helper = CreateObject<SatHelper> ("Scenario72");
+
+  SatBeamUserInfo beamInfo = SatBeamUserInfo (m_utCount, 1);
+  std::map<uint32_t, SatBeamUserInfo > beamMap;
+  beamMap[1] = beamInfo;
+
+  helper->CreateUserDefinedScenario (beamMap);
+
+  Config::ConnectWithoutContext ("/ChannelList/*/$ns3::SatChannel/RxBatch",
+                                 MakeCallback (&SatChannelBatchedDeliveryTestCase::RxBatch, this));
+
+  NodeContainer gwUsers = helper->GetGwUsers ();
+  NodeContainer utUsers = helper->GetUtUsers ();
+  uint16_t port = 9;
+
+  ApplicationContainer gwApps;
+
+  for (uint32_t i = 0; i < utUsers.GetN (); ++i)
+    {
+      CbrHelper cbr ("ns3::UdpSocketFactory", Address (InetSocketAddress (helper->GetUserAddress (utUsers.Get (i)), port)));
+      cbr.SetAttribute ("Interval", StringValue ("50ms"));
+      cbr.SetAttribute ("PacketSize", UintegerValue (100) );
+
+      gwApps.Add (cbr.Install (gwUsers.Get (0)));
+    }
+
+  gwApps.Start (Seconds (0.1));
+  gwApps.Stop (Seconds (1.5));
+
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", Address (InetSocketAddress (Ipv4Address::GetAny (), port)));
+
+  ApplicationContainer utApps = sink.Install (utUsers);
+  utApps.Start (Seconds (0.1));
+  utApps.Stop (Seconds (2.0));
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  uint64_t received (0);
+
+  for (uint32_t i = 0; i < utApps.GetN (); ++i)
+    {
+      received += DynamicCast<PacketSink> (utApps.Get (i))->GetTotalRx ();
+    }
+
+  Simulator::Destroy ();
+
+  return received;
+}
+
+void
+SatChannelBatchedDeliveryTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-channel-batched-delivery", "", true);
+
+  // All the UTs have the same propagation delay
+  Config::SetDefault ("ns3::SatBeamHelper::PropagationDelayModel", EnumValue (SatEnums::PD_CONSTANT));
+
+  uint64_t perReceiverRx = Simulate (false);
+
+  NS_TEST_ASSERT_MSG_EQ (m_batches.empty (), true, "Batched reception events without batched delivery");
+
+  uint64_t batchedRx = Simulate (true);
+
+  NS_TEST_ASSERT_MSG_GT (perReceiverRx, 0, "No data received by the UT users");
+  NS_TEST_ASSERT_MSG_EQ (batchedRx, perReceiverRx, "Batched delivery changes the received data");
+
+  uint32_t batches = m_batches[SatEnums::FORWARD_USER_CH];
+  uint32_t receptions = m_receptions[SatEnums::FORWARD_USER_CH];
+
+  NS_TEST_ASSERT_MSG_GT (batches, 0, "No batched reception events on the forward user link");
+  NS_TEST_ASSERT_MSG_EQ (receptions, batches * m_utCount, "Forward user link transmission not delivered with one event per delay");
+
+  // Restore the defaults for the other test cases
+  Config::SetDefault ("ns3::SatChannel::EnableBatchedDelivery", BooleanValue (false));
+  Config::SetDefault ("ns3::SatBeamHelper::PropagationDelayModel", EnumValue (SatEnums::PD_CONSTANT_SPEED));
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the batched delivery of the satellite channel.
+ */
+class SatChannelBatchedDeliveryTestSuite : public TestSuite
+{
+public:
+  SatChannelBatchedDeliveryTestSuite ();
+};
+
+SatChannelBatchedDeliveryTestSuite::SatChannelBatchedDeliveryTestSuite ()
+  : TestSuite ("sat-channel-batched-delivery-test", SYSTEM)
+{
+  AddTestCase (new SatChannelBatchedDeliveryTestCase, TestCase::QUICK);
+}
+
+// Allocate an instance of this TestSuite
+static SatChannelBatchedDeliveryTestSuite satChannelBatchedDeliveryTestSuite;
@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+/**
+ * \file satellite-crdsa-sic-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the successive interference cancellation of the CRDSA frame processing.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/singleton.h"
+#include "ns3/mac48-address.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/satellite-utils.h"
+#include "ns3/satellite-const-variables.h"
+#include "ns3/satellite-wave-form-conf.h"
+#include "ns3/satellite-link-results.h"
+#include "ns3/satellite-signal-parameters.h"
+#include "ns3/satellite-phy-rx-carrier-conf.h"
+#include "ns3/satellite-phy-rx-carrier-per-frame.h"
+#include "../utils/satellite-env-variables.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test that the successive interference cancellation
+ * done with the slot work list gives the same results as the full rescan of
+ * the frame after each successfully received packet.
+ *
+ *   1.  Create two CRDSA carriers using the same random variable stream, one
+ *       of them with the full rescan of the frame enabled.
+ *   2.  Create frames having the given number of packets with three replicas
+ *       in random slots and random user link Es/No values, and process the
+ *       same frame with both carriers.
+ *
+ *   Expected result:
+ *     The processed packets of each frame, their order, the error flags and
+ *     the composite SINRs are identical. Packets suffering from collisions
+ *     are received, i.e. the interference cancellation is in use.
+ */
+class SatCrdsaSicTestCase : public TestCase
+{
+public:
+  SatCrdsaSicTestCase (SatPhyRxCarrierConf::RandomAccessCollisionModel collisionModel, uint32_t packetsPerFrame);
+  virtual ~SatCrdsaSicTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Create the replicas of the packets into a frame
+   * \param frame Frame to create the replicas into
+   */
+  void CreateFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame) const;
+
+  double GetCarrierBandwidthHz (SatEnums::ChannelType_t channelType, uint32_t carrierId, SatEnums::CarrierBandwidthType_t bandwidthType);
+  static double CalculateSinr (double sinr);
+
+  SatPhyRxCarrierConf::RandomAccessCollisionModel m_collisionModel;
+  uint32_t m_packetsPerFrame;
+  uint32_t m_slotsPerFrame;
+  uint32_t m_replicas;
+  double m_carrierBandwidthHz;
+  double m_noisePowerW;
+  Ptr<SatWaveform> m_waveform;
+  std::vector<Mac48Address> m_sourceAddresses;
+  std::vector<uint16_t> m_slotIds;
+  std::vector<double> m_rxPowersW;
+};
+
+SatCrdsaSicTestCase::SatCrdsaSicTestCase (SatPhyRxCarrierConf::RandomAccessCollisionModel collisionModel, uint32_t packetsPerFrame)
+  : TestCase ("Test CRDSA successive interference cancellation against the full rescan of the frame."),
+    m_collisionModel (collisionModel),
+    m_packetsPerFrame (packetsPerFrame),
+    m_slotsPerFrame (100),
+    m_replicas (3),
+    m_carrierBandwidthHz (1.25e6),
+    m_noisePowerW (SatConstVariables::BOLTZMANN_CONSTANT * 290.0 * 1.25e6)
+{
+}
+
+SatCrdsaSicTestCase::~SatCrdsaSicTestCase ()
+{
+}
+
+double
+SatCrdsaSicTestCase::GetCarrierBandwidthHz (SatEnums::ChannelType_t channelType, uint32_t carrierId, SatEnums::CarrierBandwidthType_t bandwidthType)
+{
+  return m_carrierBandwidthHz;
+}
+
+double
+SatCrdsaSicTestCase::CalculateSinr (double sinr)
+{
+  return sinr;
+}
+
+void
+SatCrdsaSicTestCase::CreateFrame (SatPhyRxCarrierPerFrame::crdsaFrame_s& frame) const
+{
+  std::vector<double> slotPowers (m_slotsPerFrame, 0.0);
+
+  for (uint32_t i = 0; i < m_slotIds.size (); ++i)
+    {
+      slotPowers[m_slotIds[i]] += m_rxPowersW[i / m_replicas];
+    }
+
+  // the interference cancellation modifies the signal parameters, thus each frame has its own
+  for (uint32_t i = 0; i < m_slotIds.size (); ++i)
+    {
+      uint32_t packet = i / m_replicas;
+      Ptr<SatSignalParameters> rxParams = Create<SatSignalParameters> ();
+
+      rxParams->m_txInfo.packetType = SatEnums::PACKET_TYPE_CRDSA;
+      rxParams->m_txInfo.modCod = m_waveform->GetModCod ();
+      rxParams->m_txInfo.fecBlockSizeInBytes = m_waveform->GetPayloadInBytes ();
+      rxParams->m_txInfo.frameType = SatEnums::UNDEFINED_FRAME;
+      rxParams->m_txInfo.waveformId = 3;
+      rxParams->m_txInfo.crdsaUniquePacketId = packet;
+      rxParams->m_rxPowerInSatellite_W = m_rxPowersW[packet];
+      rxParams->m_ifPowerInSatellite_W = slotPowers[m_slotIds[i]] - m_rxPowersW[packet];
+      rxParams->m_rxNoisePowerInSatellite_W = m_noisePowerW;
+      rxParams->m_rxAciIfPowerInSatellite_W = 0.0;
+      rxParams->m_rxExtNoisePowerInSatellite_W = 0.0;
+      rxParams->m_rxPower_W = m_noisePowerW * SatUtils::DbToLinear (30.0);
+      rxParams->m_ifPower_W = 0.0;
+      rxParams->m_sinrCalculate = MakeCallback (&SatCrdsaSicTestCase::CalculateSinr);
+
+      SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s params;
+
+      params.rxParams = rxParams;
+      params.destAddress = Mac48Address ();
+      params.sourceAddress = m_sourceAddresses[packet];
+      params.ownSlotId = m_slotIds[i];
+      params.hasCollision = (rxParams->m_ifPowerInSatellite_W > 0.0);
+      params.packetHasBeenProcessed = false;
+      params.cSinr = 0.0;
+      params.ifPower = 0.0;
+      params.phyError = false;
+
+      for (uint32_t j = packet * m_replicas; j < (packet + 1) * m_replicas; ++j)
+        {
+          if (j != i)
+            {
+              params.slotIdsForOtherReplicas.push_back (m_slotIds[j]);
+            }
+        }
+
+      SatPhyRxCarrierPerFrame::AddCrdsaPacketToFrame (frame, params);
+    }
+}
+
+void
+SatCrdsaSicTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-crdsa-sic", "", true);
+
+  std::string dataPath = Singleton<SatEnvVariables>::Get ()->LocateDataDirectory () + "/";
+  Ptr<SatWaveformConf> waveformConf = CreateObject<SatWaveformConf> (dataPath + "dvbRcs2Waveforms.txt");
+  m_waveform = waveformConf->GetWaveform (3);
+
+  Ptr<SatLinkResultsDvbRcs2> linkResults = CreateObject<SatLinkResultsDvbRcs2> ();
+  linkResults->Initialize ();
+
+  SatPhyRxCarrierConf::RxCarrierCreateParams_s createParams = SatPhyRxCarrierConf::RxCarrierCreateParams_s ();
+  createParams.m_rxTemperatureK = 290.0;
+  createParams.m_errorModel = SatPhyRxCarrierConf::EM_AVI;
+  createParams.m_daIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  createParams.m_raIfModel = SatPhyRxCarrierConf::IF_CONSTANT;
+  createParams.m_rxMode = SatPhyRxCarrierConf::TRANSPARENT;
+  createParams.m_chType = SatEnums::RETURN_FEEDER_CH;
+  createParams.m_bwConverter = MakeCallback (&SatCrdsaSicTestCase::GetCarrierBandwidthHz, this);
+  createParams.m_carrierCount = 1;
+  createParams.m_raCollisionModel = m_collisionModel;
+  createParams.m_randomAccessModel = SatEnums::RA_MODEL_CRDSA;
+
+  Ptr<SatPhyRxCarrierConf> carrierConf = CreateObject<SatPhyRxCarrierConf> (createParams);
+  carrierConf->SetLinkResults (linkResults);
+  carrierConf->SetSinrCalculatorCb (MakeCallback (&SatCrdsaSicTestCase::CalculateSinr));
+
+  // both carriers draw the same random values for the error model
+  Ptr<SatPhyRxCarrierPerFrame> incremental = CreateObject<SatPhyRxCarrierPerFrame> (0, carrierConf, true);
+  Ptr<SatPhyRxCarrierPerFrame> fullRescan = CreateObject<SatPhyRxCarrierPerFrame> (0, carrierConf, true);
+  fullRescan->SetAttribute ("FullRescanInterferenceCancellation", BooleanValue (true));
+  incremental->AssignStreams (1000);
+  fullRescan->AssignStreams (1000);
+
+  Ptr<UniformRandomVariable> uniformVariable = CreateObject<UniformRandomVariable> ();
+  uniformVariable->SetStream (1001);
+
+  for (uint32_t i = 0; i < m_packetsPerFrame; ++i)
+    {
+      m_sourceAddresses.push_back (Mac48Address::Allocate ());
+    }
+
+  m_slotIds.resize (m_packetsPerFrame * m_replicas);
+  m_rxPowersW.resize (m_packetsPerFrame);
+
+  SatPhyRxCarrierPerFrame::crdsaFrame_s incrementalFrame;
+  SatPhyRxCarrierPerFrame::crdsaFrame_s fullRescanFrame;
+  uint32_t receivedPackets (0);
+  uint32_t receivedCollidedPackets (0);
+
+  for (uint32_t f = 0; f < 200; ++f)
+    {
+      // Es/No of the packets between 0 and 16 dB
+      for (uint32_t i = 0; i < m_packetsPerFrame; ++i)
+        {
+          m_rxPowersW[i] = m_noisePowerW * SatUtils::DbToLinear (uniformVariable->GetValue (0.0, 16.0));
+
+          for (uint32_t j = 0; j < m_replicas; ++j)
+            {
+              uint32_t index = i * m_replicas + j;
+
+              do
+                {
+                  m_slotIds[index] = uniformVariable->GetInteger (0, m_slotsPerFrame - 1);
+                }
+              while (std::find (m_slotIds.begin () + i * m_replicas, m_slotIds.begin () + index, m_slotIds[index]) != m_slotIds.begin () + index);
+            }
+        }
+
+      CreateFrame (incrementalFrame);
+      CreateFrame (fullRescanFrame);
+
+      incremental->ProcessFrame (incrementalFrame);
+      fullRescan->ProcessFrame (fullRescanFrame);
+
+      NS_TEST_ASSERT_MSG_EQ (incrementalFrame.packetCount, 0, "All packets of the frame were not processed");
+      NS_TEST_ASSERT_MSG_EQ (fullRescanFrame.packetCount, 0, "All packets of the frame were not processed");
+      NS_TEST_ASSERT_MSG_EQ (incrementalFrame.results.size (), m_packetsPerFrame, "Wrong number of processed packets");
+      NS_TEST_ASSERT_MSG_EQ (fullRescanFrame.results.size (), incrementalFrame.results.size (), "Wrong number of processed packets");
+      NS_TEST_ASSERT_MSG_EQ (fullRescanFrame.linkSinrs.size (), incrementalFrame.linkSinrs.size (), "Different number of processed replicas");
+
+      for (uint32_t i = 0; i < incrementalFrame.results.size () && i < fullRescanFrame.results.size (); ++i)
+        {
+          const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& packet = incrementalFrame.results[i];
+          const SatPhyRxCarrierPerFrame::crdsaPacketRxParams_s& reference = fullRescanFrame.results[i];
+
+          NS_TEST_ASSERT_MSG_EQ (packet.sourceAddress, reference.sourceAddress, "Packets processed in different order");
+          NS_TEST_ASSERT_MSG_EQ (packet.rxParams->m_txInfo.crdsaUniquePacketId, reference.rxParams->m_txInfo.crdsaUniquePacketId, "Packets processed in different order");
+          NS_TEST_ASSERT_MSG_EQ (packet.ownSlotId, reference.ownSlotId, "Packets received from different slots");
+          NS_TEST_ASSERT_MSG_EQ (packet.phyError, reference.phyError, "Different reception result");
+          NS_TEST_ASSERT_MSG_EQ (packet.cSinr, reference.cSinr, "Different composite SINR");
+
+          if (!packet.phyError)
+            {
+              ++receivedPackets;
+
+              if (packet.hasCollision)
+                {
+                  ++receivedCollidedPackets;
+                }
+            }
+        }
+
+      SatPhyRxCarrierPerFrame::ClearCrdsaFrame (incrementalFrame);
+      SatPhyRxCarrierPerFrame::ClearCrdsaFrame (fullRescanFrame);
+    }
+
+  NS_TEST_ASSERT_MSG_GT (receivedPackets, 0, "No packets received");
+  NS_TEST_ASSERT_MSG_GT (receivedCollidedPackets, 0, "No collided packets received");
+
+  incremental->Dispose ();
+  fullRescan->Dispose ();
+  carrierConf->Dispose ();
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the CRDSA successive interference cancellation.
+ */
+class SatCrdsaSicTestSuite : public TestSuite
+{
+public:
+  SatCrdsaSicTestSuite ();
+};
+
+SatCrdsaSicTestSuite::SatCrdsaSicTestSuite ()
+  : TestSuite ("sat-crdsa-sic-test", UNIT)
+{
+  AddTestCase (new SatCrdsaSicTestCase (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS, 40), TestCase::QUICK);
+  AddTestCase (new SatCrdsaSicTestCase (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR, 40), TestCase::QUICK);
+  AddTestCase (new SatCrdsaSicTestCase (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR, 80), TestCase::QUICK);
+}
+
+// Allocate an instance of this TestSuite
+static SatCrdsaSicTestSuite satCrdsaSicTestSuite;
@@ -0,0 +1,308 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+/**
+ * \file satellite-fading-cache-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the coherence time cache of the fading containers.
+ */
+
+#include <vector>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/nstime.h"
+#include "ns3/rng-seed-manager.h"
+#include "../model/satellite-base-fading.h"
+#include "../model/satellite-markov-conf.h"
+#include "../model/satellite-markov-container.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Fading container counting the calculated fading values.
+ */
+class SatTestFading : public SatBaseFading
+{
+public:
+  SatTestFading ()
+    : m_calculations (0)
+  {
+  }
+
+  double DoGetFading (Address macAddress, SatEnums::ChannelType_t channelType)
+  {
+    return ++m_calculations;
+  }
+
+  uint32_t m_calculations;
+};
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the coherence time cache of the fading containers.
+ *
+ *   1.  Create a fading container with the cache enabled and a constant
+ *       velocity callback.
+ *   2.  Request fading values of two channel types every millisecond for 100 ms.
+ *
+ *   Expected result:
+ *     A stationary node calculates new values only once per maximum cache
+ *     period and channel type, the values inside a bucket are the same.
+ *     A fast moving node has a coherence time bucket shorter than the
+ *     request interval, thus all the values are calculated.
+ */
+class SatFadingCacheTestCase : public TestCase
+{
+public:
+  SatFadingCacheTestCase (double velocity, uint32_t expectedCalculations);
+  virtual ~SatFadingCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  double GetVelocity ();
+  void RequestFading ();
+
+  Ptr<SatTestFading> m_fading;
+  double m_velocity;
+  uint32_t m_expectedCalculations;
+  double m_previousValue;
+  uint32_t m_changes;
+};
+
+SatFadingCacheTestCase::SatFadingCacheTestCase (double velocity, uint32_t expectedCalculations)
+  : TestCase ("Test coherence time cache of the fading containers."),
+    m_velocity (velocity),
+    m_expectedCalculations (expectedCalculations),
+    m_previousValue (0.0),
+    m_changes (0)
+{
+}
+
+SatFadingCacheTestCase::~SatFadingCacheTestCase ()
+{
+}
+
+double
+SatFadingCacheTestCase::GetVelocity ()
+{
+  return m_velocity;
+}
+
+void
+SatFadingCacheTestCase::RequestFading ()
+{
+  double value = m_fading->GetFading (Mac48Address ("00:00:00:00:00:01"), SatEnums::FORWARD_USER_CH);
+  m_fading->GetFading (Mac48Address ("00:00:00:00:00:01"), SatEnums::RETURN_USER_CH);
+
+  if (value != m_previousValue)
+    {
+      ++m_changes;
+      m_previousValue = value;
+    }
+}
+
+void
+SatFadingCacheTestCase::DoRun (void)
+{
+  m_fading = CreateObject<SatTestFading> ();
+  m_fading->SetAttribute ("EnableCoherenceCache", BooleanValue (true));
+  m_fading->SetAttribute ("MaximumCachePeriod", TimeValue (MilliSeconds (10)));
+  m_fading->SetVelocityCallback (MakeCallback (&SatFadingCacheTestCase::GetVelocity, this));
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MicroSeconds (500 + 1000 * i), &SatFadingCacheTestCase::RequestFading, this);
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_fading->m_calculations, 2 * m_expectedCalculations, "Wrong number of calculated fading values");
+  NS_TEST_ASSERT_MSG_EQ (m_changes, m_expectedCalculations, "Wrong number of fading value changes");
+  NS_TEST_ASSERT_MSG_EQ (m_fading->GetCacheHitCount () + m_fading->GetCacheMissCount (), 200, "Wrong number of cached requests");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_fading->GetCacheHitRate (), 1.0 - m_expectedCalculations / 100.0, 1e-9, "Wrong cache hit rate");
+
+  m_fading->Dispose ();
+  m_fading = NULL;
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the coherence time cache with the Markov
+ * container and the Loo fader.
+ *
+ *   1.  Create a Markov container of a stationary node with a cool down
+ *       period slightly shorter than the maximum cache period, so that the
+ *       uncached container calculates new values at the same requests that
+ *       start a new cache bucket.
+ *   2.  Request fading values of two channel types every millisecond for
+ *       100 ms and collect the values and the fading trace.
+ *   3.  Repeat the run with the same random number streams and the cache
+ *       enabled.
+ *
+ *   Expected result:
+ *     The cached values are equal to the uncached ones, cache hits occur,
+ *     and the fading trace has an equal entry for every request in both runs.
+ */
+class SatMarkovFadingCacheTestCase : public TestCase
+{
+public:
+  SatMarkovFadingCacheTestCase ();
+  virtual ~SatMarkovFadingCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void RunFading (bool enableCache, std::vector<double>& values, std::vector<double>& traces);
+  double GetElevation ();
+  double GetVelocity ();
+  void RequestFading (std::vector<double>* values);
+  void FadingTraceCb (double time, SatEnums::ChannelType_t channelType, double value);
+
+  Ptr<SatMarkovContainer> m_fading;
+  std::vector<double>* m_traces;
+};
+
+SatMarkovFadingCacheTestCase::SatMarkovFadingCacheTestCase ()
+  : TestCase ("Test coherence time cache with the Markov fading container."),
+    m_traces (NULL)
+{
+}
+
+SatMarkovFadingCacheTestCase::~SatMarkovFadingCacheTestCase ()
+{
+}
+
+double
+SatMarkovFadingCacheTestCase::GetElevation ()
+{
+  return 45.0;
+}
+
+double
+SatMarkovFadingCacheTestCase::GetVelocity ()
+{
+  return 0.0;
+}
+
+void
+SatMarkovFadingCacheTestCase::RequestFading (std::vector<double>* values)
+{
+  values->push_back (m_fading->GetFading (Mac48Address ("00:00:00:00:00:01"), SatEnums::FORWARD_USER_CH));
+  values->push_back (m_fading->GetFading (Mac48Address ("00:00:00:00:00:01"), SatEnums::RETURN_USER_CH));
+}
+
+void
+SatMarkovFadingCacheTestCase::FadingTraceCb (double time, SatEnums::ChannelType_t channelType, double value)
+{
+  m_traces->push_back (time);
+  m_traces->push_back (channelType);
+  m_traces->push_back (value);
+}
+
+void
+SatMarkovFadingCacheTestCase::RunFading (bool enableCache, std::vector<double>& values, std::vector<double>& traces)
+{
+  // both runs use the same random number streams
+  RngSeedManager::ResetNextStreamIndex ();
+
+  Ptr<SatMarkovConf> markovConf = CreateObject<SatMarkovConf> ();
+  markovConf->SetAttribute ("CooldownPeriodLength", TimeValue (MicroSeconds (9500)));
+
+  m_fading = CreateObject<SatMarkovContainer> (markovConf,
+                                               MakeCallback (&SatMarkovFadingCacheTestCase::GetElevation, this),
+                                               MakeCallback (&SatMarkovFadingCacheTestCase::GetVelocity, this));
+  m_fading->SetAttribute ("EnableCoherenceCache", BooleanValue (enableCache));
+  m_fading->SetAttribute ("MaximumCachePeriod", TimeValue (MilliSeconds (10)));
+
+  m_traces = &traces;
+  m_fading->TraceConnectWithoutContext ("FadingTrace", MakeCallback (&SatMarkovFadingCacheTestCase::FadingTraceCb, this));
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MicroSeconds (500 + 1000 * i), &SatMarkovFadingCacheTestCase::RequestFading, this, &values);
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  if (enableCache)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_fading->GetCacheHitCount (), 180, "Wrong number of cache hits");
+    }
+
+  m_fading->Dispose ();
+  m_fading = NULL;
+  m_traces = NULL;
+}
+
+void
+SatMarkovFadingCacheTestCase::DoRun (void)
+{
+  std::vector<double> uncachedValues;
+  std::vector<double> uncachedTraces;
+  std::vector<double> cachedValues;
+  std::vector<double> cachedTraces;
+
+  RunFading (false, uncachedValues, uncachedTraces);
+  RunFading (true, cachedValues, cachedTraces);
+
+  NS_TEST_ASSERT_MSG_EQ (uncachedValues.size (), 200, "Wrong number of uncached values");
+  NS_TEST_ASSERT_MSG_EQ (cachedValues.size (), uncachedValues.size (), "Wrong number of cached values");
+  NS_TEST_ASSERT_MSG_EQ (uncachedTraces.size (), 3 * uncachedValues.size (), "Wrong number of uncached traces");
+  NS_TEST_ASSERT_MSG_EQ (cachedTraces.size (), uncachedTraces.size (), "Wrong number of cached traces");
+
+  for (uint32_t i = 0; i < cachedValues.size () && i < uncachedValues.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (cachedValues[i], uncachedValues[i], "Cached fading value differs from uncached one");
+    }
+
+  for (uint32_t i = 0; i < cachedTraces.size () && i < uncachedTraces.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (cachedTraces[i], uncachedTraces[i], "Cached fading trace differs from uncached one");
+    }
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the coherence time cache of the fading containers.
+ */
+class SatFadingCacheTestSuite : public TestSuite
+{
+public:
+  SatFadingCacheTestSuite ();
+};
+
+SatFadingCacheTestSuite::SatFadingCacheTestSuite ()
+  : TestSuite ("sat-fading-cache-test", UNIT)
+{
+  // stationary node uses the 10 ms maximum cache period
+  AddTestCase (new SatFadingCacheTestCase (0.0, 10), TestCase::QUICK);
+  // 300 m/s at 30 GHz gives a coherence time of about 14 us
+  AddTestCase (new SatFadingCacheTestCase (300.0, 100), TestCase::QUICK);
+  // Markov container with the Loo fader
+  AddTestCase (new SatMarkovFadingCacheTestCase, TestCase::QUICK);
+}
+
+// Allocate an instance of this TestSuite
+static SatFadingCacheTestSuite satFadingCacheTestSuite;
@@ -24,12 +24,17 @@
  * \brief Test cases to unit test external fading traces
  */
 
+#include <cmath>
+#include <fstream>
+#include <sstream>
 #include <vector>
 #include "ns3/log.h"
 #include "ns3/test.h"
 #include "ns3/timer.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
 #include "../model/satellite-fading-external-input-trace-container.h"
+#include "../model/satellite-utils.h"
 #include "../model/satellite-channel.h"
 #include "ns3/singleton.h"
 #include "../utils/satellite-env-variables.h"
@@ -108,6 +113,387 @@ SatFadingExternalInputTraceTestCase::DoRun (void)
   Singleton<SatEnvVariables>::Get ()->DoDispose ();
 }
 
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test getting the external fading values of many
+ * nodes at the same time.
+ *
+ *  1.  Load the external fading traces of the UTs and the GWs.
+ *  2.  At several times get the fading values of a set of UTs, including
+ *      repeated nodes, and of all the GWs with one call.
+ *  3.  Get the fading of each node from its own trace.
+ *
+ *  Expected result:
+ *    The fading values of the batch call are equal to the fading values of
+ *    the traces of the nodes.
+ */
+class SatFadingExternalInputTraceBatchTestCase : public TestCase
+{
+public:
+  SatFadingExternalInputTraceBatchTestCase ();
+  virtual ~SatFadingExternalInputTraceBatchTestCase ();
+
+  void TestGetFadingValues (SatEnums::ChannelType_t channelType, std::vector<uint32_t> nodeIds);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_checkedValues;
+};
+
+SatFadingExternalInputTraceBatchTestCase::SatFadingExternalInputTraceBatchTestCase ()
+  : TestCase ("Test getting satellite fading external input trace values of many nodes."),
+    m_checkedValues (0)
+{
+}
+
+SatFadingExternalInputTraceBatchTestCase::~SatFadingExternalInputTraceBatchTestCase ()
+{
+}
+
+void
+SatFadingExternalInputTraceBatchTestCase::TestGetFadingValues (SatEnums::ChannelType_t channelType, std::vector<uint32_t> nodeIds)
+{
+  SatFadingExternalInputTraceContainer* container = Singleton<SatFadingExternalInputTraceContainer>::Get ();
+  std::vector<Ptr<MobilityModel> > mobilities;
+  std::vector<double> fadingValues;
+
+  container->GetFadingValues (channelType, nodeIds, mobilities, fadingValues);
+
+  NS_TEST_ASSERT_MSG_EQ (fadingValues.size (), nodeIds.size (), "Wrong number of fading values");
+
+  for (uint32_t i = 0; i < nodeIds.size () && i < fadingValues.size (); ++i)
+    {
+      Ptr<MobilityModel> mobility;
+      double fading = container->GetFadingTrace (nodeIds[i], channelType, mobility)->GetFading ();
+
+      NS_TEST_ASSERT_MSG_EQ (fadingValues[i], fading, "Fading of node " << nodeIds[i] << " differs from its trace");
+      m_checkedValues++;
+    }
+}
+
+void
+SatFadingExternalInputTraceBatchTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-fading-external-input-trace", "batch", true);
+
+  bool success = Singleton<SatFadingExternalInputTraceContainer>::Get ()->TestFadingTraces (2, 5);
+  NS_TEST_ASSERT_MSG_EQ (success, true, "SatChannelFadingTrace test failed");
+
+  std::vector<uint32_t> utIds;
+  utIds.push_back (1);
+  utIds.push_back (2);
+  utIds.push_back (1);
+  utIds.push_back (2);
+
+  std::vector<uint32_t> gwIds;
+
+  for (uint32_t i = 1; i <= 5; ++i)
+    {
+      gwIds.push_back (i);
+    }
+
+  double time [3] = {1.434, 40.923, 80.503};
+
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      Simulator::Schedule (Seconds (time[i]), &SatFadingExternalInputTraceBatchTestCase::TestGetFadingValues, this, SatEnums::RETURN_USER_CH, utIds);
+      Simulator::Schedule (Seconds (time[i]), &SatFadingExternalInputTraceBatchTestCase::TestGetFadingValues, this, SatEnums::FORWARD_USER_CH, utIds);
+      Simulator::Schedule (Seconds (time[i]), &SatFadingExternalInputTraceBatchTestCase::TestGetFadingValues, this, SatEnums::FORWARD_FEEDER_CH, gwIds);
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_checkedValues, 3 * (2 * utIds.size () + gwIds.size ()), "All the fading values were not checked");
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * Write a binary fading trace file with a 10 ms sample interval starting
+ * at one second, fading between -6 and 2 dB and an incomplete last row.
+ * \param fileName Path and file name of the trace file
+ * \param columns Number of columns of the trace file
+ */
+static void
+WriteTestTraceFile (std::string fileName, uint32_t columns)
+{
+  std::ofstream ofs (fileName.c_str (), std::ios::out | std::ios::binary);
+
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      float row[3] = {1.0f + 0.01f * i, (float)(4.0 * std::sin (0.05 * i) - 2.0), (float)(0.5 * std::cos (0.3 * i))};
+      ofs.write ((const char*) row, columns * sizeof (float));
+    }
+
+  float incomplete = 20.0f;
+  ofs.write ((const char*) &incomplete, sizeof (float));
+  ofs.close ();
+}
+
+/**
+ * Read the rows of a trace file one float at a time as the earlier
+ * ifstream based loader did.
+ * \param fileName Path and file name of the trace file
+ * \param columns Number of columns of the trace file
+ * \param rows Read rows
+ */
+static void
+ReadReferenceRows (std::string fileName, uint32_t columns, std::vector<std::vector<float> >& rows)
+{
+  std::ifstream ifs (fileName.c_str (), std::ios::in | std::ios::binary);
+  std::vector<float> values;
+  float temp;
+
+  while (ifs.read ((char*) &temp, sizeof (float)))
+    {
+      values.push_back (temp);
+
+      if (values.size () == columns)
+        {
+          rows.push_back (values);
+          values.clear ();
+        }
+    }
+}
+
+/**
+ * Calculate the fading from the reference rows with the index calculation
+ * and the interpolation of the earlier loader, without any cursor.
+ * \param rows Reference rows
+ * \param simTime Time in seconds
+ * \return fading value in linear format
+ */
+static double
+GetReferenceFading (const std::vector<std::vector<float> >& rows, float simTime)
+{
+  float startTime = rows[0][0];
+  float timeInterval = rows[1][0] - startTime;
+  uint32_t lowerIndex = (uint32_t)(std::floor (std::abs (simTime - startTime) / timeInterval));
+
+  float lowerKey = rows[lowerIndex][0];
+  float upperKey = rows[lowerIndex + 1][0];
+  float lowerVal = SatUtils::DbToLinear (rows[lowerIndex][1]);
+  float upperVal = SatUtils::DbToLinear (rows[lowerIndex + 1][1]);
+
+  return lowerVal + (upperVal - lowerVal) * (simTime - lowerKey) / (upperKey - lowerKey);
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the memory mapped loading of the external
+ * fading traces and sharing them by file name.
+ *
+ *  1.  Write a binary trace file of the given type with known samples.
+ *  2.  Get the trace of the file twice from the trace container.
+ *  3.  Read the file as the earlier ifstream based loader did and calculate
+ *      the interpolated fading at the request times from it.
+ *  4.  Request the fading of both the traces at times between the samples.
+ *
+ *  Expected result:
+ *    Both the requests of the file get the same memory mapped trace and the
+ *    fading values equal to the ones calculated from the ifstream loaded
+ *    samples, with and without the conversion of the samples at load time.
+ */
+class SatFadingExternalInputTraceMappingTestCase : public TestCase
+{
+public:
+  SatFadingExternalInputTraceMappingTestCase (SatFadingExternalInputTrace::TraceFileType_e fileType, bool linearSamples);
+  virtual ~SatFadingExternalInputTraceMappingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void TestGetFading ();
+
+  SatFadingExternalInputTrace::TraceFileType_e m_fileType;
+  bool m_linearSamples;
+  Ptr<SatFadingExternalInputTrace> m_trace;
+  Ptr<SatFadingExternalInputTrace> m_sharedTrace;
+  std::vector<std::vector<float> > m_referenceRows;
+  uint32_t m_requests;
+};
+
+SatFadingExternalInputTraceMappingTestCase::SatFadingExternalInputTraceMappingTestCase (SatFadingExternalInputTrace::TraceFileType_e fileType, bool linearSamples)
+  : TestCase ("Test memory mapped and shared satellite fading external input traces."),
+    m_fileType (fileType),
+    m_linearSamples (linearSamples),
+    m_requests (0)
+{
+}
+
+SatFadingExternalInputTraceMappingTestCase::~SatFadingExternalInputTraceMappingTestCase ()
+{
+}
+
+void
+SatFadingExternalInputTraceMappingTestCase::TestGetFading ()
+{
+  double expected = GetReferenceFading (m_referenceRows, Simulator::Now ().GetSeconds ());
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_trace->GetFading (), expected, 1e-6 * expected, "Fading differs from the ifstream loaded trace");
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_sharedTrace->GetFading (), expected, 1e-6 * expected, "Fading of the shared trace differs");
+
+  ++m_requests;
+}
+
+void
+SatFadingExternalInputTraceMappingTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-fading-external-input-trace", "mapping", true);
+
+  uint32_t columns = (m_fileType == SatFadingExternalInputTrace::FT_TWO_COLUMN) ? 2 : 3;
+  std::stringstream fileName;
+  fileName << Singleton<SatEnvVariables>::Get ()->GetOutputPath () << "/test-fading-trace-" << columns << "-" << m_linearSamples << ".dat";
+
+  WriteTestTraceFile (fileName.str (), columns);
+  ReadReferenceRows (fileName.str (), columns, m_referenceRows);
+
+  SatFadingExternalInputTraceContainer* container = Singleton<SatFadingExternalInputTraceContainer>::Get ();
+  container->SetAttribute ("LinearSamples", BooleanValue (m_linearSamples));
+
+  m_trace = container->GetLoadedTrace (m_fileType, fileName.str ());
+  m_sharedTrace = container->GetLoadedTrace (m_fileType, fileName.str ());
+
+  container->SetAttribute ("LinearSamples", BooleanValue (false));
+
+  NS_TEST_ASSERT_MSG_EQ ((m_trace == m_sharedTrace), true, "Users of the same file do not share the trace");
+  NS_TEST_ASSERT_MSG_EQ (m_trace->IsMapped (), true, "Trace file is not memory mapped");
+  NS_TEST_ASSERT_MSG_EQ (m_trace->TestFadingTrace (), true, "Trace file is not valid");
+  NS_TEST_ASSERT_MSG_EQ (m_referenceRows.size (), 1000, "Wrong number of reference rows");
+
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      Simulator::Schedule (MicroSeconds (1003700 + 19300 * i), &SatFadingExternalInputTraceMappingTestCase::TestGetFading, this);
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_requests, 500, "Wrong number of fading requests");
+
+  m_trace = NULL;
+  m_sharedTrace = NULL;
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the time cursor and the latest value of
+ * the external fading trace.
+ *
+ *  1.  Write a binary trace file with known samples starting at one second
+ *      and load it with or without the conversion of the samples at load time.
+ *  2.  Request the fading in several simulation runs. Within a run the
+ *      requests advance monotonically: the same time twice, times within
+ *      the same and the next sample interval, exact sample times, jumps
+ *      over many samples and the last sample interval. The following runs
+ *      start before the time where the previous run ended, which seeks the
+ *      cursor backwards, and the last run requests times before the first
+ *      sample.
+ *
+ *  Expected result:
+ *    Every fading value equals to the one calculated from the ifstream
+ *    loaded samples with the index calculation of the earlier loader.
+ */
+class SatFadingExternalInputTraceCursorTestCase : public TestCase
+{
+public:
+  SatFadingExternalInputTraceCursorTestCase (bool linearSamples);
+  virtual ~SatFadingExternalInputTraceCursorTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void TestGetFading ();
+
+  bool m_linearSamples;
+  Ptr<SatFadingExternalInputTrace> m_trace;
+  std::vector<std::vector<float> > m_referenceRows;
+  uint32_t m_requests;
+};
+
+SatFadingExternalInputTraceCursorTestCase::SatFadingExternalInputTraceCursorTestCase (bool linearSamples)
+  : TestCase ("Test time cursor of satellite fading external input trace."),
+    m_linearSamples (linearSamples),
+    m_requests (0)
+{
+}
+
+SatFadingExternalInputTraceCursorTestCase::~SatFadingExternalInputTraceCursorTestCase ()
+{
+}
+
+void
+SatFadingExternalInputTraceCursorTestCase::TestGetFading ()
+{
+  double expected = GetReferenceFading (m_referenceRows, Simulator::Now ().GetSeconds ());
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_trace->GetFading (), expected, 1e-6 * std::abs (expected), "Fading differs from the reference at " << Simulator::Now ().GetSeconds ());
+
+  ++m_requests;
+}
+
+void
+SatFadingExternalInputTraceCursorTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-fading-external-input-trace", "cursor", true);
+
+  std::stringstream fileName;
+  fileName << Singleton<SatEnvVariables>::Get ()->GetOutputPath () << "/test-fading-trace-cursor-" << m_linearSamples << ".dat";
+
+  WriteTestTraceFile (fileName.str (), 2);
+  ReadReferenceRows (fileName.str (), 2, m_referenceRows);
+
+  m_trace = Create<SatFadingExternalInputTrace> (SatFadingExternalInputTrace::FT_TWO_COLUMN, fileName.str (), m_linearSamples);
+
+  // request times in microseconds of each simulation run
+  std::vector<std::vector<uint64_t> > runs;
+
+  // monotonic requests
+  uint64_t monotonic[] = {1000000, 1000000, 1004000, 1009999, 1010000, 1015000, 1027300, 1500000,
+                          1500100, 3333300, 7770000, 7780000, 10985000, 10989900};
+  runs.push_back (std::vector<uint64_t> (monotonic, monotonic + sizeof (monotonic) / sizeof (uint64_t)));
+
+  // backward seeks from the end of the trace and back and forth
+  uint64_t backward[] = {2000000, 2004900, 2020000};
+  runs.push_back (std::vector<uint64_t> (backward, backward + sizeof (backward) / sizeof (uint64_t)));
+
+  uint64_t backwardToStart[] = {1001000, 5500000};
+  runs.push_back (std::vector<uint64_t> (backwardToStart, backwardToStart + sizeof (backwardToStart) / sizeof (uint64_t)));
+
+  // times before the first sample
+  uint64_t beforeStart[] = {0, 250000, 999000, 1000000, 1003000};
+  runs.push_back (std::vector<uint64_t> (beforeStart, beforeStart + sizeof (beforeStart) / sizeof (uint64_t)));
+
+  uint32_t requests = 0;
+
+  for (uint32_t run = 0; run < runs.size (); run++)
+    {
+      for (uint32_t i = 0; i < runs[run].size (); i++)
+        {
+          Simulator::Schedule (MicroSeconds (runs[run][i]), &SatFadingExternalInputTraceCursorTestCase::TestGetFading, this);
+        }
+
+      requests += runs[run].size ();
+
+      Simulator::Run ();
+      Simulator::Destroy ();
+
+      NS_TEST_ASSERT_MSG_EQ (m_requests, requests, "Wrong number of fading requests");
+    }
+
+  m_trace = NULL;
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
 /**
  * \ingroup satellite
  * \brief Test suite for satellite fading external input trace
@@ -122,6 +508,11 @@ SatFadingExternalInputTraceTestSuite::SatFadingExternalInputTraceTestSuite ()
   : TestSuite ("sat-fading-external-input-trace-test", UNIT)
 {
   AddTestCase (new SatFadingExternalInputTraceTestCase, TestCase::QUICK);
+  AddTestCase (new SatFadingExternalInputTraceBatchTestCase, TestCase::QUICK);
+  AddTestCase (new SatFadingExternalInputTraceMappingTestCase (SatFadingExternalInputTrace::FT_TWO_COLUMN, false), TestCase::QUICK);
+  AddTestCase (new SatFadingExternalInputTraceMappingTestCase (SatFadingExternalInputTrace::FT_THREE_COLUMN, true), TestCase::QUICK);
+  AddTestCase (new SatFadingExternalInputTraceCursorTestCase (false), TestCase::QUICK);
+  AddTestCase (new SatFadingExternalInputTraceCursorTestCase (true), TestCase::QUICK);
 }
 
 // Do allocate an instance of this TestSuite
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+/**
+ * \file satellite-fading-oscillator-bank-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the satellite fading oscillator bank.
+ */
+
+#include <cmath>
+#include <vector>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "../model/satellite-fading-oscillator.h"
+#include "../model/satellite-fading-oscillator-bank.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the satellite fading oscillator bank.
+ *
+ *   1.  Create oscillators with random complex and real amplitudes, initial
+ *       phases and rotation speeds both as SatFadingOscillator objects and
+ *       into SatFadingOscillatorBank.
+ *   2.  Calculate the complex sums and the cosine wave sums at different times.
+ *
+ *   Expected result:
+ *     The sums of the bank are equal to the sums of the individual oscillators.
+ */
+class SatFadingOscillatorBankTestCase : public TestCase
+{
+public:
+  SatFadingOscillatorBankTestCase ();
+  virtual ~SatFadingOscillatorBankTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatFadingOscillatorBankTestCase::SatFadingOscillatorBankTestCase ()
+  : TestCase ("Test satellite fading oscillator bank.")
+{
+}
+
+SatFadingOscillatorBankTestCase::~SatFadingOscillatorBankTestCase ()
+{
+}
+
+void
+SatFadingOscillatorBankTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetAttribute ("Min", DoubleValue (-1.0 * M_PI));
+  uniform->SetAttribute ("Max", DoubleValue (M_PI));
+
+  std::vector< Ptr<SatFadingOscillator> > complexOscillators;
+  std::vector< Ptr<SatFadingOscillator> > realOscillators;
+  SatFadingOscillatorBank complexBank;
+  SatFadingOscillatorBank realBank;
+
+  for (uint32_t i = 0; i < 33; i++)
+    {
+      double phi = uniform->GetValue ();
+      double omega = 2.0 * M_PI * 10.0 * std::cos (uniform->GetValue ());
+      double psi = uniform->GetValue ();
+      std::complex<double> complexAmplitude = std::complex<double> (std::cos (psi), std::sin (psi)) * 2.0 / std::sqrt (33.0);
+      double amplitude = std::fabs (psi) / 33.0;
+
+      complexOscillators.push_back (CreateObject<SatFadingOscillator> (complexAmplitude, phi, omega));
+      realOscillators.push_back (CreateObject<SatFadingOscillator> (amplitude, phi, omega));
+      complexBank.AddOscillator (complexAmplitude, phi, omega);
+      realBank.AddOscillator (amplitude, phi, omega);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (complexBank.GetN (), 33, "Wrong number of oscillators");
+
+  for (double t = 0.0; t < 10.0; t += 0.01)
+    {
+      std::complex<double> complexSum (0, 0);
+      std::complex<double> cosineWaveSum (0, 0);
+
+      for (uint32_t i = 0; i < complexOscillators.size (); i++)
+        {
+          complexSum += complexOscillators[i]->GetComplexValueAt (t);
+          cosineWaveSum += realOscillators[i]->GetCosineWaveValueAt (t);
+        }
+
+      std::complex<double> bankComplexSum = complexBank.GetComplexSum (t);
+      std::complex<double> bankCosineWaveSum = realBank.GetCosineWaveSum (t);
+
+      NS_TEST_ASSERT_MSG_EQ_TOL (bankComplexSum.real (), complexSum.real (), 1e-12, "Complex sum differs");
+      NS_TEST_ASSERT_MSG_EQ_TOL (bankComplexSum.imag (), complexSum.imag (), 1e-12, "Complex sum differs");
+      NS_TEST_ASSERT_MSG_EQ_TOL (bankCosineWaveSum.real (), cosineWaveSum.real (), 1e-12, "Cosine wave sum differs");
+      NS_TEST_ASSERT_MSG_EQ_TOL (bankCosineWaveSum.imag (), cosineWaveSum.imag (), 1e-12, "Cosine wave sum differs");
+    }
+
+  complexBank.Clear ();
+
+  NS_TEST_ASSERT_MSG_EQ (complexBank.GetN (), 0, "Bank not cleared");
+  NS_TEST_ASSERT_MSG_EQ (complexBank.GetComplexSum (1.0), std::complex<double> (0, 0), "Empty bank sum not zero");
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the satellite fading oscillator bank.
+ */
+class SatFadingOscillatorBankTestSuite : public TestSuite
+{
+public:
+  SatFadingOscillatorBankTestSuite ();
+};
+
+SatFadingOscillatorBankTestSuite::SatFadingOscillatorBankTestSuite ()
+  : TestSuite ("sat-fading-oscillator-bank-test", UNIT)
+{
+  AddTestCase (new SatFadingOscillatorBankTestCase, TestCase::QUICK);
+}
+
+// Allocate an instance of this TestSuite
+static SatFadingOscillatorBankTestSuite satFadingOscillatorBankTestSuite;
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+/**
+ * \file satellite-fading-trace-replay-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the offline generated Markov fading traces and their replay.
+ */
+
+#include <fstream>
+#include <vector>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/singleton.h"
+#include "../model/satellite-utils.h"
+#include "../model/satellite-fading-trace-replay.h"
+#include "../helper/satellite-fading-trace-generator-helper.h"
+#include "../utils/satellite-env-variables.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the offline generated Markov fading traces and their replay.
+ *
+ *   1.  Generate one second of fading of two terminals.
+ *   2.  Read the generated trace files and the index file.
+ *   3.  Replay the traces with SatFadingTraceReplay at the sample times.
+ *
+ *   Expected result:
+ *     The files contain the expected number of samples and the replayed
+ *     fading values equal to the generated ones in linear units.
+ */
+class SatFadingTraceReplayTestCase : public TestCase
+{
+public:
+  SatFadingTraceReplayTestCase ();
+  virtual ~SatFadingTraceReplayTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void ReadSamples (std::string fileName, std::vector<float>& samples);
+  void Replay (uint32_t sample);
+
+  Ptr<SatFadingTraceReplay> m_replay;
+  std::vector<float> m_upSamples;
+  std::vector<float> m_downSamples;
+};
+
+SatFadingTraceReplayTestCase::SatFadingTraceReplayTestCase ()
+  : TestCase ("Test offline generated Markov fading traces and their replay.")
+{
+}
+
+SatFadingTraceReplayTestCase::~SatFadingTraceReplayTestCase ()
+{
+}
+
+void
+SatFadingTraceReplayTestCase::ReadSamples (std::string fileName, std::vector<float>& samples)
+{
+  std::ifstream ifs (fileName.c_str (), std::ios::in | std::ios::binary);
+  float value;
+
+  while (ifs.read ((char*) &value, sizeof (float)))
+    {
+      samples.push_back (value);
+    }
+}
+
+void
+SatFadingTraceReplayTestCase::Replay (uint32_t sample)
+{
+  double up = m_replay->GetFading (Address (), SatEnums::RETURN_USER_CH);
+  double down = m_replay->GetFading (Address (), SatEnums::FORWARD_USER_CH);
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (up, SatUtils::DbToLinear<double> (m_upSamples[2 * sample + 1]), 1e-4, "Replayed uplink fading differs");
+  NS_TEST_ASSERT_MSG_EQ_TOL (down, SatUtils::DbToLinear<double> (m_downSamples[2 * sample + 1]), 1e-4, "Replayed downlink fading differs");
+}
+
+void
+SatFadingTraceReplayTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-fading-trace-replay", "", true);
+
+  std::string folder = Singleton<SatEnvVariables>::Get ()->GetOutputPath () + "/markov-fadingtraces";
+
+  Ptr<SatFadingTraceGeneratorHelper> generator = CreateObject<SatFadingTraceGeneratorHelper> ();
+  generator->SetAttribute ("Duration", TimeValue (Seconds (1)));
+  generator->SetAttribute ("SampleInterval", TimeValue (MilliSeconds (10)));
+
+  NS_TEST_ASSERT_MSG_EQ (generator->AddTerminal (30.0, 0.0), 1, "Wrong terminal id");
+  NS_TEST_ASSERT_MSG_EQ (generator->AddTerminal (60.0, 10.0), 2, "Wrong terminal id");
+
+  generator->Generate (folder);
+  generator->Dispose ();
+
+  // index file lists both the terminals
+  std::ifstream index ((folder + "/" + SatFadingTraceGeneratorHelper::GetIndexFileName ()).c_str ());
+  uint32_t id;
+  std::string upFile, downFile;
+  double elevation, velocity;
+  uint32_t terminals (0);
+
+  while (index >> id >> upFile >> downFile >> elevation >> velocity)
+    {
+      ++terminals;
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (terminals, 2, "Wrong number of terminals in the index file");
+
+  ReadSamples (folder + "/" + upFile, m_upSamples);
+  ReadSamples (folder + "/" + downFile, m_downSamples);
+
+  // 101 samples and one extra sample for the interpolation, two columns each
+  NS_TEST_ASSERT_MSG_EQ (m_upSamples.size (), 204, "Wrong number of uplink samples");
+  NS_TEST_ASSERT_MSG_EQ (m_downSamples.size (), 204, "Wrong number of downlink samples");
+
+  Ptr<SatFadingExternalInputTrace> upTrace = Create<SatFadingExternalInputTrace> (SatFadingExternalInputTrace::FT_TWO_COLUMN, folder + "/" + upFile);
+  Ptr<SatFadingExternalInputTrace> downTrace = Create<SatFadingExternalInputTrace> (SatFadingExternalInputTrace::FT_TWO_COLUMN, folder + "/" + downFile);
+  m_replay = CreateObject<SatFadingTraceReplay> (upTrace, downTrace, false);
+
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MilliSeconds (10 * i), &SatFadingTraceReplayTestCase::Replay, this, i);
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  m_replay->Dispose ();
+  m_replay = NULL;
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the offline generated Markov fading traces.
+ */
+class SatFadingTraceReplayTestSuite : public TestSuite
+{
+public:
+  SatFadingTraceReplayTestSuite ();
+};
+
+SatFadingTraceReplayTestSuite::SatFadingTraceReplayTestSuite ()
+  : TestSuite ("sat-fading-trace-replay-test", UNIT)
+{
+  AddTestCase (new SatFadingTraceReplayTestCase, TestCase::QUICK);
+}
+
+// Allocate an instance of this TestSuite
+static SatFadingTraceReplayTestSuite satFadingTraceReplayTestSuite;
@@ -0,0 +1,297 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+/**
+ * \file satellite-input-fstream-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the time sample lookup of the input file stream time double container.
+ */
+
+#include <cmath>
+#include <fstream>
+#include <vector>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/singleton.h"
+#include "../utils/satellite-env-variables.h"
+#include "../utils/satellite-input-fstream-time-double-container.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Linear scan lookup of the closest time sample, as done by the
+ * input file stream time double container before the cursor search.
+ * Used as the reference of the cursor search.
+ */
+class SatLinearScanTimeSampleReference
+{
+public:
+  /**
+   * \brief Constructor
+   * \param times time samples
+   */
+  SatLinearScanTimeSampleReference (const std::vector<double>& times)
+    : m_times (times),
+      m_lastValidPosition (0),
+      m_numOfPasses (0),
+      m_timeShiftValue (0.0)
+  {
+  }
+
+  /**
+   * \brief Locate the next closest time sample
+   * \param comparisonTimeValue time to locate
+   * \return row of the located time sample
+   */
+  uint32_t Locate (double comparisonTimeValue)
+  {
+    while (!FindNextClosest (m_lastValidPosition, m_timeShiftValue, comparisonTimeValue))
+      {
+        m_lastValidPosition = 0;
+        m_numOfPasses++;
+        m_timeShiftValue = m_numOfPasses * m_times.back ();
+      }
+    return m_lastValidPosition;
+  }
+
+private:
+  bool FindNextClosest (uint32_t lastValidPosition, double timeShiftValue, double comparisonTimeValue)
+  {
+    bool valueFound = false;
+
+    for (uint32_t i = lastValidPosition; i < m_times.size (); i++)
+      {
+        if (m_times[i] + timeShiftValue >= comparisonTimeValue)
+          {
+            double difference1 = std::abs (m_times[lastValidPosition] + timeShiftValue - comparisonTimeValue);
+            double difference2 = std::abs (m_times[i] + timeShiftValue - comparisonTimeValue);
+
+            if (difference1 < difference2)
+              {
+                m_lastValidPosition = lastValidPosition;
+              }
+            else
+              {
+                m_lastValidPosition = i;
+              }
+            valueFound = true;
+            break;
+          }
+        lastValidPosition = i;
+      }
+
+    if (valueFound && m_numOfPasses > 0 && m_lastValidPosition == 0)
+      {
+        double difference1 = std::abs (m_times[m_lastValidPosition] + timeShiftValue - comparisonTimeValue);
+        double difference2 = std::abs (m_times.back () + ((m_numOfPasses - 1) * m_times.back ()) - comparisonTimeValue);
+
+        if (difference1 > difference2)
+          {
+            m_lastValidPosition = m_times.size () - 1;
+            m_numOfPasses--;
+            m_timeShiftValue = m_numOfPasses * m_times.back ();
+          }
+      }
+
+    return valueFound;
+  }
+
+  std::vector<double> m_times;
+  uint32_t m_lastValidPosition;
+  uint32_t m_numOfPasses;
+  double m_timeShiftValue;
+};
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the cursor search of the closest time
+ * sample of the input file stream time double container against the
+ * linear scan.
+ *
+ *   1.  Write a trace file with irregularly spaced time samples and the
+ *       row index as the value.
+ *   2.  Run the simulation several times with the same container. Look up
+ *       the samples at exact time samples, at midpoints between samples,
+ *       before the first sample, after the last sample (looping the
+ *       samples) and densely over several passes. As the simulation time
+ *       restarts from zero in each run, the later runs query times before
+ *       the current position of the container.
+ *
+ *   Expected result:
+ *     Each lookup returns the same row as the linear scan. The exact time
+ *     samples return their own rows, the times before the first sample
+ *     return the first row and the times just after the last sample return
+ *     the last row.
+ */
+class SatInputFileStreamTimeDoubleContainerTestCase : public TestCase
+{
+public:
+  SatInputFileStreamTimeDoubleContainerTestCase ();
+  virtual ~SatInputFileStreamTimeDoubleContainerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void TestLookup (int32_t expectedRow);
+
+  Ptr<SatInputFileStreamTimeDoubleContainer> m_container;
+  SatLinearScanTimeSampleReference* m_reference;
+  uint32_t m_lookups;
+};
+
+SatInputFileStreamTimeDoubleContainerTestCase::SatInputFileStreamTimeDoubleContainerTestCase ()
+  : TestCase ("Test the closest time sample lookup of input file stream time double container."),
+    m_reference (NULL),
+    m_lookups (0)
+{
+}
+
+SatInputFileStreamTimeDoubleContainerTestCase::~SatInputFileStreamTimeDoubleContainerTestCase ()
+{
+}
+
+void
+SatInputFileStreamTimeDoubleContainerTestCase::TestLookup (int32_t expectedRow)
+{
+  double now = Simulator::Now ().GetSeconds ();
+  uint32_t row = static_cast<uint32_t> (m_container->ProceedToNextClosestTimeSampleValue (1));
+  uint32_t referenceRow = m_reference->Locate (now);
+
+  NS_TEST_ASSERT_MSG_EQ (row, referenceRow, "Row differs from the linear scan at " << now);
+
+  if (expectedRow >= 0)
+    {
+      NS_TEST_ASSERT_MSG_EQ (row, static_cast<uint32_t> (expectedRow), "Wrong row at " << now);
+    }
+
+  m_lookups++;
+}
+
+void
+SatInputFileStreamTimeDoubleContainerTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-input-fstream", "", true);
+
+  std::string fileName = Singleton<SatEnvVariables>::Get ()->GetOutputPath () + "/test-sat-input-fstream.txt";
+  std::ofstream file (fileName.c_str ());
+  std::vector<double> times;
+
+  // Irregularly spaced time samples, the time is rounded to nanoseconds as the simulation time
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      double time = (100000000.0 + 10000000.0 * i + 4000000.0 * (i % 3)) / 1e9;
+      times.push_back (time);
+      file << time << "\t" << i << "\n";
+    }
+  file.close ();
+
+  m_container = CreateObject<SatInputFileStreamTimeDoubleContainer> (fileName, std::ios::in, 2);
+  m_reference = new SatLinearScanTimeSampleReference (times);
+
+  double lastTime = times.back ();
+  std::vector<std::pair<double, int32_t> > lookups;
+
+  // Run 1: before the first sample, exact samples, midpoints and after the last sample
+  lookups.push_back (std::make_pair (0.0, 0));
+  lookups.push_back (std::make_pair (0.05, 0));
+  lookups.push_back (std::make_pair (times[0], 0));
+  lookups.push_back (std::make_pair (times[1], 1));
+  lookups.push_back (std::make_pair ((times[1] + times[2]) / 2, -1));
+  lookups.push_back (std::make_pair (times[2] - 0.0005, 2));
+  lookups.push_back (std::make_pair (times[3] - 0.0005, 3));
+  lookups.push_back (std::make_pair (times[100], 100));
+  lookups.push_back (std::make_pair ((times[500] + times[501]) / 2, -1));
+  lookups.push_back (std::make_pair (times[501], 501));
+  lookups.push_back (std::make_pair (times[998], 998));
+  lookups.push_back (std::make_pair (lastTime, 999));
+  lookups.push_back (std::make_pair (lastTime + 0.003, 999));
+  lookups.push_back (std::make_pair (lastTime + (times[0] + times[1]) / 2, -1));
+  lookups.push_back (std::make_pair (lastTime + times[10], 10));
+  lookups.push_back (std::make_pair (2.5 * lastTime, -1));
+  lookups.push_back (std::make_pair (7 * lastTime + times[300], 300));
+  lookups.push_back (std::make_pair (40 * lastTime - 0.001, 999));
+
+  std::vector<std::vector<std::pair<double, int32_t> > > runs;
+  runs.push_back (lookups);
+
+  // Run 2: times before the current position of the container
+  lookups.clear ();
+  lookups.push_back (std::make_pair (0.05, -1));
+  lookups.push_back (std::make_pair (times[200], -1));
+  lookups.push_back (std::make_pair (39 * lastTime + times[5], -1));
+  lookups.push_back (std::make_pair (41 * lastTime + times[700], 700));
+  lookups.push_back (std::make_pair (1000 * lastTime + times[1], 1));
+  runs.push_back (lookups);
+
+  // Run 3: dense lookups over several passes
+  lookups.clear ();
+
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      lookups.push_back (std::make_pair (1003 * lastTime + 0.0017 * i, -1));
+    }
+  runs.push_back (lookups);
+
+  uint32_t expectedLookups = 0;
+
+  for (uint32_t run = 0; run < runs.size (); run++)
+    {
+      for (uint32_t i = 0; i < runs[run].size (); i++)
+        {
+          Simulator::Schedule (Seconds (runs[run][i].first), &SatInputFileStreamTimeDoubleContainerTestCase::TestLookup, this, runs[run][i].second);
+        }
+
+      expectedLookups += runs[run].size ();
+
+      Simulator::Run ();
+      Simulator::Destroy ();
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (m_lookups, expectedLookups, "All the lookups were not done");
+
+  delete m_reference;
+  m_reference = NULL;
+  m_container->Dispose ();
+  m_container = 0;
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the input file stream containers.
+ */
+class SatInputFileStreamTestSuite : public TestSuite
+{
+public:
+  SatInputFileStreamTestSuite ();
+};
+
+SatInputFileStreamTestSuite::SatInputFileStreamTestSuite ()
+  : TestSuite ("sat-input-fstream-test", UNIT)
+{
+  AddTestCase (new SatInputFileStreamTimeDoubleContainerTestCase, TestCase::QUICK);
+}
+
+// Allocate an instance of this TestSuite
+static SatInputFileStreamTestSuite satInputFileStreamTestSuite;
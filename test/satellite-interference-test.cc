@@ -36,6 +36,13 @@
 #include "../model/satellite-constant-interference.h"
 #include "../model/satellite-traced-interference.h"
 #include "../model/satellite-per-packet-interference.h"
+#include "../model/satellite-co-channel-activity.h"
+#include "../model/satellite-co-channel-interference.h"
+#include "../model/satellite-antenna-gain-pattern-container.h"
+#include "../model/geo-coordinate.h"
+#include "ns3/propagation-delay-model.h"
+#include "ns3/mac48-address.h"
+#include "ns3/constant-position-mobility-model.h"
 #include "ns3/singleton.h"
 #include "../utils/satellite-env-variables.h"
 
@@ -239,6 +246,197 @@ SatPerPacketInterferenceTestCase::DoRun (void)
   Singleton<SatEnvVariables>::Get ()->DoDispose ();
 }
 
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test satellite co-channel activity used by co-channel interference model.
+ *
+ * This case tests that SatCoChannelActivity calculates the mean transmit powers of the beams correctly.
+ *  1.  Create SatCoChannelActivity object with the transmitter located in the satellite (no propagation delay).
+ *  2.  Add transmissions of two beams into the same carrier.
+ *  3.  Get mean transmit powers of the beams over different time windows and carriers.
+ *
+ *  Expected result:
+ *   Mean transmit powers are the transmission energies over the window divided by the window length.
+ *   Beams not transmitting within the window and other carriers have no entries.
+ *
+ */
+class SatCoChannelActivityTestCase : public TestCase
+{
+public:
+  SatCoChannelActivityTestCase ();
+  virtual ~SatCoChannelActivityTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatCoChannelActivityTestCase::SatCoChannelActivityTestCase ()
+  : TestCase ("Test satellite co-channel activity.")
+{
+}
+
+SatCoChannelActivityTestCase::~SatCoChannelActivityTestCase ()
+{
+}
+
+void
+SatCoChannelActivityTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-if-unit", "cochannel", true);
+
+  Ptr<MobilityModel> satMobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<SatCoChannelActivity> activity = CreateObject<SatCoChannelActivity> (Ptr<SatAntennaGainPatternContainer> (), satMobility, Ptr<PropagationDelayModel> ());
+
+  // transmissions of the satellite itself are not delayed
+  NS_TEST_ASSERT_MSG_EQ (activity->GetSatelliteDelay (satMobility), Seconds (0), "Satellite delay incorrect");
+
+  activity->AddTransmission (satMobility, 1, 0, MilliSeconds (10), 2.0);
+  activity->AddTransmission (satMobility, 2, 0, MilliSeconds (5), 4.0);
+
+  std::map<uint32_t, double> txPowers;
+  activity->GetMeanTxPowers (0, Seconds (0), MilliSeconds (10), txPowers);
+
+  NS_TEST_ASSERT_MSG_EQ (txPowers.size (), 2, "Number of active beams incorrect");
+  NS_TEST_ASSERT_MSG_EQ_TOL (txPowers[1], 2.0, 1e-12, "Mean TX power of beam 1 incorrect");
+  NS_TEST_ASSERT_MSG_EQ_TOL (txPowers[2], 2.0, 1e-12, "Mean TX power of beam 2 incorrect");
+
+  txPowers.clear ();
+  activity->GetMeanTxPowers (0, MilliSeconds (5), MilliSeconds (10), txPowers);
+
+  NS_TEST_ASSERT_MSG_EQ (txPowers.size (), 1, "Number of active beams incorrect");
+  NS_TEST_ASSERT_MSG_EQ_TOL (txPowers[1], 2.0, 1e-12, "Mean TX power of beam 1 incorrect");
+
+  txPowers.clear ();
+  activity->GetMeanTxPowers (1, Seconds (0), MilliSeconds (10), txPowers);
+
+  NS_TEST_ASSERT_MSG_EQ (txPowers.empty (), true, "Other carrier shall have no activity");
+
+  activity->Dispose ();
+  Simulator::Destroy ();
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test satellite co-channel interference model on the forward user link.
+ *
+ * This case tests that SatCoChannelInterference maps the reception window of a ground
+ * receiver to the satellite time in the same way as the channel delivers the burst.
+ *  1.  Create SatCoChannelActivity object with the antenna patterns of the reference system,
+ *      a satellite and a constant speed propagation delay.
+ *  2.  Create SatCoChannelInterference object for a forward user link UT receiver in beam 1.
+ *  3.  Add a transmission of beam 1 and of the strongest interfering beam at the satellite,
+ *      followed by another transmission of the interfering beam with a different power.
+ *  4.  Add the reception at the UT at the time the channel starts it, i.e. after the
+ *      propagation delay reduced by the burst duration, and calculate the interference.
+ *
+ *  Expected result:
+ *   Interference is the power of the overlapping interfering transmission scaled with the
+ *   co-channel gain ratio and the ratio of the received and the transmitted power of the
+ *   own beam.
+ *
+ */
+class SatCoChannelInterferenceTestCase : public TestCase
+{
+public:
+  SatCoChannelInterferenceTestCase ();
+  virtual ~SatCoChannelInterferenceTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Receive (Ptr<SatCoChannelInterference> interference, Time duration, double rxPower);
+
+  double m_ifPower;
+};
+
+SatCoChannelInterferenceTestCase::SatCoChannelInterferenceTestCase ()
+  : TestCase ("Test satellite co-channel interference on forward user link."),
+    m_ifPower (-1.0)
+{
+}
+
+SatCoChannelInterferenceTestCase::~SatCoChannelInterferenceTestCase ()
+{
+}
+
+void
+SatCoChannelInterferenceTestCase::Receive (Ptr<SatCoChannelInterference> interference, Time duration, double rxPower)
+{
+  Ptr<SatInterference::InterferenceChangeEvent> event = interference->Add (duration, rxPower, Mac48Address::Allocate ());
+
+  interference->NotifyRxStart (event);
+  m_ifPower = interference->Calculate (event);
+  interference->NotifyRxEnd (event);
+}
+
+void
+SatCoChannelInterferenceTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-if-unit", "cochannel-forward", true);
+
+  Ptr<SatAntennaGainPatternContainer> patterns = CreateObject<SatAntennaGainPatternContainer> ();
+  Ptr<MobilityModel> satMobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> utMobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<PropagationDelayModel> propagationDelay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+
+  GeoCoordinate satPosition (0.0, 33.0, 35786000.0);
+  GeoCoordinate utPosition (50.25, 3.75, 0.0);
+  satMobility->SetPosition (satPosition.ToVector ());
+  utMobility->SetPosition (utPosition.ToVector ());
+
+  uint32_t beamId = patterns->GetBestBeamId (utPosition);
+
+  // the strongest interfering beam towards the UT
+  std::vector<double> ratios;
+  patterns->GetCoChannelGainRatios (beamId, GeoCoordinate (utMobility->GetPosition ()), ratios);
+
+  uint32_t ifBeamId (0);
+
+  for (uint32_t i = 1; i < ratios.size (); ++i)
+    {
+      if (i != beamId && ratios[i] > ratios[ifBeamId])
+        {
+          ifBeamId = i;
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_GT (ratios[ifBeamId], 0.0, "No interfering beam found");
+
+  Ptr<SatCoChannelActivity> activity = CreateObject<SatCoChannelActivity> (patterns, satMobility, propagationDelay);
+  Ptr<SatCoChannelInterference> interference = CreateObject<SatCoChannelInterference> (activity, SatEnums::FORWARD_USER_CH, 0);
+  interference->SetBeamId (beamId);
+  interference->SetMobility (utMobility);
+
+  Time duration = MilliSeconds (10);
+  double ownTxPower = 1.0;
+  double ifTxPower = 2.0;
+  double rxPower = 1e-12;
+
+  // transmissions of the satellite, the second transmission of the interfering beam
+  // overlaps the reception only if the window is mapped incorrectly
+  activity->AddTransmission (satMobility, beamId, 0, duration, ownTxPower);
+  activity->AddTransmission (satMobility, ifBeamId, 0, duration, ifTxPower);
+  Simulator::Schedule (duration, &SatCoChannelActivity::AddTransmission, activity, satMobility, ifBeamId, 0, duration, 4.0 * ifTxPower);
+
+  // the channel starts the reception the burst duration before the propagation delay
+  Time rxDelay = propagationDelay->GetDelay (satMobility, utMobility) - duration;
+  Simulator::Schedule (rxDelay, &SatCoChannelInterferenceTestCase::Receive, this, interference, duration, rxPower);
+
+  Simulator::Run ();
+
+  double expectedIfPower = ratios[ifBeamId] * ifTxPower * rxPower / ownTxPower;
+  NS_TEST_ASSERT_MSG_EQ_TOL (m_ifPower, expectedIfPower, 1e-6 * expectedIfPower, "Co-channel interference incorrect");
+
+  interference->Dispose ();
+  activity->Dispose ();
+  Simulator::Destroy ();
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
 /**
  * \ingroup satellite
  * \brief Test suite for Satellite interference unit test cases.
@@ -254,6 +452,8 @@ SatInterferenceTestSuite::SatInterferenceTestSuite ()
 {
   AddTestCase (new SatConstantInterferenceTestCase, TestCase::QUICK);
   AddTestCase (new SatPerPacketInterferenceTestCase, TestCase::QUICK);
+  AddTestCase (new SatCoChannelActivityTestCase, TestCase::QUICK);
+  AddTestCase (new SatCoChannelInterferenceTestCase, TestCase::QUICK);
 }
 
 // Do allocate an instance of this TestSuite
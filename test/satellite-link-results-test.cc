@@ -25,9 +25,18 @@
  * \brief Test cases for satellite link results.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
 #include <ns3/test.h>
+#include <ns3/config.h>
+#include <ns3/double.h>
 #include <ns3/satellite-link-results.h>
 #include <ns3/satellite-look-up-table.h>
+#include <ns3/satellite-embedded-link-results.h>
+#include <ns3/satellite-env-variables.h>
+#include <ns3/singleton.h>
 #include <ns3/log.h>
 #include <ns3/ptr.h>
 
@@ -158,6 +167,212 @@ SatLinkResultsDvbS2TestCase::DoRun ()
 
 
 
+/*
+ * EMBEDDED LINK RESULTS TEST CASE
+ */
+
+/**
+ * \brief Test case for comparing the link results embedded into the module
+ *        with the link results file of the data package.
+ *
+ * The test passes without checks, if the module is not configured with
+ * --enable-sat-embedded-link-results.
+ */
+class SatEmbeddedLinkResultsTestCase : public TestCase
+{
+public:
+  /**
+   * \param fileName name of the link results file, e.g. "s2_qpsk_1_to_2.txt"
+   */
+  SatEmbeddedLinkResultsTestCase (std::string fileName);
+private:
+  virtual void DoRun ();
+  std::string m_fileName;
+};
+
+
+SatEmbeddedLinkResultsTestCase::SatEmbeddedLinkResultsTestCase (std::string fileName)
+  : TestCase ("Comparing embedded link results with link results file " + fileName),
+    m_fileName (fileName)
+{
+}
+
+
+void
+SatEmbeddedLinkResultsTestCase::DoRun ()
+{
+  NS_LOG_FUNCTION (this << m_fileName);
+
+  if (!SatEmbeddedLinkResults::IsEnabled ())
+    {
+      return;
+    }
+
+  const double *esNoDb;
+  const double *bler;
+  uint32_t size;
+
+  NS_TEST_ASSERT_MSG_EQ (SatEmbeddedLinkResults::Find (m_fileName, esNoDb, bler, size), true,
+                         "Link results " << m_fileName << " not embedded");
+
+  std::string dataPath = Singleton<SatEnvVariables>::Get ()->LocateDataDirectory ();
+  std::string filePathName = dataPath + "/linkresults/" + m_fileName;
+  std::ifstream ifs (filePathName.c_str (), std::ifstream::in);
+
+  NS_TEST_ASSERT_MSG_EQ (ifs.is_open (), true, "The file " << filePathName << " is not found");
+
+  std::vector<double> fileEsNoDb;
+  std::vector<double> fileBler;
+  double esNo, blerValue;
+
+  while (ifs >> esNo >> blerValue)
+    {
+      fileEsNoDb.push_back (esNo);
+      fileBler.push_back (blerValue);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (size, fileEsNoDb.size (), "Number of embedded link results differs from file");
+
+  for (uint32_t i = 0; i < size && i < fileEsNoDb.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (esNoDb[i], fileEsNoDb[i], "Embedded Es/No differs from file at " << i);
+      NS_TEST_ASSERT_MSG_EQ (bler[i], fileBler[i], "Embedded BLER differs from file at " << i);
+    }
+}
+
+
+
+/*
+ * RESAMPLING TEST CASE
+ */
+
+/**
+ * \brief Test case for the resampling of the link results to a uniform
+ *        Es/No grid.
+ *
+ *  1. Create a look-up table of a curve with a mild kink, which is
+ *     resampled within the default MaxResamplingError tolerance (1 %).
+ *  2. Create a look-up table of a curve with a BLER cliff narrower than the
+ *     finest resampling step, which cannot meet the tolerance.
+ *  3. Create a look-up table of a waterfall curve with BLER from 1 to 1e-6,
+ *     and a table of the same curve without the resampling.
+ *
+ * Expected result:
+ *  The first table is resampled and its BLER differs less than the relative
+ *  tolerance from the curve. The second table is not resampled, i.e. the
+ *  original link results are used and its BLER is equal to the curve. The
+ *  waterfall table is resampled, its BLER differs less than the relative
+ *  tolerance from the curve also at the lowest BLER values, and the Es/No
+ *  of the BLER targets differ less than 0.01 dB from the table without the
+ *  resampling.
+ */
+class SatLookUpTableResamplingTestCase : public TestCase
+{
+public:
+  SatLookUpTableResamplingTestCase ();
+private:
+  virtual void DoRun ();
+
+  /**
+   * \brief Linear interpolation of a curve
+   * \param esNoDb Es/No values of the curve
+   * \param bler BLER values of the curve
+   * \param size Number of the values
+   * \param x Es/No to interpolate
+   * \return BLER
+   */
+  static double Interpolate (const double *esNoDb, const double *bler, uint32_t size, double x);
+};
+
+
+SatLookUpTableResamplingTestCase::SatLookUpTableResamplingTestCase ()
+  : TestCase ("Test resampling of link results to a uniform Es/No grid")
+{
+}
+
+
+double
+SatLookUpTableResamplingTestCase::Interpolate (const double *esNoDb, const double *bler, uint32_t size, double x)
+{
+  for (uint32_t i = 0; i + 1 < size; ++i)
+    {
+      if (x <= esNoDb[i + 1])
+        {
+          return bler[i] + (x - esNoDb[i]) * (bler[i + 1] - bler[i]) / (esNoDb[i + 1] - esNoDb[i]);
+        }
+    }
+
+  return bler[size - 1];
+}
+
+
+void
+SatLookUpTableResamplingTestCase::DoRun ()
+{
+  const double maxResamplingError = 0.01;
+
+  // Slope changes from -0.3 to -0.54 at 1/3 dB, the error is relative to at least
+  // the smallest non-zero BLER of 0.9
+  const double kinkEsNoDb[] = { 0.0, 1.0 / 3.0, 2.0 };
+  const double kinkBler[] = { 1.0, 0.9, 0.0 };
+
+  Ptr<SatLookUpTable> kinkTable = CreateObject<SatLookUpTable> (kinkEsNoDb, kinkBler, 3, "kink");
+  NS_TEST_ASSERT_MSG_EQ (kinkTable->IsResampled (), true, "Curve within tolerance not resampled");
+
+  // BLER drops from 1 to 0 within 1e-6 dB, which no resampling step can follow
+  const double cliffEsNoDb[] = { 0.0, 1.0 / 3.0, 1.0 / 3.0 + 1e-6, 2.0 };
+  const double cliffBler[] = { 1.0, 1.0, 0.0, 0.0 };
+
+  Ptr<SatLookUpTable> cliffTable = CreateObject<SatLookUpTable> (cliffEsNoDb, cliffBler, 4, "cliff");
+  NS_TEST_ASSERT_MSG_EQ (cliffTable->IsResampled (), false, "Curve beyond tolerance resampled");
+
+  for (double esNoDb = 0.0; esNoDb <= 2.0; esNoDb += 0.001)
+    {
+      double expectedBler = Interpolate (kinkEsNoDb, kinkBler, 3, esNoDb);
+      NS_TEST_ASSERT_MSG_EQ_TOL (kinkTable->GetBler (esNoDb), expectedBler,
+                                 maxResamplingError * std::max (expectedBler, 0.9), "Resampled BLER not within tolerance at " << esNoDb);
+      NS_TEST_ASSERT_MSG_EQ_TOL (cliffTable->GetBler (esNoDb), Interpolate (cliffEsNoDb, cliffBler, 4, esNoDb),
+                                 1e-12, "Original BLER differs at " << esNoDb);
+    }
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (cliffTable->GetBler (1.0 / 3.0 + 0.5e-6), 0.5, 1e-6, "Original BLER differs within cliff");
+
+  // BLER drops by a decade every 0.54 dB down to 1e-6, the points are not on the resampling grid
+  double waterfallEsNoDb[13];
+  double waterfallBler[13];
+
+  for (uint32_t i = 0; i < 13; ++i)
+    {
+      waterfallEsNoDb[i] = 0.27 * i;
+      waterfallBler[i] = std::pow (10.0, -0.5 * i);
+    }
+
+  Ptr<SatLookUpTable> waterfallTable = CreateObject<SatLookUpTable> (waterfallEsNoDb, waterfallBler, 13, "waterfall");
+  NS_TEST_ASSERT_MSG_EQ (waterfallTable->IsResampled (), true, "Waterfall curve not resampled");
+
+  Config::SetDefault ("ns3::SatLookUpTable::ResamplingStepDb", DoubleValue (0.0));
+  Ptr<SatLookUpTable> originalTable = CreateObject<SatLookUpTable> (waterfallEsNoDb, waterfallBler, 13, "waterfall");
+  Config::SetDefault ("ns3::SatLookUpTable::ResamplingStepDb", DoubleValue (0.05));
+  NS_TEST_ASSERT_MSG_EQ (originalTable->IsResampled (), false, "Waterfall curve resampled without resampling step");
+
+  for (double esNoDb = 0.0; esNoDb <= waterfallEsNoDb[12]; esNoDb += 0.0005)
+    {
+      double bler = Interpolate (waterfallEsNoDb, waterfallBler, 13, esNoDb);
+      NS_TEST_ASSERT_MSG_EQ_TOL (waterfallTable->GetBler (esNoDb), bler,
+                                 maxResamplingError * std::max (bler, 1e-6), "Resampled BLER not within relative tolerance at " << esNoDb);
+    }
+
+  const double blerTargets[] = { 1e-1, 1e-3, 1e-5 };
+
+  for (uint32_t i = 0; i < 3; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (waterfallTable->GetEsNoDb (blerTargets[i]), originalTable->GetEsNoDb (blerTargets[i]),
+                                 0.01, "Es/No of BLER target " << blerTargets[i] << " differs");
+    }
+}
+
+
+
 /*
  * TEST SUITE
  */
@@ -789,6 +1004,12 @@ public:
 
     // END OF AUTO-GENERATED TEST CASES
 
+    AddTestCase (new SatLookUpTableResamplingTestCase, TestCase::QUICK);
+    AddTestCase (new SatEmbeddedLinkResultsTestCase ("rcs2_waveformat2.txt"), TestCase::QUICK);
+    AddTestCase (new SatEmbeddedLinkResultsTestCase ("rcs2_waveformat13.txt"), TestCase::QUICK);
+    AddTestCase (new SatEmbeddedLinkResultsTestCase ("s2_qpsk_1_to_2.txt"), TestCase::QUICK);
+    AddTestCase (new SatEmbeddedLinkResultsTestCase ("s2_8psk_2_to_3.txt"), TestCase::QUICK);
+
   } // end of LinkResultTestSuite ()
 
 } g_linkResultTestSuite;
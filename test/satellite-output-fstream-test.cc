@@ -0,0 +1,511 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+/**
+ * \file satellite-output-fstream-test.cc
+ * \ingroup satellite
+ * \brief Test cases to unit test the streaming mode and the binary format of the output file stream containers
+ * and reading the binary format with the input file stream container.
+ */
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "ns3/singleton.h"
+#include "ns3/simulator.h"
+#include "../utils/satellite-env-variables.h"
+#include "../utils/satellite-output-fstream-double-container.h"
+#include "../utils/satellite-input-fstream-time-double-container.h"
+#include "../utils/satellite-binary-trace-file.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the streaming mode of the output file
+ * stream double container.
+ *
+ *   1.  Create two containers, one of them in the streaming mode with a
+ *       small stream buffer.
+ *   2.  Add the same value rows into both containers and write them into files.
+ *
+ *   Expected result:
+ *     The contents of the files are equal.
+ */
+class SatOutputFileStreamDoubleContainerTestCase : public TestCase
+{
+public:
+  SatOutputFileStreamDoubleContainerTestCase ();
+  virtual ~SatOutputFileStreamDoubleContainerTestCase ();
+
+private:
+  virtual void DoRun (void);
+  std::vector<std::string> ReadLines (std::string fileName);
+};
+
+SatOutputFileStreamDoubleContainerTestCase::SatOutputFileStreamDoubleContainerTestCase ()
+  : TestCase ("Test streaming mode of output file stream double container.")
+{
+}
+
+SatOutputFileStreamDoubleContainerTestCase::~SatOutputFileStreamDoubleContainerTestCase ()
+{
+}
+
+std::vector<std::string>
+SatOutputFileStreamDoubleContainerTestCase::ReadLines (std::string fileName)
+{
+  std::vector<std::string> lines;
+  std::ifstream file (fileName.c_str ());
+  std::string line;
+
+  while (std::getline (file, line))
+    {
+      lines.push_back (line);
+    }
+  return lines;
+}
+
+void
+SatOutputFileStreamDoubleContainerTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-output-fstream", "", true);
+
+  std::string dataPath = Singleton<SatEnvVariables>::Get ()->GetOutputPath ();
+  std::string bufferedFileName = dataPath + "/test-sat-output-fstream-buffered.txt";
+  std::string streamingFileName = dataPath + "/test-sat-output-fstream-streaming.txt";
+
+  Ptr<SatOutputFileStreamDoubleContainer> buffered = CreateObject<SatOutputFileStreamDoubleContainer> (bufferedFileName, std::ios::out, 3);
+  Ptr<SatOutputFileStreamDoubleContainer> streaming = CreateObject<SatOutputFileStreamDoubleContainer> (streamingFileName, std::ios::out, 3);
+  streaming->SetAttribute ("StreamingMode", BooleanValue (true));
+  streaming->SetAttribute ("StreamBufferSize", UintegerValue (100));
+
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      std::vector<double> row;
+      row.push_back (0.001 * i);
+      row.push_back (1.0 / (i + 1));
+      row.push_back (-1.5e-12 * i);
+
+      buffered->AddToContainer (row);
+      streaming->AddToContainer (row);
+    }
+
+  buffered->WriteContainerToFile ();
+  streaming->WriteContainerToFile ();
+
+  std::vector<std::string> bufferedLines = ReadLines (bufferedFileName);
+  std::vector<std::string> streamingLines = ReadLines (streamingFileName);
+
+  NS_TEST_ASSERT_MSG_EQ (bufferedLines.size (), 1000, "Wrong number of buffered rows");
+  NS_TEST_ASSERT_MSG_EQ (streamingLines.size (), bufferedLines.size (), "Wrong number of streamed rows");
+
+  for (uint32_t i = 0; i < bufferedLines.size () && i < streamingLines.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (streamingLines[i], bufferedLines[i], "Streamed row differs from buffered row");
+    }
+
+  buffered->Dispose ();
+  streaming->Dispose ();
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test streaming into more files than there
+ * are file descriptors available by default.
+ *
+ *   1.  Create 2000 containers in the streaming mode with a small stream buffer.
+ *   2.  Add rows into all the containers in turns and write them into files.
+ *
+ *   Expected result:
+ *     All the files are written and contain their own rows in order.
+ */
+class SatOutputFileStreamManyFilesTestCase : public TestCase
+{
+public:
+  SatOutputFileStreamManyFilesTestCase ();
+  virtual ~SatOutputFileStreamManyFilesTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatOutputFileStreamManyFilesTestCase::SatOutputFileStreamManyFilesTestCase ()
+  : TestCase ("Test streaming mode of output file stream double container with many files.")
+{
+}
+
+SatOutputFileStreamManyFilesTestCase::~SatOutputFileStreamManyFilesTestCase ()
+{
+}
+
+void
+SatOutputFileStreamManyFilesTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-output-fstream-many-files", "", true);
+
+  std::string dataPath = Singleton<SatEnvVariables>::Get ()->GetOutputPath ();
+  uint32_t files = 2000;
+  uint32_t rows = 50;
+
+  std::vector<Ptr<SatOutputFileStreamDoubleContainer> > containers;
+  std::vector<std::string> fileNames;
+
+  for (uint32_t i = 0; i < files; i++)
+    {
+      std::stringstream fileName;
+      fileName << dataPath << "/test-sat-output-fstream-" << i << ".txt";
+      fileNames.push_back (fileName.str ());
+
+      containers.push_back (CreateObject<SatOutputFileStreamDoubleContainer> (fileName.str (), std::ios::out, 2));
+      containers.back ()->SetAttribute ("StreamingMode", BooleanValue (true));
+      containers.back ()->SetAttribute ("StreamBufferSize", UintegerValue (64));
+    }
+
+  for (uint32_t j = 0; j < rows; j++)
+    {
+      for (uint32_t i = 0; i < files; i++)
+        {
+          std::vector<double> row;
+          row.push_back (j);
+          row.push_back (i);
+          containers[i]->AddToContainer (row);
+        }
+    }
+
+  for (uint32_t i = 0; i < files; i++)
+    {
+      containers[i]->WriteContainerToFile ();
+      containers[i]->Dispose ();
+    }
+
+  for (uint32_t i = 0; i < files; i++)
+    {
+      std::ifstream file (fileNames[i].c_str ());
+      double time, value;
+      uint32_t count = 0;
+
+      while (file >> time >> value)
+        {
+          NS_TEST_ASSERT_MSG_EQ (time, count, "Wrong row order in " << fileNames[i]);
+          NS_TEST_ASSERT_MSG_EQ (value, i, "Wrong row value in " << fileNames[i]);
+          ++count;
+        }
+
+      NS_TEST_ASSERT_MSG_EQ (count, rows, "Wrong number of rows in " << fileNames[i]);
+    }
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test the binary format of the output file
+ * stream double container.
+ *
+ *   1.  Create a text container and a binary container with the given
+ *       value type, time column encoding and streaming mode.
+ *   2.  Add the same value rows into both containers and write them into files.
+ *   3.  Read the binary file and convert it into a text file.
+ *
+ *   Expected result:
+ *     The read time column is equal to the written one and the values
+ *     are equal within the precision of the value type. The converted
+ *     text file of double values is equal to the text file.
+ */
+class SatOutputFileStreamBinaryTestCase : public TestCase
+{
+public:
+  SatOutputFileStreamBinaryTestCase (SatBinaryTraceFile::ValueType_t valueType, bool deltaTime, bool streamingMode);
+  virtual ~SatOutputFileStreamBinaryTestCase ();
+
+private:
+  virtual void DoRun (void);
+  std::string ReadFile (std::string fileName);
+
+  SatBinaryTraceFile::ValueType_t m_valueType;
+  bool m_deltaTime;
+  bool m_streamingMode;
+};
+
+SatOutputFileStreamBinaryTestCase::SatOutputFileStreamBinaryTestCase (SatBinaryTraceFile::ValueType_t valueType, bool deltaTime, bool streamingMode)
+  : TestCase ("Test binary format of output file stream double container."),
+    m_valueType (valueType),
+    m_deltaTime (deltaTime),
+    m_streamingMode (streamingMode)
+{
+}
+
+SatOutputFileStreamBinaryTestCase::~SatOutputFileStreamBinaryTestCase ()
+{
+}
+
+std::string
+SatOutputFileStreamBinaryTestCase::ReadFile (std::string fileName)
+{
+  std::ifstream file (fileName.c_str ());
+  std::stringstream contents;
+  contents << file.rdbuf ();
+  return contents.str ();
+}
+
+void
+SatOutputFileStreamBinaryTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-output-fstream-binary", "", true);
+
+  std::string dataPath = Singleton<SatEnvVariables>::Get ()->GetOutputPath ();
+  std::string textFileName = dataPath + "/test-sat-output-fstream-text.txt";
+  std::string binaryFileName = dataPath + "/test-sat-output-fstream-binary.bin";
+  std::string convertedFileName = dataPath + "/test-sat-output-fstream-converted.txt";
+
+  Ptr<SatOutputFileStreamDoubleContainer> text = CreateObject<SatOutputFileStreamDoubleContainer> (textFileName, std::ios::out, 3);
+  Ptr<SatOutputFileStreamDoubleContainer> binary = CreateObject<SatOutputFileStreamDoubleContainer> (binaryFileName, std::ios::out, 3);
+  binary->SetAttribute ("FileFormat", EnumValue (SatOutputFileStreamDoubleContainer::BINARY_FILE));
+  binary->SetAttribute ("BinaryValueType", EnumValue (m_valueType));
+  binary->SetAttribute ("BinaryDeltaTime", BooleanValue (m_deltaTime));
+  binary->SetAttribute ("StreamingMode", BooleanValue (m_streamingMode));
+  binary->SetAttribute ("StreamBufferSize", UintegerValue (1000));
+
+  std::vector<std::vector<double> > rows;
+
+  for (uint32_t i = 0; i < 10000; i++)
+    {
+      std::vector<double> row;
+      row.push_back (0.001 * i);
+      row.push_back (1.0 / (i + 1));
+      row.push_back (-1.5e-12 * i);
+
+      rows.push_back (row);
+      text->AddToContainer (row);
+      binary->AddToContainer (row);
+    }
+
+  text->WriteContainerToFile ();
+  binary->WriteContainerToFile ();
+
+  NS_TEST_ASSERT_MSG_EQ (SatBinaryTraceFile::IsBinaryTraceFile (binaryFileName), true, "Binary file not detected");
+  NS_TEST_ASSERT_MSG_EQ (SatBinaryTraceFile::IsBinaryTraceFile (textFileName), false, "Text file detected as binary");
+
+  std::vector<std::vector<double> > columns;
+  SatBinaryTraceFile::ReadFile (binaryFileName, 3, columns);
+
+  NS_TEST_ASSERT_MSG_EQ (columns.size (), 3, "Wrong number of columns");
+  NS_TEST_ASSERT_MSG_EQ (columns[0].size (), rows.size (), "Wrong number of rows");
+
+  double tolerance = (m_valueType == SatBinaryTraceFile::FLOAT32) ? 1e-7 : 0.0;
+
+  for (uint32_t i = 0; i < rows.size () && i < columns[0].size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ_TOL (columns[0][i], rows[i][0], 1e-12, "Time sample differs");
+      NS_TEST_ASSERT_MSG_EQ_TOL (columns[1][i], rows[i][1], tolerance * std::abs (rows[i][1]), "Value differs");
+      NS_TEST_ASSERT_MSG_EQ_TOL (columns[2][i], rows[i][2], tolerance * std::abs (rows[i][2]), "Value differs");
+    }
+
+  if (m_valueType == SatBinaryTraceFile::FLOAT64)
+    {
+      SatBinaryTraceFile::ConvertBinaryToText (binaryFileName, convertedFileName);
+      NS_TEST_ASSERT_MSG_EQ ((ReadFile (convertedFileName) == ReadFile (textFileName)), true, "Converted file differs from text file");
+    }
+
+  text->Dispose ();
+  binary->Dispose ();
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case to unit test reading the binary files written by the
+ * output file stream double container with the input file stream time
+ * double container.
+ *
+ *   1.  Write rows into a binary file with the given value type, time column
+ *       encoding and streaming mode.
+ *   2.  Append more rows into the same file with another container.
+ *   3.  Read the file with the input container and schedule a lookup at
+ *       each written time sample.
+ *
+ *   Expected result:
+ *     Each lookup returns the row written for the time sample, the values
+ *     being equal within the precision of the value type. The delta encoded
+ *     time column takes less space than the plain one.
+ */
+class SatBinaryTraceRoundTripTestCase : public TestCase
+{
+public:
+  SatBinaryTraceRoundTripTestCase (SatBinaryTraceFile::ValueType_t valueType, bool deltaTime, bool streamingMode);
+  virtual ~SatBinaryTraceRoundTripTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void WriteRows (std::string fileName, std::ios::openmode fileMode, uint32_t first, uint32_t count);
+  void CheckRow (uint32_t index);
+
+  SatBinaryTraceFile::ValueType_t m_valueType;
+  bool m_deltaTime;
+  bool m_streamingMode;
+  std::vector<std::vector<double> > m_rows;
+  Ptr<SatInputFileStreamTimeDoubleContainer> m_input;
+  uint32_t m_checkedRows;
+};
+
+SatBinaryTraceRoundTripTestCase::SatBinaryTraceRoundTripTestCase (SatBinaryTraceFile::ValueType_t valueType, bool deltaTime, bool streamingMode)
+  : TestCase ("Test reading binary files of output file stream double container with input file stream time double container."),
+    m_valueType (valueType),
+    m_deltaTime (deltaTime),
+    m_streamingMode (streamingMode),
+    m_checkedRows (0)
+{
+}
+
+SatBinaryTraceRoundTripTestCase::~SatBinaryTraceRoundTripTestCase ()
+{
+}
+
+void
+SatBinaryTraceRoundTripTestCase::WriteRows (std::string fileName, std::ios::openmode fileMode, uint32_t first, uint32_t count)
+{
+  Ptr<SatOutputFileStreamDoubleContainer> output = CreateObject<SatOutputFileStreamDoubleContainer> (fileName, fileMode, 3);
+  output->SetAttribute ("FileFormat", EnumValue (SatOutputFileStreamDoubleContainer::BINARY_FILE));
+  output->SetAttribute ("BinaryValueType", EnumValue (m_valueType));
+  output->SetAttribute ("BinaryDeltaTime", BooleanValue (m_deltaTime));
+  output->SetAttribute ("StreamingMode", BooleanValue (m_streamingMode));
+  output->SetAttribute ("StreamBufferSize", UintegerValue (1000));
+
+  for (uint32_t i = first; i < first + count; i++)
+    {
+      std::vector<double> row;
+      row.push_back (0.001 * (i + 1));
+      row.push_back (std::sin (0.01 * i));
+      row.push_back (1.0e-13 * (i + 1));
+
+      m_rows.push_back (row);
+      output->AddToContainer (row);
+    }
+
+  output->WriteContainerToFile ();
+  output->Dispose ();
+}
+
+void
+SatBinaryTraceRoundTripTestCase::CheckRow (uint32_t index)
+{
+  std::vector<double> row = m_input->ProceedToNextClosestTimeSample ();
+  const std::vector<double>& reference = m_rows[index];
+
+  double tolerance = (m_valueType == SatBinaryTraceFile::FLOAT32) ? 1e-7 : 0.0;
+
+  NS_TEST_ASSERT_MSG_EQ (row.size (), reference.size (), "Wrong number of values in row " << index);
+  NS_TEST_ASSERT_MSG_EQ_TOL (row[0], reference[0], 1e-12, "Time sample differs in row " << index);
+  NS_TEST_ASSERT_MSG_EQ_TOL (row[1], reference[1], tolerance * std::abs (reference[1]), "Value differs in row " << index);
+  NS_TEST_ASSERT_MSG_EQ_TOL (row[2], reference[2], tolerance * std::abs (reference[2]), "Value differs in row " << index);
+
+  m_checkedRows++;
+}
+
+void
+SatBinaryTraceRoundTripTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-output-fstream-round-trip", "", true);
+
+  std::string dataPath = Singleton<SatEnvVariables>::Get ()->GetOutputPath ();
+  std::string fileName = dataPath + "/test-sat-output-fstream-round-trip.bin";
+
+  WriteRows (fileName, std::ios::out, 0, 5000);
+  WriteRows (fileName, std::ios::out | std::ios::app, 5000, 3000);
+
+  // Plain time column takes eight bytes per row
+  size_t valueSize = (m_valueType == SatBinaryTraceFile::FLOAT32) ? sizeof (float) : sizeof (double);
+  std::ifstream file (fileName.c_str (), std::ifstream::in | std::ifstream::binary);
+  file.seekg (0, std::ios::end);
+  std::streamoff valueBytes = m_rows.size () * 2 * valueSize;
+  std::streamoff plainTimeBytes = m_rows.size () * sizeof (double);
+
+  if (m_deltaTime)
+    {
+      NS_TEST_ASSERT_MSG_LT (file.tellg () - valueBytes, plainTimeBytes / 2, "Delta encoded time column is not compact");
+    }
+  else
+    {
+      NS_TEST_ASSERT_MSG_GT (file.tellg () - valueBytes, plainTimeBytes, "Wrong size of the file");
+    }
+  file.close ();
+
+  m_input = CreateObject<SatInputFileStreamTimeDoubleContainer> (fileName, std::ios::in, 3);
+
+  for (uint32_t i = 0; i < m_rows.size (); i++)
+    {
+      Simulator::Schedule (Seconds (m_rows[i][0]), &SatBinaryTraceRoundTripTestCase::CheckRow, this, i);
+    }
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_checkedRows, m_rows.size (), "All the rows were not checked");
+
+  m_input->Dispose ();
+  m_input = 0;
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the output file stream containers.
+ */
+class SatOutputFileStreamTestSuite : public TestSuite
+{
+public:
+  SatOutputFileStreamTestSuite ();
+};
+
+SatOutputFileStreamTestSuite::SatOutputFileStreamTestSuite ()
+  : TestSuite ("sat-output-fstream-test", UNIT)
+{
+  AddTestCase (new SatOutputFileStreamDoubleContainerTestCase, TestCase::QUICK);
+  AddTestCase (new SatOutputFileStreamManyFilesTestCase, TestCase::QUICK);
+  AddTestCase (new SatOutputFileStreamBinaryTestCase (SatBinaryTraceFile::FLOAT64, false, false), TestCase::QUICK);
+  AddTestCase (new SatOutputFileStreamBinaryTestCase (SatBinaryTraceFile::FLOAT64, true, true), TestCase::QUICK);
+  AddTestCase (new SatOutputFileStreamBinaryTestCase (SatBinaryTraceFile::FLOAT32, true, false), TestCase::QUICK);
+  AddTestCase (new SatBinaryTraceRoundTripTestCase (SatBinaryTraceFile::FLOAT64, false, false), TestCase::QUICK);
+  AddTestCase (new SatBinaryTraceRoundTripTestCase (SatBinaryTraceFile::FLOAT64, true, true), TestCase::QUICK);
+  AddTestCase (new SatBinaryTraceRoundTripTestCase (SatBinaryTraceFile::FLOAT32, true, false), TestCase::QUICK);
+}
+
+// Allocate an instance of this TestSuite
+static SatOutputFileStreamTestSuite satOutputFileStreamTestSuite;
@@ -0,0 +1,488 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+/**
+ * \file satellite-random-access-monte-carlo-test.cc
+ * \ingroup satellite
+ * \brief Test cases for the frame level random access Monte-Carlo simulator.
+ */
+
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/enum.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/singleton.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/satellite-const-variables.h"
+#include "ns3/satellite-superframe-sequence.h"
+#include "ns3/cbr-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "../helper/satellite-helper.h"
+#include "../helper/satellite-random-access-monte-carlo-helper.h"
+#include "../utils/satellite-env-variables.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup satellite
+ * \brief Test case for the slotted ALOHA throughput of the Monte-Carlo simulator.
+ *
+ *  1.  Frames having a fixed number of packets are simulated with one replica
+ *      per packet, strict collision model and a high Es/No.
+ *
+ *  Expected result:
+ *    The ratio of the received packets equals to the probability of not
+ *    colliding with any of the other packets, (1 - 1 / N)^(M - 1), where N
+ *    is the number of slots and M the number of packets in a frame.
+ */
+class SatRaMonteCarloSlottedAlohaTestCase : public TestCase
+{
+public:
+  SatRaMonteCarloSlottedAlohaTestCase ();
+  virtual ~SatRaMonteCarloSlottedAlohaTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatRaMonteCarloSlottedAlohaTestCase::SatRaMonteCarloSlottedAlohaTestCase ()
+  : TestCase ("Test slotted ALOHA throughput of the random access Monte-Carlo simulator.")
+{
+}
+
+SatRaMonteCarloSlottedAlohaTestCase::~SatRaMonteCarloSlottedAlohaTestCase ()
+{
+}
+
+void
+SatRaMonteCarloSlottedAlohaTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-ra-monte-carlo", "slotted-aloha", true);
+
+  uint32_t slots = 100;
+  uint32_t packets = 50;
+
+  Ptr<SatRandomAccessMonteCarloHelper> helper = CreateObject<SatRandomAccessMonteCarloHelper> ();
+  helper->SetAttribute ("SlotsPerFrame", UintegerValue (slots));
+  helper->SetAttribute ("Replicas", UintegerValue (1));
+  helper->SetAttribute ("CollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS));
+  helper->SetAttribute ("MeanEsNoDb", DoubleValue (20.0));
+
+  SatRandomAccessMonteCarloHelper::loadPointResult_s result = helper->RunFixedPacketCount (packets, 2000);
+
+  double expectedPlr = 1.0 - std::pow (1.0 - 1.0 / slots, packets - 1.0);
+
+  NS_TEST_ASSERT_MSG_EQ (result.sentPackets, (uint64_t) packets * 2000, "Wrong number of sent packets");
+  NS_TEST_ASSERT_MSG_EQ_TOL (result.packetLossRatio, expectedPlr, 0.01, "Packet loss ratio differs from the analytic one");
+  NS_TEST_ASSERT_MSG_EQ_TOL (result.throughput, (1.0 - expectedPlr) * packets / slots, 0.005, "Throughput differs from the analytic one");
+
+  // CRDSA resolves most of the collisions at the same load
+  helper = CreateObject<SatRandomAccessMonteCarloHelper> ();
+  helper->SetAttribute ("SlotsPerFrame", UintegerValue (slots));
+  helper->SetAttribute ("Replicas", UintegerValue (3));
+  helper->SetAttribute ("CollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS));
+  helper->SetAttribute ("MeanEsNoDb", DoubleValue (20.0));
+
+  SatRandomAccessMonteCarloHelper::loadPointResult_s crdsaResult = helper->RunFixedPacketCount (packets, 2000);
+
+  NS_TEST_ASSERT_MSG_LT (crdsaResult.packetLossRatio, result.packetLossRatio, "CRDSA does not outperform slotted ALOHA");
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case for changing the collision model of the Monte-Carlo simulator between runs.
+ *
+ *  1.  Frames are simulated with one replica per packet, strict collision model
+ *      and a wide Es/No range.
+ *  2.  The collision model of the same helper is changed to the SINR based one
+ *      and the frames are simulated again.
+ *  3.  The frames are simulated once more with the strict collision model.
+ *
+ *  Expected result:
+ *    The SINR based collision model receives some of the colliding packets,
+ *    thus its packet loss ratio is lower than the one of the strict model.
+ *    The strict model gives the same packet loss ratio before and after
+ *    the SINR based run.
+ */
+class SatRaMonteCarloReconfigurationTestCase : public TestCase
+{
+public:
+  SatRaMonteCarloReconfigurationTestCase ();
+  virtual ~SatRaMonteCarloReconfigurationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SatRaMonteCarloReconfigurationTestCase::SatRaMonteCarloReconfigurationTestCase ()
+  : TestCase ("Test changing the collision model of the random access Monte-Carlo simulator between runs.")
+{
+}
+
+SatRaMonteCarloReconfigurationTestCase::~SatRaMonteCarloReconfigurationTestCase ()
+{
+}
+
+void
+SatRaMonteCarloReconfigurationTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-ra-monte-carlo", "reconfiguration", true);
+
+  uint32_t slots = 100;
+  uint32_t packets = 50;
+
+  Ptr<SatRandomAccessMonteCarloHelper> helper = CreateObject<SatRandomAccessMonteCarloHelper> ();
+  helper->SetAttribute ("SlotsPerFrame", UintegerValue (slots));
+  helper->SetAttribute ("Replicas", UintegerValue (1));
+  helper->SetAttribute ("CollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS));
+  helper->SetAttribute ("MeanEsNoDb", DoubleValue (20.0));
+  helper->SetAttribute ("EsNoRangeDb", DoubleValue (20.0));
+
+  SatRandomAccessMonteCarloHelper::loadPointResult_s strictResult = helper->RunFixedPacketCount (packets, 2000);
+
+  helper->SetAttribute ("CollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR));
+
+  SatRandomAccessMonteCarloHelper::loadPointResult_s sinrResult = helper->RunFixedPacketCount (packets, 2000);
+
+  helper->SetAttribute ("CollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS));
+
+  SatRandomAccessMonteCarloHelper::loadPointResult_s strictResult2 = helper->RunFixedPacketCount (packets, 2000);
+
+  NS_TEST_ASSERT_MSG_EQ (sinrResult.sentPackets, strictResult.sentPackets, "Wrong number of sent packets");
+  NS_TEST_ASSERT_MSG_LT (sinrResult.packetLossRatio, strictResult.packetLossRatio, "Changed collision model not taken into use");
+  NS_TEST_ASSERT_MSG_EQ_TOL (strictResult2.packetLossRatio, strictResult.packetLossRatio, 0.01, "Restored collision model not taken into use");
+
+  helper->Dispose ();
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case for simulating the load points of the Monte-Carlo simulator in parallel.
+ *
+ *  1.  Load points from a low to an overloaded offered load are simulated with
+ *      three replicas, SINR based collision model and a wide Es/No range with
+ *      one thread.
+ *  2.  The same load points are simulated with four threads, drawing the same
+ *      random values.
+ *
+ *  Expected result:
+ *    The results of each load point are identical with one and four threads.
+ */
+class SatRaMonteCarloParallelTestCase : public TestCase
+{
+public:
+  SatRaMonteCarloParallelTestCase ();
+  virtual ~SatRaMonteCarloParallelTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Simulate the load points
+   * \param threads Number of threads simulating the load points
+   * \param offeredLoads Offered loads of the load points
+   * \return Results of the load points
+   */
+  std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s> Simulate (uint32_t threads, const std::vector<double>& offeredLoads);
+};
+
+SatRaMonteCarloParallelTestCase::SatRaMonteCarloParallelTestCase ()
+  : TestCase ("Test simulating the load points of the random access Monte-Carlo simulator in parallel.")
+{
+}
+
+SatRaMonteCarloParallelTestCase::~SatRaMonteCarloParallelTestCase ()
+{
+}
+
+std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s>
+SatRaMonteCarloParallelTestCase::Simulate (uint32_t threads, const std::vector<double>& offeredLoads)
+{
+  // Both simulations draw the same random values
+  RngSeedManager::ResetNextStreamIndex ();
+
+  Ptr<SatRandomAccessMonteCarloHelper> helper = CreateObject<SatRandomAccessMonteCarloHelper> ();
+  helper->SetAttribute ("SlotsPerFrame", UintegerValue (100));
+  helper->SetAttribute ("Replicas", UintegerValue (3));
+  helper->SetAttribute ("CollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR));
+  helper->SetAttribute ("MeanEsNoDb", DoubleValue (10.0));
+  helper->SetAttribute ("EsNoRangeDb", DoubleValue (10.0));
+  helper->SetAttribute ("FramesPerLoadPoint", UintegerValue (200));
+  helper->SetAttribute ("Threads", UintegerValue (threads));
+
+  std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s> results = helper->Run (offeredLoads);
+
+  helper->Dispose ();
+
+  return results;
+}
+
+void
+SatRaMonteCarloParallelTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-ra-monte-carlo", "parallel", true);
+
+  std::vector<double> offeredLoads;
+
+  for (uint32_t i = 1; i <= 8; ++i)
+    {
+      offeredLoads.push_back (0.15 * i);
+    }
+
+  std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s> sequential = Simulate (1, offeredLoads);
+  std::vector<SatRandomAccessMonteCarloHelper::loadPointResult_s> parallel = Simulate (4, offeredLoads);
+
+  NS_TEST_ASSERT_MSG_EQ (sequential.size (), offeredLoads.size (), "Wrong number of load points");
+  NS_TEST_ASSERT_MSG_EQ (parallel.size (), sequential.size (), "Different number of load points");
+
+  for (uint32_t i = 0; i < parallel.size () && i < sequential.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].offeredLoad, sequential[i].offeredLoad, "Load points in different order");
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].frames, sequential[i].frames, "Different number of frames at load " << offeredLoads[i]);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].sentPackets, sequential[i].sentPackets, "Different sent packets at load " << offeredLoads[i]);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].receivedPackets, sequential[i].receivedPackets, "Different received packets at load " << offeredLoads[i]);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].throughput, sequential[i].throughput, "Different throughput at load " << offeredLoads[i]);
+      NS_TEST_ASSERT_MSG_EQ (parallel[i].packetLossRatio, sequential[i].packetLossRatio, "Different packet loss ratio at load " << offeredLoads[i]);
+    }
+
+  // the load points are not all lost nor all received
+  NS_TEST_ASSERT_MSG_GT (sequential.front ().receivedPackets, (uint64_t) 0, "No packets received at the lowest load");
+  NS_TEST_ASSERT_MSG_GT (sequential.back ().packetLossRatio, 0.0, "No packets lost at the highest load");
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test case for the consistency of the Monte-Carlo simulator and the full simulation.
+ *
+ *  1.  A user defined scenario with the given number of UTs in one beam is simulated
+ *      with CRDSA only, strict collision model and saturated CBR traffic.
+ *  2.  The number of unique payloads and the errors in each received CRDSA frame
+ *      are collected from the CrdsaUniquePayloadRx trace of the GW.
+ *  3.  The frames are simulated with the Monte-Carlo simulator with the same
+ *      number of unique payloads per frame and the same number of slots.
+ *
+ *  Expected result:
+ *    The packet loss ratios of the full simulation and the Monte-Carlo simulator
+ *    are close to each other.
+ */
+class SatRaMonteCarloConsistencyTestCase : public TestCase
+{
+public:
+  SatRaMonteCarloConsistencyTestCase (uint32_t utCount);
+  virtual ~SatRaMonteCarloConsistencyTestCase ();
+
+  /**
+   * \brief Callback for the CrdsaUniquePayloadRx trace
+   * \param context Trace context identifying the carrier
+   * \param nPackets Number of upper layer packets in the payload
+   * \param address Address of the sender
+   * \param error Has the payload been lost
+   */
+  void UniquePayloadRx (std::string context, uint32_t nPackets, const Address &address, bool error);
+
+private:
+  virtual void DoRun (void);
+
+  uint32_t m_utCount;
+
+  /**
+   * Number of unique payloads and lost payloads of each frame,
+   * indexed by the carrier and the frame end time
+   */
+  std::map<std::pair<std::string, int64_t>, std::pair<uint32_t, uint32_t> > m_frames;
+};
+
+SatRaMonteCarloConsistencyTestCase::SatRaMonteCarloConsistencyTestCase (uint32_t utCount)
+  : TestCase ("Test consistency of the random access Monte-Carlo simulator and the full simulation."),
+    m_utCount (utCount),
+    m_frames ()
+{
+}
+
+SatRaMonteCarloConsistencyTestCase::~SatRaMonteCarloConsistencyTestCase ()
+{
+}
+
+void
+SatRaMonteCarloConsistencyTestCase::UniquePayloadRx (std::string context, uint32_t nPackets, const Address &address, bool error)
+{
+  std::pair<uint32_t, uint32_t>& frame = m_frames[std::make_pair (context, Simulator::Now ().GetInteger ())];
+
+  ++frame.first;
+
+  if (error)
+    {
+      ++frame.second;
+    }
+}
+
+void
+SatRaMonteCarloConsistencyTestCase::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-ra-monte-carlo", "consistency", true);
+
+  // Enable CRDSA only with strict collision model
+  Config::SetDefault ("ns3::SatBeamHelper::RandomAccessModel", EnumValue (SatEnums::RA_MODEL_CRDSA));
+  Config::SetDefault ("ns3::SatBeamHelper::RaInterferenceModel", EnumValue (SatPhyRxCarrierConf::IF_PER_PACKET));
+  Config::SetDefault ("ns3::SatBeamHelper::RaCollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS));
+  Config::SetDefault ("ns3::SatBeamScheduler::ControlSlotsEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::SatPhyRxCarrierConf::EnableRandomAccessDynamicLoadControl", BooleanValue (false));
+
+  // Transmit whenever there is data
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_MaximumUniquePayloadPerBlock", UintegerValue (1));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_MaximumConsecutiveBlockAccessed", UintegerValue (1000));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_MinimumIdleBlock", UintegerValue (0));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_BackOffProbability", UintegerValue (1));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_HighLoadBackOffProbability", UintegerValue (1));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_NumberOfInstances", UintegerValue (3));
+
+  // Disable CRA and DA
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService0_ConstantAssignmentProvided", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService1_ConstantAssignmentProvided", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService2_ConstantAssignmentProvided", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService3_ConstantAssignmentProvided", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService0_RbdcAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService1_RbdcAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService2_RbdcAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService3_RbdcAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService0_VolumeAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService1_VolumeAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService2_VolumeAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService3_VolumeAllowed", BooleanValue (false));
+
+  std::string scenarioName = "Scenario72";
+
+  Ptr<SatHelper> helper = CreateObject<SatHelper> (scenarioName);
+
+  SatBeamUserInfo beamInfo = SatBeamUserInfo (m_utCount, 1);
+  std::map<uint32_t, SatBeamUserInfo > beamMap;
+  beamMap[1] = beamInfo;
+
+  helper->CreateUserDefinedScenario (beamMap);
+
+  uint32_t slots = helper->GetBeamHelper ()->GetSuperframeSeq ()->GetSuperframeConf (SatConstVariables::SUPERFRAME_SEQUENCE)->GetRaSlotCount (0);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/SatPhy/PhyRx/RxCarrierList/*/$ns3::SatPhyRxCarrierPerFrame/CrdsaUniquePayloadRx",
+                   MakeCallback (&SatRaMonteCarloConsistencyTestCase::UniquePayloadRx, this));
+
+  NodeContainer gwUsers = helper->GetGwUsers ();
+  uint16_t port = 9;
+
+  CbrHelper cbr ("ns3::UdpSocketFactory", Address (InetSocketAddress (helper->GetUserAddress (gwUsers.Get (0)), port)));
+  cbr.SetAttribute ("Interval", StringValue ("10ms"));
+  cbr.SetAttribute ("PacketSize", UintegerValue (20) );
+
+  ApplicationContainer utApps = cbr.Install (helper->GetUtUsers ());
+  utApps.Start (Seconds (0.1));
+  utApps.Stop (Seconds (5.0));
+
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", Address (InetSocketAddress (helper->GetUserAddress (gwUsers.Get (0)), port)));
+
+  ApplicationContainer gwApps = sink.Install (gwUsers);
+  gwApps.Start (Seconds (0.1));
+  gwApps.Stop (Seconds (5.5));
+
+  Simulator::Stop (Seconds (5.5));
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+
+  // number of frames having given number of unique payloads
+  std::map<uint32_t, uint32_t> framesPerPayloadCount;
+  uint64_t simPackets (0);
+  uint64_t simLostPackets (0);
+
+  for (std::map<std::pair<std::string, int64_t>, std::pair<uint32_t, uint32_t> >::const_iterator it = m_frames.begin (); it != m_frames.end (); ++it)
+    {
+      ++framesPerPayloadCount[it->second.first];
+      simPackets += it->second.first;
+      simLostPackets += it->second.second;
+    }
+
+  NS_TEST_ASSERT_MSG_GT (simPackets, (uint64_t) 1000, "Too few CRDSA payloads received");
+
+  Ptr<SatRandomAccessMonteCarloHelper> monteCarlo = CreateObject<SatRandomAccessMonteCarloHelper> ();
+  monteCarlo->SetAttribute ("SlotsPerFrame", UintegerValue (slots));
+  monteCarlo->SetAttribute ("Replicas", UintegerValue (3));
+  monteCarlo->SetAttribute ("CollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_ALWAYS_DROP_ALL_COLLIDING_PACKETS));
+  monteCarlo->SetAttribute ("MeanEsNoDb", DoubleValue (20.0));
+
+  double mcLostPackets (0.0);
+
+  for (std::map<uint32_t, uint32_t>::const_iterator it = framesPerPayloadCount.begin (); it != framesPerPayloadCount.end (); ++it)
+    {
+      SatRandomAccessMonteCarloHelper::loadPointResult_s result = monteCarlo->RunFixedPacketCount (it->first, 10 * it->second);
+      mcLostPackets += result.packetLossRatio * it->first * it->second;
+    }
+
+  double simPlr = (double) simLostPackets / simPackets;
+  double mcPlr = mcLostPackets / simPackets;
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (mcPlr, simPlr, 0.05, "Packet loss ratios of the Monte-Carlo and the full simulation differ");
+
+  monteCarlo->Dispose ();
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
+/**
+ * \ingroup satellite
+ * \brief Test suite for the random access Monte-Carlo simulator.
+ */
+class SatRandomAccessMonteCarloTestSuite : public TestSuite
+{
+public:
+  SatRandomAccessMonteCarloTestSuite ();
+};
+
+SatRandomAccessMonteCarloTestSuite::SatRandomAccessMonteCarloTestSuite ()
+  : TestSuite ("sat-random-access-monte-carlo-test", UNIT)
+{
+  AddTestCase (new SatRaMonteCarloSlottedAlohaTestCase, TestCase::QUICK);
+  AddTestCase (new SatRaMonteCarloReconfigurationTestCase, TestCase::QUICK);
+  AddTestCase (new SatRaMonteCarloParallelTestCase, TestCase::QUICK);
+  AddTestCase (new SatRaMonteCarloConsistencyTestCase (20), TestCase::EXTENSIVE);
+  AddTestCase (new SatRaMonteCarloConsistencyTestCase (60), TestCase::EXTENSIVE);
+}
+
+// Allocate an instance of this TestSuite
+static SatRandomAccessMonteCarloTestSuite satRandomAccessMonteCarloTestSuite;
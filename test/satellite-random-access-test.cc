@@ -27,7 +27,12 @@
  * defined in TN6.
  */
 
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
 #include "ns3/string.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/packet-sink-helper.h"
 #include "ns3/packet-sink.h"
 #include "ns3/test.h"
@@ -333,6 +338,246 @@ SatSlottedAlohaTest1::DoRun (void)
   // <<< End of actual test using Simple scenario <<<
 }
 
+/**
+ * \ingroup satellite
+ * \brief 'CRDSA, parallel frame processing' test case implementation.
+ *
+ * This case tests that the parallel processing of the CRDSA frames of the carriers
+ * ending at the same time gives the same results as the sequential processing.
+ *  1.  User defined scenario with two beams is set with helper, using CRDSA only,
+ *      SINR based collision model and saturated CBR traffic.
+ *  2.  The scenario is simulated with sequential and with parallel frame processing.
+ *  3.  The CRDSA unique payloads are collected from the CrdsaUniquePayloadRx trace of the GWs.
+ *      The unique payloads and the replicas from the CrdsaReplicaRx trace of the GWs are
+ *      collected into one sequence of reception events.
+ *
+ *  Expected result:
+ *    The frames of several carriers end at the same time. The received unique payloads,
+ *    their error flags and their delivery order are identical in both simulations. The
+ *    sequences of the reception events are identical in both simulations, i.e. the
+ *    payloads are delivered in the same order relative to the other events.
+ */
+class SatCrdsaParallelFrameProcessingTest : public TestCase
+{
+public:
+  SatCrdsaParallelFrameProcessingTest ();
+  virtual ~SatCrdsaParallelFrameProcessingTest ();
+
+  /**
+   * \brief Callback for the CrdsaUniquePayloadRx trace
+   * \param context Trace context identifying the carrier
+   * \param nPackets Number of upper layer packets in the payload
+   * \param address Address of the sender
+   * \param error Has the payload been lost
+   */
+  void UniquePayloadRx (std::string context, uint32_t nPackets, const Address &address, bool error);
+
+  /**
+   * \brief Callback for the CrdsaReplicaRx trace
+   * \param context Trace context identifying the carrier
+   * \param nPackets Number of upper layer packets in the replica
+   * \param address Address of the sender
+   * \param collision Has the replica collided
+   */
+  void ReplicaRx (std::string context, uint32_t nPackets, const Address &address, bool collision);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Simulate the scenario and collect the received unique payloads
+   * \param threads Number of threads processing the CRDSA frames
+   * \param events Received unique payloads and replicas in the order of the reception events
+   * \return Received unique payloads in the order of the delivery
+   */
+  std::vector<std::string> Simulate (uint32_t threads, std::vector<std::string>& events);
+
+  std::vector<std::string> m_payloads;
+  std::vector<std::string> m_events;
+  std::map<Address, uint32_t> m_senders;
+};
+
+SatCrdsaParallelFrameProcessingTest::SatCrdsaParallelFrameProcessingTest ()
+  : TestCase ("'CRDSA, parallel frame processing' case tests that the CRDSA frames of the carriers processed in parallel give the same results as the sequential processing.")
+{
+}
+
+SatCrdsaParallelFrameProcessingTest::~SatCrdsaParallelFrameProcessingTest ()
+{
+}
+
+void
+SatCrdsaParallelFrameProcessingTest::UniquePayloadRx (std::string context, uint32_t nPackets, const Address &address, bool error)
+{
+  // the MAC addresses differ between the simulations, thus the senders are numbered in the order of appearance
+  std::map<Address, uint32_t>::iterator it = m_senders.insert (std::make_pair (address, m_senders.size ())).first;
+
+  std::ostringstream payload;
+  payload << Simulator::Now ().GetInteger () << " " << context << " " << it->second << " " << nPackets << " " << error;
+
+  m_payloads.push_back (payload.str ());
+  m_events.push_back ("payload " + payload.str ());
+}
+
+void
+SatCrdsaParallelFrameProcessingTest::ReplicaRx (std::string context, uint32_t nPackets, const Address &address, bool collision)
+{
+  std::map<Address, uint32_t>::iterator it = m_senders.insert (std::make_pair (address, m_senders.size ())).first;
+
+  std::ostringstream replica;
+  replica << "replica " << Simulator::Now ().GetInteger () << " " << context << " " << it->second << " " << nPackets << " " << collision;
+
+  m_events.push_back (replica.str ());
+}
+
+std::vector<std::string>
+SatCrdsaParallelFrameProcessingTest::Simulate (uint32_t threads, std::vector<std::string>& events)
+{
+  // Both simulations draw the same random values
+  RngSeedManager::ResetNextStreamIndex ();
+
+  Config::SetDefault ("ns3::SatPhyRxCarrierPerFrame::ParallelFrameProcessingThreads", UintegerValue (threads));
+
+  Ptr<SatHelper> helper = CreateObject<SatHelper> ("Scenario72");
+
+  SatBeamUserInfo beamInfo = SatBeamUserInfo (30, 1);
+  std::map<uint32_t, SatBeamUserInfo > beamMap;
+  beamMap[1] = beamInfo;
+  beamMap[2] = beamInfo;
+  beamMap[3] = beamInfo;
+
+  helper->CreateUserDefinedScenario (beamMap);
+
+  Config::Connect ("/NodeList/*/DeviceList/*/SatPhy/PhyRx/RxCarrierList/*/$ns3::SatPhyRxCarrierPerFrame/CrdsaUniquePayloadRx",
+                   MakeCallback (&SatCrdsaParallelFrameProcessingTest::UniquePayloadRx, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/SatPhy/PhyRx/RxCarrierList/*/$ns3::SatPhyRxCarrierPerFrame/CrdsaReplicaRx",
+                   MakeCallback (&SatCrdsaParallelFrameProcessingTest::ReplicaRx, this));
+
+  NodeContainer gwUsers = helper->GetGwUsers ();
+  uint16_t port = 9;
+
+  CbrHelper cbr ("ns3::UdpSocketFactory", Address (InetSocketAddress (helper->GetUserAddress (gwUsers.Get (0)), port)));
+  cbr.SetAttribute ("Interval", StringValue ("10ms"));
+  cbr.SetAttribute ("PacketSize", UintegerValue (20) );
+
+  ApplicationContainer utApps = cbr.Install (helper->GetUtUsers ());
+  utApps.Start (Seconds (0.1));
+  utApps.Stop (Seconds (2.0));
+
+  PacketSinkHelper sink ("ns3::UdpSocketFactory", Address (InetSocketAddress (helper->GetUserAddress (gwUsers.Get (0)), port)));
+
+  ApplicationContainer gwApps = sink.Install (gwUsers);
+  gwApps.Start (Seconds (0.1));
+  gwApps.Stop (Seconds (2.5));
+
+  Simulator::Stop (Seconds (2.5));
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+
+  std::vector<std::string> payloads;
+  payloads.swap (m_payloads);
+  events.clear ();
+  events.swap (m_events);
+  m_senders.clear ();
+
+  return payloads;
+}
+
+void
+SatCrdsaParallelFrameProcessingTest::DoRun (void)
+{
+  // Set simulation output details
+  Singleton<SatEnvVariables>::Get ()->DoInitialize ();
+  Singleton<SatEnvVariables>::Get ()->SetOutputVariables ("test-sat-random-access", "crdsaParallel", true);
+
+  // Enable CRDSA only with SINR based collision model
+  Config::SetDefault ("ns3::SatGwHelper::RtnLinkErrorModel", EnumValue (SatPhyRxCarrierConf::EM_AVI));
+  Config::SetDefault ("ns3::SatBeamHelper::RandomAccessModel", EnumValue (SatEnums::RA_MODEL_CRDSA));
+  Config::SetDefault ("ns3::SatBeamHelper::RaInterferenceModel", EnumValue (SatPhyRxCarrierConf::IF_PER_PACKET));
+  Config::SetDefault ("ns3::SatBeamHelper::RaCollisionModel", EnumValue (SatPhyRxCarrierConf::RA_COLLISION_CHECK_AGAINST_SINR));
+  Config::SetDefault ("ns3::SatBeamScheduler::ControlSlotsEnabled", BooleanValue (false));
+  Config::SetDefault ("ns3::SatPhyRxCarrierConf::EnableRandomAccessDynamicLoadControl", BooleanValue (false));
+
+  // Transmit whenever there is data
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_MaximumUniquePayloadPerBlock", UintegerValue (1));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_MaximumConsecutiveBlockAccessed", UintegerValue (1000));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_MinimumIdleBlock", UintegerValue (0));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_BackOffProbability", UintegerValue (1));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_HighLoadBackOffProbability", UintegerValue (1));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::RaService0_NumberOfInstances", UintegerValue (3));
+
+  // Disable CRA and DA
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService0_ConstantAssignmentProvided", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService1_ConstantAssignmentProvided", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService2_ConstantAssignmentProvided", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService3_ConstantAssignmentProvided", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService0_RbdcAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService1_RbdcAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService2_RbdcAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService3_RbdcAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService0_VolumeAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService1_VolumeAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService2_VolumeAllowed", BooleanValue (false));
+  Config::SetDefault ("ns3::SatLowerLayerServiceConf::DaService3_VolumeAllowed", BooleanValue (false));
+
+  std::vector<std::string> sequentialEvents;
+  std::vector<std::string> parallelEvents;
+  std::vector<std::string> sequential = Simulate (1, sequentialEvents);
+  std::vector<std::string> parallel = Simulate (4, parallelEvents);
+
+  // number of carriers delivering payloads at each time
+  std::map<std::string, std::set<std::string> > carriersPerTime;
+  uint32_t errors (0);
+
+  for (uint32_t i = 0; i < parallel.size (); ++i)
+    {
+      std::istringstream payload (parallel[i]);
+      std::string time, context;
+      uint32_t sender, nPackets;
+      bool error;
+
+      payload >> time >> context >> sender >> nPackets >> error;
+      carriersPerTime[time].insert (context);
+
+      if (error)
+        {
+          ++errors;
+        }
+    }
+
+  uint32_t parallelFrameEnds (0);
+
+  for (std::map<std::string, std::set<std::string> >::const_iterator it = carriersPerTime.begin (); it != carriersPerTime.end (); ++it)
+    {
+      if (it->second.size () > 1)
+        {
+          ++parallelFrameEnds;
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_GT (sequential.size (), 1000, "Too few CRDSA payloads received");
+  NS_TEST_ASSERT_MSG_GT (parallelFrameEnds, 0, "No frames of several carriers processed at the same time");
+  NS_TEST_ASSERT_MSG_GT (errors, 0, "No CRDSA payloads lost");
+  NS_TEST_ASSERT_MSG_LT (errors, parallel.size (), "All CRDSA payloads lost");
+  NS_TEST_ASSERT_MSG_EQ (parallel.size (), sequential.size (), "Different number of CRDSA payloads received");
+
+  for (uint32_t i = 0; i < parallel.size () && i < sequential.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (parallel[i], sequential[i], "CRDSA payload received differently or in different order");
+    }
+
+  NS_TEST_ASSERT_MSG_GT (sequentialEvents.size (), sequential.size (), "No CRDSA replicas received");
+  NS_TEST_ASSERT_MSG_EQ (parallelEvents.size (), sequentialEvents.size (), "Different number of CRDSA reception events");
+
+  for (uint32_t i = 0; i < parallelEvents.size () && i < sequentialEvents.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (parallelEvents[i], sequentialEvents[i], "CRDSA reception events in different order");
+    }
+
+  Singleton<SatEnvVariables>::Get ()->DoDispose ();
+}
+
 // The TestSuite class names the TestSuite as sat-random-access-test, identifies what type of TestSuite (SYSTEM),
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -349,6 +594,8 @@ SatRandomAccessTestSuite::SatRandomAccessTestSuite ()
   AddTestCase (new SatCrdsaTest1, TestCase::QUICK);
 
   AddTestCase (new SatSlottedAlohaTest1, TestCase::QUICK);
+
+  AddTestCase (new SatCrdsaParallelFrameProcessingTest, TestCase::EXTENSIVE);
 }
 
 // Allocate an instance of this TestSuite
@@ -0,0 +1,408 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include "ns3/log.h"
+#include "ns3/fatal-error.h"
+#include "satellite-binary-trace-file.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatBinaryTraceFile");
+
+namespace ns3 {
+
+const char SatBinaryTraceFile::FILE_MAGIC[8] = {'S', 'A', 'T', 'B', 'T', 'R', 'C', '\0'};
+const double SatBinaryTraceFile::TIME_TICKS_PER_SECOND = 1e9;
+
+bool
+SatBinaryTraceFile::ReadHeader (std::istream& stream, FileHeader_s& header)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  stream.read ((char *)(&header), sizeof (header));
+
+  return stream.good ()
+         && memcmp (header.m_magic, FILE_MAGIC, sizeof (FILE_MAGIC)) == 0
+         && header.m_version == FILE_VERSION
+         && header.m_nColumns > 0
+         && header.m_valueType <= FLOAT64;
+}
+
+bool
+SatBinaryTraceFile::IsBinaryTraceFile (std::string filePathName)
+{
+  NS_LOG_FUNCTION (filePathName);
+
+  std::ifstream ifs (filePathName.c_str (), std::ifstream::in | std::ifstream::binary);
+  FileHeader_s header;
+
+  return ifs.is_open () && ReadHeader (ifs, header);
+}
+
+bool
+SatBinaryTraceFile::HasMatchingHeader (std::string filePathName, uint32_t nColumns, ValueType_t valueType, bool deltaTime)
+{
+  NS_LOG_FUNCTION (filePathName << nColumns << valueType << deltaTime);
+
+  std::ifstream ifs (filePathName.c_str (), std::ifstream::in | std::ifstream::binary);
+  FileHeader_s header;
+
+  return ifs.is_open () && ReadHeader (ifs, header)
+         && header.m_nColumns == nColumns
+         && header.m_valueType == static_cast<uint32_t> (valueType)
+         && header.m_deltaTime == (deltaTime ? 1u : 0u);
+}
+
+void
+SatBinaryTraceFile::WriteHeader (std::ostream& stream, uint32_t nColumns, ValueType_t valueType, bool deltaTime)
+{
+  NS_LOG_FUNCTION (nColumns << valueType << deltaTime);
+
+  FileHeader_s header;
+  memset (&header, 0, sizeof (header));
+  memcpy (header.m_magic, FILE_MAGIC, sizeof (FILE_MAGIC));
+  header.m_version = FILE_VERSION;
+  header.m_nColumns = nColumns;
+  header.m_valueType = valueType;
+  header.m_deltaTime = deltaTime ? 1 : 0;
+
+  stream.write ((const char *)(&header), sizeof (header));
+}
+
+void
+SatBinaryTraceFile::AppendDeltaTime (std::string& buffer, int64_t delta)
+{
+  // Zigzag encoding keeps the small negative deltas short as well
+  uint64_t value = (static_cast<uint64_t> (delta) << 1) ^ static_cast<uint64_t> (delta >> 63);
+
+  while (value >= 0x80)
+    {
+      buffer.push_back (static_cast<char> ((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+  buffer.push_back (static_cast<char> (value));
+}
+
+bool
+SatBinaryTraceFile::DecodeDeltaTimes (const char* data, size_t size, double* values, uint32_t nRows)
+{
+  size_t position = 0;
+  int64_t ticks = 0;
+
+  for (uint32_t i = 0; i < nRows; i++)
+    {
+      uint64_t value = 0;
+      uint32_t shift = 0;
+      uint8_t byte;
+
+      do
+        {
+          if (position == size || shift > 63)
+            {
+              return false;
+            }
+
+          byte = static_cast<uint8_t> (data[position++]);
+          value |= static_cast<uint64_t> (byte & 0x7f) << shift;
+          shift += 7;
+        }
+      while (byte & 0x80);
+
+      ticks += static_cast<int64_t> (value >> 1) ^ -static_cast<int64_t> (value & 1);
+      values[i] = ticks / TIME_TICKS_PER_SECOND;
+    }
+
+  return position == size;
+}
+
+void
+SatBinaryTraceFile::AppendBlock (std::string& buffer, const std::vector<double>& rows,
+                                 uint32_t nColumns, ValueType_t valueType, bool deltaTime)
+{
+  NS_LOG_FUNCTION (rows.size () << nColumns << valueType << deltaTime);
+
+  if (nColumns == 0 || rows.size () % nColumns != 0)
+    {
+      NS_FATAL_ERROR ("SatBinaryTraceFile::AppendBlock - Invalid number of values");
+    }
+
+  BlockHeader_s blockHeader;
+  blockHeader.m_nRows = rows.size () / nColumns;
+  blockHeader.m_timeBytes = 0;
+
+  if (blockHeader.m_nRows == 0)
+    {
+      return;
+    }
+
+  size_t headerOffset = buffer.size ();
+  buffer.resize (headerOffset + sizeof (blockHeader));
+
+  // Time column
+  size_t timeOffset = buffer.size ();
+
+  if (deltaTime)
+    {
+      int64_t previousTicks = 0;
+
+      for (uint32_t i = 0; i < blockHeader.m_nRows; i++)
+        {
+          int64_t ticks = static_cast<int64_t> (std::floor (rows[i * nColumns] * TIME_TICKS_PER_SECOND + 0.5));
+          AppendDeltaTime (buffer, ticks - previousTicks);
+          previousTicks = ticks;
+        }
+    }
+  else
+    {
+      buffer.resize (timeOffset + blockHeader.m_nRows * sizeof (double));
+
+      for (uint32_t i = 0; i < blockHeader.m_nRows; i++)
+        {
+          memcpy (&buffer[timeOffset + i * sizeof (double)], &rows[i * nColumns], sizeof (double));
+        }
+    }
+
+  blockHeader.m_timeBytes = buffer.size () - timeOffset;
+  memcpy (&buffer[headerOffset], &blockHeader, sizeof (blockHeader));
+
+  // Value columns
+  size_t valueSize = (valueType == FLOAT32) ? sizeof (float) : sizeof (double);
+  size_t offset = buffer.size ();
+
+  buffer.resize (offset + blockHeader.m_nRows * (nColumns - 1) * valueSize);
+
+  for (uint32_t j = 1; j < nColumns; j++)
+    {
+      for (uint32_t i = 0; i < blockHeader.m_nRows; i++)
+        {
+          double value = rows[i * nColumns + j];
+
+          if (valueType == FLOAT32)
+            {
+              float floatValue = value;
+              memcpy (&buffer[offset], &floatValue, sizeof (float));
+            }
+          else
+            {
+              memcpy (&buffer[offset], &value, sizeof (double));
+            }
+          offset += valueSize;
+        }
+    }
+}
+
+void
+SatBinaryTraceFile::ReadFile (std::string filePathName, uint32_t nColumns,
+                              std::vector<std::vector<double> >& columns)
+{
+  NS_LOG_FUNCTION (filePathName << nColumns);
+
+  std::ifstream ifs (filePathName.c_str (), std::ifstream::in | std::ifstream::binary);
+
+  if (!ifs.is_open ())
+    {
+      NS_FATAL_ERROR ("The file " << filePathName << " is not found.");
+    }
+
+  FileHeader_s header;
+
+  if (!ReadHeader (ifs, header))
+    {
+      NS_FATAL_ERROR ("The file " << filePathName << " is not a valid binary trace file.");
+    }
+
+  if (header.m_nColumns != nColumns)
+    {
+      NS_FATAL_ERROR ("The file " << filePathName << " has " << header.m_nColumns << " columns, expected " << nColumns);
+    }
+
+  columns.clear ();
+  columns.resize (nColumns);
+
+  BlockHeader_s blockHeader;
+  std::vector<float> floatValues;
+  std::vector<char> timeBytes;
+
+  while (ifs.read ((char *)(&blockHeader), sizeof (blockHeader)))
+    {
+      uint32_t nRows = blockHeader.m_nRows;
+      size_t offset = columns[0].size ();
+
+      if (nRows == 0)
+        {
+          continue;
+        }
+
+      if (!header.m_deltaTime && blockHeader.m_timeBytes != nRows * sizeof (double))
+        {
+          NS_FATAL_ERROR ("The file " << filePathName << " has an invalid block.");
+        }
+
+      for (uint32_t j = 0; j < nColumns; j++)
+        {
+          columns[j].resize (offset + nRows);
+          double* values = &columns[j][offset];
+
+          if (j == 0 && header.m_deltaTime)
+            {
+              timeBytes.resize (blockHeader.m_timeBytes);
+
+              if (!timeBytes.empty ())
+                {
+                  ifs.read (&timeBytes[0], timeBytes.size ());
+                }
+
+              if (ifs.good () && !DecodeDeltaTimes (timeBytes.empty () ? NULL : &timeBytes[0], timeBytes.size (), values, nRows))
+                {
+                  NS_FATAL_ERROR ("The file " << filePathName << " has an invalid block.");
+                }
+            }
+          else if (j > 0 && header.m_valueType == FLOAT32)
+            {
+              floatValues.resize (nRows);
+              ifs.read ((char *)(&floatValues[0]), nRows * sizeof (float));
+
+              for (uint32_t i = 0; i < nRows; i++)
+                {
+                  values[i] = floatValues[i];
+                }
+            }
+          else
+            {
+              ifs.read ((char *)(values), nRows * sizeof (double));
+            }
+
+          if (!ifs.good ())
+            {
+              NS_FATAL_ERROR ("The file " << filePathName << " is truncated.");
+            }
+        }
+    }
+}
+
+void
+SatBinaryTraceFile::ConvertTextToBinary (std::string textFilePathName, std::string binaryFilePathName,
+                                         uint32_t nColumns, ValueType_t valueType, bool deltaTime)
+{
+  NS_LOG_FUNCTION (textFilePathName << binaryFilePathName << nColumns << valueType << deltaTime);
+
+  std::ifstream ifs (textFilePathName.c_str (), std::ifstream::in);
+
+  if (!ifs.is_open ())
+    {
+      NS_FATAL_ERROR ("The file " << textFilePathName << " is not found.");
+    }
+
+  std::ofstream ofs (binaryFilePathName.c_str (), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+  if (!ofs.is_open ())
+    {
+      NS_FATAL_ERROR ("The file " << binaryFilePathName << " cannot be opened for writing.");
+    }
+
+  WriteHeader (ofs, nColumns, valueType, deltaTime);
+
+  std::vector<double> rows;
+  std::string block;
+  double value;
+
+  rows.reserve (MAX_ROWS_IN_BLOCK * nColumns);
+
+  while (ifs >> value)
+    {
+      rows.push_back (value);
+
+      if (rows.size () == MAX_ROWS_IN_BLOCK * nColumns)
+        {
+          AppendBlock (block, rows, nColumns, valueType, deltaTime);
+          ofs.write (block.data (), block.size ());
+          block.clear ();
+          rows.clear ();
+        }
+    }
+
+  if (rows.size () % nColumns != 0)
+    {
+      NS_FATAL_ERROR ("The file " << textFilePathName << " has an incomplete row.");
+    }
+
+  AppendBlock (block, rows, nColumns, valueType, deltaTime);
+  ofs.write (block.data (), block.size ());
+
+  if (!ofs.good ())
+    {
+      NS_FATAL_ERROR ("Writing the file " << binaryFilePathName << " failed.");
+    }
+
+  ofs.close ();
+}
+
+void
+SatBinaryTraceFile::ConvertBinaryToText (std::string binaryFilePathName, std::string textFilePathName)
+{
+  NS_LOG_FUNCTION (binaryFilePathName << textFilePathName);
+
+  std::ifstream ifs (binaryFilePathName.c_str (), std::ifstream::in | std::ifstream::binary);
+  FileHeader_s header;
+
+  if (!ifs.is_open () || !ReadHeader (ifs, header))
+    {
+      NS_FATAL_ERROR ("The file " << binaryFilePathName << " is not a valid binary trace file.");
+    }
+
+  ifs.close ();
+
+  std::vector<std::vector<double> > columns;
+  ReadFile (binaryFilePathName, header.m_nColumns, columns);
+
+  std::ofstream ofs (textFilePathName.c_str (), std::ofstream::out | std::ofstream::trunc);
+
+  if (!ofs.is_open ())
+    {
+      NS_FATAL_ERROR ("The file " << textFilePathName << " cannot be opened for writing.");
+    }
+
+  // Same format as written by SatOutputFileStreamDoubleContainer
+  for (uint32_t i = 0; i < columns[0].size (); i++)
+    {
+      for (uint32_t j = 0; j < header.m_nColumns; j++)
+        {
+          if (j + 1 == header.m_nColumns)
+            {
+              ofs << columns[j][i];
+            }
+          else
+            {
+              ofs << columns[j][i] << "\t";
+            }
+        }
+      ofs << "\n";
+    }
+
+  if (!ofs.good ())
+    {
+      NS_FATAL_ERROR ("Writing the file " << textFilePathName << " failed.");
+    }
+
+  ofs.close ();
+}
+
+} // namespace ns3
@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+#ifndef SAT_BINARY_TRACE_FILE_H
+#define SAT_BINARY_TRACE_FILE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Binary columnar format of the time sample trace files, i.e. the
+ * files with rows [time, value1, ..., value n] written by
+ * SatOutputFileStreamDoubleContainer and read by
+ * SatInputFileStreamTimeDoubleContainer.
+ *
+ * The file starts with a fixed header, which is followed by any number
+ * of blocks. A block contains a block header telling the number of rows
+ * in the block, the time column (double) and the value columns (float or
+ * double, as told by the file header) one column after another. The time
+ * column may be delta encoded, in which case the time samples are rounded
+ * to nanoseconds, i.e. the default resolution of the simulation time, and
+ * each sample is stored as a variable length (1-10 bytes) zigzag encoded
+ * difference to the previous sample of the same block. The time samples
+ * of a simulation are stored losslessly in one or a few bytes instead of
+ * eight. Each block is self-contained, thus blocks may be appended to the
+ * file as they are produced. The values are stored in the native byte
+ * order.
+ *
+ * The class also implements the conversion between the binary and the
+ * text trace files.
+ */
+class SatBinaryTraceFile
+{
+public:
+  /**
+   * \brief Type of the stored value columns
+   */
+  typedef enum
+  {
+    FLOAT32 = 0,
+    FLOAT64 = 1
+  } ValueType_t;
+
+  /**
+   * \brief Check whether a file is a binary trace file
+   * \param filePathName path and file name
+   * \return true if the file starts with a valid binary trace file header
+   */
+  static bool IsBinaryTraceFile (std::string filePathName);
+
+  /**
+   * \brief Check whether a binary trace file has the given layout, i.e.
+   * whether blocks of the layout can be appended into the file
+   * \param filePathName path and file name
+   * \param nColumns number of columns including the time column
+   * \param valueType type of the value columns
+   * \param deltaTime is the time column delta encoded
+   * \return true if the file has a valid header matching the layout
+   */
+  static bool HasMatchingHeader (std::string filePathName, uint32_t nColumns, ValueType_t valueType, bool deltaTime);
+
+  /**
+   * \brief Write the file header into a stream
+   * \param stream output stream
+   * \param nColumns number of columns including the time column
+   * \param valueType type of the value columns
+   * \param deltaTime is the time column delta encoded
+   */
+  static void WriteHeader (std::ostream& stream, uint32_t nColumns, ValueType_t valueType, bool deltaTime);
+
+  /**
+   * \brief Encode rows into a block and append the block into a buffer
+   * \param buffer buffer where the block is appended
+   * \param rows values of the rows in row-major order
+   * \param nColumns number of columns including the time column
+   * \param valueType type of the value columns
+   * \param deltaTime is the time column delta encoded
+   */
+  static void AppendBlock (std::string& buffer, const std::vector<double>& rows,
+                           uint32_t nColumns, ValueType_t valueType, bool deltaTime);
+
+  /**
+   * \brief Read all the blocks of a binary trace file
+   * \param filePathName path and file name
+   * \param nColumns expected number of columns including the time column
+   * \param columns read values, one vector per column
+   */
+  static void ReadFile (std::string filePathName, uint32_t nColumns,
+                        std::vector<std::vector<double> >& columns);
+
+  /**
+   * \brief Convert a text trace file into a binary trace file
+   * \param textFilePathName path and file name of the text file
+   * \param binaryFilePathName path and file name of the binary file
+   * \param nColumns number of columns including the time column
+   * \param valueType type of the value columns
+   * \param deltaTime is the time column delta encoded
+   */
+  static void ConvertTextToBinary (std::string textFilePathName, std::string binaryFilePathName,
+                                   uint32_t nColumns, ValueType_t valueType, bool deltaTime);
+
+  /**
+   * \brief Convert a binary trace file into a text trace file
+   * \param binaryFilePathName path and file name of the binary file
+   * \param textFilePathName path and file name of the text file
+   */
+  static void ConvertBinaryToText (std::string binaryFilePathName, std::string textFilePathName);
+
+  /**
+   * \brief Maximum number of rows in a block written by the conversion
+   * and the buffered output containers
+   */
+  static const uint32_t MAX_ROWS_IN_BLOCK = 4096;
+
+private:
+  /**
+   * \brief Header of the binary trace file
+   */
+  typedef struct
+  {
+    char m_magic[8];
+    uint32_t m_version;
+    uint32_t m_nColumns;
+    uint32_t m_valueType;
+    uint32_t m_deltaTime;
+  } FileHeader_s;
+
+  /**
+   * \brief Header of a block
+   */
+  typedef struct
+  {
+    uint32_t m_nRows;
+    uint32_t m_timeBytes;
+  } BlockHeader_s;
+
+  /**
+   * Magic string and version of the binary trace file
+   */
+  static const char FILE_MAGIC[8];
+  static const uint32_t FILE_VERSION = 1;
+
+  /**
+   * \brief Read and validate the file header
+   * \param stream input stream positioned at the beginning of the file
+   * \param header read header
+   * \return false if the header is not valid
+   */
+  static bool ReadHeader (std::istream& stream, FileHeader_s& header);
+
+  /**
+   * \brief Append a delta encoded time sample into a buffer
+   * \param buffer buffer where the encoded bytes are appended
+   * \param delta difference to the previous time sample in nanoseconds
+   */
+  static void AppendDeltaTime (std::string& buffer, int64_t delta);
+
+  /**
+   * \brief Decode the delta encoded time column of a block
+   * \param data encoded bytes
+   * \param size number of the encoded bytes
+   * \param values decoded time samples
+   * \param nRows number of rows in the block
+   * \return false if the encoded bytes do not match the number of rows
+   */
+  static bool DecodeDeltaTimes (const char* data, size_t size, double* values, uint32_t nRows);
+
+  /**
+   * Resolution of the delta encoded time samples
+   */
+  static const double TIME_TICKS_PER_SECOND;
+};
+
+} // namespace ns3
+
+#endif /* SAT_BINARY_TRACE_FILE_H */
@@ -18,10 +18,13 @@
  * Author: Frans Laakso <frans.laakso@magister.fi>
  */
 
+#include <algorithm>
+#include <cmath>
 #include "satellite-input-fstream-time-double-container.h"
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/simulator.h"
+#include "satellite-binary-trace-file.h"
 
 NS_LOG_COMPONENT_DEFINE ("SatInputFileStreamTimeDoubleContainer");
 
@@ -39,7 +42,8 @@ SatInputFileStreamTimeDoubleContainer::GetTypeId (void)
 SatInputFileStreamTimeDoubleContainer::SatInputFileStreamTimeDoubleContainer (std::string filename, std::ios::openmode filemode, uint32_t valuesInRow)
   : m_inputFileStreamWrapper (),
     m_inputFileStream (),
-    m_container (),
+    m_values (),
+    m_rowCount (0),
     m_fileName (filename),
     m_fileMode (filemode),
     m_valuesInRow (valuesInRow),
@@ -56,7 +60,8 @@ SatInputFileStreamTimeDoubleContainer::SatInputFileStreamTimeDoubleContainer (st
 SatInputFileStreamTimeDoubleContainer::SatInputFileStreamTimeDoubleContainer ()
   : m_inputFileStreamWrapper (),
     m_inputFileStream (),
-    m_container (),
+    m_values (),
+    m_rowCount (),
     m_fileName (),
     m_fileMode (),
     m_valuesInRow (),
@@ -96,19 +101,32 @@ SatInputFileStreamTimeDoubleContainer::UpdateContainer (std::string filename, st
   m_fileMode = filemode;
   m_valuesInRow = valuesInRow;
 
+  if (SatBinaryTraceFile::IsBinaryTraceFile (filename))
+    {
+      ReadBinaryFile ();
+      CheckContainerSanity ();
+      return;
+    }
+
   m_inputFileStreamWrapper = new SatInputFileStreamWrapper (filename,filemode);
   m_inputFileStream = m_inputFileStreamWrapper->GetStream ();
 
   if (m_inputFileStream->is_open ())
     {
+      std::vector<std::vector<double> > columns (m_valuesInRow);
       std::vector<double> tempVector = ReadRow ();
 
       while (!m_inputFileStream->eof ())
         {
-          m_container.push_back (tempVector);
+          for (uint32_t i = 0; i < m_valuesInRow; i++)
+            {
+              columns[i].push_back (tempVector[i]);
+            }
           tempVector = ReadRow ();
         }
       m_inputFileStream->close ();
+
+      SetColumns (columns);
     }
   else
     {
@@ -120,6 +138,35 @@ SatInputFileStreamTimeDoubleContainer::UpdateContainer (std::string filename, st
   ResetStream ();
 }
 
+void
+SatInputFileStreamTimeDoubleContainer::ReadBinaryFile ()
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<std::vector<double> > columns;
+  SatBinaryTraceFile::ReadFile (m_fileName, m_valuesInRow, columns);
+
+  SetColumns (columns);
+}
+
+void
+SatInputFileStreamTimeDoubleContainer::SetColumns (const std::vector<std::vector<double> >& columns)
+{
+  NS_LOG_FUNCTION (this);
+
+  NS_ASSERT (columns.size () == m_valuesInRow);
+
+  m_rowCount = m_valuesInRow > 0 ? columns[0].size () : 0;
+  m_values.clear ();
+  m_values.reserve (m_rowCount * m_valuesInRow);
+
+  for (uint32_t i = 0; i < m_valuesInRow; i++)
+    {
+      NS_ASSERT (columns[i].size () == m_rowCount);
+      m_values.insert (m_values.end (), columns[i].begin (), columns[i].end ());
+    }
+}
+
 std::vector<double>
 SatInputFileStreamTimeDoubleContainer::ReadRow ()
 {
@@ -141,29 +188,28 @@ SatInputFileStreamTimeDoubleContainer::CheckContainerSanity ()
 {
   NS_LOG_FUNCTION (this);
 
+  NS_ASSERT (m_timeColumn < m_valuesInRow);
+
   /// check time sample sanity
-  if (m_container.size () < 1)
+  if (m_rowCount < 1)
     {
       NS_FATAL_ERROR ("SatInputFileStreamDoubleContainer::UpdateContainer - Empty file");
     }
-  else if (m_container.size () == 1)
+  else if (m_rowCount == 1)
     {
-      if (m_container[m_container.size () - 1].at (m_timeColumn) == 0)
+      if (GetTime (0) == 0)
         {
           NS_FATAL_ERROR ("SatInputFileStreamDoubleContainer::UpdateContainer - Invalid input file format (time sample error)");
         }
     }
   else
     {
-      double tempValue1 = m_container[0].at (m_timeColumn);
-
-      for (uint32_t i = 1; i < m_container.size (); i++)
+      for (uint32_t i = 1; i < m_rowCount; i++)
         {
-          if (tempValue1 > m_container[i].at (m_timeColumn))
+          if (GetTime (i - 1) > GetTime (i))
             {
               NS_FATAL_ERROR ("SatInputFileStreamDoubleContainer::UpdateContainer - Invalid input file format (time sample error)");
             }
-          tempValue1 = m_container[i].at (m_timeColumn);
         }
     }
 }
@@ -173,22 +219,77 @@ SatInputFileStreamTimeDoubleContainer::ProceedToNextClosestTimeSample ()
 {
   NS_LOG_FUNCTION (this);
 
-  while (!FindNextClosest (m_lastValidPosition,m_timeShiftValue, Now ().GetSeconds ()))
+  LocateNextClosest (Now ().GetSeconds ());
+
+  std::vector<double> row (m_valuesInRow);
+
+  for (uint32_t i = 0; i < m_valuesInRow; i++)
+    {
+      row[i] = GetValue (m_lastValidPosition, i);
+    }
+  return row;
+}
+
+double
+SatInputFileStreamTimeDoubleContainer::ProceedToNextClosestTimeSampleValue (uint32_t column)
+{
+  NS_LOG_FUNCTION (this << column);
+
+  if (column >= m_valuesInRow)
+    {
+      NS_FATAL_ERROR ("SatInputFileStreamDoubleContainer::ProceedToNextClosestTimeSampleValue - Invalid column " << column);
+    }
+
+  LocateNextClosest (Now ().GetSeconds ());
+
+  return GetValue (m_lastValidPosition, column);
+}
+
+void
+SatInputFileStreamTimeDoubleContainer::LocateNextClosest (double comparisonTimeValue)
+{
+  NS_LOG_FUNCTION (this << comparisonTimeValue);
+
+  if (FindNextClosest (m_lastValidPosition, m_timeShiftValue, comparisonTimeValue))
     {
-      m_lastValidPosition = 0;
-      m_numOfPasses++;
-      m_timeShiftValue = m_numOfPasses * m_container[m_container.size () - 1].at (m_timeColumn);
+      return;
+    }
+
+  /**
+   * The time is beyond the samples of the current pass. The samples of pass
+   * k cover the times up to the last time sample shifted by k times the
+   * last time sample, thus the first pass covering the time is calculated
+   * directly instead of looping the passes one by one.
+   */
+  double lastTime = GetTime (m_rowCount - 1);
 
-      NS_LOG_INFO ("Looping samples again with shift value: " << m_timeShiftValue);
+  if (!(lastTime > 0))
+    {
+      NS_FATAL_ERROR ("SatInputFileStreamDoubleContainer::LocateNextClosest - Unable to loop samples of " << m_fileName << " (time sample error)");
     }
 
-  if (m_numOfPasses > 0)
+  uint32_t numOfPasses = std::max<double> (m_numOfPasses + 1, std::ceil (comparisonTimeValue / lastTime) - 1);
+
+  // Correct possible rounding errors with the same comparison as FindNextClosest
+  while (lastTime + numOfPasses * lastTime < comparisonTimeValue)
     {
-      std::cout << "WARNING! - SatInputFileStreamDoubleContainer::ProceedToNextClosestTimeSample for " << m_fileName << " is out of samples @ time sample " << Now ().GetSeconds () << " (passes " << m_numOfPasses << ")" << std::endl;
-      std::cout << "The container will loop samples from the beginning." << std::endl;
+      numOfPasses++;
     }
 
-  return m_container[m_lastValidPosition];
+  while (numOfPasses > m_numOfPasses + 1 && lastTime + (numOfPasses - 1) * lastTime >= comparisonTimeValue)
+    {
+      numOfPasses--;
+    }
+
+  m_lastValidPosition = 0;
+  m_numOfPasses = numOfPasses;
+  m_timeShiftValue = m_numOfPasses * lastTime;
+
+  NS_LOG_WARN ("Out of samples in " << m_fileName << " @ time sample " << comparisonTimeValue << ", looping samples again with shift value: " << m_timeShiftValue);
+
+  bool valueFound = FindNextClosest (m_lastValidPosition, m_timeShiftValue, comparisonTimeValue);
+
+  NS_ASSERT (valueFound);
 }
 
 bool
@@ -197,50 +298,88 @@ SatInputFileStreamTimeDoubleContainer::FindNextClosest (uint32_t lastValidPositi
   NS_LOG_FUNCTION (this);
 
   NS_ASSERT (m_timeColumn < m_valuesInRow);
-  NS_ASSERT (m_container.size () > 0);
-  NS_ASSERT (lastValidPosition >= 0 && lastValidPosition < m_container.size ());
+  NS_ASSERT (m_rowCount > 0);
+  NS_ASSERT (lastValidPosition < m_rowCount);
 
   NS_LOG_INFO ("SatInputFileStreamDoubleContainer::FindNextClosest: lastValidPosition " << lastValidPosition << " column " << m_timeColumn << " timeShiftValue " << timeShiftValue << " comparisonTimeValue " << comparisonTimeValue);
 
-  bool valueFound = false;
+  uint32_t lastPosition = m_rowCount - 1;
+
+  if (GetTime (lastPosition) + timeShiftValue < comparisonTimeValue)
+    {
+      NS_LOG_INFO ("Done: 0 comparison time value: " << comparisonTimeValue << " passes: " << m_numOfPasses);
+      return false;
+    }
+
+  /**
+   * Find the first position from the last valid position onwards with time
+   * sample at or after the comparison time. The current and the next
+   * position are checked first, then the step is doubled until the time is
+   * passed and finally the position is binary searched between the last
+   * two steps.
+   */
+  uint32_t position = lastValidPosition;
 
-  for (uint32_t i = lastValidPosition; i < m_container.size (); i++)
+  if (GetTime (position) + timeShiftValue < comparisonTimeValue)
     {
-      if (m_container[i].at (m_timeColumn) + timeShiftValue >= comparisonTimeValue)
+      uint32_t low = lastValidPosition;
+      uint32_t high = lastValidPosition + 1;
+      uint32_t step = 1;
+
+      while (high < lastPosition && GetTime (high) + timeShiftValue < comparisonTimeValue)
+        {
+          low = high;
+          step *= 2;
+          high = std::min (lastValidPosition + step, lastPosition);
+        }
+
+      while (high - low > 1)
         {
-          double difference1 = std::abs (m_container[lastValidPosition].at (m_timeColumn) + timeShiftValue - comparisonTimeValue);
-          double difference2 = std::abs (m_container[i].at (m_timeColumn) + timeShiftValue - comparisonTimeValue);
+          uint32_t middle = low + (high - low) / 2;
 
-          if (difference1 < difference2)
+          if (GetTime (middle) + timeShiftValue >= comparisonTimeValue)
             {
-              m_lastValidPosition = lastValidPosition;
+              high = middle;
             }
           else
             {
-              m_lastValidPosition = i;
+              low = middle;
             }
-          valueFound = true;
-          break;
         }
-      lastValidPosition = i;
+      position = high;
     }
 
-  if (valueFound && m_numOfPasses > 0 && m_lastValidPosition == 0)
+  // Choose the closer one of the found position and the position before it
+  uint32_t previousPosition = position > lastValidPosition ? position - 1 : position;
+
+  double difference1 = std::abs (GetTime (previousPosition) + timeShiftValue - comparisonTimeValue);
+  double difference2 = std::abs (GetTime (position) + timeShiftValue - comparisonTimeValue);
+
+  if (difference1 < difference2)
+    {
+      m_lastValidPosition = previousPosition;
+    }
+  else
     {
-      double difference1 = std::abs (m_container[m_lastValidPosition].at (m_timeColumn) + timeShiftValue - comparisonTimeValue);
-      double difference2 = std::abs (m_container[m_container.size () - 1].at (m_timeColumn) + ((m_numOfPasses - 1) * m_container[m_container.size () - 1].at (m_timeColumn)) - comparisonTimeValue);
+      m_lastValidPosition = position;
+    }
+
+  if (m_numOfPasses > 0 && m_lastValidPosition == 0)
+    {
+      difference1 = std::abs (GetTime (m_lastValidPosition) + timeShiftValue - comparisonTimeValue);
+      difference2 = std::abs (GetTime (lastPosition) + ((m_numOfPasses - 1) * GetTime (lastPosition)) - comparisonTimeValue);
 
       if (difference1 > difference2)
         {
-          m_lastValidPosition = m_container.size () - 1;
+          m_lastValidPosition = lastPosition;
           m_numOfPasses--;
-          m_timeShiftValue = m_numOfPasses * m_container[m_container.size () - 1].at (m_timeColumn);
+          m_timeShiftValue = m_numOfPasses * GetTime (lastPosition);
         }
     }
 
-  NS_LOG_INFO ("Done: " << valueFound << " value: " << m_container[m_lastValidPosition].at (m_timeColumn) << " @ line: " << m_lastValidPosition + 1 << " comparison time value: " << comparisonTimeValue << " passes: " << m_numOfPasses);
+  NS_LOG_INFO ("Done: 1 value: " << GetTime (m_lastValidPosition) << " @ line: " << m_lastValidPosition + 1 << " comparison time value: " << comparisonTimeValue << " passes: " << m_numOfPasses);
 
-  return valueFound;
+  return true;
 }
 
 void
@@ -270,17 +409,8 @@ SatInputFileStreamTimeDoubleContainer::ClearContainer ()
 {
   NS_LOG_FUNCTION (this);
 
-  if (!m_container.empty ())
-    {
-      for (uint32_t i = 0; i < m_container.size (); i++)
-        {
-          if (!m_container[i].empty ())
-            {
-              m_container[i].clear ();
-            }
-        }
-      m_container.clear ();
-    }
+  m_values.clear ();
+  m_rowCount = 0;
 
   m_valuesInRow = 0;
   m_lastValidPosition = 0;
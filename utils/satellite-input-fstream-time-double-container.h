@@ -34,7 +34,18 @@ namespace ns3 {
  * The class implements reading the values from a file, storing the values
  * and iterating the stored values.
  *
- * Row format is [time, value1, ..., value n].
+ * Row format is [time, value1, ..., value n]. The file is either a text
+ * file or a binary file of SatBinaryTraceFile format, which is detected
+ * from the file header.
+ *
+ * The values are stored as contiguous columns. The closest time sample
+ * is searched forward from the previously found sample, first checking
+ * the current and the next sample and then doubling the search step
+ * before a binary search, so that the monotonically advancing simulation
+ * time is served in constant time and jumps in logarithmic time. If the
+ * simulation time exceeds the last time sample, the samples are looped
+ * from the beginning and the needed number of passes is calculated
+ * directly from the time.
  */
 class SatInputFileStreamTimeDoubleContainer : public Object
 {
@@ -77,6 +88,13 @@ public:
    */
   std::vector<double> ProceedToNextClosestTimeSample ();
 
+  /**
+   * \brief Function for locating the next closest time sample and returning a value related to it
+   * \param column index of the value in the row
+   * \return matching value
+   */
+  double ProceedToNextClosestTimeSampleValue (uint32_t column);
+
   /**
    * \brief Do needed dispose actions
    */
@@ -105,10 +123,31 @@ private:
   std::vector<double> ReadRow ();
 
   /**
-   * \brief Function for locating the next closest value index. This locator loops the samples if the container does not have enough samples. Next closest index value is saved to a separate member variable.
+   * \brief Function for reading the rows from a binary trace file
+   */
+  void ReadBinaryFile ();
+
+  /**
+   * \brief Function for storing the read columns into the container
+   * \param columns values of the columns
+   */
+  void SetColumns (const std::vector<std::vector<double> >& columns);
+
+  /**
+   * \brief Function for locating the next closest time sample and updating
+   * the last valid position, the number of passes and the time shift value
+   * accordingly
+   * \param comparisonTimeValue value which next closest match to find
+   */
+  void LocateNextClosest (double comparisonTimeValue);
+
+  /**
+   * \brief Function for locating the next closest value index within the
+   * current pass. Next closest index value is saved to a separate member
+   * variable.
    * \param lastValidPosition position of last matching value
-   * \param shiftValue value to shift the time if needed
-   * \param comparisonValue value which next closest match to find
+   * \param timeShiftValue value to shift the time
+   * \param comparisonTimeValue value which next closest match to find
    * \return was next time sample found
    */
   bool FindNextClosest (uint32_t lastValidPosition, double timeShiftValue, double comparisonTimeValue);
@@ -118,6 +157,27 @@ private:
    */
   void CheckContainerSanity ();
 
+  /**
+   * \brief Get a stored value
+   * \param row row index
+   * \param column column index
+   * \return value
+   */
+  inline double GetValue (uint32_t row, uint32_t column) const
+  {
+    return m_values[column * m_rowCount + row];
+  }
+
+  /**
+   * \brief Get a time sample
+   * \param row row index
+   * \return time sample
+   */
+  inline double GetTime (uint32_t row) const
+  {
+    return m_values[m_timeColumn * m_rowCount + row];
+  }
+
   /**
    * \brief Pointer to input file stream wrapper
    */
@@ -129,9 +189,14 @@ private:
   std::ifstream* m_inputFileStream;
 
   /**
-   * \brief Container for value rows
+   * \brief Stored values, one column after another
+   */
+  std::vector<double> m_values;
+
+  /**
+   * \brief Number of stored rows
    */
-  std::vector<std::vector<double> > m_container;
+  uint32_t m_rowCount;
 
   /**
    * \brief File name
@@ -22,17 +22,51 @@
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/simulator.h"
+#include "ns3/singleton.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+#include "satellite-output-fstream-writer.h"
 
 NS_LOG_COMPONENT_DEFINE ("SatOutputFileStreamDoubleContainer");
 
 namespace ns3 {
 
+NS_OBJECT_ENSURE_REGISTERED (SatOutputFileStreamDoubleContainer);
+
 TypeId
 SatOutputFileStreamDoubleContainer::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::SatOutputFileStreamDoubleContainer")
     .SetParent<Object> ()
-    .AddConstructor<SatOutputFileStreamDoubleContainer> ();
+    .AddConstructor<SatOutputFileStreamDoubleContainer> ()
+    .AddAttribute ("StreamingMode",
+                   "Write the values into the file during the simulation instead of storing them until the end.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SatOutputFileStreamDoubleContainer::m_streamingMode),
+                   MakeBooleanChecker ())
+    .AddAttribute ("StreamBufferSize",
+                   "Size of the buffer in bytes collecting the rows before they are written in the streaming mode.",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&SatOutputFileStreamDoubleContainer::m_streamBufferSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("FileFormat",
+                   "Format of the written file.",
+                   EnumValue (SatOutputFileStreamDoubleContainer::TEXT_FILE),
+                   MakeEnumAccessor (&SatOutputFileStreamDoubleContainer::m_fileFormat),
+                   MakeEnumChecker (SatOutputFileStreamDoubleContainer::TEXT_FILE, "Text",
+                                    SatOutputFileStreamDoubleContainer::BINARY_FILE, "Binary"))
+    .AddAttribute ("BinaryValueType",
+                   "Type of the value columns in the binary file format. The time column is always stored as double.",
+                   EnumValue (SatBinaryTraceFile::FLOAT64),
+                   MakeEnumAccessor (&SatOutputFileStreamDoubleContainer::m_binaryValueType),
+                   MakeEnumChecker (SatBinaryTraceFile::FLOAT32, "Float32",
+                                    SatBinaryTraceFile::FLOAT64, "Float64"))
+    .AddAttribute ("BinaryDeltaTime",
+                   "Delta encode the time column with nanosecond resolution in the binary file format.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SatOutputFileStreamDoubleContainer::m_binaryDeltaTime),
+                   MakeBooleanChecker ());
   return tid;
 }
 
@@ -45,7 +79,15 @@ SatOutputFileStreamDoubleContainer::SatOutputFileStreamDoubleContainer (std::str
     m_valuesInRow (valuesInRow),
     m_printFigure (false),
     m_figureUnitConversionType (RAW),
-    m_style (Gnuplot2dDataset::LINES)
+    m_style (Gnuplot2dDataset::LINES),
+    m_streamingMode (false),
+    m_streamBufferSize (65536),
+    m_streamBuffer (),
+    m_streamRows (),
+    m_streamFileCreated (false),
+    m_fileFormat (TEXT_FILE),
+    m_binaryValueType (SatBinaryTraceFile::FLOAT64),
+    m_binaryDeltaTime (false)
 {
   NS_LOG_FUNCTION (this << m_fileName << m_fileMode);
 
@@ -64,7 +106,15 @@ SatOutputFileStreamDoubleContainer::SatOutputFileStreamDoubleContainer ()
     m_valuesInRow (),
     m_printFigure (),
     m_figureUnitConversionType (),
-    m_style ()
+    m_style (),
+    m_streamingMode (),
+    m_streamBufferSize (),
+    m_streamBuffer (),
+    m_streamRows (),
+    m_streamFileCreated (false),
+    m_fileFormat (),
+    m_binaryValueType (),
+    m_binaryDeltaTime ()
 {
   NS_LOG_FUNCTION (this);
   NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::SatOutputFileStreamDoubleContainer - Constructor not in use");
@@ -91,30 +141,39 @@ SatOutputFileStreamDoubleContainer::WriteContainerToFile ()
 {
   NS_LOG_FUNCTION (this);
 
-  OpenStream ();
+  if (m_streamingMode)
+    {
+      if (!m_streamFileCreated)
+        {
+          CreateStreamFile ();
+        }
 
-  if (m_outputFileStream->is_open ())
+      FlushStreamBuffer ();
+      Singleton<SatOutputFileStreamWriter>::Get ()->Flush (m_fileName);
+    }
+  else
     {
-      for (uint32_t i = 0; i < m_container.size (); i++)
+      OpenStream ();
+
+      if (m_outputFileStream->is_open ())
         {
-          for (uint32_t j = 0; j < m_valuesInRow; j++ )
+          if (m_fileFormat == BINARY_FILE)
             {
-              if (j + 1 == m_valuesInRow)
-                {
-                  *m_outputFileStream << m_container[i].at (j);
-                }
-              else
+              WriteContainerToBinaryFile ();
+            }
+          else
+            {
+              for (uint32_t i = 0; i < m_container.size (); i++)
                 {
-                  *m_outputFileStream << m_container[i].at (j) << "\t";
+                  WriteRow (*m_outputFileStream, m_container[i]);
                 }
             }
-          *m_outputFileStream << std::endl;
+          m_outputFileStream->close ();
+        }
+      else
+        {
+          NS_ABORT_MSG ("Output stream " << m_fileName << " is not valid for writing.");
         }
-      m_outputFileStream->close ();
-    }
-  else
-    {
-      NS_ABORT_MSG ("Output stream is not valid for writing.");
     }
 
   if (m_printFigure)
@@ -125,14 +184,51 @@ SatOutputFileStreamDoubleContainer::WriteContainerToFile ()
   Reset ();
 }
 
+void
+SatOutputFileStreamDoubleContainer::WriteContainerToBinaryFile ()
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<double> rows;
+  std::string block;
+
+  rows.reserve (SatBinaryTraceFile::MAX_ROWS_IN_BLOCK * m_valuesInRow);
+
+  for (uint32_t i = 0; i < m_container.size (); i++)
+    {
+      rows.insert (rows.end (), m_container[i].begin (), m_container[i].end ());
+
+      if (rows.size () == SatBinaryTraceFile::MAX_ROWS_IN_BLOCK * m_valuesInRow || i + 1 == m_container.size ())
+        {
+          SatBinaryTraceFile::AppendBlock (block, rows, m_valuesInRow, m_binaryValueType, m_binaryDeltaTime);
+          m_outputFileStream->write (block.data (), block.size ());
+          block.clear ();
+          rows.clear ();
+        }
+    }
+}
+
 void
 SatOutputFileStreamDoubleContainer::PrintFigure ()
 {
   NS_LOG_FUNCTION (this);
 
-  Gnuplot2dDataset dataset = GetGnuplotDataset ();
+  if (m_streamingMode && m_fileFormat == BINARY_FILE)
+    {
+      NS_LOG_WARN ("Figure output is not supported for streamed binary file " << m_fileName);
+      return;
+    }
+
   Gnuplot plot = GetGnuplot ();
-  plot.AddDataset (dataset);
+
+  if (m_streamingMode)
+    {
+      plot.AddDataset (GetGnuplotFunction ());
+    }
+  else
+    {
+      plot.AddDataset (GetGnuplotDataset ());
+    }
 
   std::string plotFileName = m_fileName + ".plt";
   std::ofstream plotFile (plotFileName.c_str ());
@@ -159,7 +255,74 @@ SatOutputFileStreamDoubleContainer::AddToContainer (std::vector<double> newItem)
       NS_FATAL_ERROR ("SatOutputFileStreamDoubleContainer::AddToContainer - Invalid vector size");
     }
 
-  m_container.push_back (newItem);
+  if (m_streamingMode)
+    {
+      if (!m_streamFileCreated)
+        {
+          CreateStreamFile ();
+        }
+
+      if (m_fileFormat == BINARY_FILE)
+        {
+          m_streamRows.insert (m_streamRows.end (), newItem.begin (), newItem.end ());
+
+          if (m_streamRows.size () * sizeof (double) >= m_streamBufferSize)
+            {
+              FlushStreamBuffer ();
+            }
+        }
+      else
+        {
+          WriteRow (m_streamBuffer, newItem);
+
+          if (m_streamBuffer.tellp () >= static_cast<std::streamoff> (m_streamBufferSize))
+            {
+              FlushStreamBuffer ();
+            }
+        }
+    }
+  else
+    {
+      m_container.push_back (newItem);
+    }
+}
+
+void
+SatOutputFileStreamDoubleContainer::WriteRow (std::ostream& stream, const std::vector<double>& row) const
+{
+  for (uint32_t j = 0; j < m_valuesInRow; j++ )
+    {
+      if (j + 1 == m_valuesInRow)
+        {
+          stream << row.at (j);
+        }
+      else
+        {
+          stream << row.at (j) << "\t";
+        }
+    }
+  stream << "\n";
+}
+
+void
+SatOutputFileStreamDoubleContainer::FlushStreamBuffer ()
+{
+  NS_LOG_FUNCTION (this);
+
+  std::string block;
+
+  if (m_fileFormat == BINARY_FILE)
+    {
+      SatBinaryTraceFile::AppendBlock (block, m_streamRows, m_valuesInRow, m_binaryValueType, m_binaryDeltaTime);
+      m_streamRows.clear ();
+    }
+  else
+    {
+      block = m_streamBuffer.str ();
+      m_streamBuffer.str ("");
+    }
+
+  Singleton<SatOutputFileStreamWriter>::Get ()->Write (m_fileName, block);
 }
 
 void
@@ -167,8 +330,56 @@ SatOutputFileStreamDoubleContainer::OpenStream ()
 {
   NS_LOG_FUNCTION (this);
 
-  m_outputFileStreamWrapper = new SatOutputFileStreamWrapper (m_fileName,m_fileMode);
-  m_outputFileStream = m_outputFileStreamWrapper->GetStream ();
+  if (m_fileFormat == BINARY_FILE)
+    {
+      m_outputFileStreamWrapper = new SatOutputFileStreamWrapper (m_fileName, m_fileMode | std::ios::binary);
+      m_outputFileStream = m_outputFileStreamWrapper->GetStream ();
+
+      // The header is written only into an empty file, the blocks can be
+      // appended into an existing file of the same layout
+      m_outputFileStream->seekp (0, std::ios::end);
+
+      if (m_outputFileStream->tellp () == 0)
+        {
+          SatBinaryTraceFile::WriteHeader (*m_outputFileStream, m_valuesInRow, m_binaryValueType, m_binaryDeltaTime);
+        }
+      else if (!SatBinaryTraceFile::HasMatchingHeader (m_fileName, m_valuesInRow, m_binaryValueType, m_binaryDeltaTime))
+        {
+          NS_FATAL_ERROR ("Unable to append into " << m_fileName << ", the file is not a binary trace file with "
+                          << m_valuesInRow << " columns and the same value type and time encoding.");
+        }
+    }
+  else
+    {
+      m_outputFileStreamWrapper = new SatOutputFileStreamWrapper (m_fileName,m_fileMode);
+      m_outputFileStream = m_outputFileStreamWrapper->GetStream ();
+    }
+}
+
+void
+SatOutputFileStreamDoubleContainer::CreateStreamFile ()
+{
+  NS_LOG_FUNCTION (this);
+
+  // The file is created here and kept closed, the writer opens it only
+  // for appending a block, so that the number of open files stays bounded
+  OpenStream ();
+  CloseStream ();
+
+  m_streamFileCreated = true;
+}
+
+void
+SatOutputFileStreamDoubleContainer::CloseStream ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_outputFileStreamWrapper != NULL)
+    {
+      delete m_outputFileStreamWrapper;
+      m_outputFileStreamWrapper = 0;
+    }
+  m_outputFileStream = 0;
 }
 
 void
@@ -185,12 +396,16 @@ SatOutputFileStreamDoubleContainer::ResetStream ()
 {
   NS_LOG_FUNCTION (this);
 
-  if (m_outputFileStreamWrapper != NULL)
+  if (m_streamFileCreated)
     {
-      delete m_outputFileStreamWrapper;
-      m_outputFileStreamWrapper = 0;
+      // The writer may still be writing the file
+      Singleton<SatOutputFileStreamWriter>::Get ()->Flush (m_fileName);
+      m_streamBuffer.str ("");
+      m_streamRows.clear ();
+      m_streamFileCreated = false;
     }
-  m_outputFileStream = 0;
+
+  CloseStream ();
 
   m_fileName = "";
   m_fileMode = std::ofstream::out;
@@ -282,6 +497,96 @@ SatOutputFileStreamDoubleContainer::ConvertValue (double value)
   return -1;
 }
 
+Gnuplot2dFunction
+SatOutputFileStreamDoubleContainer::GetGnuplotFunction ()
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_valuesInRow != 2)
+    {
+      NS_ABORT_MSG ("SatOutputFileStreamDoubleContainer::GetGnuplotFunction - Figure output not implemented for " << m_valuesInRow << " columns.");
+    }
+
+  std::stringstream function;
+  function << "\"" << m_fileName << "\" using 1:";
+
+  switch (m_figureUnitConversionType)
+    {
+    case RAW:
+      {
+        function << "2";
+        break;
+      }
+    case DECIBEL:
+      {
+        function << "(10.0 * log10 ($2))";
+        break;
+      }
+    case DECIBEL_AMPLITUDE:
+      {
+        function << "(20.0 * log10 ($2))";
+        break;
+      }
+    default:
+      {
+        NS_ABORT_MSG ("SatOutputFileStreamDoubleContainer::GetGnuplotFunction - Invalid conversion type.");
+        break;
+      }
+    }
+
+  Gnuplot2dFunction ret (m_title, function.str ());
+
+  switch (m_style)
+    {
+    case Gnuplot2dDataset::LINES:
+      {
+        ret.SetExtra ("with lines");
+        break;
+      }
+    case Gnuplot2dDataset::POINTS:
+      {
+        ret.SetExtra ("with points");
+        break;
+      }
+    case Gnuplot2dDataset::LINES_POINTS:
+      {
+        ret.SetExtra ("with linespoints");
+        break;
+      }
+    case Gnuplot2dDataset::DOTS:
+      {
+        ret.SetExtra ("with dots");
+        break;
+      }
+    case Gnuplot2dDataset::IMPULSES:
+      {
+        ret.SetExtra ("with impulses");
+        break;
+      }
+    case Gnuplot2dDataset::STEPS:
+      {
+        ret.SetExtra ("with steps");
+        break;
+      }
+    case Gnuplot2dDataset::FSTEPS:
+      {
+        ret.SetExtra ("with fsteps");
+        break;
+      }
+    case Gnuplot2dDataset::HISTEPS:
+      {
+        ret.SetExtra ("with histeps");
+        break;
+      }
+    default:
+      {
+        NS_ABORT_MSG ("SatOutputFileStreamDoubleContainer::GetGnuplotFunction - Invalid style.");
+        break;
+      }
+    }
+  return ret;
+}
+
 Gnuplot
 SatOutputFileStreamDoubleContainer::GetGnuplot ()
 {
@@ -22,8 +22,10 @@
 #define SAT_OUTPUT_FSTREAM_DOUBLE_CONTAINER_H
 
 #include <fstream>
+#include <sstream>
 #include "ns3/object.h"
 #include "satellite-output-fstream-wrapper.h"
+#include "satellite-binary-trace-file.h"
 #include <ns3/gnuplot.h>
 
 namespace ns3 {
@@ -34,6 +36,20 @@ namespace ns3 {
  * \brief Class for output file stream container for double values.
  * The class implements storing the values and writing the stored
  * values into a file. A figure output in two dimensions is also supported.
+ *
+ * In the streaming mode the values are not stored for the whole
+ * simulation. Instead the rows are formatted into a fixed size buffer,
+ * which is handed to the background writer (SatOutputFileStreamWriter)
+ * when full, thus the memory used by the container does not grow with
+ * the number of rows. The file is created at the first row and opened by
+ * the writer only for appending a buffer, so that simulations with
+ * thousands of streamed trace files do not run out of file descriptors.
+ * The file format is the same in both modes, and the
+ * figure of the streaming mode is plotted directly from the written file.
+ *
+ * The values are written either as tab separated text or in the binary
+ * columnar format of SatBinaryTraceFile, in which case the first value
+ * of the rows is expected to be the time.
  */
 class SatOutputFileStreamDoubleContainer : public Object
 {
@@ -45,6 +61,12 @@ public:
     DECIBEL_AMPLITUDE
   } FigureUnitConversion_t;
 
+  typedef enum
+  {
+    TEXT_FILE,
+    BINARY_FILE
+  } FileFormat_t;
+
   /**
    * \brief NS-3 function for type id
    * \return type id
@@ -121,6 +143,37 @@ private:
    */
   void OpenStream ();
 
+  /**
+   * \brief Function for closing the output file stream
+   */
+  void CloseStream ();
+
+  /**
+   * \brief Function for creating the output file of the streaming mode,
+   * the file is closed until the writer appends the rows into it
+   */
+  void CreateStreamFile ();
+
+  /**
+   * \brief Function for writing the container contents into the output
+   * file stream in the binary format
+   */
+  void WriteContainerToBinaryFile ();
+
+  /**
+   * \brief Function for writing a value row into a stream
+   * \param stream output stream
+   * \param row value row
+   */
+  void WriteRow (std::ostream& stream, const std::vector<double>& row) const;
+
+  /**
+   * \brief Function for handing the stream buffer contents to the
+   * background writer
+   */
+  void FlushStreamBuffer ();
+
+
   /**
    * \brief Function for printing the container contents into a figure
    */
@@ -139,6 +192,13 @@ private:
    */
   Gnuplot2dDataset GetGnuplotDataset ();
 
+  /**
+   * \brief Function for creating Gnuplot function plotting the samples
+   * directly from the output file, used in the streaming mode
+   * \return function
+   */
+  Gnuplot2dFunction GetGnuplotFunction ();
+
   /**
    * \brief Function for creating Gnuplots
    * \return Gnuplot
@@ -209,6 +269,46 @@ private:
    * \brief 2D dataset figure style
    */
   Gnuplot2dDataset::Style m_style;
+
+  /**
+   * \brief Enable / disable the streaming mode
+   */
+  bool m_streamingMode;
+
+  /**
+   * \brief Size of the stream buffer in bytes
+   */
+  uint32_t m_streamBufferSize;
+
+  /**
+   * \brief Buffer for the formatted rows not yet handed to the writer
+   */
+  std::ostringstream m_streamBuffer;
+
+  /**
+   * \brief Rows not yet handed to the writer in the binary streaming mode
+   */
+  std::vector<double> m_streamRows;
+
+  /**
+   * \brief Is the output file of the streaming mode created
+   */
+  bool m_streamFileCreated;
+
+  /**
+   * \brief Format of the written file
+   */
+  FileFormat_t m_fileFormat;
+
+  /**
+   * \brief Type of the value columns in the binary format
+   */
+  SatBinaryTraceFile::ValueType_t m_binaryValueType;
+
+  /**
+   * \brief Delta encode the time column in the binary format
+   */
+  bool m_binaryDeltaTime;
 };
 
 } // namespace ns3
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+#include <fstream>
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "satellite-output-fstream-writer.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatOutputFileStreamWriter");
+
+namespace ns3 {
+
+SatOutputFileStreamWriter::SatOutputFileStreamWriter ()
+  : m_queue (),
+    m_maxQueuedBlocks (64),
+    m_writing (false),
+    m_failedFiles (),
+    m_stop (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SatOutputFileStreamWriter::~SatOutputFileStreamWriter ()
+{
+  NS_LOG_FUNCTION (this);
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+
+  m_queueCondition.notify_all ();
+
+  if (m_thread.joinable ())
+    {
+      m_thread.join ();
+    }
+}
+
+void
+SatOutputFileStreamWriter::Write (std::string fileName, std::string& block)
+{
+  NS_LOG_FUNCTION (this << fileName << block.size ());
+
+  if (block.empty ())
+    {
+      return;
+    }
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  if (!m_thread.joinable ())
+    {
+      m_thread = std::thread (&SatOutputFileStreamWriter::Worker, this);
+    }
+
+  m_doneCondition.wait (lock, [this] { return m_queue.size () < m_maxQueuedBlocks; });
+
+  m_queue.push_back (block_t (fileName, std::string ()));
+  m_queue.back ().second.swap (block);
+
+  lock.unlock ();
+  m_queueCondition.notify_one ();
+}
+
+void
+SatOutputFileStreamWriter::Flush (std::string fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_doneCondition.wait (lock, [this] { return m_queue.empty () && !m_writing; });
+
+  NS_ABORT_MSG_IF (m_failedFiles.count (fileName) > 0, "Writing the output file " << fileName << " failed.");
+}
+
+void
+SatOutputFileStreamWriter::Worker ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  while (true)
+    {
+      m_queueCondition.wait (lock, [this] { return m_stop || !m_queue.empty (); });
+
+      if (m_queue.empty ())
+        {
+          return;
+        }
+
+      block_t block;
+      block.swap (m_queue.front ());
+      m_queue.pop_front ();
+      m_writing = true;
+
+      // The block is written without holding the lock, so that the
+      // simulation thread is able to queue new blocks meanwhile
+      lock.unlock ();
+      m_doneCondition.notify_all ();
+
+      std::ofstream stream (block.first.c_str (), std::ios::out | std::ios::app | std::ios::binary);
+      stream.write (block.second.data (), block.second.size ());
+      stream.close ();
+      bool failed = stream.fail ();
+
+      lock.lock ();
+      m_writing = false;
+
+      if (failed)
+        {
+          m_failedFiles.insert (block.first);
+        }
+
+      m_doneCondition.notify_all ();
+    }
+}
+
+} // namespace ns3
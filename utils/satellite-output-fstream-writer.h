@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Frans Laakso <frans.laakso@magister.fi>
+ */
+
+#ifndef SAT_OUTPUT_FSTREAM_WRITER_H
+#define SAT_OUTPUT_FSTREAM_WRITER_H
+
+#include <stdint.h>
+#include <deque>
+#include <set>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Background writer for output files. The writer owns a single
+ * thread, which appends the queued data blocks into their output files in
+ * the queuing order, so that the simulation thread does not wait for the
+ * file system. The writer is accessed through
+ * Singleton<SatOutputFileStreamWriter>.
+ *
+ * A file is opened only for writing a block and closed right after, thus
+ * the number of open files does not grow with the number of files written
+ * during the simulation. The file must exist, i.e. it is created and
+ * truncated by the caller, and must not be written by the caller before
+ * Flush has returned.
+ *
+ * The number of queued blocks is limited, i.e. Write blocks the caller
+ * when the writer thread is not able to keep up, thus the memory used
+ * by the queue is bounded. A failed write is recorded for the file and
+ * reported by Flush of that file only.
+ *
+ * The writer thread is created lazily, so the writer has no cost if the
+ * streaming output is not used.
+ */
+class SatOutputFileStreamWriter
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  SatOutputFileStreamWriter ();
+
+  /**
+   * \brief Destructor. Writes the queued blocks and joins the writer thread.
+   */
+  ~SatOutputFileStreamWriter ();
+
+  /**
+   * \brief Queue a data block to be appended into the file. The contents
+   * of the block are moved into the queue, i.e. the block is empty when
+   * the function returns.
+   * \param fileName Path and name of the output file
+   * \param block Data block
+   */
+  void Write (std::string fileName, std::string& block);
+
+  /**
+   * \brief Wait until all the queued blocks have been written. Aborts
+   * the simulation if writing a block into the given file has failed.
+   * \param fileName Path and name of the output file
+   */
+  void Flush (std::string fileName);
+
+private:
+  /**
+   * \brief Main loop of the writer thread
+   */
+  void Worker ();
+
+  /**
+   * \brief Queued data block and the name of its output file
+   */
+  typedef std::pair<std::string, std::string> block_t;
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_queueCondition;
+  std::condition_variable m_doneCondition;
+
+  std::deque<block_t> m_queue;
+
+  /**
+   * Maximum number of queued blocks
+   */
+  uint32_t m_maxQueuedBlocks;
+
+  /**
+   * Flag telling that the writer thread is writing a block taken from
+   * the queue
+   */
+  bool m_writing;
+
+  /**
+   * Names of the files, into which writing a block has failed
+   */
+  std::set<std::string> m_failedFiles;
+  bool m_stop;
+};
+
+} // namespace ns3
+
+#endif /* SAT_OUTPUT_FSTREAM_WRITER_H */
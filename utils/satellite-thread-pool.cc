@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "satellite-thread-pool.h"
+
+NS_LOG_COMPONENT_DEFINE ("SatThreadPool");
+
+namespace ns3 {
+
+SatThreadPool::SatThreadPool ()
+  : m_workers (),
+    m_task (0),
+    m_count (0),
+    m_nJobWorkers (0),
+    m_nextIndex (0),
+    m_finishedWorkers (0),
+    m_jobId (0),
+    m_stop (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+SatThreadPool::~SatThreadPool ()
+{
+  NS_LOG_FUNCTION (this);
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+
+  m_jobCondition.notify_all ();
+
+  for (std::vector<std::thread>::iterator it = m_workers.begin (); it != m_workers.end (); ++it)
+    {
+      it->join ();
+    }
+}
+
+void
+SatThreadPool::ParallelFor (uint32_t nThreads, uint32_t count, const Task_t& task)
+{
+  NS_LOG_FUNCTION (this << nThreads << count);
+
+  uint32_t nWorkers = std::min (nThreads, count);
+
+  // Calling thread takes part in the evaluation, thus one worker less is needed
+  if (nWorkers <= 1)
+    {
+      for (uint32_t i = 0; i < count; ++i)
+        {
+          task (i);
+        }
+      return;
+    }
+
+  --nWorkers;
+  Reserve (nWorkers);
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_task = &task;
+    m_count = count;
+    m_nJobWorkers = nWorkers;
+    m_nextIndex = 0;
+    m_finishedWorkers = 0;
+    ++m_jobId;
+  }
+
+  m_jobCondition.notify_all ();
+
+  RunTasks ();
+
+  /**
+   * All the indexes are taken when RunTasks returns, but the job may still
+   * be running in the workers. Wait until every participating worker has
+   * finished, so that the job state can be safely reset by the next call.
+   */
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_doneCondition.wait (lock, [this] { return m_finishedWorkers == m_nJobWorkers; });
+  m_task = 0;
+}
+
+uint32_t
+SatThreadPool::GetNWorkers () const
+{
+  return m_workers.size ();
+}
+
+void
+SatThreadPool::Reserve (uint32_t nWorkers)
+{
+  NS_LOG_FUNCTION (this << nWorkers);
+
+  while (m_workers.size () < nWorkers)
+    {
+      // New worker takes part only in the jobs started after its creation
+      m_workers.push_back (std::thread (&SatThreadPool::Worker, this, m_workers.size (), m_jobId));
+    }
+}
+
+void
+SatThreadPool::Worker (uint32_t workerId, uint64_t lastJobId)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  while (true)
+    {
+      m_jobCondition.wait (lock, [this, &lastJobId] { return m_stop || m_jobId != lastJobId; });
+
+      if (m_stop)
+        {
+          return;
+        }
+
+      lastJobId = m_jobId;
+
+      if (workerId >= m_nJobWorkers)
+        {
+          continue;
+        }
+
+      lock.unlock ();
+      RunTasks ();
+      lock.lock ();
+
+      if (++m_finishedWorkers == m_nJobWorkers)
+        {
+          m_doneCondition.notify_one ();
+        }
+    }
+}
+
+void
+SatThreadPool::RunTasks ()
+{
+  uint32_t i;
+
+  while ((i = m_nextIndex++) < m_count)
+    {
+      (*m_task) (i);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2013 Magister Solutions Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Jani Puttonen <jani.puttonen@magister.fi>
+ */
+#ifndef SATELLITE_THREAD_POOL_H
+#define SATELLITE_THREAD_POOL_H
+
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace ns3 {
+
+/**
+ * \ingroup satellite
+ *
+ * \brief Pool of worker threads for evaluating independent, side effect
+ * free computations in parallel from within the single threaded ns-3
+ * event loop. The pool is accessed through Singleton<SatThreadPool>.
+ *
+ * The tasks given to the pool must not touch the simulator, the random
+ * number generators, the trace sources or the reference counts of
+ * shared objects (i.e. Ptr<> objects must not be copied in a task),
+ * since none of them are thread safe. Each task writes only its own
+ * result slot, so that the results are consumed by the calling thread
+ * in a deterministic order regardless of the thread scheduling.
+ *
+ * The worker threads are created lazily, so the pool has no cost if
+ * the parallel evaluation is not enabled.
+ */
+class SatThreadPool
+{
+public:
+  /**
+   * \brief Task to be evaluated for each index of a parallel loop
+   */
+  typedef std::function<void (uint32_t)> Task_t;
+
+  /**
+   * \brief Constructor
+   */
+  SatThreadPool ();
+
+  /**
+   * \brief Destructor. Stops and joins the worker threads.
+   */
+  ~SatThreadPool ();
+
+  /**
+   * \brief Evaluate the task for indexes [0, count) using at most the
+   * given number of threads including the calling thread. The function
+   * returns when the task has been evaluated for all the indexes.
+   * \param nThreads Maximum number of threads used
+   * \param count Number of indexes
+   * \param task Task evaluated for each index
+   */
+  void ParallelFor (uint32_t nThreads, uint32_t count, const Task_t& task);
+
+  /**
+   * \brief Get the number of worker threads created so far
+   * \return Number of worker threads
+   */
+  uint32_t GetNWorkers () const;
+
+private:
+  /**
+   * \brief Create worker threads until there are the given amount of them
+   * \param nWorkers Number of worker threads needed
+   */
+  void Reserve (uint32_t nWorkers);
+
+  /**
+   * \brief Main loop of a worker thread
+   * \param workerId Index of the worker thread
+   * \param lastJobId Id of the last job started before the worker was created
+   */
+  void Worker (uint32_t workerId, uint64_t lastJobId);
+
+  /**
+   * \brief Evaluate the task of the current job until there are no
+   * indexes left
+   */
+  void RunTasks ();
+
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_jobCondition;
+  std::condition_variable m_doneCondition;
+
+  /**
+   * Task, size and participating worker count of the current job
+   */
+  const Task_t *m_task;
+  uint32_t m_count;
+  uint32_t m_nJobWorkers;
+
+  /**
+   * Next free index of the current job
+   */
+  std::atomic<uint32_t> m_nextIndex;
+
+  /**
+   * Number of participating workers which have finished the current job
+   */
+  uint32_t m_finishedWorkers;
+
+  /**
+   * Job counter, used by the workers to detect a new job
+   */
+  uint64_t m_jobId;
+  bool m_stop;
+};
+
+} // namespace ns3
+
+#endif /* SATELLITE_THREAD_POOL_H */